@@ -102,6 +102,8 @@
 
 guint32 _nm_setting_get_setting_priority (NMSetting *setting);
 
+void _nm_setting_ensure_all_registered (void);
+
 gboolean _nm_setting_get_property (NMSetting *setting, const char *name, GValue *value);
 
 GSList *    _nm_utils_hash_values_to_slist (GHashTable *hash);
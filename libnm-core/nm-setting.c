@@ -189,6 +189,54 @@ _nm_setting_lookup_setting_by_type (GType type)
 	return g_hash_table_lookup (registered_settings_by_type, &type);
 }
 
+/**
+ * _nm_setting_ensure_all_registered:
+ *
+ * The settings register themselves when their type is first used,
+ * and the registry is not protected by a lock. Call this on the main
+ * thread before parsing connections in worker threads, so that they
+ * only read from the registry.
+ */
+void
+_nm_setting_ensure_all_registered (void)
+{
+	static gboolean ensured = FALSE;
+
+	if (G_UNLIKELY (!ensured)) {
+		g_type_ensure (NM_TYPE_SETTING_802_1X);
+		g_type_ensure (NM_TYPE_SETTING_ADSL);
+		g_type_ensure (NM_TYPE_SETTING_BLUETOOTH);
+		g_type_ensure (NM_TYPE_SETTING_BOND);
+		g_type_ensure (NM_TYPE_SETTING_BRIDGE);
+		g_type_ensure (NM_TYPE_SETTING_BRIDGE_PORT);
+		g_type_ensure (NM_TYPE_SETTING_CDMA);
+		g_type_ensure (NM_TYPE_SETTING_CONNECTION);
+		g_type_ensure (NM_TYPE_SETTING_DCB);
+		g_type_ensure (NM_TYPE_SETTING_GENERIC);
+		g_type_ensure (NM_TYPE_SETTING_GSM);
+		g_type_ensure (NM_TYPE_SETTING_INFINIBAND);
+		g_type_ensure (NM_TYPE_SETTING_IP4_CONFIG);
+		g_type_ensure (NM_TYPE_SETTING_IP6_CONFIG);
+		g_type_ensure (NM_TYPE_SETTING_IP_TUNNEL);
+		g_type_ensure (NM_TYPE_SETTING_MACVLAN);
+		g_type_ensure (NM_TYPE_SETTING_OLPC_MESH);
+		g_type_ensure (NM_TYPE_SETTING_PPP);
+		g_type_ensure (NM_TYPE_SETTING_PPPOE);
+		g_type_ensure (NM_TYPE_SETTING_SERIAL);
+		g_type_ensure (NM_TYPE_SETTING_TEAM);
+		g_type_ensure (NM_TYPE_SETTING_TEAM_PORT);
+		g_type_ensure (NM_TYPE_SETTING_TUN);
+		g_type_ensure (NM_TYPE_SETTING_VLAN);
+		g_type_ensure (NM_TYPE_SETTING_VPN);
+		g_type_ensure (NM_TYPE_SETTING_VXLAN);
+		g_type_ensure (NM_TYPE_SETTING_WIMAX);
+		g_type_ensure (NM_TYPE_SETTING_WIRED);
+		g_type_ensure (NM_TYPE_SETTING_WIRELESS);
+		g_type_ensure (NM_TYPE_SETTING_WIRELESS_SECURITY);
+		ensured = TRUE;
+	}
+}
+
 static guint32
 _get_setting_type_priority (GType type)
 {
@@ -22,6 +22,7 @@
 
 #include <errno.h>
 #include <stdlib.h>
+#include <arpa/inet.h>
 
 #include "nm-default.h"
 #include "nm-device-bond.h"
@@ -136,6 +137,68 @@ set_bond_attr (NMDevice *device, const char *attr, const char *value)
 	return ret;
 }
 
+/* The names of the numeric option values, indexed by the value that
+ * the kernel uses for them. */
+static const char *const mode_names[]             = { "balance-rr", "active-backup", "balance-xor", "broadcast", "802.3ad", "balance-tlb", "balance-alb", NULL };
+static const char *const arp_validate_names[]     = { "none", "active", "backup", "all", NULL };
+static const char *const primary_reselect_names[] = { "always", "better", "failure", NULL };
+static const char *const fail_over_mac_names[]    = { "none", "active", "follow", NULL };
+static const char *const xmit_hash_policy_names[] = { "layer2", "layer3+4", "layer2+3", NULL };
+static const char *const lacp_rate_names[]        = { "slow", "fast", NULL };
+static const char *const ad_select_names[]        = { "stable", "bandwidth", "count", NULL };
+
+#define BOND_MODE_ACTIVE_BACKUP 1
+#define BOND_MODE_8023AD        4
+#define BOND_MODE_TLB           5
+#define BOND_MODE_ALB           6
+
+static gboolean
+option_parse_uint (const char *value, const char *const *names, guint32 *out_value)
+{
+	gint64 v;
+	guint i;
+
+	if (!value)
+		return FALSE;
+
+	for (i = 0; names && names[i]; i++) {
+		if (!strcmp (value, names[i])) {
+			*out_value = i;
+			return TRUE;
+		}
+	}
+
+	v = _nm_utils_ascii_str_to_int64 (value, 10, 0, G_MAXUINT32, -1);
+	if (v < 0)
+		return FALSE;
+	*out_value = v;
+	return TRUE;
+}
+
+static const char *
+option_uint_to_string (guint32 value, const char *const *names, char *buf, gsize len)
+{
+	guint i;
+
+	for (i = 0; names && names[i]; i++) {
+		if (i == value)
+			return names[i];
+	}
+	g_snprintf (buf, len, "%u", value);
+	return buf;
+}
+
+static gboolean
+get_uint_option (NMSettingBond *s_bond, const char *opt, const char *const *names, guint32 *out_value)
+{
+	const char *value;
+
+	value = nm_setting_bond_get_option_by_name (s_bond, opt);
+	if (!value)
+		value = nm_setting_bond_get_option_default (s_bond, opt);
+	return option_parse_uint (value, names, out_value);
+}
+
 /* Ignore certain bond options if they are zero (off/disabled) */
 static gboolean
 ignore_if_zero (const char *option, const char *value)
@@ -149,11 +212,94 @@ ignore_if_zero (const char *option, const char *value)
 	return g_strcmp0 (value, "0") == 0 ? TRUE : FALSE;
 }
 
+static void
+update_connection_from_lnk (NMSettingBond *s_bond, const NMPlatformLnkBond *lnk)
+{
+	const char **options;
+	char buf[NM_PLATFORM_LNK_BOND_MAX_ARP_TARGETS * (INET_ADDRSTRLEN + 1)];
+
+	options = nm_setting_bond_get_valid_options (s_bond);
+	for (; options && *options; options++) {
+		const char *opt = *options;
+		const char *const *names = NULL;
+		const char *value;
+		guint32 v, v_default;
+
+		if (!strcmp (opt, NM_SETTING_BOND_OPTION_ARP_IP_TARGET)) {
+			char *b = buf;
+			gsize l = sizeof (buf);
+			guint i;
+
+			if (!lnk->num_arp_ip_targets)
+				continue;
+			buf[0] = '\0';
+			for (i = 0; i < lnk->num_arp_ip_targets; i++) {
+				nm_utils_strbuf_append (&b, &l, "%s%s",
+				                        i == 0 ? "" : ",",
+				                        nm_utils_inet4_ntop (lnk->arp_ip_targets[i], NULL));
+			}
+			nm_setting_bond_add_option (s_bond, opt, buf);
+			continue;
+		}
+		if (!strcmp (opt, NM_SETTING_BOND_OPTION_PRIMARY)) {
+			value = lnk->primary ? nm_platform_link_get_name (NM_PLATFORM_GET, lnk->primary) : NULL;
+			if (value)
+				nm_setting_bond_add_option (s_bond, opt, value);
+			continue;
+		}
+
+		if (!strcmp (opt, NM_SETTING_BOND_OPTION_MODE)) {
+			v = lnk->mode;
+			names = mode_names;
+		} else if (!strcmp (opt, NM_SETTING_BOND_OPTION_MIIMON))
+			v = lnk->miimon;
+		else if (!strcmp (opt, NM_SETTING_BOND_OPTION_UPDELAY))
+			v = lnk->updelay;
+		else if (!strcmp (opt, NM_SETTING_BOND_OPTION_DOWNDELAY))
+			v = lnk->downdelay;
+		else if (!strcmp (opt, NM_SETTING_BOND_OPTION_ARP_INTERVAL))
+			v = lnk->arp_interval;
+		else if (!strcmp (opt, NM_SETTING_BOND_OPTION_ARP_VALIDATE)) {
+			v = lnk->arp_validate;
+			names = arp_validate_names;
+		} else if (!strcmp (opt, NM_SETTING_BOND_OPTION_PRIMARY_RESELECT)) {
+			v = lnk->primary_reselect;
+			names = primary_reselect_names;
+		} else if (!strcmp (opt, NM_SETTING_BOND_OPTION_FAIL_OVER_MAC)) {
+			v = lnk->fail_over_mac;
+			names = fail_over_mac_names;
+		} else if (!strcmp (opt, NM_SETTING_BOND_OPTION_USE_CARRIER))
+			v = !!lnk->use_carrier;
+		else if (!strcmp (opt, NM_SETTING_BOND_OPTION_AD_SELECT)) {
+			v = lnk->ad_select;
+			names = ad_select_names;
+		} else if (!strcmp (opt, NM_SETTING_BOND_OPTION_XMIT_HASH_POLICY)) {
+			v = lnk->xmit_hash_policy;
+			names = xmit_hash_policy_names;
+		} else if (!strcmp (opt, NM_SETTING_BOND_OPTION_RESEND_IGMP))
+			v = lnk->resend_igmp;
+		else if (!strcmp (opt, NM_SETTING_BOND_OPTION_LACP_RATE)) {
+			v = lnk->lacp_rate;
+			names = lacp_rate_names;
+		} else
+			continue;
+
+		value = option_uint_to_string (v, names, buf, sizeof (buf));
+		if (ignore_if_zero (opt, value))
+			continue;
+		if (   option_parse_uint (nm_setting_bond_get_option_default (s_bond, opt), names, &v_default)
+		    && v == v_default)
+			continue;
+		nm_setting_bond_add_option (s_bond, opt, value);
+	}
+}
+
 static void
 update_connection (NMDevice *device, NMConnection *connection)
 {
 	NMSettingBond *s_bond = nm_connection_get_setting_bond (connection);
 	int ifindex = nm_device_get_ifindex (device);
+	const NMPlatformLnkBond *lnk;
 	const char **options;
 
 	if (!s_bond) {
@@ -161,6 +307,14 @@ update_connection (NMDevice *device, NMConnection *connection)
 		nm_connection_add_setting (connection, (NMSetting *) s_bond);
 	}
 
+	/* Prefer the options from the platform cache, they are only missing
+	 * if the kernel doesn't report them via netlink. */
+	lnk = nm_platform_link_get_lnk_bond (NM_PLATFORM_GET, ifindex, NULL);
+	if (lnk) {
+		update_connection_from_lnk (s_bond, lnk);
+		return;
+	}
+
 	/* Read bond options from sysfs and update the Bond setting to match */
 	options = nm_setting_bond_get_valid_options (s_bond);
 	while (options && *options) {
@@ -234,9 +388,129 @@ set_simple_option (NMDevice *device,
 	set_bond_attr (device, attr, value);
 }
 
+/* Sets all options with one netlink message. The option restrictions
+ * are the same as for sysfs in apply_bonding_config(), but kernel
+ * applies the mode first. Returns %FALSE if the caller should fall back
+ * to sysfs. */
+static gboolean
+apply_bonding_config_netlink (NMDevice *device, NMSettingBond *s_bond)
+{
+	NMPlatformLnkBond props = { 0 };
+	NMPlatformLnkBondAttrs attrs;
+	const char *value, *primary_sysfs = NULL;
+	guint32 v;
+
+	if (!get_uint_option (s_bond, NM_SETTING_BOND_OPTION_MODE, mode_names, &v))
+		return FALSE;
+	props.mode = v;
+	attrs = NM_PLATFORM_LNK_BOND_ATTR_MODE;
+
+	value = nm_setting_bond_get_option_by_name (s_bond, NM_SETTING_BOND_OPTION_MIIMON);
+	if (value && atoi (value)) {
+		if (   !option_parse_uint (value, NULL, &props.miimon)
+		    || !get_uint_option (s_bond, NM_SETTING_BOND_OPTION_UPDELAY, NULL, &props.updelay)
+		    || !get_uint_option (s_bond, NM_SETTING_BOND_OPTION_DOWNDELAY, NULL, &props.downdelay))
+			return FALSE;
+		attrs |=   NM_PLATFORM_LNK_BOND_ATTR_MIIMON
+		         | NM_PLATFORM_LNK_BOND_ATTR_UPDELAY
+		         | NM_PLATFORM_LNK_BOND_ATTR_DOWNDELAY;
+	} else {
+		if (!get_uint_option (s_bond, NM_SETTING_BOND_OPTION_ARP_INTERVAL, NULL, &props.arp_interval))
+			return FALSE;
+		if (!value && !props.arp_interval) {
+			props.miimon = 100;
+			attrs |= NM_PLATFORM_LNK_BOND_ATTR_MIIMON;
+		}
+	}
+
+	/* kernel refuses arp_interval and arp_validate for 802.3ad, alb
+	 * and tlb, even when clearing them. */
+	if (!NM_IN_SET (props.mode, BOND_MODE_8023AD, BOND_MODE_TLB, BOND_MODE_ALB)) {
+		attrs |= NM_PLATFORM_LNK_BOND_ATTR_ARP_INTERVAL;
+
+		value = nm_setting_bond_get_option_by_name (s_bond, NM_SETTING_BOND_OPTION_ARP_VALIDATE);
+		if (value && props.mode == BOND_MODE_ACTIVE_BACKUP) {
+			if (!option_parse_uint (value, arp_validate_names, &v))
+				return FALSE;
+			props.arp_validate = v;
+		}
+		attrs |= NM_PLATFORM_LNK_BOND_ATTR_ARP_VALIDATE;
+	}
+
+	if (NM_IN_SET (props.mode, BOND_MODE_ACTIVE_BACKUP, BOND_MODE_TLB, BOND_MODE_ALB)) {
+		value = nm_setting_bond_get_option_by_name (s_bond, NM_SETTING_BOND_OPTION_PRIMARY);
+		if (value && *value) {
+			/* netlink refers to the primary by ifindex. If it doesn't exist yet,
+			 * set the name via sysfs, kernel picks it up once it gets enslaved. */
+			props.primary = nm_platform_link_get_ifindex (NM_PLATFORM_GET, value);
+			if (props.primary <= 0) {
+				props.primary = 0;
+				primary_sysfs = value;
+			}
+		}
+		if (!primary_sysfs)
+			attrs |= NM_PLATFORM_LNK_BOND_ATTR_PRIMARY;
+	}
+
+	value = nm_setting_bond_get_option_by_name (s_bond, NM_SETTING_BOND_OPTION_ARP_IP_TARGET);
+	if (value && *value) {
+		gs_strfreev char **items = g_strsplit (value, ",", 0);
+		char **iter;
+
+		for (iter = items; *iter; iter++) {
+			if (!*iter[0])
+				continue;
+			if (   props.num_arp_ip_targets >= NM_PLATFORM_LNK_BOND_MAX_ARP_TARGETS
+			    || inet_pton (AF_INET, *iter, &props.arp_ip_targets[props.num_arp_ip_targets]) != 1)
+				return FALSE;
+			props.num_arp_ip_targets++;
+		}
+	}
+	attrs |= NM_PLATFORM_LNK_BOND_ATTR_ARP_IP_TARGETS;
+
+	if (!get_uint_option (s_bond, NM_SETTING_BOND_OPTION_PRIMARY_RESELECT, primary_reselect_names, &v))
+		return FALSE;
+	props.primary_reselect = v;
+	if (!get_uint_option (s_bond, NM_SETTING_BOND_OPTION_FAIL_OVER_MAC, fail_over_mac_names, &v))
+		return FALSE;
+	props.fail_over_mac = v;
+	if (!get_uint_option (s_bond, NM_SETTING_BOND_OPTION_USE_CARRIER, NULL, &v))
+		return FALSE;
+	props.use_carrier = !!v;
+	if (!get_uint_option (s_bond, NM_SETTING_BOND_OPTION_AD_SELECT, ad_select_names, &v))
+		return FALSE;
+	props.ad_select = v;
+	if (!get_uint_option (s_bond, NM_SETTING_BOND_OPTION_XMIT_HASH_POLICY, xmit_hash_policy_names, &v))
+		return FALSE;
+	props.xmit_hash_policy = v;
+	if (!get_uint_option (s_bond, NM_SETTING_BOND_OPTION_RESEND_IGMP, NULL, &props.resend_igmp))
+		return FALSE;
+	attrs |=   NM_PLATFORM_LNK_BOND_ATTR_PRIMARY_RESELECT
+	         | NM_PLATFORM_LNK_BOND_ATTR_FAIL_OVER_MAC
+	         | NM_PLATFORM_LNK_BOND_ATTR_USE_CARRIER
+	         | NM_PLATFORM_LNK_BOND_ATTR_AD_SELECT
+	         | NM_PLATFORM_LNK_BOND_ATTR_XMIT_HASH_POLICY
+	         | NM_PLATFORM_LNK_BOND_ATTR_RESEND_IGMP;
+
+	if (props.mode == BOND_MODE_8023AD) {
+		if (!get_uint_option (s_bond, NM_SETTING_BOND_OPTION_LACP_RATE, lacp_rate_names, &v))
+			return FALSE;
+		props.lacp_rate = v;
+		attrs |= NM_PLATFORM_LNK_BOND_ATTR_LACP_RATE;
+	}
+
+	if (!nm_platform_link_bond_change (NM_PLATFORM_GET, nm_device_get_ifindex (device), &props, attrs))
+		return FALSE;
+
+	if (primary_sysfs)
+		set_bond_attr (device, "primary", primary_sysfs);
+	return TRUE;
+}
+
 static NMActStageReturn
 apply_bonding_config (NMDevice *device)
 {
+	NMDeviceBond *self = NM_DEVICE_BOND (device);
 	NMConnection *connection;
 	NMSettingBond *s_bond;
 	int ifindex = nm_device_get_ifindex (device);
@@ -262,6 +536,10 @@ apply_bonding_config (NMDevice *device)
 	s_bond = nm_connection_get_setting_bond (connection);
 	g_assert (s_bond);
 
+	if (apply_bonding_config_netlink (device, s_bond))
+		return NM_ACT_STAGE_RETURN_SUCCESS;
+	_LOGD (LOGD_BOND, "failed to set bonding options via netlink, falling back to sysfs");
+
 	mode = nm_setting_bond_get_option_by_name (s_bond, NM_SETTING_BOND_OPTION_MODE);
 	if (mode == NULL)
 		mode = "balance-rr";
@@ -154,14 +154,12 @@ static const Option slave_options[] = {
 	{ NULL, NULL }
 };
 
-static void
-commit_option (NMDevice *device, NMSetting *setting, const Option *option, gboolean slave)
+static guint32
+option_get_value (NMSetting *setting, const Option *option)
 {
-	int ifindex = nm_device_get_ifindex (device);
 	GParamSpec *pspec;
 	GValue val = G_VALUE_INIT;
 	guint32 uval = 0;
-	gs_free char *value = NULL;
 
 	g_assert (setting);
 
@@ -197,18 +195,78 @@ commit_option (NMDevice *device, NMSetting *setting, const Option *option, gbool
 		g_assert_not_reached ();
 	g_value_unset (&val);
 
-	value = g_strdup_printf ("%u", uval);
+	return uval;
+}
+
+static void
+commit_option (NMDevice *device, NMSetting *setting, const Option *option, gboolean slave)
+{
+	int ifindex = nm_device_get_ifindex (device);
+	gs_free char *value = NULL;
+
+	value = g_strdup_printf ("%u", option_get_value (setting, option));
 	if (slave)
 		nm_platform_sysctl_slave_set_option (NM_PLATFORM_GET, ifindex, option->sysname, value);
 	else
 		nm_platform_sysctl_master_set_option (NM_PLATFORM_GET, ifindex, option->sysname, value);
 }
 
+/* Map the sysfs names of the options to the fields used for netlink. */
+static guint32
+lnk_bridge_get_option (const NMPlatformLnkBridge *lnk, const Option *option)
+{
+	if (!strcmp (option->sysname, "stp_state"))
+		return !!lnk->stp_state;
+	if (!strcmp (option->sysname, "priority"))
+		return lnk->priority;
+	if (!strcmp (option->sysname, "forward_delay"))
+		return lnk->forward_delay;
+	if (!strcmp (option->sysname, "hello_time"))
+		return lnk->hello_time;
+	if (!strcmp (option->sysname, "max_age"))
+		return lnk->max_age;
+	if (!strcmp (option->sysname, "ageing_time"))
+		return lnk->ageing_time;
+	if (!strcmp (option->sysname, "multicast_snooping"))
+		return !!lnk->mcast_snooping;
+	g_return_val_if_reached (0);
+}
+
+static void
+lnk_bridge_set_option (NMPlatformLnkBridge *lnk, const Option *option, guint32 value)
+{
+	if (!strcmp (option->sysname, "stp_state"))
+		lnk->stp_state = !!value;
+	else if (!strcmp (option->sysname, "priority"))
+		lnk->priority = value;
+	else if (!strcmp (option->sysname, "forward_delay"))
+		lnk->forward_delay = value;
+	else if (!strcmp (option->sysname, "hello_time"))
+		lnk->hello_time = value;
+	else if (!strcmp (option->sysname, "max_age"))
+		lnk->max_age = value;
+	else if (!strcmp (option->sysname, "ageing_time"))
+		lnk->ageing_time = value;
+	else if (!strcmp (option->sysname, "multicast_snooping"))
+		lnk->mcast_snooping = !!value;
+	else
+		g_return_if_reached ();
+}
+
 static void
 commit_master_options (NMDevice *device, NMSettingBridge *setting)
 {
+	NMDeviceBridge *self = NM_DEVICE_BRIDGE (device);
 	const Option *option;
 	NMSetting *s = NM_SETTING (setting);
+	NMPlatformLnkBridge props = { 0 };
+
+	for (option = master_options; option->name; option++)
+		lnk_bridge_set_option (&props, option, option_get_value (s, option));
+
+	if (nm_platform_link_bridge_change (NM_PLATFORM_GET, nm_device_get_ifindex (device), &props))
+		return;
+	_LOGD (LOGD_BRIDGE, "failed to set bridge options via netlink, falling back to sysfs");
 
 	for (option = master_options; option->name; option++)
 		commit_option (device, s, option, FALSE);
@@ -219,14 +277,28 @@ commit_slave_options (NMDevice *device, NMSettingBridgePort *setting)
 {
 	const Option *option;
 	NMSetting *s, *s_clear = NULL;
+	NMPlatformBridgePort props = { 0 };
 
 	if (setting)
 		s = NM_SETTING (setting);
 	else
 		s = s_clear = nm_setting_bridge_port_new ();
 
-	for (option = slave_options; option->name; option++)
-		commit_option (device, s, option, TRUE);
+	for (option = slave_options; option->name; option++) {
+		guint32 value = option_get_value (s, option);
+
+		if (!strcmp (option->sysname, "priority"))
+			props.priority = value;
+		else if (!strcmp (option->sysname, "path_cost"))
+			props.path_cost = value;
+		else if (!strcmp (option->sysname, "hairpin_mode"))
+			props.hairpin_mode = !!value;
+	}
+
+	if (!nm_platform_link_bridge_port_change (NM_PLATFORM_GET, nm_device_get_ifindex (device), &props)) {
+		for (option = slave_options; option->name; option++)
+			commit_option (device, s, option, TRUE);
+	}
 
 	g_clear_object (&s_clear);
 }
@@ -237,6 +309,7 @@ update_connection (NMDevice *device, NMConnection *connection)
 	NMDeviceBridge *self = NM_DEVICE_BRIDGE (device);
 	NMSettingBridge *s_bridge = nm_connection_get_setting_bridge (connection);
 	int ifindex = nm_device_get_ifindex (device);
+	const NMPlatformLnkBridge *lnk;
 	const Option *option;
 
 	if (!s_bridge) {
@@ -244,6 +317,19 @@ update_connection (NMDevice *device, NMConnection *connection)
 		nm_connection_add_setting (connection, (NMSetting *) s_bridge);
 	}
 
+	lnk = nm_platform_link_get_lnk_bridge (NM_PLATFORM_GET, ifindex, NULL);
+	if (lnk) {
+		for (option = master_options; option->name; option++) {
+			guint32 value = lnk_bridge_get_option (lnk, option);
+
+			/* See comments in commit_option() about centiseconds. */
+			if (option->user_hz_compensate)
+				value /= 100;
+			g_object_set (s_bridge, option->name, value, NULL);
+		}
+		return;
+	}
+
 	for (option = master_options; option->name; option++) {
 		gs_free char *str = nm_platform_sysctl_master_get_option (NM_PLATFORM_GET, ifindex, option->sysname);
 		int value;
@@ -534,9 +534,27 @@ NM_UTILS_LOOKUP_STR_DEFINE_STATIC (_reason_to_string, NMDeviceStateReason, NULL,
 gboolean
 nm_device_ipv6_sysctl_set (NMDevice *self, const char *property, const char *value)
 {
+	int ifindex = nm_device_get_ip_ifindex (self);
+
+	if (ifindex > 0)
+		return nm_platform_sysctl_ifindex_set (NM_PLATFORM_GET, ifindex, NM_PLATFORM_SYSCTL_DIR_IP6_CONF, property, value);
 	return nm_platform_sysctl_set (NM_PLATFORM_GET, nm_utils_ip6_property_path (nm_device_get_ip_iface (self), property), value);
 }
 
+static void
+nm_device_ipv6_sysctl_set_many (NMDevice *self, const NMPlatformSysctlSetting *settings, guint n_settings)
+{
+	int ifindex = nm_device_get_ip_ifindex (self);
+	guint i;
+
+	if (ifindex > 0) {
+		nm_platform_sysctl_ifindex_set_many (NM_PLATFORM_GET, ifindex, NM_PLATFORM_SYSCTL_DIR_IP6_CONF, settings, n_settings);
+		return;
+	}
+	for (i = 0; i < n_settings; i++)
+		nm_device_ipv6_sysctl_set (self, settings[i].name, settings[i].value);
+}
+
 static guint32
 nm_device_ipv6_sysctl_get_int32 (NMDevice *self, const char *property, gint32 fallback)
 {
@@ -5832,10 +5850,16 @@ addrconf6_start_with_link_ready (NMDevice *self)
 	if (!ip6_config_merge_and_apply (self, TRUE, NULL))
 		_LOGW (LOGD_IP6, "failed to apply manual IPv6 configuration");
 
-	nm_device_ipv6_sysctl_set (self, "accept_ra", "1");
-	nm_device_ipv6_sysctl_set (self, "accept_ra_defrtr", "0");
-	nm_device_ipv6_sysctl_set (self, "accept_ra_pinfo", "0");
-	nm_device_ipv6_sysctl_set (self, "accept_ra_rtr_pref", "0");
+	{
+		static const NMPlatformSysctlSetting settings[] = {
+			{ "accept_ra",          "1" },
+			{ "accept_ra_defrtr",   "0" },
+			{ "accept_ra_pinfo",    "0" },
+			{ "accept_ra_rtr_pref", "0" },
+		};
+
+		nm_device_ipv6_sysctl_set_many (self, settings, G_N_ELEMENTS (settings));
+	}
 
 	priv->rdisc_changed_id = g_signal_connect (priv->rdisc,
 	                                           NM_RDISC_CONFIG_CHANGED,
@@ -5936,13 +5960,18 @@ save_ip6_properties (NMDevice *self)
 {
 	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
 	const char *ifname = nm_device_get_ip_iface (self);
+	int ifindex = nm_device_get_ip_ifindex (self);
 	char *value;
 	int i;
 
 	g_hash_table_remove_all (priv->ip6_saved_properties);
 
 	for (i = 0; i < G_N_ELEMENTS (ip6_properties_to_save); i++) {
-		value = nm_platform_sysctl_get (NM_PLATFORM_GET, nm_utils_ip6_property_path (ifname, ip6_properties_to_save[i]));
+		if (ifindex > 0) {
+			value = nm_platform_sysctl_ifindex_get (NM_PLATFORM_GET, ifindex, NM_PLATFORM_SYSCTL_DIR_IP6_CONF,
+			                                        ip6_properties_to_save[i]);
+		} else
+			value = nm_platform_sysctl_get (NM_PLATFORM_GET, nm_utils_ip6_property_path (ifname, ip6_properties_to_save[i]));
 		if (value) {
 			g_hash_table_insert (priv->ip6_saved_properties,
 			                     (char *) ip6_properties_to_save[i],
@@ -5957,14 +5986,22 @@ restore_ip6_properties (NMDevice *self)
 	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
 	GHashTableIter iter;
 	gpointer key, value;
+	NMPlatformSysctlSetting settings[G_N_ELEMENTS (ip6_properties_to_save)];
+	guint n = 0;
 
 	g_hash_table_iter_init (&iter, priv->ip6_saved_properties);
 	while (g_hash_table_iter_next (&iter, &key, &value)) {
 		/* Don't touch "disable_ipv6" if we're doing userland IPv6LL */
 		if (priv->nm_ipv6ll && strcmp (key, "disable_ipv6") == 0)
 			continue;
-		nm_device_ipv6_sysctl_set (self, key, value);
+		g_return_if_fail (n < G_N_ELEMENTS (settings));
+		settings[n].name = key;
+		settings[n].value = value;
+		n++;
 	}
+
+	/* most of the saved properties usually did not change. */
+	nm_device_ipv6_sysctl_set_many (self, settings, n);
 }
 
 static inline void
@@ -8821,30 +8858,23 @@ queued_ip6_config_change (gpointer user_data)
 }
 
 static void
-device_ipx_changed (NMPlatform *platform,
-                    NMPObjectType obj_type,
-                    int ifindex,
+device_ipx_changed (NMDevice *self,
+                    NMPlatformSignalIdType signal_id,
                     gpointer platform_object,
-                    NMPlatformSignalChangeType change_type,
-                    NMDevice *self)
+                    NMPlatformSignalChangeType change_type)
 {
-	NMDevicePrivate *priv;
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
 	NMPlatformIP6Address *addr;
 
-	if (nm_device_get_ip_ifindex (self) != ifindex)
-		return;
-
-	priv = NM_DEVICE_GET_PRIVATE (self);
-
-	switch (obj_type) {
-	case NMP_OBJECT_TYPE_IP4_ADDRESS:
-	case NMP_OBJECT_TYPE_IP4_ROUTE:
+	switch (signal_id) {
+	case NM_PLATFORM_SIGNAL_ID_IP4_ADDRESS:
+	case NM_PLATFORM_SIGNAL_ID_IP4_ROUTE:
 		if (!priv->queued_ip4_config_id) {
 			priv->queued_ip4_config_id = g_idle_add (queued_ip4_config_change, self);
 			_LOGD (LOGD_DEVICE, "queued IP4 config change");
 		}
 		break;
-	case NMP_OBJECT_TYPE_IP6_ADDRESS:
+	case NM_PLATFORM_SIGNAL_ID_IP6_ADDRESS:
 		addr = platform_object;
 
 		if (   priv->state > NM_DEVICE_STATE_DISCONNECTED
@@ -8855,7 +8885,7 @@ device_ipx_changed (NMPlatform *platform,
 			                                          g_memdup (addr, sizeof (NMPlatformIP6Address)));
 		}
 		/* fallthrough */
-	case NMP_OBJECT_TYPE_IP6_ROUTE:
+	case NM_PLATFORM_SIGNAL_ID_IP6_ROUTE:
 		if (!priv->queued_ip6_config_id) {
 			priv->queued_ip6_config_id = g_idle_add (queued_ip6_config_change, self);
 			_LOGD (LOGD_DEVICE, "queued IP6 config change");
@@ -8866,6 +8896,28 @@ device_ipx_changed (NMPlatform *platform,
 	}
 }
 
+static void
+device_ipx_changes (NMPlatform *platform,
+                    const NMPlatformChanges *changes,
+                    NMDevice *self)
+{
+	const NMPlatformChange *ifindex_changes;
+	int ifindex;
+	guint i, len;
+
+	ifindex = nm_device_get_ip_ifindex (self);
+	if (ifindex <= 0)
+		return;
+
+	ifindex_changes = nm_platform_changes_lookup_ifindex (changes, ifindex, &len);
+	for (i = 0; i < len; i++) {
+		device_ipx_changed (self,
+		                    ifindex_changes[i].signal_id,
+		                    (gpointer) nm_platform_changes_get_object (changes, &ifindex_changes[i]),
+		                    ifindex_changes[i].change_type);
+	}
+}
+
 /**
  * nm_device_get_managed():
  * @self: the #NMDevice
@@ -9937,12 +9989,16 @@ notify_ip_properties (NMDevice *self)
 static void
 ip6_managed_setup (NMDevice *self)
 {
+	static const NMPlatformSysctlSetting settings[] = {
+		{ "accept_ra_defrtr",   "0" },
+		{ "accept_ra_pinfo",    "0" },
+		{ "accept_ra_rtr_pref", "0" },
+		{ "use_tempaddr",       "0" },
+	};
+
 	set_nm_ipv6ll (self, TRUE);
 	set_disable_ipv6 (self, "1");
-	nm_device_ipv6_sysctl_set (self, "accept_ra_defrtr", "0");
-	nm_device_ipv6_sysctl_set (self, "accept_ra_pinfo", "0");
-	nm_device_ipv6_sysctl_set (self, "accept_ra_rtr_pref", "0");
-	nm_device_ipv6_sysctl_set (self, "use_tempaddr", "0");
+	nm_device_ipv6_sysctl_set_many (self, settings, G_N_ELEMENTS (settings));
 }
 
 static void
@@ -10748,10 +10804,7 @@ constructed (GObject *object)
 		priv->capabilities |= NM_DEVICE_GET_CLASS (self)->get_generic_capabilities (self);
 
 	/* Watch for external IP config changes */
-	g_signal_connect (platform, NM_PLATFORM_SIGNAL_IP4_ADDRESS_CHANGED, G_CALLBACK (device_ipx_changed), self);
-	g_signal_connect (platform, NM_PLATFORM_SIGNAL_IP6_ADDRESS_CHANGED, G_CALLBACK (device_ipx_changed), self);
-	g_signal_connect (platform, NM_PLATFORM_SIGNAL_IP4_ROUTE_CHANGED, G_CALLBACK (device_ipx_changed), self);
-	g_signal_connect (platform, NM_PLATFORM_SIGNAL_IP6_ROUTE_CHANGED, G_CALLBACK (device_ipx_changed), self);
+	g_signal_connect (platform, NM_PLATFORM_SIGNAL_CHANGES, G_CALLBACK (device_ipx_changes), self);
 	g_signal_connect (platform, NM_PLATFORM_SIGNAL_LINK_CHANGED, G_CALLBACK (link_changed_cb), self);
 
 	priv->con_provider = nm_connection_provider_get ();
@@ -10835,7 +10888,7 @@ dispose (GObject *object)
 	_clear_queued_act_request (priv);
 
 	platform = nm_platform_get ();
-	g_signal_handlers_disconnect_by_func (platform, G_CALLBACK (device_ipx_changed), self);
+	g_signal_handlers_disconnect_by_func (platform, G_CALLBACK (device_ipx_changes), self);
 	g_signal_handlers_disconnect_by_func (platform, G_CALLBACK (link_changed_cb), self);
 
 	nm_clear_g_source (&priv->device_link_changed_id);
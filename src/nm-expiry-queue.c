@@ -0,0 +1,283 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2016 Red Hat, Inc.
+ */
+
+
+#include "config.h"
+
+#include "nm-default.h"
+#include "nm-expiry-queue.h"
+
+#include "nm-macros-internal.h"
+#include "NetworkManagerUtils.h"
+
+#define NS_PER_MSEC ((gint64) 1000000)
+
+struct _NMExpiryQueue {
+	NMExpiryQueueNode **nodes;
+	guint len;
+	guint alloc;
+
+	NMExpiryQueueFunc func;
+	gpointer user_data;
+
+	guint timeout_id;
+	/* the expiry for which @timeout_id is armed. */
+	gint64 armed_expiry_ns;
+};
+
+/******************************************************************************************/
+
+static inline void
+_heap_set (NMExpiryQueue *queue, guint pos, NMExpiryQueueNode *node)
+{
+	queue->nodes[pos] = node;
+	node->_pos = pos + 1;
+}
+
+static void
+_heap_sift_up (NMExpiryQueue *queue, guint pos)
+{
+	NMExpiryQueueNode *node = queue->nodes[pos];
+	guint parent;
+
+	while (pos > 0) {
+		parent = (pos - 1) / 2;
+		if (queue->nodes[parent]->_expiry_ns <= node->_expiry_ns)
+			break;
+		_heap_set (queue, pos, queue->nodes[parent]);
+		pos = parent;
+	}
+	_heap_set (queue, pos, node);
+}
+
+static void
+_heap_sift_down (NMExpiryQueue *queue, guint pos)
+{
+	NMExpiryQueueNode *node = queue->nodes[pos];
+	guint child;
+
+	while ((child = 2 * pos + 1) < queue->len) {
+		if (   child + 1 < queue->len
+		    && queue->nodes[child + 1]->_expiry_ns < queue->nodes[child]->_expiry_ns)
+			child++;
+		if (node->_expiry_ns <= queue->nodes[child]->_expiry_ns)
+			break;
+		_heap_set (queue, pos, queue->nodes[child]);
+		pos = child;
+	}
+	_heap_set (queue, pos, node);
+}
+
+static void
+_heap_fixup (NMExpiryQueue *queue, guint pos)
+{
+	if (   pos > 0
+	    && queue->nodes[pos]->_expiry_ns < queue->nodes[(pos - 1) / 2]->_expiry_ns)
+		_heap_sift_up (queue, pos);
+	else
+		_heap_sift_down (queue, pos);
+}
+
+static void
+_heap_remove_at (NMExpiryQueue *queue, guint pos)
+{
+	NMExpiryQueueNode *node = queue->nodes[pos];
+	guint last;
+
+	nm_assert (pos < queue->len);
+
+	last = --queue->len;
+	if (pos != last) {
+		_heap_set (queue, pos, queue->nodes[last]);
+		_heap_fixup (queue, pos);
+	}
+	queue->nodes[last] = NULL;
+	node->_pos = 0;
+}
+
+/******************************************************************************************/
+
+static gboolean _timeout_cb (gpointer user_data);
+
+static void
+_rearm (NMExpiryQueue *queue)
+{
+	NMExpiryQueueNode *head;
+	gint64 delay_ns;
+
+	if (queue->len == 0) {
+		nm_clear_g_source (&queue->timeout_id);
+		return;
+	}
+
+	head = queue->nodes[0];
+	if (   queue->timeout_id
+	    && queue->armed_expiry_ns == head->_expiry_ns)
+		return;
+
+	nm_clear_g_source (&queue->timeout_id);
+
+	/* round up, so that the timeout does not fire before the expiry. */
+	delay_ns = MAX (head->_expiry_ns - nm_utils_get_monotonic_timestamp_ns (), (gint64) 0);
+	queue->timeout_id = g_timeout_add ((delay_ns + NS_PER_MSEC - 1) / NS_PER_MSEC, _timeout_cb, queue);
+	queue->armed_expiry_ns = head->_expiry_ns;
+}
+
+static gboolean
+_timeout_cb (gpointer user_data)
+{
+	NMExpiryQueue *queue = user_data;
+	NMExpiryQueueNode *node;
+	gint64 now_ns;
+
+	queue->timeout_id = 0;
+
+	now_ns = nm_utils_get_monotonic_timestamp_ns ();
+	while (   queue->len > 0
+	       && queue->nodes[0]->_expiry_ns <= now_ns) {
+		node = queue->nodes[0];
+		_heap_remove_at (queue, 0);
+
+		/* the callback may modify the queue, but not free it. */
+		queue->func (node, queue->user_data);
+	}
+
+	_rearm (queue);
+	return G_SOURCE_REMOVE;
+}
+
+/******************************************************************************************/
+
+/**
+ * nm_expiry_queue_schedule:
+ * @queue: the #NMExpiryQueue
+ * @node: the node to schedule. It must stay valid as long as it
+ *   is queued, usually it is embedded in the value that expires.
+ * @expiry_ns: the monotonic timestamp at which @node expires.
+ *
+ * Adds @node to @queue. If @node is already queued, its expiry is
+ * updated instead. The timeout is only re-armed if the earliest
+ * expiry of the queue changes.
+ */
+void
+nm_expiry_queue_schedule (NMExpiryQueue *queue,
+                          NMExpiryQueueNode *node,
+                          gint64 expiry_ns)
+{
+	g_return_if_fail (queue);
+	g_return_if_fail (node);
+
+	node->_expiry_ns = expiry_ns;
+
+	if (node->_pos) {
+		nm_assert (node->_pos <= queue->len);
+		nm_assert (queue->nodes[node->_pos - 1] == node);
+
+		_heap_fixup (queue, node->_pos - 1);
+	} else {
+		if (queue->len == queue->alloc) {
+			queue->alloc = MAX (8u, queue->alloc * 2);
+			queue->nodes = g_renew (NMExpiryQueueNode *, queue->nodes, queue->alloc);
+		}
+		queue->nodes[queue->len++] = node;
+		_heap_sift_up (queue, queue->len - 1);
+	}
+
+	_rearm (queue);
+}
+
+/**
+ * nm_expiry_queue_remove:
+ * @queue: the #NMExpiryQueue
+ * @node: the node to remove
+ *
+ * Returns: %TRUE if @node was removed, %FALSE if it was
+ *   not queued.
+ */
+gboolean
+nm_expiry_queue_remove (NMExpiryQueue *queue,
+                        NMExpiryQueueNode *node)
+{
+	g_return_val_if_fail (queue, FALSE);
+	g_return_val_if_fail (node, FALSE);
+
+	if (!node->_pos)
+		return FALSE;
+
+	nm_assert (node->_pos <= queue->len);
+	nm_assert (queue->nodes[node->_pos - 1] == node);
+
+	_heap_remove_at (queue, node->_pos - 1);
+	_rearm (queue);
+	return TRUE;
+}
+
+guint
+nm_expiry_queue_get_length (const NMExpiryQueue *queue)
+{
+	g_return_val_if_fail (queue, 0);
+
+	return queue->len;
+}
+
+/**
+ * nm_expiry_queue_peek:
+ * @queue: the #NMExpiryQueue
+ *
+ * Returns: the node with the earliest expiry or %NULL if
+ *   @queue is empty.
+ */
+NMExpiryQueueNode *
+nm_expiry_queue_peek (const NMExpiryQueue *queue)
+{
+	g_return_val_if_fail (queue, NULL);
+
+	return queue->len > 0 ? queue->nodes[0] : NULL;
+}
+
+/******************************************************************************************/
+
+NMExpiryQueue *
+nm_expiry_queue_new (NMExpiryQueueFunc func,
+                     gpointer user_data)
+{
+	NMExpiryQueue *queue;
+
+	g_return_val_if_fail (func, NULL);
+
+	queue = g_slice_new0 (NMExpiryQueue);
+	queue->func = func;
+	queue->user_data = user_data;
+	return queue;
+}
+
+void
+nm_expiry_queue_free (NMExpiryQueue *queue)
+{
+	guint i;
+
+	g_return_if_fail (queue);
+
+	for (i = 0; i < queue->len; i++)
+		queue->nodes[i]->_pos = 0;
+	nm_clear_g_source (&queue->timeout_id);
+	g_free (queue->nodes);
+	g_slice_free (NMExpiryQueue, queue);
+}
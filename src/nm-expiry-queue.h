@@ -0,0 +1,81 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2016 Red Hat, Inc.
+ */
+
+
+#ifndef __NM_EXPIRY_QUEUE__
+#define __NM_EXPIRY_QUEUE__
+
+#include "nm-default.h"
+
+G_BEGIN_DECLS
+
+/* NMExpiryQueue is a binary min-heap of expiry timestamps, backed by a
+ * single timeout source that is armed for the earliest expiry.
+ *
+ * Like NMGroupIndex, every value embeds a NMExpiryQueueNode that remembers
+ * its position in the heap, so that scheduling, rescheduling and removing
+ * a value is O(log n). When the timeout fires, the callback is invoked for
+ * every expired node, in the order of their expiry. The node is already
+ * unlinked when the callback runs, so the callback may free its value or
+ * schedule it again.
+ *
+ * Timestamps are in nanoseconds of nm_utils_get_monotonic_timestamp_ns(). */
+
+typedef struct _NMExpiryQueue NMExpiryQueue;
+
+typedef struct {
+	gint64 _expiry_ns;
+	/* the position inside the heap plus one, zero if not queued. */
+	guint _pos;
+} NMExpiryQueueNode;
+
+typedef void (*NMExpiryQueueFunc) (NMExpiryQueueNode *node, gpointer user_data);
+
+NMExpiryQueue *nm_expiry_queue_new (NMExpiryQueueFunc func,
+                                    gpointer user_data);
+
+void nm_expiry_queue_free (NMExpiryQueue *queue);
+
+void nm_expiry_queue_schedule (NMExpiryQueue *queue,
+                               NMExpiryQueueNode *node,
+                               gint64 expiry_ns);
+
+gboolean nm_expiry_queue_remove (NMExpiryQueue *queue,
+                                 NMExpiryQueueNode *node);
+
+guint nm_expiry_queue_get_length (const NMExpiryQueue *queue);
+
+NMExpiryQueueNode *nm_expiry_queue_peek (const NMExpiryQueue *queue);
+
+static inline gboolean
+nm_expiry_queue_node_is_queued (const NMExpiryQueueNode *node)
+{
+	return node->_pos != 0;
+}
+
+static inline gint64
+nm_expiry_queue_node_get_expiry (const NMExpiryQueueNode *node)
+{
+	return node->_expiry_ns;
+}
+
+G_END_DECLS
+
+#endif /* __NM_EXPIRY_QUEUE__ */
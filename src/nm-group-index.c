@@ -0,0 +1,303 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2016 Red Hat, Inc.
+ */
+
+#include "config.h"
+
+#include "nm-default.h"
+#include "nm-group-index.h"
+
+#include <string.h>
+
+#include "nm-macros-internal.h"
+
+struct _NMGroupIndex {
+	GHashTable *hash;
+	gsize id_size;
+};
+
+struct _NMGroupIndexGroup {
+	/* @values is a %NULL terminated array of @len elements, suitable
+	 * to be returned by nm_group_index_lookup(). @nodes has the
+	 * corresponding node for each value, so that moving a value
+	 * inside the array can update its position. */
+	gpointer *values;
+	NMGroupIndexNode **nodes;
+	guint len;
+	guint alloc;
+
+	/* the id of the group. It is also the key in the hash table. */
+	union {
+		gpointer _align_ptr;
+		guint64 _align_u64;
+	} id[];
+};
+
+/******************************************************************************************/
+
+static NMGroupIndexGroup *
+_group_new (const NMGroupIndex *index, gconstpointer id)
+{
+	NMGroupIndexGroup *group;
+
+	group = g_malloc (G_STRUCT_OFFSET (NMGroupIndexGroup, id) + index->id_size);
+	group->alloc = 4;
+	group->len = 0;
+	group->values = g_new (gpointer, group->alloc + 1);
+	group->values[0] = NULL;
+	group->nodes = g_new (NMGroupIndexNode *, group->alloc);
+	memcpy (group->id, id, index->id_size);
+	return group;
+}
+
+static void
+_group_free (NMGroupIndexGroup *group)
+{
+	guint i;
+
+	for (i = 0; i < group->len; i++) {
+		group->nodes[i]->_group = NULL;
+		group->nodes[i]->_pos = 0;
+	}
+	g_free (group->values);
+	g_free (group->nodes);
+	g_free (group);
+}
+
+/******************************************************************************************/
+
+/**
+ * nm_group_index_lookup():
+ * @index:
+ * @id:
+ * @out_len: (allow-none): output the number of values
+ *   that are returned.
+ *
+ * Returns: (transfer-none): %NULL if there are no values
+ *   or a %NULL terminated array of pointers. The array is
+ *   only valid until the next modification of the group.
+ */
+void *const*
+nm_group_index_lookup (const NMGroupIndex *index,
+                       gconstpointer id,
+                       guint *out_len)
+{
+	NMGroupIndexGroup *group;
+
+	g_return_val_if_fail (index, NULL);
+	g_return_val_if_fail (id, NULL);
+
+	group = g_hash_table_lookup (index->hash, id);
+	if (!group) {
+		NM_SET_OUT (out_len, 0);
+		return NULL;
+	}
+
+	nm_assert (group->len > 0);
+	nm_assert (!group->values[group->len]);
+
+	NM_SET_OUT (out_len, group->len);
+	return group->values;
+}
+
+gconstpointer
+nm_group_index_node_get_id (const NMGroupIndexNode *node)
+{
+	g_return_val_if_fail (node, NULL);
+
+	return node->_group ? (gconstpointer) node->_group->id : NULL;
+}
+
+guint
+nm_group_index_get_num_groups (const NMGroupIndex *index)
+{
+	g_return_val_if_fail (index, 0);
+
+	return g_hash_table_size (index->hash);
+}
+
+void
+nm_group_index_iter_init (NMGroupIndexIter *iter,
+                          const NMGroupIndex *index)
+{
+	g_return_if_fail (index);
+	g_return_if_fail (iter);
+
+	g_hash_table_iter_init (&iter->_iter, index->hash);
+}
+
+gboolean
+nm_group_index_iter_next (NMGroupIndexIter *iter,
+                          gconstpointer *out_id,
+                          void *const**out_values,
+                          guint *out_len)
+{
+	NMGroupIndexGroup *group;
+
+	g_return_val_if_fail (iter, FALSE);
+
+	if (!g_hash_table_iter_next (&iter->_iter, NULL, (gpointer *) &group))
+		return FALSE;
+
+	NM_SET_OUT (out_id, group->id);
+	NM_SET_OUT (out_values, group->values);
+	NM_SET_OUT (out_len, group->len);
+	return TRUE;
+}
+
+/******************************************************************************************/
+
+/**
+ * nm_group_index_add:
+ * @index:
+ * @id: the id of the group to which @value is added. The id
+ *   is copied (with the size given to nm_group_index_new())
+ *   when a new group must be created.
+ * @value: the value to add.
+ * @node: the node of @value that tracks the membership in
+ *   the group. It must stay valid as long as @value is
+ *   part of the group, usually it is embedded in @value.
+ *
+ * Returns: %TRUE if @value was added, %FALSE if @node is
+ *   already linked.
+ */
+gboolean
+nm_group_index_add (NMGroupIndex *index,
+                    gconstpointer id,
+                    gpointer value,
+                    NMGroupIndexNode *node)
+{
+	NMGroupIndexGroup *group;
+
+	g_return_val_if_fail (index, FALSE);
+	g_return_val_if_fail (id, FALSE);
+	g_return_val_if_fail (value, FALSE);
+	g_return_val_if_fail (node, FALSE);
+
+	if (node->_group)
+		return FALSE;
+
+	group = g_hash_table_lookup (index->hash, id);
+	if (!group) {
+		group = _group_new (index, id);
+		g_hash_table_insert (index->hash, group->id, group);
+	} else if (group->len == group->alloc) {
+		group->alloc *= 2;
+		group->values = g_renew (gpointer, group->values, group->alloc + 1);
+		group->nodes = g_renew (NMGroupIndexNode *, group->nodes, group->alloc);
+	}
+
+	node->_group = group;
+	node->_pos = group->len;
+	group->values[group->len] = value;
+	group->nodes[group->len] = node;
+	group->values[++group->len] = NULL;
+	return TRUE;
+}
+
+/**
+ * nm_group_index_remove:
+ * @index:
+ * @value: the value to remove.
+ * @node: the node with which @value was added.
+ *
+ * Removes @value from the group that @node is linked to.
+ * The last value of the group takes the place of @value,
+ * so this is O(1). Empty groups are released.
+ *
+ * Returns: %TRUE if @value was removed, %FALSE if @node
+ *   is not linked.
+ */
+gboolean
+nm_group_index_remove (NMGroupIndex *index,
+                       gpointer value,
+                       NMGroupIndexNode *node)
+{
+	NMGroupIndexGroup *group;
+	guint last;
+
+	g_return_val_if_fail (index, FALSE);
+	g_return_val_if_fail (node, FALSE);
+
+	group = node->_group;
+	if (!group)
+		return FALSE;
+
+	nm_assert (node->_pos < group->len);
+	nm_assert (group->nodes[node->_pos] == node);
+	nm_assert (group->values[node->_pos] == value);
+
+	if (group->len == 1) {
+		if (!g_hash_table_remove (index->hash, group->id))
+			g_return_val_if_reached (FALSE);
+		return TRUE;
+	}
+
+	last = --group->len;
+	if (node->_pos != last) {
+		group->values[node->_pos] = group->values[last];
+		group->nodes[node->_pos] = group->nodes[last];
+		group->nodes[node->_pos]->_pos = node->_pos;
+	}
+	group->values[last] = NULL;
+
+	node->_group = NULL;
+	node->_pos = 0;
+	return TRUE;
+}
+
+/******************************************************************************************/
+
+/**
+ * nm_group_index_new:
+ * @hash_fcn: the hash function for the ids.
+ * @equal_fcn: the equal function for the ids.
+ * @id_size: the size of the ids. The index keeps a copy
+ *   of the id for each group.
+ *
+ * Returns: the new index.
+ */
+NMGroupIndex *
+nm_group_index_new (GHashFunc hash_fcn,
+                    GEqualFunc equal_fcn,
+                    gsize id_size)
+{
+	NMGroupIndex *index;
+
+	g_return_val_if_fail (hash_fcn, NULL);
+	g_return_val_if_fail (equal_fcn, NULL);
+	g_return_val_if_fail (id_size > 0, NULL);
+
+	index = g_new (NMGroupIndex, 1);
+	index->id_size = id_size;
+	index->hash = g_hash_table_new_full (hash_fcn,
+	                                     equal_fcn,
+	                                     NULL,
+	                                     (GDestroyNotify) _group_free);
+	return index;
+}
+
+void
+nm_group_index_free (NMGroupIndex *index)
+{
+	g_return_if_fail (index);
+
+	g_hash_table_unref (index->hash);
+	g_free (index);
+}
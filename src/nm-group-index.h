@@ -0,0 +1,90 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2016 Red Hat, Inc.
+ */
+
+#ifndef __NM_GROUP_INDEX__
+#define __NM_GROUP_INDEX__
+
+#include "nm-default.h"
+
+G_BEGIN_DECLS
+
+/* NMGroupIndex groups values by an id, similar to NMMultiIndex.
+ *
+ * The difference is, that the values of a group are kept in a dense
+ * array and each value embeds a NMGroupIndexNode for every group
+ * it is part of. The node remembers the group and the position inside
+ * the group, so that removing a value is O(1) and does not require the id.
+ * A lookup returns the internal array of the group directly, without
+ * creating a copy.
+ *
+ * A value can only be part of one group per NMGroupIndexNode.
+ * The order of the values inside a group is undefined. */
+
+typedef struct _NMGroupIndex NMGroupIndex;
+typedef struct _NMGroupIndexGroup NMGroupIndexGroup;
+
+typedef struct {
+	NMGroupIndexGroup *_group;
+	guint _pos;
+} NMGroupIndexNode;
+
+typedef struct {
+	GHashTableIter _iter;
+} NMGroupIndexIter;
+
+NMGroupIndex *nm_group_index_new (GHashFunc hash_fcn,
+                                  GEqualFunc equal_fcn,
+                                  gsize id_size);
+
+void nm_group_index_free (NMGroupIndex *index);
+
+gboolean nm_group_index_add (NMGroupIndex *index,
+                             gconstpointer id,
+                             gpointer value,
+                             NMGroupIndexNode *node);
+
+gboolean nm_group_index_remove (NMGroupIndex *index,
+                                gpointer value,
+                                NMGroupIndexNode *node);
+
+static inline gboolean
+nm_group_index_node_is_linked (const NMGroupIndexNode *node)
+{
+	return !!node->_group;
+}
+
+gconstpointer nm_group_index_node_get_id (const NMGroupIndexNode *node);
+
+guint nm_group_index_get_num_groups (const NMGroupIndex *index);
+
+void *const*nm_group_index_lookup (const NMGroupIndex *index,
+                                   gconstpointer id,
+                                   guint *out_len);
+
+void nm_group_index_iter_init (NMGroupIndexIter *iter,
+                               const NMGroupIndex *index);
+gboolean nm_group_index_iter_next (NMGroupIndexIter *iter,
+                                   gconstpointer *out_id,
+                                   void *const**out_values,
+                                   guint *out_len);
+
+G_END_DECLS
+
+#endif /* __NM_GROUP_INDEX__ */
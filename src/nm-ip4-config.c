@@ -32,6 +32,8 @@
 #include "NetworkManagerUtils.h"
 #include "nm-core-internal.h"
 #include "nm-route-manager.h"
+#include "nm-route-trie.h"
+#include "nm-config.h"
 #include "nm-core-internal.h"
 #include "nm-macros-internal.h"
 
@@ -47,6 +49,45 @@ typedef struct _NMIP4ConfigPrivate {
 	gboolean has_gateway;
 	GArray *addresses;
 	GArray *routes;
+
+	/* longest-prefix-match indexes for @routes and the peer networks of
+	 * @addresses. They point into the arrays, so they are created lazily
+	 * and dropped whenever the arrays change. */
+	NMRouteTrie *routes_trie;
+	NMRouteTrie *addresses_trie;
+
+	/* hash indexes to find duplicate addresses and routes. They are sets of
+	 * pointers into the arrays and are only valid as long as the array data
+	 * does not move (see _idx_get()). */
+	GHashTable *addresses_idx;
+	gconstpointer addresses_idx_data;
+	GHashTable *routes_idx;
+	gconstpointer routes_idx_data;
+
+	/* @addresses and @routes can be shared with other configs. In that
+	 * case these point to the number of configs that share the array,
+	 * and the array must be copied before modifying it. */
+	guint *addresses_shared;
+	guint *routes_shared;
+
+	/* the exported values of the address and route properties. They are
+	 * built on demand and dropped whenever the addresses or routes change. */
+	GVariant *address_data_variant;
+	GVariant *addresses_variant;
+	GVariant *route_data_variant;
+	GVariant *routes_variant;
+
+	/* the entries of the last exported RouteData, by route. See
+	 * _route_data_build(). */
+	GHashTable *route_data_cache;
+	GHashTable *routes_added;
+	GHashTable *routes_removed;
+	guint routes_delta_id;
+
+	/* see _notify_coalesced(). */
+	guint notify_pending;
+	guint notify_idle_id;
+
 	GArray *nameservers;
 	GPtrArray *domains;
 	GPtrArray *searches;
@@ -80,6 +121,56 @@ NM_GOBJECT_PROPERTIES_DEFINE (NMIP4Config,
 	PROP_WINS_SERVERS,
 );
 
+enum {
+	ROUTES_ADDED,
+	ROUTES_REMOVED,
+
+	LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+/******************************************************************/
+
+static gboolean
+_notify_pending_cb (gpointer user_data)
+{
+	NMIP4Config *self = user_data;
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+	guint pending = priv->notify_pending;
+	_PropertyEnums prop;
+
+	priv->notify_idle_id = 0;
+	priv->notify_pending = 0;
+
+	g_object_freeze_notify (G_OBJECT (self));
+	for (prop = _PROPERTY_ENUMS_0 + 1; prop < _PROPERTY_ENUMS_LAST; prop++) {
+		if (NM_FLAGS_HAS (pending, 1u << prop))
+			_notify (self, prop);
+	}
+	g_object_thaw_notify (G_OBJECT (self));
+	return G_SOURCE_REMOVE;
+}
+
+/* The D-Bus skeleton of an exported config reads a property on every
+ * notification (see nm_exported_object_skeleton_create()). For the
+ * address and route properties, that means building the whole array.
+ * Notify them only once per main loop iteration. */
+static void
+_notify_coalesced (NMIP4Config *self, _PropertyEnums prop)
+{
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+
+	if (!nm_exported_object_is_exported ((NMExportedObject *) self)) {
+		_notify (self, prop);
+		return;
+	}
+
+	priv->notify_pending |= 1u << prop;
+	if (!priv->notify_idle_id)
+		priv->notify_idle_id = g_idle_add (_notify_pending_cb, self);
+}
+
 NMIP4Config *
 nm_ip4_config_new (int ifindex)
 {
@@ -185,6 +276,257 @@ routes_are_duplicate (const NMPlatformIP4Route *a, const NMPlatformIP4Route *b,
 	       (!consider_gateway_and_metric || (a->gateway == b->gateway && a->metric == b->metric));
 }
 
+/******************************************************************/
+
+/* Up to this number of entries, addresses and routes are searched
+ * linearly instead of through the hash index. */
+#define IDX_MIN_LEN 32
+
+static guint
+_addresses_idx_hash (gconstpointer ptr)
+{
+	const NMPlatformIP4Address *a = ptr;
+	guint h = a->address;
+
+	h = (h * 33) + a->plen;
+	h = (h * 33) + (a->peer_address & nm_utils_ip4_prefix_to_netmask (a->plen));
+	return h;
+}
+
+static gboolean
+_addresses_idx_equal (gconstpointer a, gconstpointer b)
+{
+	return addresses_are_duplicate (a, b);
+}
+
+static guint
+_routes_idx_hash (gconstpointer ptr)
+{
+	const NMPlatformIP4Route *r = ptr;
+
+	return (((guint) r->network) * 33) + r->plen;
+}
+
+static gboolean
+_routes_idx_equal (gconstpointer a, gconstpointer b)
+{
+	return routes_are_duplicate (a, b, FALSE);
+}
+
+static GHashTable *
+_idx_get (GHashTable **p_idx, gconstpointer *p_idx_data, GArray *array, GHashFunc hash_func, GEqualFunc equal_func)
+{
+	guint elt_size = g_array_get_element_size (array);
+	guint i;
+
+	/* the index contains pointers to the array elements. If the array
+	 * was reallocated, rebuild it. */
+	if (*p_idx && *p_idx_data != array->data)
+		g_clear_pointer (p_idx, g_hash_table_unref);
+
+	if (!*p_idx) {
+		*p_idx = g_hash_table_new (hash_func, equal_func);
+		for (i = 0; i < array->len; i++) {
+			gpointer item = &array->data[i * elt_size];
+
+			/* like a linear search, find the first of several duplicates. */
+			if (!g_hash_table_contains (*p_idx, item))
+				g_hash_table_add (*p_idx, item);
+		}
+		*p_idx_data = array->data;
+	}
+	return *p_idx;
+}
+
+static void
+_idx_append (GHashTable **p_idx, gconstpointer *p_idx_data, GArray *array)
+{
+	if (!*p_idx)
+		return;
+	if (*p_idx_data != array->data) {
+		g_clear_pointer (p_idx, g_hash_table_unref);
+		return;
+	}
+	g_hash_table_add (*p_idx, &array->data[(array->len - 1) * g_array_get_element_size (array)]);
+}
+
+/* Must be called when the addresses change. If @ids_changed is %FALSE,
+ * the addresses were only modified in place without changing what
+ * addresses_are_duplicate() compares. */
+static void
+_addresses_variants_clear (NMIP4ConfigPrivate *priv)
+{
+	g_clear_pointer (&priv->address_data_variant, g_variant_unref);
+	g_clear_pointer (&priv->addresses_variant, g_variant_unref);
+}
+
+static void
+_routes_variants_clear (NMIP4ConfigPrivate *priv)
+{
+	g_clear_pointer (&priv->route_data_variant, g_variant_unref);
+	g_clear_pointer (&priv->routes_variant, g_variant_unref);
+}
+
+static void
+_addresses_changed (NMIP4ConfigPrivate *priv, gboolean ids_changed)
+{
+	g_clear_pointer (&priv->addresses_trie, nm_route_trie_free);
+	_addresses_variants_clear (priv);
+	if (ids_changed)
+		g_clear_pointer (&priv->addresses_idx, g_hash_table_unref);
+}
+
+static void
+_addresses_appended (NMIP4ConfigPrivate *priv)
+{
+	g_clear_pointer (&priv->addresses_trie, nm_route_trie_free);
+	_addresses_variants_clear (priv);
+	_idx_append (&priv->addresses_idx, &priv->addresses_idx_data, priv->addresses);
+}
+
+static void
+_routes_changed (NMIP4ConfigPrivate *priv, gboolean ids_changed)
+{
+	g_clear_pointer (&priv->routes_trie, nm_route_trie_free);
+	_routes_variants_clear (priv);
+	if (ids_changed)
+		g_clear_pointer (&priv->routes_idx, g_hash_table_unref);
+}
+
+static void
+_routes_appended (NMIP4ConfigPrivate *priv)
+{
+	g_clear_pointer (&priv->routes_trie, nm_route_trie_free);
+	_routes_variants_clear (priv);
+	_idx_append (&priv->routes_idx, &priv->routes_idx_data, priv->routes);
+}
+
+/******************************************************************/
+
+static void
+_array_release (GArray **p_array, guint **p_shared)
+{
+	if (*p_shared) {
+		if (--(**p_shared) == 0)
+			g_free (*p_shared);
+		*p_shared = NULL;
+	}
+	g_clear_pointer (p_array, g_array_unref);
+}
+
+static void
+_array_share (GArray **p_dst, guint **p_dst_shared, GArray *src, guint **p_src_shared)
+{
+	if (!*p_src_shared) {
+		*p_src_shared = g_new (guint, 1);
+		**p_src_shared = 1;
+	}
+	_array_release (p_dst, p_dst_shared);
+	*p_dst = g_array_ref (src);
+	*p_dst_shared = *p_src_shared;
+	(**p_dst_shared)++;
+}
+
+/* Makes sure the array is not shared with other configs. If @copy is %FALSE,
+ * a shared array is replaced by an empty one. Returns %TRUE if the array
+ * was replaced. */
+static gboolean
+_array_unshare (GArray **p_array, guint **p_shared, gboolean copy)
+{
+	GArray *array = *p_array;
+
+	if (!*p_shared)
+		return FALSE;
+	if (**p_shared == 1) {
+		/* the other configs are gone. */
+		g_clear_pointer (p_shared, g_free);
+		return FALSE;
+	}
+	(**p_shared)--;
+	*p_shared = NULL;
+
+	*p_array = g_array_sized_new (FALSE, FALSE, g_array_get_element_size (array), copy ? array->len : 0);
+	if (copy)
+		g_array_append_vals (*p_array, array->data, array->len);
+	g_array_unref (array);
+	return TRUE;
+}
+
+static void
+_addresses_unshare (NMIP4ConfigPrivate *priv, gboolean copy)
+{
+	if (_array_unshare (&priv->addresses, &priv->addresses_shared, copy))
+		_addresses_changed (priv, TRUE);
+}
+
+static void
+_routes_unshare (NMIP4ConfigPrivate *priv, gboolean copy)
+{
+	if (_array_unshare (&priv->routes, &priv->routes_shared, copy))
+		_routes_changed (priv, TRUE);
+}
+
+/* Sharing the array of @src is only the same as adding its
+ * entries one by one, if they contain no duplicates. That is the case for
+ * configs built with nm_ip4_config_add_*(), but not necessarily for
+ * captured ones. */
+static gboolean
+_addresses_are_unique (NMIP4ConfigPrivate *priv)
+{
+	return g_hash_table_size (_idx_get (&priv->addresses_idx, &priv->addresses_idx_data, priv->addresses,
+	                                    _addresses_idx_hash, _addresses_idx_equal)) == priv->addresses->len;
+}
+
+static gboolean
+_routes_are_unique (NMIP4ConfigPrivate *priv)
+{
+	return g_hash_table_size (_idx_get (&priv->routes_idx, &priv->routes_idx_data, priv->routes,
+	                                    _routes_idx_hash, _routes_idx_equal)) == priv->routes->len;
+}
+
+/* Lets @dst share the addresses of @src, if @dst has no addresses yet.
+ * Returns %FALSE if the addresses must be added one by one instead. */
+static gboolean
+_addresses_share (NMIP4Config *dst, const NMIP4Config *src)
+{
+	NMIP4ConfigPrivate *dst_priv = NM_IP4_CONFIG_GET_PRIVATE (dst);
+	NMIP4ConfigPrivate *src_priv = NM_IP4_CONFIG_GET_PRIVATE (src);
+
+	if (   dst_priv->addresses->len != 0
+	    || src_priv->addresses->len == 0
+	    || !_addresses_are_unique (src_priv))
+		return FALSE;
+
+	_addresses_changed (dst_priv, TRUE);
+	_array_share (&dst_priv->addresses, &dst_priv->addresses_shared, src_priv->addresses, &src_priv->addresses_shared);
+	_notify_coalesced (dst, PROP_ADDRESS_DATA);
+	_notify_coalesced (dst, PROP_ADDRESSES);
+	return TRUE;
+}
+
+/* Like _addresses_share(). The routes of @src carry its ifindex, so they
+ * can only be shared between configs of the same interface. */
+static gboolean
+_routes_share (NMIP4Config *dst, const NMIP4Config *src)
+{
+	NMIP4ConfigPrivate *dst_priv = NM_IP4_CONFIG_GET_PRIVATE (dst);
+	NMIP4ConfigPrivate *src_priv = NM_IP4_CONFIG_GET_PRIVATE (src);
+
+	if (   dst_priv->routes->len != 0
+	    || src_priv->routes->len == 0
+	    || dst_priv->ifindex != src_priv->ifindex
+	    || !_routes_are_unique (src_priv))
+		return FALSE;
+
+	_routes_changed (dst_priv, TRUE);
+	_array_share (&dst_priv->routes, &dst_priv->routes_shared, src_priv->routes, &src_priv->routes_shared);
+	_notify_coalesced (dst, PROP_ROUTE_DATA);
+	_notify_coalesced (dst, PROP_ROUTES);
+	return TRUE;
+}
+
+/******************************************************************/
+
 NMIP4Config *
 nm_ip4_config_capture (int ifindex, gboolean capture_resolv_conf)
 {
@@ -256,10 +598,10 @@ nm_ip4_config_capture (int ifindex, gboolean capture_resolv_conf)
 	}
 
 	/* actually, nobody should be connected to the signal, just to be sure, notify */
-	_notify (config, PROP_ADDRESS_DATA);
-	_notify (config, PROP_ROUTE_DATA);
-	_notify (config, PROP_ADDRESSES);
-	_notify (config, PROP_ROUTES);
+	_notify_coalesced (config, PROP_ADDRESS_DATA);
+	_notify_coalesced (config, PROP_ROUTE_DATA);
+	_notify_coalesced (config, PROP_ADDRESSES);
+	_notify_coalesced (config, PROP_ROUTES);
 	if (   priv->gateway != old_gateway
 	    || priv->has_gateway != old_has_gateway)
 		_notify (config, PROP_GATEWAY);
@@ -584,8 +926,10 @@ nm_ip4_config_merge (NMIP4Config *dst, const NMIP4Config *src, NMIPConfigMergeFl
 	g_object_freeze_notify (G_OBJECT (dst));
 
 	/* addresses */
-	for (i = 0; i < nm_ip4_config_get_num_addresses (src); i++)
-		nm_ip4_config_add_address (dst, nm_ip4_config_get_address (src, i));
+	if (!_addresses_share (dst, src)) {
+		for (i = 0; i < nm_ip4_config_get_num_addresses (src); i++)
+			nm_ip4_config_add_address (dst, nm_ip4_config_get_address (src, i));
+	}
 
 	/* nameservers */
 	if (!NM_FLAGS_HAS (merge_flags, NM_IP_CONFIG_MERGE_NO_DNS)) {
@@ -598,7 +942,8 @@ nm_ip4_config_merge (NMIP4Config *dst, const NMIP4Config *src, NMIPConfigMergeFl
 		nm_ip4_config_set_gateway (dst, nm_ip4_config_get_gateway (src));
 
 	/* routes */
-	if (!NM_FLAGS_HAS (merge_flags, NM_IP_CONFIG_MERGE_NO_ROUTES)) {
+	if (   !NM_FLAGS_HAS (merge_flags, NM_IP_CONFIG_MERGE_NO_ROUTES)
+	    && !_routes_share (dst, src)) {
 		for (i = 0; i < nm_ip4_config_get_num_routes (src); i++)
 			nm_ip4_config_add_route (dst, nm_ip4_config_get_route (src, i));
 	}
@@ -663,8 +1008,16 @@ static int
 _addresses_get_index (const NMIP4Config *self, const NMPlatformIP4Address *addr)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+	const NMPlatformIP4Address *found;
 	guint i;
 
+	if (priv->addresses->len > IDX_MIN_LEN) {
+		found = g_hash_table_lookup (_idx_get (&priv->addresses_idx, &priv->addresses_idx_data, priv->addresses,
+		                                       _addresses_idx_hash, _addresses_idx_equal),
+		                             addr);
+		return found ? (int) (found - (const NMPlatformIP4Address *) priv->addresses->data) : -1;
+	}
+
 	for (i = 0; i < priv->addresses->len; i++) {
 		const NMPlatformIP4Address *a = &g_array_index (priv->addresses, NMPlatformIP4Address, i);
 
@@ -693,8 +1046,16 @@ static int
 _routes_get_index (const NMIP4Config *self, const NMPlatformIP4Route *route)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+	const NMPlatformIP4Route *found;
 	guint i;
 
+	if (priv->routes->len > IDX_MIN_LEN) {
+		found = g_hash_table_lookup (_idx_get (&priv->routes_idx, &priv->routes_idx_data, priv->routes,
+		                                       _routes_idx_hash, _routes_idx_equal),
+		                             route);
+		return found ? (int) (found - (const NMPlatformIP4Route *) priv->routes->data) : -1;
+	}
+
 	for (i = 0; i < priv->routes->len; i++) {
 		const NMPlatformIP4Route *r = &g_array_index (priv->routes, NMPlatformIP4Route, i);
 
@@ -780,6 +1141,73 @@ _wins_get_index (const NMIP4Config *self, guint32 wins_server)
 	return -1;
 }
 
+/* Removes all addresses from @dst that are contained in @src, or with
+ * @subtract %FALSE, all addresses that are not contained in @src.
+ * This is O(n) with the hash index of @src. */
+static void
+_addresses_filter (NMIP4Config *dst, const NMIP4Config *src, gboolean subtract)
+{
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (dst);
+	guint i, j;
+
+	if (dst == src) {
+		if (subtract)
+			nm_ip4_config_reset_addresses (dst);
+		return;
+	}
+
+	for (i = 0, j = 0; i < priv->addresses->len; i++) {
+		const NMPlatformIP4Address *a = &g_array_index (priv->addresses, NMPlatformIP4Address, i);
+
+		if ((_addresses_get_index (src, a) >= 0) == subtract) {
+			_addresses_unshare (priv, TRUE);
+			continue;
+		}
+		if (i != j)
+			g_array_index (priv->addresses, NMPlatformIP4Address, j) = g_array_index (priv->addresses, NMPlatformIP4Address, i);
+		j++;
+	}
+
+	if (j != priv->addresses->len) {
+		_addresses_changed (priv, TRUE);
+		g_array_set_size (priv->addresses, j);
+		_notify_coalesced (dst, PROP_ADDRESS_DATA);
+		_notify_coalesced (dst, PROP_ADDRESSES);
+	}
+}
+
+static void
+_routes_filter (NMIP4Config *dst, const NMIP4Config *src, gboolean subtract)
+{
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (dst);
+	guint i, j;
+
+	if (dst == src) {
+		if (subtract)
+			nm_ip4_config_reset_routes (dst);
+		return;
+	}
+
+	for (i = 0, j = 0; i < priv->routes->len; i++) {
+		const NMPlatformIP4Route *r = &g_array_index (priv->routes, NMPlatformIP4Route, i);
+
+		if ((_routes_get_index (src, r) >= 0) == subtract) {
+			_routes_unshare (priv, TRUE);
+			continue;
+		}
+		if (i != j)
+			g_array_index (priv->routes, NMPlatformIP4Route, j) = g_array_index (priv->routes, NMPlatformIP4Route, i);
+		j++;
+	}
+
+	if (j != priv->routes->len) {
+		_routes_changed (priv, TRUE);
+		g_array_set_size (priv->routes, j);
+		_notify_coalesced (dst, PROP_ROUTE_DATA);
+		_notify_coalesced (dst, PROP_ROUTES);
+	}
+}
+
 /*******************************************************************************/
 
 /**
@@ -801,11 +1229,7 @@ nm_ip4_config_subtract (NMIP4Config *dst, const NMIP4Config *src)
 	g_object_freeze_notify (G_OBJECT (dst));
 
 	/* addresses */
-	for (i = 0; i < nm_ip4_config_get_num_addresses (src); i++) {
-		idx = _addresses_get_index (dst, nm_ip4_config_get_address (src, i));
-		if (idx >= 0)
-			nm_ip4_config_del_address (dst, idx);
-	}
+	_addresses_filter (dst, src, TRUE);
 
 	/* nameservers */
 	for (i = 0; i < nm_ip4_config_get_num_nameservers (src); i++) {
@@ -825,11 +1249,7 @@ nm_ip4_config_subtract (NMIP4Config *dst, const NMIP4Config *src)
 	/* ignore route_metric */
 
 	/* routes */
-	for (i = 0; i < nm_ip4_config_get_num_routes (src); i++) {
-		idx = _routes_get_index (dst, nm_ip4_config_get_route (src, i));
-		if (idx >= 0)
-			nm_ip4_config_del_route (dst, idx);
-	}
+	_routes_filter (dst, src, TRUE);
 
 	/* domains */
 	for (i = 0; i < nm_ip4_config_get_num_domains (src); i++) {
@@ -883,22 +1303,13 @@ nm_ip4_config_subtract (NMIP4Config *dst, const NMIP4Config *src)
 void
 nm_ip4_config_intersect (NMIP4Config *dst, const NMIP4Config *src)
 {
-	guint32 i;
-	gint idx;
-
 	g_return_if_fail (src != NULL);
 	g_return_if_fail (dst != NULL);
 
 	g_object_freeze_notify (G_OBJECT (dst));
 
 	/* addresses */
-	for (i = 0; i < nm_ip4_config_get_num_addresses (dst); ) {
-		idx = _addresses_get_index (src, nm_ip4_config_get_address (dst, i));
-		if (idx < 0)
-			nm_ip4_config_del_address (dst, i);
-		else
-			i++;
-	}
+	_addresses_filter (dst, src, FALSE);
 
 	/* ignore route_metric */
 	/* ignore nameservers */
@@ -911,13 +1322,7 @@ nm_ip4_config_intersect (NMIP4Config *dst, const NMIP4Config *src)
 	}
 
 	/* routes */
-	for (i = 0; i < nm_ip4_config_get_num_routes (dst); ) {
-		idx = _routes_get_index (src, nm_ip4_config_get_route (dst, i));
-		if (idx < 0)
-			nm_ip4_config_del_route (dst, i);
-		else
-			i++;
-	}
+	_routes_filter (dst, src, FALSE);
 
 	/* ignore domains */
 	/* ignore dns searches */
@@ -1014,8 +1419,10 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 		has_relevant_changes = TRUE;
 	if (!are_equal) {
 		nm_ip4_config_reset_addresses (dst);
-		for (i = 0; i < num; i++)
-			nm_ip4_config_add_address (dst, nm_ip4_config_get_address (src, i));
+		if (!_addresses_share (dst, src)) {
+			for (i = 0; i < num; i++)
+				nm_ip4_config_add_address (dst, nm_ip4_config_get_address (src, i));
+		}
 		has_minor_changes = TRUE;
 	}
 
@@ -1037,8 +1444,10 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 		has_relevant_changes = TRUE;
 	if (!are_equal) {
 		nm_ip4_config_reset_routes (dst);
-		for (i = 0; i < num; i++)
-			nm_ip4_config_add_route (dst, nm_ip4_config_get_route (src, i));
+		if (!_routes_share (dst, src)) {
+			for (i = 0; i < num; i++)
+				nm_ip4_config_add_route (dst, nm_ip4_config_get_route (src, i));
+		}
 		has_minor_changes = TRUE;
 	}
 
@@ -1262,30 +1671,48 @@ nm_ip4_config_dump (const NMIP4Config *config, const char *detail)
 	g_message (" mtrd:   %d", (int) nm_ip4_config_get_metered (config));
 }
 
-gboolean
-nm_ip4_config_destination_is_direct (const NMIP4Config *config, guint32 network, int plen)
+static NMRouteTrie *
+_addresses_get_trie (const NMIP4Config *config)
 {
-	guint naddresses = nm_ip4_config_get_num_addresses (config);
-	int i;
-	in_addr_t peer_network;
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (config);
+	guint i;
 
-	for (i = 0; i < naddresses; i++) {
-		const NMPlatformIP4Address *item = nm_ip4_config_get_address (config, i);
+	if (!priv->addresses_trie) {
+		priv->addresses_trie = nm_route_trie_new (AF_INET);
+		for (i = 0; i < priv->addresses->len; i++) {
+			const NMPlatformIP4Address *item = &g_array_index (priv->addresses, NMPlatformIP4Address, i);
+			in_addr_t peer_network;
 
-		if (item->plen > plen)
-			continue;
+			peer_network = nm_utils_ip4_address_clear_host_address (item->peer_address, item->plen);
+			if (_ipv4_is_zeronet (peer_network))
+				continue;
+			nm_route_trie_insert (priv->addresses_trie, &peer_network, item->plen, (gpointer) item);
+		}
+	}
+	return priv->addresses_trie;
+}
 
-		peer_network = nm_utils_ip4_address_clear_host_address (item->peer_address, item->plen);
-		if (_ipv4_is_zeronet (peer_network))
-			continue;
+static gboolean
+_destination_is_direct_cb (gpointer value, guint8 plen, gpointer user_data)
+{
+	*((gboolean *) user_data) = TRUE;
+	return FALSE;
+}
 
-		if (peer_network != nm_utils_ip4_address_clear_host_address (network, item->plen))
-			continue;
+gboolean
+nm_ip4_config_destination_is_direct (const NMIP4Config *config, guint32 network, int plen)
+{
+	gboolean found = FALSE;
 
-		return TRUE;
-	}
+	if (plen < 0)
+		return FALSE;
 
-	return FALSE;
+	nm_route_trie_foreach_covering (_addresses_get_trie (config),
+	                                &network,
+	                                MIN (plen, 32),
+	                                _destination_is_direct_cb,
+	                                &found);
+	return found;
 }
 
 /******************************************************************/
@@ -1314,7 +1741,10 @@ nm_ip4_config_set_gateway (NMIP4Config *config, guint32 gateway)
 	if (priv->gateway != gateway || !priv->has_gateway) {
 		priv->gateway = gateway;
 		priv->has_gateway = TRUE;
+		/* "Addresses" contains the gateway. */
+		g_clear_pointer (&priv->addresses_variant, g_variant_unref);
 		_notify (config, PROP_GATEWAY);
+		_notify_coalesced (config, PROP_ADDRESSES);
 	}
 }
 
@@ -1326,7 +1756,9 @@ nm_ip4_config_unset_gateway (NMIP4Config *config)
 	if (priv->has_gateway) {
 		priv->gateway = 0;
 		priv->has_gateway = FALSE;
+		g_clear_pointer (&priv->addresses_variant, g_variant_unref);
 		_notify (config, PROP_GATEWAY);
+		_notify_coalesced (config, PROP_ADDRESSES);
 	}
 }
 
@@ -1372,9 +1804,11 @@ nm_ip4_config_reset_addresses (NMIP4Config *config)
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (config);
 
 	if (priv->addresses->len != 0) {
+		_addresses_changed (priv, TRUE);
+		_addresses_unshare (priv, FALSE);
 		g_array_set_size (priv->addresses, 0);
-		_notify (config, PROP_ADDRESS_DATA);
-		_notify (config, PROP_ADDRESSES);
+		_notify_coalesced (config, PROP_ADDRESS_DATA);
+		_notify_coalesced (config, PROP_ADDRESSES);
 	}
 }
 
@@ -1397,42 +1831,47 @@ nm_ip4_config_add_address (NMIP4Config *config, const NMPlatformIP4Address *new)
 
 	g_return_if_fail (new != NULL);
 
-	for (i = 0; i < priv->addresses->len; i++ ) {
+	i = _addresses_get_index (config, new);
+	if (i >= 0) {
 		NMPlatformIP4Address *item = &g_array_index (priv->addresses, NMPlatformIP4Address, i);
 
-		if (addresses_are_duplicate (item, new)) {
-			if (nm_platform_ip4_address_cmp (item, new) == 0)
-				return;
-
-			/* remember the old values. */
-			item_old = *item;
-			/* Copy over old item to get new lifetime, timestamp, preferred */
-			*item = *new;
-
-			/* But restore highest priority source */
-			item->source = MAX (item_old.source, new->source);
-
-			/* for addresses that we read from the kernel, we keep the timestamps as defined
-			 * by the previous source (item_old). The reason is, that the other source configured the lifetimes
-			 * with "what should be" and the kernel values are "what turned out after configuring it".
-			 *
-			 * For other sources, the longer lifetime wins. */
-			if (   (new->source == NM_IP_CONFIG_SOURCE_KERNEL && new->source != item_old.source)
-			    || nm_platform_ip_address_cmp_expiry ((const NMPlatformIPAddress *) &item_old, (const NMPlatformIPAddress *) new) > 0) {
-				item->timestamp = item_old.timestamp;
-				item->lifetime = item_old.lifetime;
-				item->preferred = item_old.preferred;
-			}
-			if (nm_platform_ip4_address_cmp (&item_old, item) == 0)
-				return;
-			goto NOTIFY;
+		if (nm_platform_ip4_address_cmp (item, new) == 0)
+			return;
+
+		_addresses_unshare (priv, TRUE);
+		item = &g_array_index (priv->addresses, NMPlatformIP4Address, i);
+
+		/* remember the old values. */
+		item_old = *item;
+		/* Copy over old item to get new lifetime, timestamp, preferred */
+		*item = *new;
+
+		/* But restore highest priority source */
+		item->source = MAX (item_old.source, new->source);
+
+		/* for addresses that we read from the kernel, we keep the timestamps as defined
+		 * by the previous source (item_old). The reason is, that the other source configured the lifetimes
+		 * with "what should be" and the kernel values are "what turned out after configuring it".
+		 *
+		 * For other sources, the longer lifetime wins. */
+		if (   (new->source == NM_IP_CONFIG_SOURCE_KERNEL && new->source != item_old.source)
+		    || nm_platform_ip_address_cmp_expiry ((const NMPlatformIPAddress *) &item_old, (const NMPlatformIPAddress *) new) > 0) {
+			item->timestamp = item_old.timestamp;
+			item->lifetime = item_old.lifetime;
+			item->preferred = item_old.preferred;
 		}
+		if (nm_platform_ip4_address_cmp (&item_old, item) == 0)
+			return;
+		_addresses_changed (priv, FALSE);
+		goto NOTIFY;
 	}
 
+	_addresses_unshare (priv, TRUE);
 	g_array_append_val (priv->addresses, *new);
+	_addresses_appended (priv);
 NOTIFY:
-	_notify (config, PROP_ADDRESS_DATA);
-	_notify (config, PROP_ADDRESSES);
+	_notify_coalesced (config, PROP_ADDRESS_DATA);
+	_notify_coalesced (config, PROP_ADDRESSES);
 }
 
 void
@@ -1442,9 +1881,11 @@ nm_ip4_config_del_address (NMIP4Config *config, guint i)
 
 	g_return_if_fail (i < priv->addresses->len);
 
+	_addresses_changed (priv, TRUE);
+	_addresses_unshare (priv, TRUE);
 	g_array_remove_index (priv->addresses, i);
-	_notify (config, PROP_ADDRESS_DATA);
-	_notify (config, PROP_ADDRESSES);
+	_notify_coalesced (config, PROP_ADDRESS_DATA);
+	_notify_coalesced (config, PROP_ADDRESSES);
 }
 
 guint
@@ -1478,9 +1919,11 @@ nm_ip4_config_reset_routes (NMIP4Config *config)
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (config);
 
 	if (priv->routes->len != 0) {
+		_routes_changed (priv, TRUE);
+		_routes_unshare (priv, FALSE);
 		g_array_set_size (priv->routes, 0);
-		_notify (config, PROP_ROUTE_DATA);
-		_notify (config, PROP_ROUTES);
+		_notify_coalesced (config, PROP_ROUTE_DATA);
+		_notify_coalesced (config, PROP_ROUTES);
 	}
 }
 
@@ -1505,26 +1948,31 @@ nm_ip4_config_add_route (NMIP4Config *config, const NMPlatformIP4Route *new)
 	g_return_if_fail (new->plen > 0);
 	g_assert (priv->ifindex);
 
-	for (i = 0; i < priv->routes->len; i++ ) {
+	i = _routes_get_index (config, new);
+	if (i >= 0) {
 		NMPlatformIP4Route *item = &g_array_index (priv->routes, NMPlatformIP4Route, i);
 
-		if (routes_are_duplicate (item, new, FALSE)) {
-			if (nm_platform_ip4_route_cmp (item, new) == 0)
-				return;
-			old_source = item->source;
-			memcpy (item, new, sizeof (*item));
-			/* Restore highest priority source */
-			item->source = MAX (old_source, new->source);
-			item->ifindex = priv->ifindex;
-			goto NOTIFY;
-		}
+		if (nm_platform_ip4_route_cmp (item, new) == 0)
+			return;
+
+		_routes_unshare (priv, TRUE);
+		item = &g_array_index (priv->routes, NMPlatformIP4Route, i);
+		old_source = item->source;
+		_routes_changed (priv, FALSE);
+		memcpy (item, new, sizeof (*item));
+		/* Restore highest priority source */
+		item->source = MAX (old_source, new->source);
+		item->ifindex = priv->ifindex;
+		goto NOTIFY;
 	}
 
+	_routes_unshare (priv, TRUE);
 	g_array_append_val (priv->routes, *new);
 	g_array_index (priv->routes, NMPlatformIP4Route, priv->routes->len - 1).ifindex = priv->ifindex;
+	_routes_appended (priv);
 NOTIFY:
-	_notify (config, PROP_ROUTE_DATA);
-	_notify (config, PROP_ROUTES);
+	_notify_coalesced (config, PROP_ROUTE_DATA);
+	_notify_coalesced (config, PROP_ROUTES);
 }
 
 void
@@ -1534,9 +1982,11 @@ nm_ip4_config_del_route (NMIP4Config *config, guint i)
 
 	g_return_if_fail (i < priv->routes->len);
 
+	_routes_changed (priv, TRUE);
+	_routes_unshare (priv, TRUE);
 	g_array_remove_index (priv->routes, i);
-	_notify (config, PROP_ROUTE_DATA);
-	_notify (config, PROP_ROUTES);
+	_notify_coalesced (config, PROP_ROUTE_DATA);
+	_notify_coalesced (config, PROP_ROUTES);
 }
 
 guint
@@ -1555,33 +2005,53 @@ nm_ip4_config_get_route (const NMIP4Config *config, guint i)
 	return &g_array_index (priv->routes, NMPlatformIP4Route, i);
 }
 
+static gboolean
+_direct_route_for_host_cb (gpointer value, guint8 plen, gpointer user_data)
+{
+	const NMPlatformIP4Route *item = value;
+	const NMPlatformIP4Route **p_best_route = user_data;
+
+	/* the prefixes are visited longest first. Once we have a route,
+	 * shorter prefixes cannot be better. */
+	if (*p_best_route && (*p_best_route)->plen > plen)
+		return FALSE;
+
+	if (item->gateway != 0)
+		return TRUE;
+
+	if (!*p_best_route || (*p_best_route)->metric > item->metric)
+		*p_best_route = item;
+	return TRUE;
+}
+
+/**
+ * nm_ip4_config_get_direct_route_for_host:
+ * @config: the #NMIP4Config
+ * @host: the host address
+ *
+ * Returns: the route without gateway with the longest prefix that
+ *   contains @host. Among routes with the same prefix length, the one
+ *   with the lowest metric wins.
+ */
 const NMPlatformIP4Route *
 nm_ip4_config_get_direct_route_for_host (const NMIP4Config *config, guint32 host)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (config);
+	const NMPlatformIP4Route *best_route = NULL;
 	guint i;
-	NMPlatformIP4Route *best_route = NULL;
 
 	g_return_val_if_fail (host, NULL);
 
-	for (i = 0; i < priv->routes->len; i++) {
-		NMPlatformIP4Route *item = &g_array_index (priv->routes, NMPlatformIP4Route, i);
-
-		if (item->gateway != 0)
-			continue;
-
-		if (best_route && best_route->plen > item->plen)
-			continue;
-
-		if (nm_utils_ip4_address_clear_host_address (host, item->plen) != nm_utils_ip4_address_clear_host_address (item->network, item->plen))
-			continue;
-
-		if (best_route && best_route->metric <= item->metric)
-			continue;
+	if (!priv->routes_trie) {
+		priv->routes_trie = nm_route_trie_new (AF_INET);
+		for (i = 0; i < priv->routes->len; i++) {
+			const NMPlatformIP4Route *item = &g_array_index (priv->routes, NMPlatformIP4Route, i);
 
-		best_route = item;
+			nm_route_trie_insert (priv->routes_trie, &item->network, item->plen, (gpointer) item);
+		}
 	}
 
+	nm_route_trie_foreach_covering (priv->routes_trie, &host, 32, _direct_route_for_host_cb, &best_route);
 	return best_route;
 }
 
@@ -2144,14 +2614,213 @@ nm_ip4_config_init (NMIP4Config *config)
 	priv->route_metric = -1;
 }
 
+static guint
+_route_data_hash (gconstpointer ptr)
+{
+	const NMPlatformIP4Route *r = ptr;
+	guint h = r->network;
+
+	h = (h * 33) + r->plen;
+	h = (h * 33) + r->gateway;
+	h = (h * 33) + r->metric;
+	return h;
+}
+
+/* compares the fields that are exported in RouteData. */
+static gboolean
+_route_data_equal (gconstpointer a, gconstpointer b)
+{
+	const NMPlatformIP4Route *r1 = a, *r2 = b;
+
+	return    r1->network == r2->network
+	       && r1->plen == r2->plen
+	       && r1->gateway == r2->gateway
+	       && r1->metric == r2->metric;
+}
+
+static GHashTable *
+_route_data_table_new (void)
+{
+	return g_hash_table_new_full (_route_data_hash, _route_data_equal, g_free, (GDestroyNotify) g_variant_unref);
+}
+
+static GVariant *
+_route_data_entry_new (const NMPlatformIP4Route *route)
+{
+	GVariantBuilder route_builder;
+
+	g_variant_builder_init (&route_builder, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&route_builder, "{sv}",
+	                       "dest",
+	                       g_variant_new_string (nm_utils_inet4_ntop (route->network, NULL)));
+	g_variant_builder_add (&route_builder, "{sv}",
+	                       "prefix",
+	                       g_variant_new_uint32 (route->plen));
+	if (route->gateway) {
+		g_variant_builder_add (&route_builder, "{sv}",
+		                       "next-hop",
+		                       g_variant_new_string (nm_utils_inet4_ntop (route->gateway, NULL)));
+	}
+	g_variant_builder_add (&route_builder, "{sv}",
+	                       "metric",
+	                       g_variant_new_uint32 (route->metric));
+	return g_variant_ref_sink (g_variant_builder_end (&route_builder));
+}
+
+/* The deltas are emitted to in-process handlers of the GObject signals,
+ * and as D-Bus signals while the config is exported, if enabled with the
+ * "route-deltas" option of NetworkManager.conf. */
+static gboolean
+_routes_delta_wanted (NMIP4Config *self)
+{
+	if (   nm_exported_object_is_exported ((NMExportedObject *) self)
+	    && nm_config_data_get_value_boolean (NM_CONFIG_GET_DATA,
+	                                         NM_CONFIG_KEYFILE_GROUP_MAIN,
+	                                         NM_CONFIG_KEYFILE_KEY_ROUTE_DELTAS,
+	                                         FALSE))
+		return TRUE;
+
+	return    g_signal_has_handler_pending (self, signals[ROUTES_ADDED], 0, FALSE)
+	       || g_signal_has_handler_pending (self, signals[ROUTES_REMOVED], 0, FALSE);
+}
+
+/* Records @route as added or removed. A pending change in the opposite
+ * direction cancels out. */
+static void
+_routes_delta_add (GHashTable *pending, GHashTable *opposite, gconstpointer route, GVariant *entry)
+{
+	if (g_hash_table_remove (opposite, route))
+		return;
+	g_hash_table_insert (pending, g_memdup (route, sizeof (NMPlatformIP4Route)), g_variant_ref (entry));
+}
+
+/* Builds RouteData, reusing the entries of routes that did not change
+ * since the last time. The differences are collected in @routes_added
+ * and @routes_removed and emitted as signals by _routes_delta_cb(). */
+static GVariant *
+_route_data_build (NMIP4Config *self)
+{
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+	GHashTable *cache;
+	gs_free GVariant **entries = NULL;
+	gboolean track_delta;
+	GHashTableIter iter;
+	gpointer key, entry;
+	guint i;
+
+	/* the first RouteData is built when exporting the object. Only later
+	 * changes are announced as deltas. */
+	track_delta =    priv->route_data_cache
+	              && _routes_delta_wanted (self);
+	if (track_delta && !priv->routes_added) {
+		priv->routes_added = _route_data_table_new ();
+		priv->routes_removed = _route_data_table_new ();
+	}
+
+	cache = _route_data_table_new ();
+	entries = g_new (GVariant *, priv->routes->len);
+	for (i = 0; i < priv->routes->len; i++) {
+		const NMPlatformIP4Route *route = &g_array_index (priv->routes, NMPlatformIP4Route, i);
+
+		entry = g_hash_table_lookup (cache, route);
+		if (!entry) {
+			if (   priv->route_data_cache
+			    && g_hash_table_lookup_extended (priv->route_data_cache, route, &key, &entry)) {
+				g_hash_table_steal (priv->route_data_cache, route);
+				g_hash_table_insert (cache, key, entry);
+			} else {
+				entry = _route_data_entry_new (route);
+				g_hash_table_insert (cache, g_memdup (route, sizeof (*route)), entry);
+				if (track_delta)
+					_routes_delta_add (priv->routes_added, priv->routes_removed, route, entry);
+			}
+		}
+		entries[i] = entry;
+	}
+
+	if (priv->route_data_cache) {
+		if (track_delta) {
+			g_hash_table_iter_init (&iter, priv->route_data_cache);
+			while (g_hash_table_iter_next (&iter, &key, &entry))
+				_routes_delta_add (priv->routes_removed, priv->routes_added, key, entry);
+		}
+		g_hash_table_unref (priv->route_data_cache);
+	}
+	priv->route_data_cache = cache;
+
+	return g_variant_new_array (G_VARIANT_TYPE ("a{sv}"), entries, priv->routes->len);
+}
+
+static GVariant *
+_routes_delta_to_variant (GHashTable *pending)
+{
+	GVariantBuilder builder;
+	GHashTableIter iter;
+	GVariant *entry;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+	g_hash_table_iter_init (&iter, pending);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &entry))
+		g_variant_builder_add_value (&builder, entry);
+	g_hash_table_remove_all (pending);
+	return g_variant_builder_end (&builder);
+}
+
+static gboolean
+_routes_delta_cb (gpointer user_data)
+{
+	NMIP4Config *self = user_data;
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+
+	priv->routes_delta_id = 0;
+
+	if (!priv->route_data_variant)
+		priv->route_data_variant = g_variant_ref_sink (_route_data_build (self));
+
+	if (!priv->routes_added)
+		return G_SOURCE_REMOVE;
+
+	/* emit the removals first, so that a client applying both signals
+	 * in order ends up with the current routes. */
+	if (g_hash_table_size (priv->routes_removed))
+		g_signal_emit (self, signals[ROUTES_REMOVED], 0, _routes_delta_to_variant (priv->routes_removed));
+	if (g_hash_table_size (priv->routes_added))
+		g_signal_emit (self, signals[ROUTES_ADDED], 0, _routes_delta_to_variant (priv->routes_added));
+	return G_SOURCE_REMOVE;
+}
+
+static void
+notify (GObject *object, GParamSpec *pspec)
+{
+	NMIP4Config *self = NM_IP4_CONFIG (object);
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+
+	if (   pspec == obj_properties[PROP_ROUTE_DATA]
+	    && !priv->routes_delta_id
+	    && _routes_delta_wanted (self))
+		priv->routes_delta_id = g_idle_add (_routes_delta_cb, self);
+
+	G_OBJECT_CLASS (nm_ip4_config_parent_class)->notify (object, pspec);
+}
+
+/******************************************************************/
+
 static void
 finalize (GObject *object)
 {
 	NMIP4Config *self = NM_IP4_CONFIG (object);
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
-	g_array_unref (priv->addresses);
-	g_array_unref (priv->routes);
+	nm_clear_g_source (&priv->routes_delta_id);
+	nm_clear_g_source (&priv->notify_idle_id);
+	g_clear_pointer (&priv->route_data_cache, g_hash_table_unref);
+	g_clear_pointer (&priv->routes_added, g_hash_table_unref);
+	g_clear_pointer (&priv->routes_removed, g_hash_table_unref);
+
+	_array_release (&priv->addresses, &priv->addresses_shared);
+	_array_release (&priv->routes, &priv->routes_shared);
+	_addresses_changed (priv, TRUE);
+	_routes_changed (priv, TRUE);
 	g_array_unref (priv->nameservers);
 	g_ptr_array_unref (priv->domains);
 	g_ptr_array_unref (priv->searches);
@@ -2175,7 +2844,7 @@ get_property (GObject *object, guint prop_id,
 		g_value_set_int (value, priv->ifindex);
 		break;
 	case PROP_ADDRESS_DATA:
-		{
+		if (!priv->address_data_variant) {
 			GVariantBuilder array_builder, addr_builder;
 			int naddr = nm_ip4_config_get_num_addresses (config);
 			int i;
@@ -2206,11 +2875,12 @@ get_property (GObject *object, guint prop_id,
 				g_variant_builder_add (&array_builder, "a{sv}", &addr_builder);
 			}
 
-			g_value_take_variant (value, g_variant_builder_end (&array_builder));
+			priv->address_data_variant = g_variant_ref_sink (g_variant_builder_end (&array_builder));
 		}
+		g_value_set_variant (value, priv->address_data_variant);
 		break;
 	case PROP_ADDRESSES:
-		{
+		if (!priv->addresses_variant) {
 			GVariantBuilder array_builder;
 			int naddr = nm_ip4_config_get_num_addresses (config);
 			int i;
@@ -2229,43 +2899,17 @@ get_property (GObject *object, guint prop_id,
 				                                                  dbus_addr, 3, sizeof (guint32)));
 			}
 
-			g_value_take_variant (value, g_variant_builder_end (&array_builder));
+			priv->addresses_variant = g_variant_ref_sink (g_variant_builder_end (&array_builder));
 		}
+		g_value_set_variant (value, priv->addresses_variant);
 		break;
 	case PROP_ROUTE_DATA:
-		{
-			GVariantBuilder array_builder, route_builder;
-			guint nroutes = nm_ip4_config_get_num_routes (config);
-			int i;
-
-			g_variant_builder_init (&array_builder, G_VARIANT_TYPE ("aa{sv}"));
-			for (i = 0; i < nroutes; i++) {
-				const NMPlatformIP4Route *route = nm_ip4_config_get_route (config, i);
-
-				g_variant_builder_init (&route_builder, G_VARIANT_TYPE ("a{sv}"));
-				g_variant_builder_add (&route_builder, "{sv}",
-				                       "dest",
-				                       g_variant_new_string (nm_utils_inet4_ntop (route->network, NULL)));
-				g_variant_builder_add (&route_builder, "{sv}",
-				                       "prefix",
-				                       g_variant_new_uint32 (route->plen));
-				if (route->gateway) {
-					g_variant_builder_add (&route_builder, "{sv}",
-					                       "next-hop",
-					                       g_variant_new_string (nm_utils_inet4_ntop (route->gateway, NULL)));
-				}
-				g_variant_builder_add (&route_builder, "{sv}",
-				                       "metric",
-				                       g_variant_new_uint32 (route->metric));
-
-				g_variant_builder_add (&array_builder, "a{sv}", &route_builder);
-			}
-
-			g_value_take_variant (value, g_variant_builder_end (&array_builder));
-		}
+		if (!priv->route_data_variant)
+			priv->route_data_variant = g_variant_ref_sink (_route_data_build (config));
+		g_value_set_variant (value, priv->route_data_variant);
 		break;
 	case PROP_ROUTES:
-		{
+		if (!priv->routes_variant) {
 			GVariantBuilder array_builder;
 			guint nroutes = nm_ip4_config_get_num_routes (config);
 			int i;
@@ -2290,8 +2934,9 @@ get_property (GObject *object, guint prop_id,
 				                                                  dbus_route, 4, sizeof (guint32)));
 			}
 
-			g_value_take_variant (value, g_variant_builder_end (&array_builder));
+			priv->routes_variant = g_variant_ref_sink (g_variant_builder_end (&array_builder));
 		}
+		g_value_set_variant (value, priv->routes_variant);
 		break;
 	case PROP_GATEWAY:
 		if (priv->has_gateway)
@@ -2359,6 +3004,7 @@ nm_ip4_config_class_init (NMIP4ConfigClass *config_class)
 
 	object_class->get_property = get_property;
 	object_class->set_property = set_property;
+	object_class->notify = notify;
 	object_class->finalize = finalize;
 
 	obj_properties[PROP_IFINDEX] =
@@ -2427,6 +3073,20 @@ nm_ip4_config_class_init (NMIP4ConfigClass *config_class)
 
 	g_object_class_install_properties (object_class, _PROPERTY_ENUMS_LAST, obj_properties);
 
+	signals[ROUTES_ADDED] =
+		g_signal_new (NM_IP4_CONFIG_ROUTES_ADDED,
+		              G_OBJECT_CLASS_TYPE (object_class),
+		              G_SIGNAL_RUN_FIRST,
+		              0, NULL, NULL, NULL,
+		              G_TYPE_NONE, 1, G_TYPE_VARIANT);
+
+	signals[ROUTES_REMOVED] =
+		g_signal_new (NM_IP4_CONFIG_ROUTES_REMOVED,
+		              G_OBJECT_CLASS_TYPE (object_class),
+		              G_SIGNAL_RUN_FIRST,
+		              0, NULL, NULL, NULL,
+		              G_TYPE_NONE, 1, G_TYPE_VARIANT);
+
 	nm_exported_object_class_add_interface (NM_EXPORTED_OBJECT_CLASS (config_class),
 	                                        NMDBUS_TYPE_IP4_CONFIG_SKELETON,
 	                                        NULL);
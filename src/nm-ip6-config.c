@@ -30,6 +30,8 @@
 #include "nm-utils.h"
 #include "nm-platform.h"
 #include "nm-route-manager.h"
+#include "nm-route-trie.h"
+#include "nm-config.h"
 #include "nm-core-internal.h"
 #include "NetworkManagerUtils.h"
 #include "nm-macros-internal.h"
@@ -45,6 +47,45 @@ typedef struct _NMIP6ConfigPrivate {
 	struct in6_addr gateway;
 	GArray *addresses;
 	GArray *routes;
+
+	/* longest-prefix-match indexes for @routes and the prefixes of
+	 * @addresses. They point into the arrays, so they are created lazily
+	 * and dropped whenever the arrays change. */
+	NMRouteTrie *routes_trie;
+	NMRouteTrie *addresses_trie;
+
+	/* hash indexes to find duplicate addresses and routes. They are sets of
+	 * pointers into the arrays and are only valid as long as the array data
+	 * does not move (see _idx_get()). */
+	GHashTable *addresses_idx;
+	gconstpointer addresses_idx_data;
+	GHashTable *routes_idx;
+	gconstpointer routes_idx_data;
+
+	/* @addresses and @routes can be shared with other configs. In that
+	 * case these point to the number of configs that share the array,
+	 * and the array must be copied before modifying it. */
+	guint *addresses_shared;
+	guint *routes_shared;
+
+	/* the exported values of the address and route properties. They are
+	 * built on demand and dropped whenever the addresses or routes change. */
+	GVariant *address_data_variant;
+	GVariant *addresses_variant;
+	GVariant *route_data_variant;
+	GVariant *routes_variant;
+
+	/* the entries of the last exported RouteData, by route. See
+	 * _route_data_build(). */
+	GHashTable *route_data_cache;
+	GHashTable *routes_added;
+	GHashTable *routes_removed;
+	guint routes_delta_id;
+
+	/* see _notify_coalesced(). */
+	guint notify_pending;
+	guint notify_idle_id;
+
 	GArray *nameservers;
 	GPtrArray *domains;
 	GPtrArray *searches;
@@ -68,6 +109,56 @@ NM_GOBJECT_PROPERTIES_DEFINE (NMIP6Config,
 	PROP_DNS_OPTIONS,
 );
 
+enum {
+	ROUTES_ADDED,
+	ROUTES_REMOVED,
+
+	LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+/******************************************************************/
+
+static gboolean
+_notify_pending_cb (gpointer user_data)
+{
+	NMIP6Config *self = user_data;
+	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+	guint pending = priv->notify_pending;
+	_PropertyEnums prop;
+
+	priv->notify_idle_id = 0;
+	priv->notify_pending = 0;
+
+	g_object_freeze_notify (G_OBJECT (self));
+	for (prop = _PROPERTY_ENUMS_0 + 1; prop < _PROPERTY_ENUMS_LAST; prop++) {
+		if (NM_FLAGS_HAS (pending, 1u << prop))
+			_notify (self, prop);
+	}
+	g_object_thaw_notify (G_OBJECT (self));
+	return G_SOURCE_REMOVE;
+}
+
+/* The D-Bus skeleton of an exported config reads a property on every
+ * notification (see nm_exported_object_skeleton_create()). For the
+ * address and route properties, that means building the whole array.
+ * Notify them only once per main loop iteration. */
+static void
+_notify_coalesced (NMIP6Config *self, _PropertyEnums prop)
+{
+	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+
+	if (!nm_exported_object_is_exported ((NMExportedObject *) self)) {
+		_notify (self, prop);
+		return;
+	}
+
+	priv->notify_pending |= 1u << prop;
+	if (!priv->notify_idle_id)
+		priv->notify_idle_id = g_idle_add (_notify_pending_cb, self);
+}
+
 NMIP6Config *
 nm_ip6_config_new (int ifindex)
 {
@@ -85,24 +176,6 @@ nm_ip6_config_get_ifindex (const NMIP6Config *config)
 
 /******************************************************************/
 
-static gboolean
-same_prefix (const struct in6_addr *address1, const struct in6_addr *address2, int plen)
-{
-	const guint8 *bytes1 = (const guint8 *) address1;
-	const guint8 *bytes2 = (const guint8 *) address2;
-	int nbytes = plen / 8;
-	int nbits = plen % 8;
-	int masked1 = bytes1[nbytes] >> (8 - nbits);
-	int masked2 = bytes2[nbytes] >> (8 - nbits);
-
-	if (nbytes && memcmp (bytes1, bytes2, nbytes))
-		return FALSE;
-
-	return masked1 == masked2;
-}
-
-/******************************************************************/
-
 /**
  * nm_ip6_config_capture_resolv_conf():
  * @nameservers: array of struct in6_addr
@@ -184,6 +257,265 @@ routes_are_duplicate (const NMPlatformIP6Route *a, const NMPlatformIP6Route *b,
 	            && nm_utils_ip6_route_metric_normalize (a->metric) == nm_utils_ip6_route_metric_normalize (b->metric)));
 }
 
+/******************************************************************/
+
+/* Up to this number of entries, addresses and routes are searched
+ * linearly instead of through the hash index. */
+#define IDX_MIN_LEN 32
+
+static guint
+_in6_addr_hash (const struct in6_addr *addr)
+{
+	guint h = 5381;
+	guint i;
+
+	for (i = 0; i < 4; i++)
+		h = (h * 33) + addr->s6_addr32[i];
+	return h;
+}
+
+static guint
+_addresses_idx_hash (gconstpointer ptr)
+{
+	const NMPlatformIP6Address *a = ptr;
+
+	return _in6_addr_hash (&a->address);
+}
+
+static gboolean
+_addresses_idx_equal (gconstpointer a, gconstpointer b)
+{
+	return addresses_are_duplicate (a, b);
+}
+
+static guint
+_routes_idx_hash (gconstpointer ptr)
+{
+	const NMPlatformIP6Route *r = ptr;
+
+	return (_in6_addr_hash (&r->network) * 33) + r->plen;
+}
+
+static gboolean
+_routes_idx_equal (gconstpointer a, gconstpointer b)
+{
+	return routes_are_duplicate (a, b, FALSE);
+}
+
+static GHashTable *
+_idx_get (GHashTable **p_idx, gconstpointer *p_idx_data, GArray *array, GHashFunc hash_func, GEqualFunc equal_func)
+{
+	guint elt_size = g_array_get_element_size (array);
+	guint i;
+
+	/* the index contains pointers to the array elements. If the array
+	 * was reallocated, rebuild it. */
+	if (*p_idx && *p_idx_data != array->data)
+		g_clear_pointer (p_idx, g_hash_table_unref);
+
+	if (!*p_idx) {
+		*p_idx = g_hash_table_new (hash_func, equal_func);
+		for (i = 0; i < array->len; i++) {
+			gpointer item = &array->data[i * elt_size];
+
+			/* like a linear search, find the first of several duplicates. */
+			if (!g_hash_table_contains (*p_idx, item))
+				g_hash_table_add (*p_idx, item);
+		}
+		*p_idx_data = array->data;
+	}
+	return *p_idx;
+}
+
+static void
+_idx_append (GHashTable **p_idx, gconstpointer *p_idx_data, GArray *array)
+{
+	if (!*p_idx)
+		return;
+	if (*p_idx_data != array->data) {
+		g_clear_pointer (p_idx, g_hash_table_unref);
+		return;
+	}
+	g_hash_table_add (*p_idx, &array->data[(array->len - 1) * g_array_get_element_size (array)]);
+}
+
+/* Must be called when the addresses change. If @ids_changed is %FALSE,
+ * the addresses were only modified in place without changing what
+ * addresses_are_duplicate() compares. */
+static void
+_addresses_variants_clear (NMIP6ConfigPrivate *priv)
+{
+	g_clear_pointer (&priv->address_data_variant, g_variant_unref);
+	g_clear_pointer (&priv->addresses_variant, g_variant_unref);
+}
+
+static void
+_routes_variants_clear (NMIP6ConfigPrivate *priv)
+{
+	g_clear_pointer (&priv->route_data_variant, g_variant_unref);
+	g_clear_pointer (&priv->routes_variant, g_variant_unref);
+}
+
+static void
+_addresses_changed (NMIP6ConfigPrivate *priv, gboolean ids_changed)
+{
+	g_clear_pointer (&priv->addresses_trie, nm_route_trie_free);
+	_addresses_variants_clear (priv);
+	if (ids_changed)
+		g_clear_pointer (&priv->addresses_idx, g_hash_table_unref);
+}
+
+static void
+_addresses_appended (NMIP6ConfigPrivate *priv)
+{
+	g_clear_pointer (&priv->addresses_trie, nm_route_trie_free);
+	_addresses_variants_clear (priv);
+	_idx_append (&priv->addresses_idx, &priv->addresses_idx_data, priv->addresses);
+}
+
+static void
+_routes_changed (NMIP6ConfigPrivate *priv, gboolean ids_changed)
+{
+	g_clear_pointer (&priv->routes_trie, nm_route_trie_free);
+	_routes_variants_clear (priv);
+	if (ids_changed)
+		g_clear_pointer (&priv->routes_idx, g_hash_table_unref);
+}
+
+static void
+_routes_appended (NMIP6ConfigPrivate *priv)
+{
+	g_clear_pointer (&priv->routes_trie, nm_route_trie_free);
+	_routes_variants_clear (priv);
+	_idx_append (&priv->routes_idx, &priv->routes_idx_data, priv->routes);
+}
+
+/******************************************************************/
+
+static void
+_array_release (GArray **p_array, guint **p_shared)
+{
+	if (*p_shared) {
+		if (--(**p_shared) == 0)
+			g_free (*p_shared);
+		*p_shared = NULL;
+	}
+	g_clear_pointer (p_array, g_array_unref);
+}
+
+static void
+_array_share (GArray **p_dst, guint **p_dst_shared, GArray *src, guint **p_src_shared)
+{
+	if (!*p_src_shared) {
+		*p_src_shared = g_new (guint, 1);
+		**p_src_shared = 1;
+	}
+	_array_release (p_dst, p_dst_shared);
+	*p_dst = g_array_ref (src);
+	*p_dst_shared = *p_src_shared;
+	(**p_dst_shared)++;
+}
+
+/* Makes sure the array is not shared with other configs. If @copy is %FALSE,
+ * a shared array is replaced by an empty one. Returns %TRUE if the array
+ * was replaced. */
+static gboolean
+_array_unshare (GArray **p_array, guint **p_shared, gboolean copy)
+{
+	GArray *array = *p_array;
+
+	if (!*p_shared)
+		return FALSE;
+	if (**p_shared == 1) {
+		/* the other configs are gone. */
+		g_clear_pointer (p_shared, g_free);
+		return FALSE;
+	}
+	(**p_shared)--;
+	*p_shared = NULL;
+
+	*p_array = g_array_sized_new (FALSE, TRUE, g_array_get_element_size (array), copy ? array->len : 0);
+	if (copy)
+		g_array_append_vals (*p_array, array->data, array->len);
+	g_array_unref (array);
+	return TRUE;
+}
+
+static void
+_addresses_unshare (NMIP6ConfigPrivate *priv, gboolean copy)
+{
+	if (_array_unshare (&priv->addresses, &priv->addresses_shared, copy))
+		_addresses_changed (priv, TRUE);
+}
+
+static void
+_routes_unshare (NMIP6ConfigPrivate *priv, gboolean copy)
+{
+	if (_array_unshare (&priv->routes, &priv->routes_shared, copy))
+		_routes_changed (priv, TRUE);
+}
+
+/* Sharing the array of @src is only the same as adding its
+ * entries one by one, if they contain no duplicates. That is the case for
+ * configs built with nm_ip6_config_add_*(), but not necessarily for
+ * captured ones. */
+static gboolean
+_addresses_are_unique (NMIP6ConfigPrivate *priv)
+{
+	return g_hash_table_size (_idx_get (&priv->addresses_idx, &priv->addresses_idx_data, priv->addresses,
+	                                    _addresses_idx_hash, _addresses_idx_equal)) == priv->addresses->len;
+}
+
+static gboolean
+_routes_are_unique (NMIP6ConfigPrivate *priv)
+{
+	return g_hash_table_size (_idx_get (&priv->routes_idx, &priv->routes_idx_data, priv->routes,
+	                                    _routes_idx_hash, _routes_idx_equal)) == priv->routes->len;
+}
+
+/* Lets @dst share the addresses of @src, if @dst has no addresses yet.
+ * Returns %FALSE if the addresses must be added one by one instead. */
+static gboolean
+_addresses_share (NMIP6Config *dst, const NMIP6Config *src)
+{
+	NMIP6ConfigPrivate *dst_priv = NM_IP6_CONFIG_GET_PRIVATE (dst);
+	NMIP6ConfigPrivate *src_priv = NM_IP6_CONFIG_GET_PRIVATE (src);
+
+	if (   dst_priv->addresses->len != 0
+	    || src_priv->addresses->len == 0
+	    || !_addresses_are_unique (src_priv))
+		return FALSE;
+
+	_addresses_changed (dst_priv, TRUE);
+	_array_share (&dst_priv->addresses, &dst_priv->addresses_shared, src_priv->addresses, &src_priv->addresses_shared);
+	_notify_coalesced (dst, PROP_ADDRESS_DATA);
+	_notify_coalesced (dst, PROP_ADDRESSES);
+	return TRUE;
+}
+
+/* Like _addresses_share(). The routes of @src carry its ifindex, so they
+ * can only be shared between configs of the same interface. */
+static gboolean
+_routes_share (NMIP6Config *dst, const NMIP6Config *src)
+{
+	NMIP6ConfigPrivate *dst_priv = NM_IP6_CONFIG_GET_PRIVATE (dst);
+	NMIP6ConfigPrivate *src_priv = NM_IP6_CONFIG_GET_PRIVATE (src);
+
+	if (   dst_priv->routes->len != 0
+	    || src_priv->routes->len == 0
+	    || dst_priv->ifindex != src_priv->ifindex
+	    || !_routes_are_unique (src_priv))
+		return FALSE;
+
+	_routes_changed (dst_priv, TRUE);
+	_array_share (&dst_priv->routes, &dst_priv->routes_shared, src_priv->routes, &src_priv->routes_shared);
+	_notify_coalesced (dst, PROP_ROUTE_DATA);
+	_notify_coalesced (dst, PROP_ROUTES);
+	return TRUE;
+}
+
+/******************************************************************/
+
 static gint
 _addresses_sort_cmp_get_prio (const struct in6_addr *addr)
 {
@@ -267,25 +599,27 @@ nm_ip6_config_addresses_sort (NMIP6Config *self, NMSettingIP6ConfigPrivacy use_t
 {
 	NMIP6ConfigPrivate *priv;
 	size_t data_len = 0;
-	char *data_pre = NULL;
-	gboolean changed;
+	gs_free char *data_sorted = NULL;
 
 	g_return_val_if_fail (NM_IS_IP6_CONFIG (self), FALSE);
 
 	priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 	if (priv->addresses->len > 1) {
+		/* sort a copy, so that a shared array is only copied if
+		 * the order actually changes. */
 		data_len = priv->addresses->len * g_array_get_element_size (priv->addresses);
-		data_pre = g_new (char, data_len);
-		memcpy (data_pre, priv->addresses->data, data_len);
-
-		g_array_sort_with_data (priv->addresses, _addresses_sort_cmp, GINT_TO_POINTER (use_temporary));
-
-		changed = memcmp (data_pre, priv->addresses->data, data_len) != 0;
-		g_free (data_pre);
-
-		if (changed) {
-			_notify (self, PROP_ADDRESS_DATA);
-			_notify (self, PROP_ADDRESSES);
+		data_sorted = g_new (char, data_len);
+		memcpy (data_sorted, priv->addresses->data, data_len);
+
+		g_qsort_with_data (data_sorted, priv->addresses->len, g_array_get_element_size (priv->addresses),
+		                   _addresses_sort_cmp, GINT_TO_POINTER (use_temporary));
+
+		if (memcmp (data_sorted, priv->addresses->data, data_len) != 0) {
+			_addresses_unshare (priv, TRUE);
+			memcpy (priv->addresses->data, data_sorted, data_len);
+			_addresses_changed (priv, TRUE);
+			_notify_coalesced (self, PROP_ADDRESS_DATA);
+			_notify_coalesced (self, PROP_ADDRESSES);
 			return TRUE;
 		}
 	}
@@ -367,10 +701,10 @@ nm_ip6_config_capture (int ifindex, gboolean capture_resolv_conf, NMSettingIP6Co
 	/* actually, nobody should be connected to the signal, just to be sure, notify */
 	if (notify_nameservers)
 		_notify (config, PROP_NAMESERVERS);
-	_notify (config, PROP_ADDRESS_DATA);
-	_notify (config, PROP_ADDRESSES);
-	_notify (config, PROP_ROUTE_DATA);
-	_notify (config, PROP_ROUTES);
+	_notify_coalesced (config, PROP_ADDRESS_DATA);
+	_notify_coalesced (config, PROP_ADDRESSES);
+	_notify_coalesced (config, PROP_ROUTE_DATA);
+	_notify_coalesced (config, PROP_ROUTES);
 	if (!IN6_ARE_ADDR_EQUAL (&priv->gateway, &old_gateway))
 		_notify (config, PROP_GATEWAY);
 
@@ -649,8 +983,10 @@ nm_ip6_config_merge (NMIP6Config *dst, const NMIP6Config *src, NMIPConfigMergeFl
 	g_object_freeze_notify (G_OBJECT (dst));
 
 	/* addresses */
-	for (i = 0; i < nm_ip6_config_get_num_addresses (src); i++)
-		nm_ip6_config_add_address (dst, nm_ip6_config_get_address (src, i));
+	if (!_addresses_share (dst, src)) {
+		for (i = 0; i < nm_ip6_config_get_num_addresses (src); i++)
+			nm_ip6_config_add_address (dst, nm_ip6_config_get_address (src, i));
+	}
 
 	/* nameservers */
 	if (!NM_FLAGS_HAS (merge_flags, NM_IP_CONFIG_MERGE_NO_DNS)) {
@@ -663,7 +999,8 @@ nm_ip6_config_merge (NMIP6Config *dst, const NMIP6Config *src, NMIPConfigMergeFl
 		nm_ip6_config_set_gateway (dst, nm_ip6_config_get_gateway (src));
 
 	/* routes */
-	if (!NM_FLAGS_HAS (merge_flags, NM_IP_CONFIG_MERGE_NO_ROUTES)) {
+	if (   !NM_FLAGS_HAS (merge_flags, NM_IP_CONFIG_MERGE_NO_ROUTES)
+	    && !_routes_share (dst, src)) {
 		for (i = 0; i < nm_ip6_config_get_num_routes (src); i++)
 			nm_ip6_config_add_route (dst, nm_ip6_config_get_route (src, i));
 	}
@@ -697,21 +1034,40 @@ nm_ip6_config_merge (NMIP6Config *dst, const NMIP6Config *src, NMIPConfigMergeFl
 	g_object_thaw_notify (G_OBJECT (dst));
 }
 
+static gboolean
+_destination_is_direct_cb (gpointer value, guint8 plen, gpointer user_data)
+{
+	*((gboolean *) user_data) = TRUE;
+	return FALSE;
+}
+
 gboolean
 nm_ip6_config_destination_is_direct (const NMIP6Config *config, const struct in6_addr *network, int plen)
 {
-	int num = nm_ip6_config_get_num_addresses (config);
-	int i;
+	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (config);
+	gboolean found = FALSE;
+	guint i;
 
-	for (i = 0; i < num; i++) {
-		const NMPlatformIP6Address *item = nm_ip6_config_get_address (config, i);
+	if (plen < 0)
+		return FALSE;
 
-		if (item->plen <= plen && same_prefix (&item->address, network, item->plen) &&
-		    !(item->flags & IFA_F_NOPREFIXROUTE))
-			return TRUE;
+	if (!priv->addresses_trie) {
+		priv->addresses_trie = nm_route_trie_new (AF_INET6);
+		for (i = 0; i < priv->addresses->len; i++) {
+			const NMPlatformIP6Address *item = &g_array_index (priv->addresses, NMPlatformIP6Address, i);
+
+			if (item->flags & IFA_F_NOPREFIXROUTE)
+				continue;
+			nm_route_trie_insert (priv->addresses_trie, &item->address, item->plen, (gpointer) item);
+		}
 	}
 
-	return FALSE;
+	nm_route_trie_foreach_covering (priv->addresses_trie,
+	                                network,
+	                                MIN (plen, 128),
+	                                _destination_is_direct_cb,
+	                                &found);
+	return found;
 }
 
 /*******************************************************************************/
@@ -720,8 +1076,16 @@ static int
 _addresses_get_index (const NMIP6Config *self, const NMPlatformIP6Address *addr)
 {
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+	const NMPlatformIP6Address *found;
 	guint i;
 
+	if (priv->addresses->len > IDX_MIN_LEN) {
+		found = g_hash_table_lookup (_idx_get (&priv->addresses_idx, &priv->addresses_idx_data, priv->addresses,
+		                                       _addresses_idx_hash, _addresses_idx_equal),
+		                             addr);
+		return found ? (int) (found - (const NMPlatformIP6Address *) priv->addresses->data) : -1;
+	}
+
 	for (i = 0; i < priv->addresses->len; i++) {
 		const NMPlatformIP6Address *a = &g_array_index (priv->addresses, NMPlatformIP6Address, i);
 
@@ -750,8 +1114,16 @@ static int
 _routes_get_index (const NMIP6Config *self, const NMPlatformIP6Route *route)
 {
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+	const NMPlatformIP6Route *found;
 	guint i;
 
+	if (priv->routes->len > IDX_MIN_LEN) {
+		found = g_hash_table_lookup (_idx_get (&priv->routes_idx, &priv->routes_idx_data, priv->routes,
+		                                       _routes_idx_hash, _routes_idx_equal),
+		                             route);
+		return found ? (int) (found - (const NMPlatformIP6Route *) priv->routes->data) : -1;
+	}
+
 	for (i = 0; i < priv->routes->len; i++) {
 		const NMPlatformIP6Route *r = &g_array_index (priv->routes, NMPlatformIP6Route, i);
 
@@ -806,6 +1178,73 @@ _dns_options_get_index (const NMIP6Config *self, const char *option)
 	return -1;
 }
 
+/* Removes all addresses from @dst that are contained in @src, or with
+ * @subtract %FALSE, all addresses that are not contained in @src.
+ * This is O(n) with the hash index of @src. */
+static void
+_addresses_filter (NMIP6Config *dst, const NMIP6Config *src, gboolean subtract)
+{
+	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (dst);
+	guint i, j;
+
+	if (dst == src) {
+		if (subtract)
+			nm_ip6_config_reset_addresses (dst);
+		return;
+	}
+
+	for (i = 0, j = 0; i < priv->addresses->len; i++) {
+		const NMPlatformIP6Address *a = &g_array_index (priv->addresses, NMPlatformIP6Address, i);
+
+		if ((_addresses_get_index (src, a) >= 0) == subtract) {
+			_addresses_unshare (priv, TRUE);
+			continue;
+		}
+		if (i != j)
+			g_array_index (priv->addresses, NMPlatformIP6Address, j) = g_array_index (priv->addresses, NMPlatformIP6Address, i);
+		j++;
+	}
+
+	if (j != priv->addresses->len) {
+		_addresses_changed (priv, TRUE);
+		g_array_set_size (priv->addresses, j);
+		_notify_coalesced (dst, PROP_ADDRESS_DATA);
+		_notify_coalesced (dst, PROP_ADDRESSES);
+	}
+}
+
+static void
+_routes_filter (NMIP6Config *dst, const NMIP6Config *src, gboolean subtract)
+{
+	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (dst);
+	guint i, j;
+
+	if (dst == src) {
+		if (subtract)
+			nm_ip6_config_reset_routes (dst);
+		return;
+	}
+
+	for (i = 0, j = 0; i < priv->routes->len; i++) {
+		const NMPlatformIP6Route *r = &g_array_index (priv->routes, NMPlatformIP6Route, i);
+
+		if ((_routes_get_index (src, r) >= 0) == subtract) {
+			_routes_unshare (priv, TRUE);
+			continue;
+		}
+		if (i != j)
+			g_array_index (priv->routes, NMPlatformIP6Route, j) = g_array_index (priv->routes, NMPlatformIP6Route, i);
+		j++;
+	}
+
+	if (j != priv->routes->len) {
+		_routes_changed (priv, TRUE);
+		g_array_set_size (priv->routes, j);
+		_notify_coalesced (dst, PROP_ROUTE_DATA);
+		_notify_coalesced (dst, PROP_ROUTES);
+	}
+}
+
 /*******************************************************************************/
 
 /**
@@ -828,11 +1267,7 @@ nm_ip6_config_subtract (NMIP6Config *dst, const NMIP6Config *src)
 	g_object_freeze_notify (G_OBJECT (dst));
 
 	/* addresses */
-	for (i = 0; i < nm_ip6_config_get_num_addresses (src); i++) {
-		idx = _addresses_get_index (dst, nm_ip6_config_get_address (src, i));
-		if (idx >= 0)
-			nm_ip6_config_del_address (dst, idx);
-	}
+	_addresses_filter (dst, src, TRUE);
 
 	/* nameservers */
 	for (i = 0; i < nm_ip6_config_get_num_nameservers (src); i++) {
@@ -853,11 +1288,7 @@ nm_ip6_config_subtract (NMIP6Config *dst, const NMIP6Config *src)
 	/* ignore route_metric */
 
 	/* routes */
-	for (i = 0; i < nm_ip6_config_get_num_routes (src); i++) {
-		idx = _routes_get_index (dst, nm_ip6_config_get_route (src, i));
-		if (idx >= 0)
-			nm_ip6_config_del_route (dst, idx);
-	}
+	_routes_filter (dst, src, TRUE);
 
 	/* domains */
 	for (i = 0; i < nm_ip6_config_get_num_domains (src); i++) {
@@ -889,8 +1320,6 @@ nm_ip6_config_subtract (NMIP6Config *dst, const NMIP6Config *src)
 void
 nm_ip6_config_intersect (NMIP6Config *dst, const NMIP6Config *src)
 {
-	guint i;
-	gint idx;
 	const struct in6_addr *dst_tmp, *src_tmp;
 
 	g_return_if_fail (src != NULL);
@@ -899,13 +1328,7 @@ nm_ip6_config_intersect (NMIP6Config *dst, const NMIP6Config *src)
 	g_object_freeze_notify (G_OBJECT (dst));
 
 	/* addresses */
-	for (i = 0; i < nm_ip6_config_get_num_addresses (dst); ) {
-		idx = _addresses_get_index (src, nm_ip6_config_get_address (dst, i));
-		if (idx < 0)
-			nm_ip6_config_del_address (dst, i);
-		else
-			i++;
-	}
+	_addresses_filter (dst, src, FALSE);
 
 	/* ignore route_metric */
 	/* ignore nameservers */
@@ -921,13 +1344,7 @@ nm_ip6_config_intersect (NMIP6Config *dst, const NMIP6Config *src)
 	}
 
 	/* routes */
-	for (i = 0; i < nm_ip6_config_get_num_routes (dst); ) {
-		idx = _routes_get_index (src, nm_ip6_config_get_route (dst, i));
-		if (idx < 0)
-			nm_ip6_config_del_route (dst, i);
-		else
-			i++;
-	}
+	_routes_filter (dst, src, FALSE);
 
 	/* ignore domains */
 	/* ignore dns searches */
@@ -1019,8 +1436,10 @@ nm_ip6_config_replace (NMIP6Config *dst, const NMIP6Config *src, gboolean *relev
 		has_relevant_changes = TRUE;
 	if (!are_equal) {
 		nm_ip6_config_reset_addresses (dst);
-		for (i = 0; i < num; i++)
-			nm_ip6_config_add_address (dst, nm_ip6_config_get_address (src, i));
+		if (!_addresses_share (dst, src)) {
+			for (i = 0; i < num; i++)
+				nm_ip6_config_add_address (dst, nm_ip6_config_get_address (src, i));
+		}
 		has_minor_changes = TRUE;
 	}
 
@@ -1042,8 +1461,10 @@ nm_ip6_config_replace (NMIP6Config *dst, const NMIP6Config *src, gboolean *relev
 		has_relevant_changes = TRUE;
 	if (!are_equal) {
 		nm_ip6_config_reset_routes (dst);
-		for (i = 0; i < num; i++)
-			nm_ip6_config_add_route (dst, nm_ip6_config_get_route (src, i));
+		if (!_routes_share (dst, src)) {
+			for (i = 0; i < num; i++)
+				nm_ip6_config_add_route (dst, nm_ip6_config_get_route (src, i));
+		}
 		has_minor_changes = TRUE;
 	}
 
@@ -1225,7 +1646,10 @@ nm_ip6_config_set_gateway (NMIP6Config *config, const struct in6_addr *gateway)
 			return;
 		memset (&priv->gateway, 0, sizeof (priv->gateway));
 	}
+	/* "Addresses" contains the gateway. */
+	g_clear_pointer (&priv->addresses_variant, g_variant_unref);
 	_notify (config, PROP_GATEWAY);
+	_notify_coalesced (config, PROP_ADDRESSES);
 }
 
 const struct in6_addr *
@@ -1252,9 +1676,11 @@ nm_ip6_config_reset_addresses (NMIP6Config *config)
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (config);
 
 	if (priv->addresses->len != 0) {
+		_addresses_changed (priv, TRUE);
+		_addresses_unshare (priv, FALSE);
 		g_array_set_size (priv->addresses, 0);
-		_notify (config, PROP_ADDRESS_DATA);
-		_notify (config, PROP_ADDRESSES);
+		_notify_coalesced (config, PROP_ADDRESS_DATA);
+		_notify_coalesced (config, PROP_ADDRESSES);
 	}
 }
 
@@ -1277,42 +1703,47 @@ nm_ip6_config_add_address (NMIP6Config *config, const NMPlatformIP6Address *new)
 
 	g_return_if_fail (new != NULL);
 
-	for (i = 0; i < priv->addresses->len; i++ ) {
+	i = _addresses_get_index (config, new);
+	if (i >= 0) {
 		NMPlatformIP6Address *item = &g_array_index (priv->addresses, NMPlatformIP6Address, i);
 
-		if (addresses_are_duplicate (item, new)) {
-			if (nm_platform_ip6_address_cmp (item, new) == 0)
-				return;
-
-			/* remember the old values. */
-			item_old = *item;
-			/* Copy over old item to get new lifetime, timestamp, preferred */
-			*item = *new;
-
-			/* But restore highest priority source */
-			item->source = MAX (item_old.source, new->source);
-
-			/* for addresses that we read from the kernel, we keep the timestamps as defined
-			 * by the previous source (item_old). The reason is, that the other source configured the lifetimes
-			 * with "what should be" and the kernel values are "what turned out after configuring it".
-			 *
-			 * For other sources, the longer lifetime wins. */
-			if (   (new->source == NM_IP_CONFIG_SOURCE_KERNEL && new->source != item_old.source)
-			    || nm_platform_ip_address_cmp_expiry ((const NMPlatformIPAddress *) &item_old, (const NMPlatformIPAddress *) new) > 0) {
-				item->timestamp = item_old.timestamp;
-				item->lifetime = item_old.lifetime;
-				item->preferred = item_old.preferred;
-			}
-			if (nm_platform_ip6_address_cmp (&item_old, item) == 0)
-				return;
-			goto NOTIFY;
+		if (nm_platform_ip6_address_cmp (item, new) == 0)
+			return;
+
+		_addresses_unshare (priv, TRUE);
+		item = &g_array_index (priv->addresses, NMPlatformIP6Address, i);
+
+		/* remember the old values. */
+		item_old = *item;
+		/* Copy over old item to get new lifetime, timestamp, preferred */
+		*item = *new;
+
+		/* But restore highest priority source */
+		item->source = MAX (item_old.source, new->source);
+
+		/* for addresses that we read from the kernel, we keep the timestamps as defined
+		 * by the previous source (item_old). The reason is, that the other source configured the lifetimes
+		 * with "what should be" and the kernel values are "what turned out after configuring it".
+		 *
+		 * For other sources, the longer lifetime wins. */
+		if (   (new->source == NM_IP_CONFIG_SOURCE_KERNEL && new->source != item_old.source)
+		    || nm_platform_ip_address_cmp_expiry ((const NMPlatformIPAddress *) &item_old, (const NMPlatformIPAddress *) new) > 0) {
+			item->timestamp = item_old.timestamp;
+			item->lifetime = item_old.lifetime;
+			item->preferred = item_old.preferred;
 		}
+		if (nm_platform_ip6_address_cmp (&item_old, item) == 0)
+			return;
+		_addresses_changed (priv, FALSE);
+		goto NOTIFY;
 	}
 
+	_addresses_unshare (priv, TRUE);
 	g_array_append_val (priv->addresses, *new);
+	_addresses_appended (priv);
 NOTIFY:
-	_notify (config, PROP_ADDRESS_DATA);
-	_notify (config, PROP_ADDRESSES);
+	_notify_coalesced (config, PROP_ADDRESS_DATA);
+	_notify_coalesced (config, PROP_ADDRESSES);
 }
 
 void
@@ -1322,9 +1753,11 @@ nm_ip6_config_del_address (NMIP6Config *config, guint i)
 
 	g_return_if_fail (i < priv->addresses->len);
 
+	_addresses_changed (priv, TRUE);
+	_addresses_unshare (priv, TRUE);
 	g_array_remove_index (priv->addresses, i);
-	_notify (config, PROP_ADDRESS_DATA);
-	_notify (config, PROP_ADDRESSES);
+	_notify_coalesced (config, PROP_ADDRESS_DATA);
+	_notify_coalesced (config, PROP_ADDRESSES);
 }
 
 guint
@@ -1358,9 +1791,11 @@ nm_ip6_config_reset_routes (NMIP6Config *config)
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (config);
 
 	if (priv->routes->len != 0) {
+		_routes_changed (priv, TRUE);
+		_routes_unshare (priv, FALSE);
 		g_array_set_size (priv->routes, 0);
-		_notify (config, PROP_ROUTE_DATA);
-		_notify (config, PROP_ROUTES);
+		_notify_coalesced (config, PROP_ROUTE_DATA);
+		_notify_coalesced (config, PROP_ROUTES);
 	}
 }
 
@@ -1385,26 +1820,31 @@ nm_ip6_config_add_route (NMIP6Config *config, const NMPlatformIP6Route *new)
 	g_return_if_fail (new->plen > 0);
 	g_assert (priv->ifindex);
 
-	for (i = 0; i < priv->routes->len; i++ ) {
+	i = _routes_get_index (config, new);
+	if (i >= 0) {
 		NMPlatformIP6Route *item = &g_array_index (priv->routes, NMPlatformIP6Route, i);
 
-		if (routes_are_duplicate (item, new, FALSE)) {
-			if (nm_platform_ip6_route_cmp (item, new) == 0)
-				return;
-			old_source = item->source;
-			*item = *new;
-			/* Restore highest priority source */
-			item->source = MAX (old_source, new->source);
-			item->ifindex = priv->ifindex;
-			goto NOTIFY;
-		}
+		if (nm_platform_ip6_route_cmp (item, new) == 0)
+			return;
+
+		_routes_unshare (priv, TRUE);
+		item = &g_array_index (priv->routes, NMPlatformIP6Route, i);
+		old_source = item->source;
+		_routes_changed (priv, FALSE);
+		*item = *new;
+		/* Restore highest priority source */
+		item->source = MAX (old_source, new->source);
+		item->ifindex = priv->ifindex;
+		goto NOTIFY;
 	}
 
+	_routes_unshare (priv, TRUE);
 	g_array_append_val (priv->routes, *new);
 	g_array_index (priv->routes, NMPlatformIP6Route, priv->routes->len - 1).ifindex = priv->ifindex;
+	_routes_appended (priv);
 NOTIFY:
-	_notify (config, PROP_ROUTE_DATA);
-	_notify (config, PROP_ROUTES);
+	_notify_coalesced (config, PROP_ROUTE_DATA);
+	_notify_coalesced (config, PROP_ROUTES);
 }
 
 void
@@ -1414,9 +1854,11 @@ nm_ip6_config_del_route (NMIP6Config *config, guint i)
 
 	g_return_if_fail (i < priv->routes->len);
 
+	_routes_changed (priv, TRUE);
+	_routes_unshare (priv, TRUE);
 	g_array_remove_index (priv->routes, i);
-	_notify (config, PROP_ROUTE_DATA);
-	_notify (config, PROP_ROUTES);
+	_notify_coalesced (config, PROP_ROUTE_DATA);
+	_notify_coalesced (config, PROP_ROUTES);
 }
 
 guint
@@ -1435,38 +1877,54 @@ nm_ip6_config_get_route (const NMIP6Config *config, guint i)
 	return &g_array_index (priv->routes, NMPlatformIP6Route, i);
 }
 
+static gboolean
+_direct_route_for_host_cb (gpointer value, guint8 plen, gpointer user_data)
+{
+	const NMPlatformIP6Route *item = value;
+	const NMPlatformIP6Route **p_best_route = user_data;
+
+	/* the prefixes are visited longest first. Once we have a route,
+	 * shorter prefixes cannot be better. */
+	if (*p_best_route && (*p_best_route)->plen > plen)
+		return FALSE;
+
+	if (!IN6_IS_ADDR_UNSPECIFIED (&item->gateway))
+		return TRUE;
+
+	if (   !*p_best_route
+	    || nm_utils_ip6_route_metric_normalize ((*p_best_route)->metric) > nm_utils_ip6_route_metric_normalize (item->metric))
+		*p_best_route = item;
+	return TRUE;
+}
+
+/**
+ * nm_ip6_config_get_direct_route_for_host:
+ * @config: the #NMIP6Config
+ * @host: the host address
+ *
+ * Returns: the route without gateway with the longest prefix that
+ *   contains @host. Among routes with the same prefix length, the one
+ *   with the lowest metric wins.
+ */
 const NMPlatformIP6Route *
 nm_ip6_config_get_direct_route_for_host (const NMIP6Config *config, const struct in6_addr *host)
 {
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (config);
+	const NMPlatformIP6Route *best_route = NULL;
 	guint i;
-	struct in6_addr network2, host2;
-	NMPlatformIP6Route *best_route = NULL;
 
 	g_return_val_if_fail (host && !IN6_IS_ADDR_UNSPECIFIED (host), NULL);
 
-	for (i = 0; i < priv->routes->len; i++) {
-		NMPlatformIP6Route *item = &g_array_index (priv->routes, NMPlatformIP6Route, i);
-
-		if (!IN6_IS_ADDR_UNSPECIFIED (&item->gateway))
-			continue;
-
-		if (best_route && best_route->plen > item->plen)
-			continue;
-
-		nm_utils_ip6_address_clear_host_address (&host2, host, item->plen);
-		nm_utils_ip6_address_clear_host_address (&network2, &item->network, item->plen);
-
-		if (!IN6_ARE_ADDR_EQUAL (&network2, &host2))
-			continue;
-
-		if (best_route &&
-		    nm_utils_ip6_route_metric_normalize (best_route->metric) <= nm_utils_ip6_route_metric_normalize (item->metric))
-			continue;
+	if (!priv->routes_trie) {
+		priv->routes_trie = nm_route_trie_new (AF_INET6);
+		for (i = 0; i < priv->routes->len; i++) {
+			const NMPlatformIP6Route *item = &g_array_index (priv->routes, NMPlatformIP6Route, i);
 
-		best_route = item;
+			nm_route_trie_insert (priv->routes_trie, &item->network, item->plen, (gpointer) item);
+		}
 	}
 
+	nm_route_trie_foreach_covering (priv->routes_trie, host, 128, _direct_route_for_host_cb, &best_route);
 	return best_route;
 }
 
@@ -1882,14 +2340,215 @@ nm_ip6_config_init (NMIP6Config *config)
 	priv->route_metric = -1;
 }
 
+static guint
+_route_data_hash (gconstpointer ptr)
+{
+	const NMPlatformIP6Route *r = ptr;
+	guint h;
+
+	h = _in6_addr_hash (&r->network);
+	h = (h * 33) + r->plen;
+	h = (h * 33) + _in6_addr_hash (&r->gateway);
+	h = (h * 33) + r->metric;
+	return h;
+}
+
+/* compares the fields that are exported in RouteData. */
+static gboolean
+_route_data_equal (gconstpointer a, gconstpointer b)
+{
+	const NMPlatformIP6Route *r1 = a, *r2 = b;
+
+	return    IN6_ARE_ADDR_EQUAL (&r1->network, &r2->network)
+	       && r1->plen == r2->plen
+	       && IN6_ARE_ADDR_EQUAL (&r1->gateway, &r2->gateway)
+	       && r1->metric == r2->metric;
+}
+
+static GHashTable *
+_route_data_table_new (void)
+{
+	return g_hash_table_new_full (_route_data_hash, _route_data_equal, g_free, (GDestroyNotify) g_variant_unref);
+}
+
+static GVariant *
+_route_data_entry_new (const NMPlatformIP6Route *route)
+{
+	GVariantBuilder route_builder;
+
+	g_variant_builder_init (&route_builder, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&route_builder, "{sv}",
+	                       "dest",
+	                       g_variant_new_string (nm_utils_inet6_ntop (&route->network, NULL)));
+	g_variant_builder_add (&route_builder, "{sv}",
+	                       "prefix",
+	                       g_variant_new_uint32 (route->plen));
+	if (!IN6_IS_ADDR_UNSPECIFIED (&route->gateway)) {
+		g_variant_builder_add (&route_builder, "{sv}",
+		                       "next-hop",
+		                       g_variant_new_string (nm_utils_inet6_ntop (&route->gateway, NULL)));
+	}
+
+	g_variant_builder_add (&route_builder, "{sv}",
+	                       "metric",
+	                       g_variant_new_uint32 (route->metric));
+	return g_variant_ref_sink (g_variant_builder_end (&route_builder));
+}
+
+/* The deltas are emitted to in-process handlers of the GObject signals,
+ * and as D-Bus signals while the config is exported, if enabled with the
+ * "route-deltas" option of NetworkManager.conf. */
+static gboolean
+_routes_delta_wanted (NMIP6Config *self)
+{
+	if (   nm_exported_object_is_exported ((NMExportedObject *) self)
+	    && nm_config_data_get_value_boolean (NM_CONFIG_GET_DATA,
+	                                         NM_CONFIG_KEYFILE_GROUP_MAIN,
+	                                         NM_CONFIG_KEYFILE_KEY_ROUTE_DELTAS,
+	                                         FALSE))
+		return TRUE;
+
+	return    g_signal_has_handler_pending (self, signals[ROUTES_ADDED], 0, FALSE)
+	       || g_signal_has_handler_pending (self, signals[ROUTES_REMOVED], 0, FALSE);
+}
+
+/* Records @route as added or removed. A pending change in the opposite
+ * direction cancels out. */
+static void
+_routes_delta_add (GHashTable *pending, GHashTable *opposite, gconstpointer route, GVariant *entry)
+{
+	if (g_hash_table_remove (opposite, route))
+		return;
+	g_hash_table_insert (pending, g_memdup (route, sizeof (NMPlatformIP6Route)), g_variant_ref (entry));
+}
+
+/* Builds RouteData, reusing the entries of routes that did not change
+ * since the last time. The differences are collected in @routes_added
+ * and @routes_removed and emitted as signals by _routes_delta_cb(). */
+static GVariant *
+_route_data_build (NMIP6Config *self)
+{
+	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+	GHashTable *cache;
+	gs_free GVariant **entries = NULL;
+	gboolean track_delta;
+	GHashTableIter iter;
+	gpointer key, entry;
+	guint i;
+
+	/* the first RouteData is built when exporting the object. Only later
+	 * changes are announced as deltas. */
+	track_delta =    priv->route_data_cache
+	              && _routes_delta_wanted (self);
+	if (track_delta && !priv->routes_added) {
+		priv->routes_added = _route_data_table_new ();
+		priv->routes_removed = _route_data_table_new ();
+	}
+
+	cache = _route_data_table_new ();
+	entries = g_new (GVariant *, priv->routes->len);
+	for (i = 0; i < priv->routes->len; i++) {
+		const NMPlatformIP6Route *route = &g_array_index (priv->routes, NMPlatformIP6Route, i);
+
+		entry = g_hash_table_lookup (cache, route);
+		if (!entry) {
+			if (   priv->route_data_cache
+			    && g_hash_table_lookup_extended (priv->route_data_cache, route, &key, &entry)) {
+				g_hash_table_steal (priv->route_data_cache, route);
+				g_hash_table_insert (cache, key, entry);
+			} else {
+				entry = _route_data_entry_new (route);
+				g_hash_table_insert (cache, g_memdup (route, sizeof (*route)), entry);
+				if (track_delta)
+					_routes_delta_add (priv->routes_added, priv->routes_removed, route, entry);
+			}
+		}
+		entries[i] = entry;
+	}
+
+	if (priv->route_data_cache) {
+		if (track_delta) {
+			g_hash_table_iter_init (&iter, priv->route_data_cache);
+			while (g_hash_table_iter_next (&iter, &key, &entry))
+				_routes_delta_add (priv->routes_removed, priv->routes_added, key, entry);
+		}
+		g_hash_table_unref (priv->route_data_cache);
+	}
+	priv->route_data_cache = cache;
+
+	return g_variant_new_array (G_VARIANT_TYPE ("a{sv}"), entries, priv->routes->len);
+}
+
+static GVariant *
+_routes_delta_to_variant (GHashTable *pending)
+{
+	GVariantBuilder builder;
+	GHashTableIter iter;
+	GVariant *entry;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+	g_hash_table_iter_init (&iter, pending);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &entry))
+		g_variant_builder_add_value (&builder, entry);
+	g_hash_table_remove_all (pending);
+	return g_variant_builder_end (&builder);
+}
+
+static gboolean
+_routes_delta_cb (gpointer user_data)
+{
+	NMIP6Config *self = user_data;
+	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+
+	priv->routes_delta_id = 0;
+
+	if (!priv->route_data_variant)
+		priv->route_data_variant = g_variant_ref_sink (_route_data_build (self));
+
+	if (!priv->routes_added)
+		return G_SOURCE_REMOVE;
+
+	/* emit the removals first, so that a client applying both signals
+	 * in order ends up with the current routes. */
+	if (g_hash_table_size (priv->routes_removed))
+		g_signal_emit (self, signals[ROUTES_REMOVED], 0, _routes_delta_to_variant (priv->routes_removed));
+	if (g_hash_table_size (priv->routes_added))
+		g_signal_emit (self, signals[ROUTES_ADDED], 0, _routes_delta_to_variant (priv->routes_added));
+	return G_SOURCE_REMOVE;
+}
+
+static void
+notify (GObject *object, GParamSpec *pspec)
+{
+	NMIP6Config *self = NM_IP6_CONFIG (object);
+	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+
+	if (   pspec == obj_properties[PROP_ROUTE_DATA]
+	    && !priv->routes_delta_id
+	    && _routes_delta_wanted (self))
+		priv->routes_delta_id = g_idle_add (_routes_delta_cb, self);
+
+	G_OBJECT_CLASS (nm_ip6_config_parent_class)->notify (object, pspec);
+}
+
+/******************************************************************/
+
 static void
 finalize (GObject *object)
 {
 	NMIP6Config *self = NM_IP6_CONFIG (object);
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
-	g_array_unref (priv->addresses);
-	g_array_unref (priv->routes);
+	nm_clear_g_source (&priv->routes_delta_id);
+	nm_clear_g_source (&priv->notify_idle_id);
+	g_clear_pointer (&priv->route_data_cache, g_hash_table_unref);
+	g_clear_pointer (&priv->routes_added, g_hash_table_unref);
+	g_clear_pointer (&priv->routes_removed, g_hash_table_unref);
+
+	_array_release (&priv->addresses, &priv->addresses_shared);
+	_array_release (&priv->routes, &priv->routes_shared);
+	_addresses_changed (priv, TRUE);
+	_routes_changed (priv, TRUE);
 	g_array_unref (priv->nameservers);
 	g_ptr_array_unref (priv->domains);
 	g_ptr_array_unref (priv->searches);
@@ -1930,7 +2589,7 @@ get_property (GObject *object, guint prop_id,
 		g_value_set_int (value, priv->ifindex);
 		break;
 	case PROP_ADDRESS_DATA:
-		{
+		if (!priv->address_data_variant) {
 			GVariantBuilder array_builder, addr_builder;
 			int naddr = nm_ip6_config_get_num_addresses (config);
 			int i;
@@ -1956,11 +2615,12 @@ get_property (GObject *object, guint prop_id,
 				g_variant_builder_add (&array_builder, "a{sv}", &addr_builder);
 			}
 
-			g_value_take_variant (value, g_variant_builder_end (&array_builder));
+			priv->address_data_variant = g_variant_ref_sink (g_variant_builder_end (&array_builder));
 		}
+		g_value_set_variant (value, priv->address_data_variant);
 		break;
 	case PROP_ADDRESSES:
-		{
+		if (!priv->addresses_variant) {
 			GVariantBuilder array_builder;
 			const struct in6_addr *gateway = nm_ip6_config_get_gateway (config);
 			int naddr = nm_ip6_config_get_num_addresses (config);
@@ -1979,44 +2639,17 @@ get_property (GObject *object, guint prop_id,
 				                                                  16, 1));
 			}
 
-			g_value_take_variant (value, g_variant_builder_end (&array_builder));
+			priv->addresses_variant = g_variant_ref_sink (g_variant_builder_end (&array_builder));
 		}
+		g_value_set_variant (value, priv->addresses_variant);
 		break;
 	case PROP_ROUTE_DATA:
-		{
-			GVariantBuilder array_builder, route_builder;
-			guint nroutes = nm_ip6_config_get_num_routes (config);
-			int i;
-
-			g_variant_builder_init (&array_builder, G_VARIANT_TYPE ("aa{sv}"));
-			for (i = 0; i < nroutes; i++) {
-				const NMPlatformIP6Route *route = nm_ip6_config_get_route (config, i);
-
-				g_variant_builder_init (&route_builder, G_VARIANT_TYPE ("a{sv}"));
-				g_variant_builder_add (&route_builder, "{sv}",
-				                       "dest",
-				                       g_variant_new_string (nm_utils_inet6_ntop (&route->network, NULL)));
-				g_variant_builder_add (&route_builder, "{sv}",
-				                       "prefix",
-				                       g_variant_new_uint32 (route->plen));
-				if (!IN6_IS_ADDR_UNSPECIFIED (&route->gateway)) {
-					g_variant_builder_add (&route_builder, "{sv}",
-					                       "next-hop",
-					                       g_variant_new_string (nm_utils_inet6_ntop (&route->gateway, NULL)));
-				}
-
-				g_variant_builder_add (&route_builder, "{sv}",
-				                       "metric",
-				                       g_variant_new_uint32 (route->metric));
-
-				g_variant_builder_add (&array_builder, "a{sv}", &route_builder);
-			}
-
-			g_value_take_variant (value, g_variant_builder_end (&array_builder));
-		}
+		if (!priv->route_data_variant)
+			priv->route_data_variant = g_variant_ref_sink (_route_data_build (config));
+		g_value_set_variant (value, priv->route_data_variant);
 		break;
 	case PROP_ROUTES:
-		{
+		if (!priv->routes_variant) {
 			GVariantBuilder array_builder;
 			int nroutes = nm_ip6_config_get_num_routes (config);
 			int i;
@@ -2039,8 +2672,9 @@ get_property (GObject *object, guint prop_id,
 				                       (guint32) route->metric);
 			}
 
-			g_value_take_variant (value, g_variant_builder_end (&array_builder));
+			priv->routes_variant = g_variant_ref_sink (g_variant_builder_end (&array_builder));
 		}
+		g_value_set_variant (value, priv->routes_variant);
 		break;
 	case PROP_GATEWAY:
 		if (!IN6_IS_ADDR_UNSPECIFIED (&priv->gateway))
@@ -2098,6 +2732,7 @@ nm_ip6_config_class_init (NMIP6ConfigClass *config_class)
 	/* virtual methods */
 	object_class->get_property = get_property;
 	object_class->set_property = set_property;
+	object_class->notify = notify;
 	object_class->finalize = finalize;
 
 	/* properties */
@@ -2160,6 +2795,20 @@ nm_ip6_config_class_init (NMIP6ConfigClass *config_class)
 
 	g_object_class_install_properties (object_class, _PROPERTY_ENUMS_LAST, obj_properties);
 
+	signals[ROUTES_ADDED] =
+		g_signal_new (NM_IP6_CONFIG_ROUTES_ADDED,
+		              G_OBJECT_CLASS_TYPE (object_class),
+		              G_SIGNAL_RUN_FIRST,
+		              0, NULL, NULL, NULL,
+		              G_TYPE_NONE, 1, G_TYPE_VARIANT);
+
+	signals[ROUTES_REMOVED] =
+		g_signal_new (NM_IP6_CONFIG_ROUTES_REMOVED,
+		              G_OBJECT_CLASS_TYPE (object_class),
+		              G_SIGNAL_RUN_FIRST,
+		              0, NULL, NULL, NULL,
+		              G_TYPE_NONE, 1, G_TYPE_VARIANT);
+
 	nm_exported_object_class_add_interface (NM_EXPORTED_OBJECT_CLASS (config_class),
 	                                        NMDBUS_TYPE_IP6_CONFIG_SKELETON,
 	                                        NULL);
@@ -62,6 +62,10 @@ typedef struct {
 #define NM_IP6_CONFIG_ADDRESSES "addresses"
 #define NM_IP6_CONFIG_ROUTES "routes"
 
+/* signals */
+#define NM_IP6_CONFIG_ROUTES_ADDED   "routes-added"
+#define NM_IP6_CONFIG_ROUTES_REMOVED "routes-removed"
+
 GType nm_ip6_config_get_type (void);
 
 
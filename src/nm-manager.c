@@ -406,19 +406,18 @@ GSList *
 nm_manager_get_activatable_connections (NMManager *manager)
 {
 	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (manager);
-	GSList *all_connections = nm_settings_get_connections (priv->settings);
-	GSList *connections = NULL, *iter;
-	NMSettingsConnection *connection;
+	NMSettingsConnection *const*all_connections;
+	GSList *connections = NULL;
+	guint i;
 
-	for (iter = all_connections; iter; iter = iter->next) {
-		connection = iter->data;
+	all_connections = nm_settings_get_connections_sorted (priv->settings, &i);
+	while (i > 0) {
+		NMSettingsConnection *connection = all_connections[--i];
 
 		if (!find_ac_for_connection (manager, NM_CONNECTION (connection)))
 			connections = g_slist_prepend (connections, connection);
 	}
-
-	g_slist_free (all_connections);
-	return g_slist_reverse (connections);
+	return connections;
 }
 
 static NMActiveConnection *
@@ -452,6 +451,9 @@ _config_changed_cb (NMConfig *config, NMConfigData *config_data, NMConfigChangeF
 
 	if (NM_FLAGS_HAS (changes, NM_CONFIG_CHANGE_GLOBAL_DNS_CONFIG))
 		g_object_notify (G_OBJECT (self), NM_MANAGER_GLOBAL_DNS_CONFIGURATION);
+
+	if (NM_FLAGS_HAS (changes, NM_CONFIG_CHANGE_SIGUSR2))
+		nm_platform_stats_log (NM_PLATFORM_GET, LOGL_INFO);
 }
 
 /************************************************************************/
@@ -1012,7 +1014,8 @@ system_create_virtual_device (NMManager *self, NMConnection *connection)
 {
 	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (self);
 	NMDeviceFactory *factory;
-	gs_free_slist GSList *connections = NULL;
+	NMSettingsConnection *const*connections;
+	guint i, len;
 	GSList *iter;
 	gs_free char *iface = NULL;
 	NMDevice *device = NULL, *parent = NULL;
@@ -1081,9 +1084,9 @@ system_create_virtual_device (NMManager *self, NMConnection *connection)
 	}
 
 	/* Create backing resources if the device has any autoconnect connections */
-	connections = nm_settings_get_connections (priv->settings);
-	for (iter = connections; iter; iter = g_slist_next (iter)) {
-		NMConnection *candidate = iter->data;
+	connections = nm_settings_get_connections_sorted (priv->settings, &len);
+	for (i = 0; i < len; i++) {
+		NMConnection *candidate = NM_CONNECTION (connections[i]);
 		NMSettingConnection *s_con;
 
 		if (!nm_device_check_connection_compatible (device, candidate))
@@ -2602,7 +2605,8 @@ find_slaves (NMManager *manager,
              NMDevice *device)
 {
 	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (manager);
-	GSList *all_connections, *iter;
+	NMSettingsConnection *const*all_connections;
+	guint i, len;
 	GSList *slaves = NULL;
 	NMSettingConnection *s_con;
 	const char *master;
@@ -2618,11 +2622,11 @@ find_slaves (NMManager *manager,
 	 * even if a slave was already active, it might be deactivated during
 	 * master reactivation.
 	 */
-	all_connections = nm_settings_get_connections (priv->settings);
-	for (iter = all_connections; iter; iter = iter->next) {
+	all_connections = nm_settings_get_connections_sorted (priv->settings, &len);
+	for (i = 0; i < len; i++) {
 		NMSettingsConnection *master_connection = NULL;
 		NMDevice *master_device = NULL;
-		NMConnection *candidate = iter->data;
+		NMConnection *candidate = NM_CONNECTION (all_connections[i]);
 
 		find_master (manager, candidate, NULL, &master_connection, &master_device, NULL, NULL);
 		if (   (master_connection && master_connection == connection)
@@ -2630,7 +2634,6 @@ find_slaves (NMManager *manager,
 			slaves = g_slist_prepend (slaves, candidate);
 		}
 	}
-	g_slist_free (all_connections);
 
 	return g_slist_reverse (slaves);
 }
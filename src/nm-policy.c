@@ -823,7 +823,8 @@ static void
 reset_autoconnect_all (NMPolicy *policy, NMDevice *device)
 {
 	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (policy);
-	GSList *connections, *iter;
+	NMSettingsConnection *const*connections;
+	guint i, len;
 
 	if (device) {
 		nm_log_dbg (LOGD_DEVICE, "Re-enabling autoconnect for all connections on %s",
@@ -831,41 +832,41 @@ reset_autoconnect_all (NMPolicy *policy, NMDevice *device)
 	} else
 		nm_log_dbg (LOGD_DEVICE, "Re-enabling autoconnect for all connections");
 
-	connections = nm_settings_get_connections (priv->settings);
-	for (iter = connections; iter; iter = g_slist_next (iter)) {
-		if (!device || nm_device_check_connection_compatible (device, iter->data)) {
-			nm_settings_connection_reset_autoconnect_retries (iter->data);
-			nm_settings_connection_set_autoconnect_blocked_reason (iter->data, NM_DEVICE_STATE_REASON_NONE);
+	connections = nm_settings_get_connections_sorted (priv->settings, &len);
+	for (i = 0; i < len; i++) {
+		if (!device || nm_device_check_connection_compatible (device, NM_CONNECTION (connections[i]))) {
+			nm_settings_connection_reset_autoconnect_retries (connections[i]);
+			nm_settings_connection_set_autoconnect_blocked_reason (connections[i], NM_DEVICE_STATE_REASON_NONE);
 		}
 	}
-	g_slist_free (connections);
 }
 
 static void
 reset_autoconnect_for_failed_secrets (NMPolicy *policy)
 {
 	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (policy);
-	GSList *connections, *iter;
+	NMSettingsConnection *const*connections;
+	guint i, len;
 
 	nm_log_dbg (LOGD_DEVICE, "Re-enabling autoconnect for all connections with failed secrets");
 
-	connections = nm_settings_get_connections (priv->settings);
-	for (iter = connections; iter; iter = g_slist_next (iter)) {
-		NMSettingsConnection *connection = NM_SETTINGS_CONNECTION (iter->data);
+	connections = nm_settings_get_connections_sorted (priv->settings, &len);
+	for (i = 0; i < len; i++) {
+		NMSettingsConnection *connection = connections[i];
 
 		if (nm_settings_connection_get_autoconnect_blocked_reason (connection) == NM_DEVICE_STATE_REASON_NO_SECRETS) {
 			nm_settings_connection_reset_autoconnect_retries (connection);
 			nm_settings_connection_set_autoconnect_blocked_reason (connection, NM_DEVICE_STATE_REASON_NONE);
 		}
 	}
-	g_slist_free (connections);
 }
 
 static void
 block_autoconnect_for_device (NMPolicy *policy, NMDevice *device)
 {
 	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (policy);
-	GSList *connections, *iter;
+	NMSettingsConnection *const*connections;
+	guint i, len;
 
 	nm_log_dbg (LOGD_DEVICE, "Blocking autoconnect for all connections on %s",
 	            nm_device_get_iface (device));
@@ -877,10 +878,10 @@ block_autoconnect_for_device (NMPolicy *policy, NMDevice *device)
 	if (!nm_device_is_software (device))
 		return;
 
-	connections = nm_settings_get_connections (priv->settings);
-	for (iter = connections; iter; iter = g_slist_next (iter)) {
-		if (nm_device_check_connection_compatible (device, iter->data)) {
-			nm_settings_connection_set_autoconnect_blocked_reason (NM_SETTINGS_CONNECTION (iter->data),
+	connections = nm_settings_get_connections_sorted (priv->settings, &len);
+	for (i = 0; i < len; i++) {
+		if (nm_device_check_connection_compatible (device, NM_CONNECTION (connections[i]))) {
+			nm_settings_connection_set_autoconnect_blocked_reason (connections[i],
 			                                                       NM_DEVICE_STATE_REASON_USER_REQUESTED);
 		}
 	}
@@ -950,7 +951,8 @@ reset_connections_retries (gpointer user_data)
 {
 	NMPolicy *policy = (NMPolicy *) user_data;
 	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (policy);
-	GSList *connections, *iter;
+	NMSettingsConnection *const*connections;
+	guint i, len;
 	gint32 con_stamp, min_stamp, now;
 	gboolean changed = FALSE;
 
@@ -958,9 +960,9 @@ reset_connections_retries (gpointer user_data)
 
 	min_stamp = 0;
 	now = nm_utils_get_monotonic_timestamp_s ();
-	connections = nm_settings_get_connections (priv->settings);
-	for (iter = connections; iter; iter = g_slist_next (iter)) {
-		NMSettingsConnection *connection = NM_SETTINGS_CONNECTION (iter->data);
+	connections = nm_settings_get_connections_sorted (priv->settings, &len);
+	for (i = 0; i < len; i++) {
+		NMSettingsConnection *connection = connections[i];
 
 		con_stamp = nm_settings_connection_get_autoconnect_retry_time (connection);
 		if (con_stamp == 0)
@@ -972,7 +974,6 @@ reset_connections_retries (gpointer user_data)
 		} else if (min_stamp == 0 || min_stamp > con_stamp)
 			min_stamp = con_stamp;
 	}
-	g_slist_free (connections);
 
 	/* Schedule the handler again if there are some stamps left */
 	if (min_stamp != 0)
@@ -992,7 +993,8 @@ activate_slave_connections (NMPolicy *policy, NMDevice *device)
 {
 	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (policy);
 	const char *master_device, *master_uuid_settings = NULL, *master_uuid_applied = NULL;
-	GSList *connections, *iter;
+	NMSettingsConnection *const*connections;
+	guint i, len;
 	NMActRequest *req;
 
 	master_device = nm_device_get_iface (device);
@@ -1013,13 +1015,13 @@ activate_slave_connections (NMPolicy *policy, NMDevice *device)
 		}
 	}
 
-	connections = nm_settings_get_connections (priv->settings);
-	for (iter = connections; iter; iter = g_slist_next (iter)) {
+	connections = nm_settings_get_connections_sorted (priv->settings, &len);
+	for (i = 0; i < len; i++) {
 		NMConnection *slave;
 		NMSettingConnection *s_slave_con;
 		const char *slave_master;
 
-		slave = NM_CONNECTION (iter->data);
+		slave = NM_CONNECTION (connections[i]);
 		g_assert (slave);
 
 		s_slave_con = nm_connection_get_setting_connection (slave);
@@ -1034,8 +1036,6 @@ activate_slave_connections (NMPolicy *policy, NMDevice *device)
 			nm_settings_connection_reset_autoconnect_retries (NM_SETTINGS_CONNECTION (slave));
 	}
 
-	g_slist_free (connections);
-
 	schedule_activate_all (policy);
 }
 
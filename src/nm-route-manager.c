@@ -28,13 +28,12 @@
 #include "nm-core-internal.h"
 #include "nm-default.h"
 #include "NetworkManagerUtils.h"
+#include "nm-expiry-queue.h"
 
 /* if within half a second after adding an IP address a matching device-route shows
  * up, we delete it. */
 #define IP4_DEVICE_ROUTES_WAIT_TIME_NS                 (NM_UTILS_NS_PER_SECOND / 2)
 
-#define IP4_DEVICE_ROUTES_GC_INTERVAL_SEC              (IP4_DEVICE_ROUTES_WAIT_TIME_NS * 2)
-
 typedef struct {
 	guint len;
 	NMPlatformIPXRoute *entries[1];
@@ -50,11 +49,51 @@ typedef struct {
 	/* this array contains the effective metrics but using the reversed index that corresponds
 	 * to @entries, instead of @index. */
 	GArray *effective_metrics_reverse;
+
+	/* the RouteIfindexState of the ifindexes that were synced. */
+	GHashTable *ifindex_states;
 } RouteEntries;
 
+typedef struct {
+	/* all non-default routes in platform on the ifindex, sorted by @route_id_cmp().
+	 * The routes are fetched once and afterwards kept up to date from
+	 * NM_PLATFORM_SIGNAL_CHANGES, so that a sync does not need to fetch and
+	 * sort the routes again. */
+	GSequence *plat_routes;
+
+	/* the destinations whose routes changed since the last sync, either in
+	 * platform or because the effective metric of a route changed. The keys
+	 * are routes, compared by their destination. */
+	GHashTable *dirty_dests;
+
+	/* the routes of @ipx_routes on the ifindex, that is the known routes of the
+	 * last sync without default routes and duplicates, sorted by @route_id_cmp(). */
+	GArray *synced_routes;
+
+	/* whether the last sync succeeded. Then platform is in the state it left,
+	 * except for the routes with a destination in @dirty_dests, and the
+	 * next sync only needs to look at those and at the changed known routes. */
+	bool synced:1;
+	bool synced_ignore_kernel_routes:1;
+	bool synced_full_sync:1;
+} RouteIfindexState;
+
+typedef struct {
+	guint batch_idx;
+	const NMPlatformIPXRoute *route;
+	gint64 effective_metric;
+	bool replace;
+} RouteBatchAdd;
+
+typedef enum {
+	PLAT_ROUTE_DELETE_FIRST,
+	PLAT_ROUTE_DELETE_LAST,
+	PLAT_ROUTE_DELETE_SKIP,
+} PlatRouteDeleteOrder;
+
 typedef struct {
 	NMRouteManager *self;
-	gint64 scheduled_at_ns;
+	NMExpiryQueueNode expiry_node;
 	guint idle_id;
 	NMPObject *obj;
 } IP4DeviceRoutePurgeEntry;
@@ -66,7 +105,8 @@ typedef struct {
 	RouteEntries ip6_routes;
 	struct {
 		GHashTable *entries;
-		guint gc_id;
+		NMExpiryQueue *expiry;
+		bool watching;
 	} ip4_device_routes;
 } NMRouteManagerPrivate;
 
@@ -89,6 +129,10 @@ typedef struct {
 
 	/* a compare function for two routes that considers only the fields network/plen,metric. */
 	int (*route_id_cmp) (const NMPlatformIPXRoute *r1, const NMPlatformIPXRoute *r2);
+
+	/* hash and equal functions that consider only the destination, like @route_dest_cmp(). */
+	GHashFunc route_dest_hash;
+	GEqualFunc route_dest_equal;
 } VTableIP;
 
 static const VTableIP vtable_v4, vtable_v6;
@@ -143,7 +187,7 @@ static const VTableIP vtable_v4, vtable_v6;
 
 /*********************************************************************************************/
 
-static gboolean _ip4_device_routes_cancel (NMRouteManager *self);
+static void _ip4_device_routes_cancel (NMRouteManager *self);
 
 /*********************************************************************************************/
 
@@ -222,6 +266,45 @@ _v6_route_dest_cmp (const NMPlatformIP6Route *r1, const NMPlatformIP6Route *r2)
 	return memcmp (&n1, &n2, sizeof (n1));
 }
 
+static guint
+_v4_route_dest_hash (const NMPlatformIP4Route *r)
+{
+	guint hash;
+
+	hash = (guint) 1729370651u;
+	hash = hash * 33 + ((guint) r->plen);
+	hash = hash * 33 + ((guint) nm_utils_ip4_address_clear_host_address (r->network, r->plen));
+	return hash;
+}
+
+static gboolean
+_v4_route_dest_equal (const NMPlatformIP4Route *r1, const NMPlatformIP4Route *r2)
+{
+	return _v4_route_dest_cmp (r1, r2) == 0;
+}
+
+static guint
+_v6_route_dest_hash (const NMPlatformIP6Route *r)
+{
+	struct in6_addr n;
+	guint hash;
+	guint i;
+
+	nm_utils_ip6_address_clear_host_address (&n, &r->network, r->plen);
+
+	hash = (guint) 2338510427u;
+	hash = hash * 33 + ((guint) r->plen);
+	for (i = 0; i < sizeof (n); i++)
+		hash = hash * 33 + n.s6_addr[i];
+	return hash;
+}
+
+static gboolean
+_v6_route_dest_equal (const NMPlatformIP6Route *r1, const NMPlatformIP6Route *r2)
+{
+	return _v6_route_dest_cmp (r1, r2) == 0;
+}
+
 static int
 _v4_route_id_cmp (const NMPlatformIP4Route *r1, const NMPlatformIP4Route *r2)
 {
@@ -288,6 +371,142 @@ _vx_route_id_cmp_full (const NMPlatformIPXRoute *r1, const NMPlatformIPXRoute *r
 	return vtable->route_id_cmp (r1, r2);
 }
 
+static int
+_route_index_create_dest_sort (const NMPlatformIPXRoute **p1, const NMPlatformIPXRoute **p2, const VTableIP *vtable)
+{
+	return vtable->route_dest_cmp (*p1, *p2);
+}
+
+/* create an index of the destinations in @dests, sorted by @route_dest_cmp(). */
+static RouteIndex *
+_route_index_create_from_dests (const VTableIP *vtable, GHashTable *dests)
+{
+	RouteIndex *index;
+	GHashTableIter iter;
+	gpointer dest;
+	guint len = 0;
+
+	index = g_malloc (sizeof (RouteIndex) + g_hash_table_size (dests) * sizeof (NMPlatformIPXRoute *));
+
+	g_hash_table_iter_init (&iter, dests);
+	while (g_hash_table_iter_next (&iter, &dest, NULL))
+		index->entries[len++] = dest;
+	index->entries[len] = NULL;
+	index->len = len;
+
+	g_qsort_with_data (index->entries,
+	                   len,
+	                   sizeof (NMPlatformIPXRoute *),
+	                   (GCompareDataFunc) _route_index_create_dest_sort,
+	                   (gpointer) vtable);
+	return index;
+}
+
+/* create an index of the routes in @index that have one of the destinations
+ * in @dests. Both must be sorted by destination. */
+static RouteIndex *
+_route_index_select (const VTableIP *vtable, const RouteIndex *index, const RouteIndex *dests)
+{
+	RouteIndex *selected;
+	guint i, j = 0, len = 0;
+
+	selected = g_malloc (sizeof (RouteIndex) + index->len * sizeof (NMPlatformIPXRoute *));
+
+	for (i = 0; i < index->len; i++) {
+		int c = 1;
+
+		while (   j < dests->len
+		       && (c = vtable->route_dest_cmp (dests->entries[j], index->entries[i])) < 0)
+			j++;
+		if (j == dests->len)
+			break;
+		if (c == 0)
+			selected->entries[len++] = index->entries[i];
+	}
+	selected->entries[len] = NULL;
+	selected->len = len;
+	return selected;
+}
+
+/* return the position of the first route in @index with the destination of @dest. */
+static guint
+_route_index_find_dest (const VTableIP *vtable, const RouteIndex *index, const NMPlatformIPXRoute *dest)
+{
+	guint lo = 0, hi = index->len, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (vtable->route_dest_cmp (index->entries[mid], dest) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+typedef struct {
+	const VTableIP *vtable;
+	const NMPlatformIPXRoute *needle;
+} PlatRoutesSearchData;
+
+/* compares by destination, but sorts @needle before the routes with the same destination. */
+static int
+_plat_routes_search_cmp (const NMPlatformIPXRoute *r1, const NMPlatformIPXRoute *r2, const PlatRoutesSearchData *data)
+{
+	int c;
+
+	c = data->vtable->route_dest_cmp (r1, r2);
+	if (c != 0)
+		return c;
+	if (r1 == data->needle)
+		return -1;
+	if (r2 == data->needle)
+		return 1;
+	return 0;
+}
+
+static void
+_plat_routes_index_append (const VTableIP *vtable, RouteIndex *index, GSequenceIter *iter, const NMPlatformIPXRoute *dest, gboolean ignore_kernel_routes)
+{
+	for (; !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter)) {
+		NMPlatformIPXRoute *r = g_sequence_get (iter);
+
+		if (   dest
+		    && vtable->route_dest_cmp (r, dest) != 0)
+			break;
+		if (   ignore_kernel_routes
+		    && r->rx.source == NM_IP_CONFIG_SOURCE_RTPROT_KERNEL)
+			continue;
+		index->entries[index->len++] = r;
+	}
+}
+
+/* create an index of the sorted @plat_routes. If @dests is given, it only
+ * contains the routes with one of these destinations. */
+static RouteIndex *
+_plat_routes_index_create (const VTableIP *vtable, GSequence *plat_routes, const RouteIndex *dests, gboolean ignore_kernel_routes)
+{
+	RouteIndex *index;
+	PlatRoutesSearchData data = { .vtable = vtable };
+	guint i;
+
+	index = g_malloc (sizeof (RouteIndex) + g_sequence_get_length (plat_routes) * sizeof (NMPlatformIPXRoute *));
+	index->len = 0;
+
+	if (!dests)
+		_plat_routes_index_append (vtable, index, g_sequence_get_begin_iter (plat_routes), NULL, ignore_kernel_routes);
+	else {
+		for (i = 0; i < dests->len; i++) {
+			data.needle = dests->entries[i];
+			_plat_routes_index_append (vtable, index,
+			                           g_sequence_search (plat_routes, (gpointer) data.needle, (GCompareDataFunc) _plat_routes_search_cmp, &data),
+			                           data.needle, ignore_kernel_routes);
+		}
+	}
+	index->entries[index->len] = NULL;
+	return index;
+}
+
 static gssize
 _route_index_find (const VTableIP *vtable, const RouteIndex *index, const NMPlatformIPXRoute *needle)
 {
@@ -317,6 +536,49 @@ _route_index_find (const VTableIP *vtable, const RouteIndex *index, const NMPlat
 	return ~idx;
 }
 
+static int
+_vx_route_dest_cmp_full (const NMPlatformIPXRoute *r1, const NMPlatformIPXRoute *r2, const VTableIP *vtable)
+{
+	return vtable->route_dest_cmp (r1, r2);
+}
+
+/* Determine when to delete @plat_route, a route on @ifindex that is about to be
+ * removed from platform. If we configure a route with the same destination on
+ * @ifindex but a different metric, delete @plat_route only after adding the new
+ * one, so that there is no moment without route to the destination. The kernel
+ * identifies a route by destination and metric, so changing the metric cannot be
+ * done by replacing the route in place.
+ * If we configure a route with the very same destination and metric, don't delete
+ * @plat_route at all. Instead it gets replaced when syncing @ipx_routes below. */
+static PlatRouteDeleteOrder
+_plat_route_delete_order (const VTableIP *vtable,
+                          const RouteIndex *index,
+                          const gint64 *effective_metrics,
+                          int ifindex,
+                          const NMPlatformIPXRoute *plat_route)
+{
+	PlatRouteDeleteOrder order = PLAT_ROUTE_DELETE_FIRST;
+	gssize idx, i;
+
+	idx = _nm_utils_ptrarray_find_binary_search ((gpointer *) index->entries, index->len, (gpointer) plat_route, (GCompareDataFunc) _vx_route_dest_cmp_full, (gpointer) vtable);
+	if (idx < 0)
+		return PLAT_ROUTE_DELETE_FIRST;
+
+	/* the index is sorted by destination, so all routes with the destination of
+	 * @plat_route are around @idx. */
+	while (idx > 0 && vtable->route_dest_cmp (index->entries[idx - 1], plat_route) == 0)
+		idx--;
+	for (i = idx; i < index->len && vtable->route_dest_cmp (index->entries[i], plat_route) == 0; i++) {
+		if (   index->entries[i]->rx.ifindex != ifindex
+		    || effective_metrics[i] == -1)
+			continue;
+		if (effective_metrics[i] == plat_route->rx.metric)
+			return PLAT_ROUTE_DELETE_SKIP;
+		order = PLAT_ROUTE_DELETE_LAST;
+	}
+	return order;
+}
+
 static guint
 _route_index_reverse_idx (const VTableIP *vtable, const RouteIndex *index, guint idx_idx, const GArray *routes)
 {
@@ -355,22 +617,49 @@ _route_equals_ignoring_ifindex (const VTableIP *vtable, const NMPlatformIPXRoute
 	return vtable->vt->route_cmp (r1, r2) == 0;
 }
 
-static NMPlatformIPXRoute *
-_get_next_ipx_route (const RouteIndex *index, gboolean start_at_zero, guint *cur_idx, int ifindex)
+/* return the positions in @index of the routes on @ifindex, in ascending order.
+ * If @dests is given, only of the routes with one of these destinations. */
+static GArray *
+_ipx_routes_select (const VTableIP *vtable, const RouteIndex *index, int ifindex, const RouteIndex *dests)
 {
-	guint i;
+	GArray *selection;
+	guint i, j;
+
+	selection = g_array_new (FALSE, FALSE, sizeof (guint));
+
+	if (!dests) {
+		for (i = 0; i < index->len; i++) {
+			if (index->entries[i]->rx.ifindex == ifindex)
+				g_array_append_val (selection, i);
+		}
+		return selection;
+	}
+
+	for (j = 0; j < dests->len; j++) {
+		for (i = _route_index_find_dest (vtable, index, dests->entries[j]);
+		     i < index->len && vtable->route_dest_cmp (index->entries[i], dests->entries[j]) == 0;
+		     i++) {
+			if (index->entries[i]->rx.ifindex == ifindex)
+				g_array_append_val (selection, i);
+		}
+	}
+	return selection;
+}
 
+static NMPlatformIPXRoute *
+_get_next_ipx_route (const RouteIndex *index, const GArray *selection, gboolean start_at_zero, guint *cur_sel, guint *cur_idx)
+{
 	if (start_at_zero)
-		i = 0;
+		*cur_sel = 0;
 	else
-		i = *cur_idx + 1;
-	/* Find the next route with matching @ifindex. */
-	for (; i < index->len; i++) {
-		if (index->entries[i]->rx.ifindex == ifindex) {
-			*cur_idx = i;
-			return index->entries[i];
-		}
+		++*cur_sel;
+
+	/* get the next route from the positions in @selection. */
+	if (*cur_sel < selection->len) {
+		*cur_idx = g_array_index (selection, guint, *cur_sel);
+		return index->entries[*cur_idx];
 	}
+	*cur_sel = selection->len;
 	*cur_idx = index->len;
 	return NULL;
 }
@@ -430,40 +719,321 @@ _sort_indexes_cmp (guint *a, guint *b)
 
 /*********************************************************************************************/
 
+static void
+_route_dest_set_add (const VTableIP *vtable, GHashTable *dests, const NMPlatformIPXRoute *route)
+{
+	if (!g_hash_table_contains (dests, route))
+		g_hash_table_add (dests, g_memdup (route, vtable->vt->sizeof_route));
+}
+
+static GHashTable *
+_route_dest_set_new (const VTableIP *vtable)
+{
+	return g_hash_table_new_full (vtable->route_dest_hash, vtable->route_dest_equal, g_free, NULL);
+}
+
+static void
+_route_ifindex_state_free (RouteIfindexState *state)
+{
+	g_sequence_free (state->plat_routes);
+	g_hash_table_unref (state->dirty_dests);
+	if (state->synced_routes)
+		g_array_unref (state->synced_routes);
+	g_slice_free (RouteIfindexState, state);
+}
+
+static RouteIfindexState *
+_route_ifindex_state_get (const VTableIP *vtable, NMRouteManager *self, int ifindex)
+{
+	NMRouteManagerPrivate *priv = NM_ROUTE_MANAGER_GET_PRIVATE (self);
+	RouteEntries *ipx_routes = vtable->vt->is_ip4 ? &priv->ip4_routes : &priv->ip6_routes;
+	RouteIfindexState *state;
+	gs_unref_array GArray *routes = NULL;
+	guint i;
+
+	state = g_hash_table_lookup (ipx_routes->ifindex_states, GINT_TO_POINTER (ifindex));
+	if (state)
+		return state;
+
+	state = g_slice_new0 (RouteIfindexState);
+	state->plat_routes = g_sequence_new (g_free);
+	state->dirty_dests = _route_dest_set_new (vtable);
+
+	routes = vtable->vt->route_get_all (priv->platform, ifindex,
+	                                    NM_PLATFORM_GET_ROUTE_FLAGS_WITH_NON_DEFAULT | NM_PLATFORM_GET_ROUTE_FLAGS_WITH_RTPROT_KERNEL);
+	g_array_sort_with_data (routes, (GCompareDataFunc) _vx_route_id_cmp_full, (gpointer) vtable);
+	for (i = 0; i < routes->len; i++) {
+		g_sequence_append (state->plat_routes,
+		                   g_memdup (VTABLE_ROUTE_INDEX (vtable, routes, i), vtable->vt->sizeof_route));
+	}
+
+	g_hash_table_insert (ipx_routes->ifindex_states, GINT_TO_POINTER (ifindex), state);
+	return state;
+}
+
+#if NM_MORE_ASSERTS && !defined (G_DISABLE_ASSERT)
+inline static void
+ASSERT_route_ifindex_state_valid (const VTableIP *vtable, NMPlatform *platform, int ifindex, const RouteIfindexState *state)
+{
+	gs_unref_array GArray *routes = NULL;
+	GSequenceIter *iter;
+	guint i;
+
+	/* assert that the routes of @state are identical to the routes in platform. */
+	routes = vtable->vt->route_get_all (platform, ifindex,
+	                                    NM_PLATFORM_GET_ROUTE_FLAGS_WITH_NON_DEFAULT | NM_PLATFORM_GET_ROUTE_FLAGS_WITH_RTPROT_KERNEL);
+	g_array_sort_with_data (routes, (GCompareDataFunc) _vx_route_id_cmp_full, (gpointer) vtable);
+
+	g_assert_cmpint (routes->len, ==, g_sequence_get_length (state->plat_routes));
+	iter = g_sequence_get_begin_iter (state->plat_routes);
+	for (i = 0; i < routes->len; i++, iter = g_sequence_iter_next (iter)) {
+		g_assert (vtable->vt->route_cmp (VTABLE_ROUTE_INDEX (vtable, routes, i),
+		                                 g_sequence_get (iter)) == 0);
+	}
+}
+#else
+#define ASSERT_route_ifindex_state_valid(vtable, platform, ifindex, state) G_STMT_START { (void) 0; } G_STMT_END
+#endif
+
+static void
+_route_ifindex_state_add_dirty (const VTableIP *vtable, RouteEntries *ipx_routes, int ifindex, const NMPlatformIPXRoute *route)
+{
+	RouteIfindexState *state;
+
+	state = g_hash_table_lookup (ipx_routes->ifindex_states, GINT_TO_POINTER (ifindex));
+	if (state)
+		_route_dest_set_add (vtable, state->dirty_dests, route);
+}
+
+/* add the destinations of the routes that differ between the @synced_routes
+ * of the last sync and @known_routes_idx to @dests. */
+static void
+_route_ifindex_state_add_changed_dests (const VTableIP *vtable,
+                                        const RouteIfindexState *state,
+                                        const RouteIndex *known_routes_idx,
+                                        GHashTable *dests)
+{
+	const NMPlatformIPXRoute *cur_known_route, *cur_synced_route;
+	guint i_known_routes, i_synced_routes = 0;
+
+	cur_known_route = _get_next_known_route (vtable, known_routes_idx, TRUE, &i_known_routes);
+	cur_synced_route = state->synced_routes->len > 0 ? VTABLE_ROUTE_INDEX (vtable, state->synced_routes, 0) : NULL;
+	while (cur_known_route || cur_synced_route) {
+		int c;
+
+		if (!cur_known_route)
+			c = 1;
+		else if (!cur_synced_route)
+			c = -1;
+		else
+			c = vtable->route_id_cmp (cur_known_route, cur_synced_route);
+
+		if (c < 0)
+			_route_dest_set_add (vtable, dests, cur_known_route);
+		else if (c > 0)
+			_route_dest_set_add (vtable, dests, cur_synced_route);
+		else if (vtable->vt->route_cmp (cur_known_route, cur_synced_route) != 0)
+			_route_dest_set_add (vtable, dests, cur_known_route);
+
+		if (c <= 0)
+			cur_known_route = _get_next_known_route (vtable, known_routes_idx, FALSE, &i_known_routes);
+		if (c >= 0) {
+			cur_synced_route =   ++i_synced_routes < state->synced_routes->len
+			                   ? VTABLE_ROUTE_INDEX (vtable, state->synced_routes, i_synced_routes)
+			                   : NULL;
+		}
+	}
+}
+
+static void
+_route_ifindex_state_set_synced (const VTableIP *vtable,
+                                 RouteIfindexState *state,
+                                 const RouteIndex *known_routes_idx,
+                                 gboolean synced,
+                                 gboolean ignore_kernel_routes,
+                                 gboolean full_sync)
+{
+	const NMPlatformIPXRoute *cur_known_route;
+	guint i_known_routes;
+
+	if (!state->synced_routes)
+		state->synced_routes = g_array_sized_new (FALSE, FALSE, vtable->vt->sizeof_route, known_routes_idx->len);
+	else
+		g_array_set_size (state->synced_routes, 0);
+	for (cur_known_route = _get_next_known_route (vtable, known_routes_idx, TRUE, &i_known_routes);
+	     cur_known_route;
+	     cur_known_route = _get_next_known_route (vtable, known_routes_idx, FALSE, &i_known_routes))
+		g_array_append_vals (state->synced_routes, cur_known_route, 1);
+
+	state->synced = !!synced;
+	state->synced_ignore_kernel_routes = !!ignore_kernel_routes;
+	state->synced_full_sync = !!full_sync;
+}
+
+static void
+_vx_route_changed (const VTableIP *vtable, RouteIfindexState *state, const NMPlatformIPXRoute *route, NMPlatformSignalChangeType change_type)
+{
+	GSequenceIter *iter;
+
+	if (NM_PLATFORM_IP_ROUTE_IS_DEFAULT (route))
+		return;
+
+	_route_dest_set_add (vtable, state->dirty_dests, route);
+
+	iter = g_sequence_lookup (state->plat_routes, (gpointer) route, (GCompareDataFunc) _vx_route_id_cmp_full, (gpointer) vtable);
+	if (change_type == NM_PLATFORM_SIGNAL_REMOVED) {
+		if (iter)
+			g_sequence_remove (iter);
+	} else if (iter)
+		memcpy (g_sequence_get (iter), route, vtable->vt->sizeof_route);
+	else {
+		g_sequence_insert_sorted (state->plat_routes,
+		                          g_memdup (route, vtable->vt->sizeof_route),
+		                          (GCompareDataFunc) _vx_route_id_cmp_full,
+		                          (gpointer) vtable);
+	}
+}
+
+static void
+_vx_route_changes (const VTableIP *vtable, RouteEntries *ipx_routes, const NMPlatformChanges *changes)
+{
+	NMPlatformSignalIdType signal_id = vtable->vt->is_ip4 ? NM_PLATFORM_SIGNAL_ID_IP4_ROUTE : NM_PLATFORM_SIGNAL_ID_IP6_ROUTE;
+	const NMPlatformChange *ifindex_changes;
+	GHashTableIter iter;
+	gpointer ifindex;
+	RouteIfindexState *state;
+	guint i, len;
+
+	if (   !changes->objs[signal_id][NM_PLATFORM_SIGNAL_ADDED]
+	    && !changes->objs[signal_id][NM_PLATFORM_SIGNAL_CHANGED]
+	    && !changes->objs[signal_id][NM_PLATFORM_SIGNAL_REMOVED])
+		return;
+
+	g_hash_table_iter_init (&iter, ipx_routes->ifindex_states);
+	while (g_hash_table_iter_next (&iter, &ifindex, (gpointer *) &state)) {
+		ifindex_changes = nm_platform_changes_lookup_ifindex (changes, GPOINTER_TO_INT (ifindex), &len);
+		for (i = 0; i < len; i++) {
+			if (ifindex_changes[i].signal_id != signal_id)
+				continue;
+			_vx_route_changed (vtable, state,
+			                   (const NMPlatformIPXRoute *) nm_platform_changes_get_object (changes, &ifindex_changes[i]),
+			                   ifindex_changes[i].change_type);
+		}
+	}
+}
+
+static void
+_platform_changes_cb (NMPlatform *platform,
+                      const NMPlatformChanges *changes,
+                      NMRouteManager *self)
+{
+	NMRouteManagerPrivate *priv = NM_ROUTE_MANAGER_GET_PRIVATE (self);
+
+	_vx_route_changes (&vtable_v4, &priv->ip4_routes, changes);
+	_vx_route_changes (&vtable_v6, &priv->ip6_routes, changes);
+}
+
+static void
+_link_changed_cb (NMPlatform *platform,
+                  NMPObjectType obj_type,
+                  int ifindex,
+                  const NMPlatformLink *link,
+                  NMPlatformSignalChangeType change_type,
+                  NMRouteManager *self)
+{
+	NMRouteManagerPrivate *priv;
+
+	if (change_type != NM_PLATFORM_SIGNAL_REMOVED)
+		return;
+
+	/* the routes of the link are gone. Don't rely on a change for each of them. */
+	priv = NM_ROUTE_MANAGER_GET_PRIVATE (self);
+	g_hash_table_remove (priv->ip4_routes.ifindex_states, GINT_TO_POINTER (ifindex));
+	g_hash_table_remove (priv->ip6_routes.ifindex_states, GINT_TO_POINTER (ifindex));
+}
+
+/*********************************************************************************************/
+
 static gboolean
 _vx_route_sync (const VTableIP *vtable, NMRouteManager *self, int ifindex, const GArray *known_routes, gboolean ignore_kernel_routes, gboolean full_sync)
 {
 	NMRouteManagerPrivate *priv = NM_ROUTE_MANAGER_GET_PRIVATE (self);
-	GArray *plat_routes;
 	RouteEntries *ipx_routes;
-	RouteIndex *plat_routes_idx, *known_routes_idx;
-	gboolean success = TRUE;
+	RouteIndex *plat_routes_idx, *known_routes_idx, *known_routes_sel_idx;
+	RouteIndex *dirty_dests_idx = NULL;
+	GHashTable *dirty_dests;
+	GArray *ipx_routes_sel;
+	gboolean success = TRUE, committed;
 	guint i, i_type;
 	GArray *to_delete_indexes = NULL;
 	GPtrArray *to_add_routes = NULL;
-	guint i_known_routes, i_plat_routes, i_ipx_routes;
+	guint i_known_routes, i_plat_routes, i_ipx_routes, i_ipx_routes_sel;
 	const NMPlatformIPXRoute *cur_known_route, *cur_plat_route;
 	NMPlatformIPXRoute *cur_ipx_route;
 	gint64 *p_effective_metric = NULL;
 	gboolean ipx_routes_changed = FALSE;
 	gint64 *effective_metrics = NULL;
+	NMPlatformBatch *batch;
+	GArray *batch_adds;
+	GPtrArray *plat_deletes = NULL;
+	RouteIfindexState *state;
 
 	nm_platform_process_events (priv->platform);
 
+	/* bring the states up to date with the pending route changes. */
+	nm_platform_changes_flush (priv->platform);
+
 	ipx_routes = vtable->vt->is_ip4 ? &priv->ip4_routes : &priv->ip6_routes;
-	plat_routes = vtable->vt->route_get_all (priv->platform, ifindex,
-	                                         ignore_kernel_routes
-	                                             ? NM_PLATFORM_GET_ROUTE_FLAGS_WITH_NON_DEFAULT
-	                                             : NM_PLATFORM_GET_ROUTE_FLAGS_WITH_NON_DEFAULT | NM_PLATFORM_GET_ROUTE_FLAGS_WITH_RTPROT_KERNEL);
-	plat_routes_idx = _route_index_create (vtable, plat_routes);
+	state = _route_ifindex_state_get (vtable, self, ifindex);
 	known_routes_idx = _route_index_create (vtable, known_routes);
 
-	effective_metrics = &g_array_index (ipx_routes->effective_metrics, gint64, 0);
-
-	ASSERT_route_index_valid (vtable, plat_routes, plat_routes_idx, TRUE);
+	ASSERT_route_ifindex_state_valid (vtable, priv->platform, ifindex, state);
 	ASSERT_route_index_valid (vtable, known_routes, known_routes_idx, FALSE);
 
-	_LOGD (vtable->vt->addr_family, "%3d: sync %u IPv%c routes", ifindex, known_routes_idx->len, vtable->vt->is_ip4 ? '4' : '6');
+	dirty_dests = state->dirty_dests;
+	state->dirty_dests = _route_dest_set_new (vtable);
+
+	if (   state->synced
+	    && state->synced_ignore_kernel_routes == !!ignore_kernel_routes
+	    && (!full_sync || state->synced_full_sync)) {
+		/* Platform is in the state the last sync left it, except for the routes with
+		 * a destination in @dirty_dests. Routes with different destinations don't
+		 * affect each other, so only sync the routes with a dirty destination or one
+		 * whose known routes changed. Otherwise, sync all routes of the ifindex.
+		 * If the last sync was not a full sync, it didn't remove routes that route-manager
+		 * doesn't know about, and a full sync must consider all routes. */
+		_route_ifindex_state_add_changed_dests (vtable, state, known_routes_idx, dirty_dests);
+		if (g_hash_table_size (dirty_dests) == 0) {
+			_LOGD (vtable->vt->addr_family, "%3d: sync %u IPv%c routes (unchanged)", ifindex, known_routes_idx->len, vtable->vt->is_ip4 ? '4' : '6');
+			g_hash_table_unref (dirty_dests);
+			g_free (known_routes_idx);
+			return TRUE;
+		}
+		dirty_dests_idx = _route_index_create_from_dests (vtable, dirty_dests);
+	}
+
+	/* All changes to platform are queued in @batch and committed at the end
+	 * in one go. The operations are performed in the order they are queued,
+	 * so deletions still happen before additions and device routes are still
+	 * added before gateway routes. Only routes whose metric changes are deleted
+	 * after their replacement was added. */
+	batch = nm_platform_batch_new (priv->platform);
+	batch_adds = g_array_new (FALSE, FALSE, sizeof (RouteBatchAdd));
+
+	/* the routes to sync. Without @dirty_dests_idx, all routes on @ifindex.
+	 * @plat_routes_idx points into @state. It is only valid until the platform
+	 * changes are emitted next, because they update @state. */
+	plat_routes_idx = _plat_routes_index_create (vtable, state->plat_routes, dirty_dests_idx, ignore_kernel_routes);
+	known_routes_sel_idx = dirty_dests_idx ? _route_index_select (vtable, known_routes_idx, dirty_dests_idx) : known_routes_idx;
+	ipx_routes_sel = _ipx_routes_select (vtable, ipx_routes->index, ifindex, dirty_dests_idx);
+
+	effective_metrics = &g_array_index (ipx_routes->effective_metrics, gint64, 0);
+
+	if (dirty_dests_idx) {
+		_LOGD (vtable->vt->addr_family, "%3d: sync %u IPv%c routes (%u destinations changed)",
+		       ifindex, known_routes_idx->len, vtable->vt->is_ip4 ? '4' : '6', dirty_dests_idx->len);
+	} else
+		_LOGD (vtable->vt->addr_family, "%3d: sync %u IPv%c routes", ifindex, known_routes_idx->len, vtable->vt->is_ip4 ? '4' : '6');
 	if (_LOGt_ENABLED (vtable->vt->addr_family)) {
 		for (i = 0; i < known_routes_idx->len; i++) {
 			_LOGt (vtable->vt->addr_family, "%3d: sync new route #%u: %s",
@@ -484,8 +1054,8 @@ _vx_route_sync (const VTableIP *vtable, NMRouteManager *self, int ifindex, const
 	 **************************************************************************/
 
 	/* iterate over @ipx_routes and @known_routes */
-	cur_ipx_route = _get_next_ipx_route (ipx_routes->index, TRUE, &i_ipx_routes, ifindex);
-	cur_known_route = _get_next_known_route (vtable, known_routes_idx, TRUE, &i_known_routes);
+	cur_ipx_route = _get_next_ipx_route (ipx_routes->index, ipx_routes_sel, TRUE, &i_ipx_routes_sel, &i_ipx_routes);
+	cur_known_route = _get_next_known_route (vtable, known_routes_sel_idx, TRUE, &i_known_routes);
 	while (cur_ipx_route || cur_known_route) {
 		int route_id_cmp_result = -1;
 
@@ -499,7 +1069,7 @@ _vx_route_sync (const VTableIP *vtable, NMRouteManager *self, int ifindex, const
 			g_array_append_val (to_delete_indexes, i_ipx_routes);
 
 			/* find the next @cur_ipx_route with matching ifindex. */
-			cur_ipx_route = _get_next_ipx_route (ipx_routes->index, FALSE, &i_ipx_routes, ifindex);
+			cur_ipx_route = _get_next_ipx_route (ipx_routes->index, ipx_routes_sel, FALSE, &i_ipx_routes_sel, &i_ipx_routes);
 		}
 		if (   cur_ipx_route
 		    && cur_known_route
@@ -525,9 +1095,9 @@ _vx_route_sync (const VTableIP *vtable, NMRouteManager *self, int ifindex, const
 		}
 
 		if (cur_ipx_route && (!cur_known_route || route_id_cmp_result == 0))
-			cur_ipx_route = _get_next_ipx_route (ipx_routes->index, FALSE, &i_ipx_routes, ifindex);
+			cur_ipx_route = _get_next_ipx_route (ipx_routes->index, ipx_routes_sel, FALSE, &i_ipx_routes_sel, &i_ipx_routes);
 		if (cur_known_route)
-			cur_known_route = _get_next_known_route (vtable, known_routes_idx, FALSE, &i_known_routes);
+			cur_known_route = _get_next_known_route (vtable, known_routes_sel_idx, FALSE, &i_known_routes);
 	}
 
 	if (!full_sync && to_delete_indexes) {
@@ -573,7 +1143,9 @@ _vx_route_sync (const VTableIP *vtable, NMRouteManager *self, int ifindex, const
 				 * in platform. Delete it. */
 				_LOGt (vtable->vt->addr_family, "%3d: platform rt-rm #%u - %s", ifindex, i_plat_routes,
 				       vtable->vt->route_to_string (cur_plat_route, NULL, 0));
-				vtable->vt->route_delete (priv->platform, ifindex, cur_plat_route);
+				if (!plat_deletes)
+					plat_deletes = g_ptr_array_new ();
+				g_ptr_array_add (plat_deletes, (gpointer) cur_plat_route);
 			}
 		}
 	}
@@ -618,6 +1190,10 @@ _vx_route_sync (const VTableIP *vtable, NMRouteManager *self, int ifindex, const
 		ipx_routes->index = _route_index_create (vtable, ipx_routes->entries);
 		ipx_routes_changed = TRUE;
 		ASSERT_route_index_valid (vtable, ipx_routes->entries, ipx_routes->index, TRUE);
+
+		/* the positions changed with the new index. */
+		g_array_unref (ipx_routes_sel);
+		ipx_routes_sel = _ipx_routes_select (vtable, ipx_routes->index, ifindex, dirty_dests_idx);
 	}
 
 	if (ipx_routes_changed) {
@@ -712,7 +1288,7 @@ next:
 
 		/* iterate over @plat_routes and @ipx_routes */
 		cur_plat_route = _get_next_plat_route (plat_routes_idx, TRUE, &i_plat_routes);
-		cur_ipx_route = _get_next_ipx_route (ipx_routes->index, TRUE, &i_ipx_routes, ifindex);
+		cur_ipx_route = _get_next_ipx_route (ipx_routes->index, ipx_routes_sel, TRUE, &i_ipx_routes_sel, &i_ipx_routes);
 		if (cur_ipx_route)
 			p_effective_metric = &effective_metrics[i_ipx_routes];
 		while (cur_plat_route) {
@@ -730,7 +1306,7 @@ next:
 				    && *p_effective_metric >= cur_plat_route->rx.metric) {
 					break;
 				}
-				cur_ipx_route = _get_next_ipx_route (ipx_routes->index, FALSE, &i_ipx_routes, ifindex);
+				cur_ipx_route = _get_next_ipx_route (ipx_routes->index, ipx_routes_sel, FALSE, &i_ipx_routes_sel, &i_ipx_routes);
 				if (cur_ipx_route)
 					p_effective_metric = &effective_metrics[i_ipx_routes];
 			}
@@ -738,13 +1314,40 @@ next:
 			/* if @cur_ipx_route is not equal to @plat_route, the route must be deleted. */
 			if (   !cur_ipx_route
 			    || route_dest_cmp_result != 0
-			    || *p_effective_metric != cur_plat_route->rx.metric)
-				vtable->vt->route_delete (priv->platform, ifindex, cur_plat_route);
+			    || *p_effective_metric != cur_plat_route->rx.metric) {
+				if (!plat_deletes)
+					plat_deletes = g_ptr_array_new ();
+				g_ptr_array_add (plat_deletes, (gpointer) cur_plat_route);
+			}
 
 			cur_plat_route = _get_next_plat_route (plat_routes_idx, FALSE, &i_plat_routes);
 		}
 	}
 
+	if (plat_deletes) {
+		guint j = 0;
+
+		/* Queue the deletions now, except those that must wait until the
+		 * routes are added. Those are kept in @plat_deletes. */
+		for (i = 0; i < plat_deletes->len; i++) {
+			cur_plat_route = plat_deletes->pdata[i];
+
+			switch (_plat_route_delete_order (vtable, ipx_routes->index, effective_metrics, ifindex, cur_plat_route)) {
+			case PLAT_ROUTE_DELETE_FIRST:
+				vtable->vt->batch_route_delete (batch, ifindex, cur_plat_route);
+				break;
+			case PLAT_ROUTE_DELETE_LAST:
+				plat_deletes->pdata[j++] = (gpointer) cur_plat_route;
+				break;
+			case PLAT_ROUTE_DELETE_SKIP:
+				_LOGt (vtable->vt->addr_family, "%3d: platform rt-keep   - %s", ifindex,
+				       vtable->vt->route_to_string (cur_plat_route, NULL, 0));
+				break;
+			}
+		}
+		g_ptr_array_set_size (plat_deletes, j);
+	}
+
 	/***************************************************************************
 	 * Restore shadowed routes. These routes are on an other @ifindex then what
 	 * we are syncing now. But the current changes make it necessary to add those
@@ -778,12 +1381,18 @@ next:
 			}
 			*p_effective_metric_reversed = *p_effective_metric;
 
+			cur_ipx_route = ipx_routes->index->entries[i_ipx_routes];
+			if (cur_ipx_route->rx.ifindex != ifindex) {
+				/* the routes to configure on the other ifindex changed. Its next
+				 * sync must look at the destination. */
+				_route_ifindex_state_add_dirty (vtable, ipx_routes, cur_ipx_route->rx.ifindex, cur_ipx_route);
+			}
+
 			if (*p_effective_metric == -1) {
 				/* the entry is shadowed. Nothing to do. */
 				continue;
 			}
 
-			cur_ipx_route = ipx_routes->index->entries[i_ipx_routes];
 			if (cur_ipx_route->rx.ifindex == ifindex) {
 				/* @cur_ipx_route is on the current @ifindex. No need to special handling them
 				 * because we are about to do a full sync of the ifindex. */
@@ -812,15 +1421,15 @@ next:
 					gateway_routes = g_array_new (FALSE, FALSE, sizeof (guint));
 				g_array_append_val (gateway_routes, i_ipx_routes);
 			} else
-				vtable->vt->route_add (priv->platform, 0, cur_ipx_route, *p_effective_metric);
+				vtable->vt->batch_route_add (batch, 0, cur_ipx_route, *p_effective_metric);
 		}
 
 		if (gateway_routes) {
 			for (i = 0; i < gateway_routes->len; i++) {
 				i_ipx_routes = g_array_index (gateway_routes, guint, i);
-				vtable->vt->route_add (priv->platform, 0,
-				                       ipx_routes->index->entries[i_ipx_routes],
-				                       effective_metrics[i_ipx_routes]);
+				vtable->vt->batch_route_add (batch, 0,
+				                             ipx_routes->index->entries[i_ipx_routes],
+				                             effective_metrics[i_ipx_routes]);
 			}
 			g_array_unref (gateway_routes);
 		}
@@ -833,11 +1442,11 @@ next:
 	for (i_type = 0; i_type < 2; i_type++) {
 		/* iterate (twice) over @ipx_routes and @plat_routes */
 		cur_plat_route = _get_next_plat_route (plat_routes_idx, TRUE, &i_plat_routes);
-		cur_ipx_route = _get_next_ipx_route (ipx_routes->index, TRUE, &i_ipx_routes, ifindex);
+		cur_ipx_route = _get_next_ipx_route (ipx_routes->index, ipx_routes_sel, TRUE, &i_ipx_routes_sel, &i_ipx_routes);
 		/* Iterate here over @ipx_routes instead of @known_routes. That is done because
 		 * we need to know whether a route is shadowed by another route, and that
 		 * requires to look at @ipx_routes. */
-		for (; cur_ipx_route; cur_ipx_route = _get_next_ipx_route (ipx_routes->index, FALSE, &i_ipx_routes, ifindex)) {
+		for (; cur_ipx_route; cur_ipx_route = _get_next_ipx_route (ipx_routes->index, ipx_routes_sel, FALSE, &i_ipx_routes_sel, &i_ipx_routes)) {
 			int route_dest_cmp_result = -1;
 
 			if (   (i_type == 0 && !VTABLE_IS_DEVICE_ROUTE (vtable, cur_ipx_route))
@@ -868,26 +1477,74 @@ next:
 			if (   !cur_plat_route
 			    || route_dest_cmp_result != 0
 			    || !_route_equals_ignoring_ifindex (vtable, cur_plat_route, cur_ipx_route, *p_effective_metric)) {
-
-				if (!vtable->vt->route_add (priv->platform, ifindex, cur_ipx_route, *p_effective_metric)) {
-					if (cur_ipx_route->rx.source < NM_IP_CONFIG_SOURCE_USER) {
-						_LOGD (vtable->vt->addr_family,
-						       "ignore error adding IPv%c route to kernel: %s",
-						       vtable->vt->is_ip4 ? '4' : '6',
-						       vtable->vt->route_to_string (cur_ipx_route, NULL, 0));
-					} else {
-						/* Remember that there was a failure, but for now continue trying
-						 * to sync the remaining routes. */
-						success = FALSE;
-					}
-				}
+				RouteBatchAdd batch_add = {
+					.route = cur_ipx_route,
+					.effective_metric = *p_effective_metric,
+				};
+
+				/* if only attributes like the gateway or mss differ, update the
+				 * route in place instead of creating it anew. */
+				batch_add.replace =    cur_plat_route
+				                    && route_dest_cmp_result == 0
+				                    && cur_plat_route->rx.metric == *p_effective_metric;
+				if (batch_add.replace)
+					batch_add.batch_idx = vtable->vt->batch_route_replace (batch, ifindex, cur_ipx_route, *p_effective_metric);
+				else
+					batch_add.batch_idx = vtable->vt->batch_route_add (batch, ifindex, cur_ipx_route, *p_effective_metric);
+
+				g_array_append_val (batch_adds, batch_add);
 			}
 		}
 	}
 
+	if (plat_deletes) {
+		for (i = 0; i < plat_deletes->len; i++)
+			vtable->vt->batch_route_delete (batch, ifindex, plat_deletes->pdata[i]);
+		g_ptr_array_unref (plat_deletes);
+	}
+
+	g_clear_pointer (&plat_routes_idx, g_free);
+	if (known_routes_sel_idx != known_routes_idx)
+		g_free (known_routes_sel_idx);
+	g_free (dirty_dests_idx);
+	g_hash_table_unref (dirty_dests);
+	g_array_unref (ipx_routes_sel);
+
+	committed = nm_platform_batch_commit (batch);
+
+	/* lookup @state again. It is gone, if the link was removed in the meantime. */
+	state = g_hash_table_lookup (ipx_routes->ifindex_states, GINT_TO_POINTER (ifindex));
+	if (state)
+		_route_ifindex_state_set_synced (vtable, state, known_routes_idx, committed, ignore_kernel_routes, full_sync);
+
+	for (i = 0; i < batch_adds->len; i++) {
+		const RouteBatchAdd *batch_add = &g_array_index (batch_adds, RouteBatchAdd, i);
+
+		if (   batch_add->batch_idx != G_MAXUINT
+		    && nm_platform_batch_get_result (batch, batch_add->batch_idx))
+			continue;
+
+		/* the route to replace might have vanished in the meantime. Add it then. */
+		if (   batch_add->replace
+		    && vtable->vt->route_add (priv->platform, ifindex, batch_add->route, batch_add->effective_metric))
+			continue;
+
+		if (batch_add->route->rx.source < NM_IP_CONFIG_SOURCE_USER) {
+			_LOGD (vtable->vt->addr_family,
+			       "ignore error adding IPv%c route to kernel: %s",
+			       vtable->vt->is_ip4 ? '4' : '6',
+			       vtable->vt->route_to_string (batch_add->route, NULL, 0));
+		} else {
+			/* Remember that there was a failure, but still report
+			 * the remaining routes. */
+			success = FALSE;
+		}
+	}
+
+	g_array_unref (batch_adds);
+	nm_platform_batch_free (batch);
+
 	g_free (known_routes_idx);
-	g_free (plat_routes_idx);
-	g_array_unref (plat_routes);
 
 	return success;
 }
@@ -953,19 +1610,17 @@ nm_route_manager_route_flush (NMRouteManager *self, int ifindex)
 static gboolean
 _ip4_device_routes_entry_expired (const IP4DeviceRoutePurgeEntry *entry, gint64 now)
 {
-	return entry->scheduled_at_ns + IP4_DEVICE_ROUTES_WAIT_TIME_NS < now;
+	return nm_expiry_queue_node_get_expiry (&entry->expiry_node) < now;
 }
 
 static IP4DeviceRoutePurgeEntry *
-_ip4_device_routes_purge_entry_create (NMRouteManager *self, const NMPlatformIP4Route *route, gint64 now_ns)
+_ip4_device_routes_purge_entry_create (NMRouteManager *self, const NMPlatformIP4Route *route)
 {
 	IP4DeviceRoutePurgeEntry *entry;
 
-	entry = g_slice_new (IP4DeviceRoutePurgeEntry);
+	entry = g_slice_new0 (IP4DeviceRoutePurgeEntry);
 
 	entry->self = self;
-	entry->scheduled_at_ns = now_ns;
-	entry->idle_id = 0;
 	entry->obj = nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (NMPlatformObject *) route);
 	return entry;
 }
@@ -973,6 +1628,7 @@ _ip4_device_routes_purge_entry_create (NMRouteManager *self, const NMPlatformIP4
 static void
 _ip4_device_routes_purge_entry_free (IP4DeviceRoutePurgeEntry *entry)
 {
+	nm_expiry_queue_remove (NM_ROUTE_MANAGER_GET_PRIVATE (entry->self)->ip4_device_routes.expiry, &entry->expiry_node);
 	nmp_object_unref (entry->obj);
 	nm_clear_g_source (&entry->idle_id);
 	g_slice_free (IP4DeviceRoutePurgeEntry, entry);
@@ -1007,20 +1663,13 @@ _ip4_device_routes_idle_cb (IP4DeviceRoutePurgeEntry *entry)
 }
 
 static void
-_ip4_device_routes_ip4_route_changed (NMPlatform *platform,
-                                      NMPObjectType obj_type,
-                                      int ifindex,
-                                      const NMPlatformIP4Route *route,
-                                      NMPlatformSignalChangeType change_type,
-                                      NMRouteManager *self)
+_ip4_device_routes_ip4_route_changed (NMRouteManager *self,
+                                      const NMPlatformIP4Route *route)
 {
 	NMRouteManagerPrivate *priv;
 	NMPObject obj_needle;
 	IP4DeviceRoutePurgeEntry *entry;
 
-	if (change_type == NM_PLATFORM_SIGNAL_REMOVED)
-		return;
-
 	if (   route->source != NM_IP_CONFIG_SOURCE_RTPROT_KERNEL
 	    || route->metric != 0) {
 		/* we don't have an automatically created device route at hand. Bail out early. */
@@ -1047,41 +1696,53 @@ _ip4_device_routes_ip4_route_changed (NMPlatform *platform,
 	}
 }
 
-static gboolean
+static void
+_ip4_device_routes_platform_changes (NMPlatform *platform,
+                                     const NMPlatformChanges *changes,
+                                     NMRouteManager *self)
+{
+	const NMPlatformSignalChangeType change_types[] = { NM_PLATFORM_SIGNAL_ADDED, NM_PLATFORM_SIGNAL_CHANGED };
+	GArray *routes;
+	guint i, j;
+
+	for (i = 0; i < G_N_ELEMENTS (change_types); i++) {
+		routes = changes->objs[NM_PLATFORM_SIGNAL_ID_IP4_ROUTE][change_types[i]];
+		if (!routes)
+			continue;
+		for (j = 0; j < routes->len; j++) {
+			/* handling a route might cancel the watch. */
+			if (!NM_ROUTE_MANAGER_GET_PRIVATE (self)->ip4_device_routes.watching)
+				return;
+			_ip4_device_routes_ip4_route_changed (self, &g_array_index (routes, NMPlatformIP4Route, j));
+		}
+	}
+}
+
+static void
 _ip4_device_routes_cancel (NMRouteManager *self)
 {
 	NMRouteManagerPrivate *priv = NM_ROUTE_MANAGER_GET_PRIVATE (self);
 
-	if (priv->ip4_device_routes.gc_id) {
-		if (g_hash_table_size (priv->ip4_device_routes.entries) > 0)
-			return G_SOURCE_CONTINUE;
+	if (   priv->ip4_device_routes.watching
+	    && g_hash_table_size (priv->ip4_device_routes.entries) == 0) {
 		_LOGt (vtable_v4.vt->addr_family, "device-route: cancel");
 		if (priv->platform)
-			g_signal_handlers_disconnect_by_func (priv->platform, G_CALLBACK (_ip4_device_routes_ip4_route_changed), self);
-		nm_clear_g_source (&priv->ip4_device_routes.gc_id);
+			g_signal_handlers_disconnect_by_func (priv->platform, G_CALLBACK (_ip4_device_routes_platform_changes), self);
+		priv->ip4_device_routes.watching = FALSE;
 	}
-	return G_SOURCE_REMOVE;
 }
 
-static gboolean
-_ip4_device_routes_gc (NMRouteManager *self)
+static void
+_ip4_device_routes_expired_cb (NMExpiryQueueNode *node, gpointer user_data)
 {
-	NMRouteManagerPrivate *priv;
-	GHashTableIter iter;
+	NMRouteManager *self = user_data;
 	IP4DeviceRoutePurgeEntry *entry;
-	gint64 now = nm_utils_get_monotonic_timestamp_ns ();
-
-	priv = NM_ROUTE_MANAGER_GET_PRIVATE (self);
 
-	g_hash_table_iter_init (&iter, priv->ip4_device_routes.entries);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &entry)) {
-		if (_ip4_device_routes_entry_expired (entry, now)) {
-			_LOGt (vtable_v4.vt->addr_family, "device-route: cleanup-gc %s", nmp_object_to_string (entry->obj, NMP_OBJECT_TO_STRING_PUBLIC, NULL, 0));
-			g_hash_table_iter_remove (&iter);
-		}
-	}
+	entry = (IP4DeviceRoutePurgeEntry *) (((char *) node) - G_STRUCT_OFFSET (IP4DeviceRoutePurgeEntry, expiry_node));
 
-	return _ip4_device_routes_cancel (self);
+	_LOGt (vtable_v4.vt->addr_family, "device-route: cleanup-gc %s", nmp_object_to_string (entry->obj, NMP_OBJECT_TO_STRING_PUBLIC, NULL, 0));
+	g_hash_table_remove (NM_ROUTE_MANAGER_GET_PRIVATE (self)->ip4_device_routes.entries, entry->obj);
+	_ip4_device_routes_cancel (self);
 }
 
 /**
@@ -1108,7 +1769,7 @@ nm_route_manager_ip4_route_register_device_route_purge_list (NMRouteManager *sel
 	for (i = 0; i < device_route_purge_list->len; i++) {
 		IP4DeviceRoutePurgeEntry *entry;
 
-		entry = _ip4_device_routes_purge_entry_create (self, &g_array_index (device_route_purge_list, NMPlatformIP4Route, i), now_ns);
+		entry = _ip4_device_routes_purge_entry_create (self, &g_array_index (device_route_purge_list, NMPlatformIP4Route, i));
 		_LOGt (vtable_v4.vt->addr_family, "device-route: watch (%s) %s",
 		                                  g_hash_table_contains (priv->ip4_device_routes.entries, entry->obj)
 		                                      ? "update" : "new",
@@ -1116,10 +1777,13 @@ nm_route_manager_ip4_route_register_device_route_purge_list (NMRouteManager *sel
 		g_hash_table_replace (priv->ip4_device_routes.entries,
 		                      nmp_object_ref (entry->obj),
 		                      entry);
+		nm_expiry_queue_schedule (priv->ip4_device_routes.expiry,
+		                          &entry->expiry_node,
+		                          now_ns + IP4_DEVICE_ROUTES_WAIT_TIME_NS);
 	}
-	if (priv->ip4_device_routes.gc_id == 0) {
-		g_signal_connect (priv->platform, NM_PLATFORM_SIGNAL_IP4_ROUTE_CHANGED, G_CALLBACK (_ip4_device_routes_ip4_route_changed), self);
-		priv->ip4_device_routes.gc_id = g_timeout_add (IP4_DEVICE_ROUTES_GC_INTERVAL_SEC, (GSourceFunc) _ip4_device_routes_gc, self);
+	if (!priv->ip4_device_routes.watching) {
+		g_signal_connect (priv->platform, NM_PLATFORM_SIGNAL_CHANGES, G_CALLBACK (_ip4_device_routes_platform_changes), self);
+		priv->ip4_device_routes.watching = TRUE;
 	}
 }
 
@@ -1129,12 +1793,16 @@ static const VTableIP vtable_v4 = {
 	.vt                             = &nm_platform_vtable_route_v4,
 	.route_dest_cmp                 = (int (*) (const NMPlatformIPXRoute *, const NMPlatformIPXRoute *)) _v4_route_dest_cmp,
 	.route_id_cmp                   = (int (*) (const NMPlatformIPXRoute *, const NMPlatformIPXRoute *)) _v4_route_id_cmp,
+	.route_dest_hash                = (GHashFunc) _v4_route_dest_hash,
+	.route_dest_equal               = (GEqualFunc) _v4_route_dest_equal,
 };
 
 static const VTableIP vtable_v6 = {
 	.vt                             = &nm_platform_vtable_route_v6,
 	.route_dest_cmp                 = (int (*) (const NMPlatformIPXRoute *, const NMPlatformIPXRoute *)) _v6_route_dest_cmp,
 	.route_id_cmp                   = (int (*) (const NMPlatformIPXRoute *, const NMPlatformIPXRoute *)) _v6_route_id_cmp,
+	.route_dest_hash                = (GHashFunc) _v6_route_dest_hash,
+	.route_dest_equal               = (GEqualFunc) _v6_route_dest_equal,
 };
 
 /*********************************************************************************************/
@@ -1154,10 +1822,16 @@ nm_route_manager_init (NMRouteManager *self)
 	priv->ip6_routes.effective_metrics_reverse = g_array_new (FALSE, FALSE, sizeof (gint64));
 	priv->ip4_routes.index = _route_index_create (&vtable_v4, priv->ip4_routes.entries);
 	priv->ip6_routes.index = _route_index_create (&vtable_v6, priv->ip6_routes.entries);
+	priv->ip4_routes.ifindex_states = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) _route_ifindex_state_free);
+	priv->ip6_routes.ifindex_states = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) _route_ifindex_state_free);
 	priv->ip4_device_routes.entries = g_hash_table_new_full ((GHashFunc) nmp_object_id_hash,
 	                                                         (GEqualFunc) nmp_object_id_equal,
 	                                                         (GDestroyNotify) nmp_object_unref,
 	                                                         (GDestroyNotify) _ip4_device_routes_purge_entry_free);
+	priv->ip4_device_routes.expiry = nm_expiry_queue_new (_ip4_device_routes_expired_cb, self);
+
+	g_signal_connect (priv->platform, NM_PLATFORM_SIGNAL_LINK_CHANGED, G_CALLBACK (_link_changed_cb), self);
+	g_signal_connect (priv->platform, NM_PLATFORM_SIGNAL_CHANGES, G_CALLBACK (_platform_changes_cb), self);
 }
 
 static void
@@ -1169,7 +1843,13 @@ dispose (GObject *object)
 	g_hash_table_remove_all (priv->ip4_device_routes.entries);
 	_ip4_device_routes_cancel (self);
 
-	g_clear_object (&priv->platform);
+	if (priv->platform) {
+		g_signal_handlers_disconnect_by_func (priv->platform, G_CALLBACK (_link_changed_cb), self);
+		g_signal_handlers_disconnect_by_func (priv->platform, G_CALLBACK (_platform_changes_cb), self);
+		g_clear_object (&priv->platform);
+	}
+	g_hash_table_remove_all (priv->ip4_routes.ifindex_states);
+	g_hash_table_remove_all (priv->ip6_routes.ifindex_states);
 
 	G_OBJECT_CLASS (nm_route_manager_parent_class)->dispose (object);
 }
@@ -1187,8 +1867,11 @@ finalize (GObject *object)
 	g_array_free (priv->ip6_routes.effective_metrics_reverse, TRUE);
 	g_free (priv->ip4_routes.index);
 	g_free (priv->ip6_routes.index);
+	g_hash_table_unref (priv->ip4_routes.ifindex_states);
+	g_hash_table_unref (priv->ip6_routes.ifindex_states);
 
 	g_hash_table_unref (priv->ip4_device_routes.entries);
+	nm_expiry_queue_free (priv->ip4_device_routes.expiry);
 
 	G_OBJECT_CLASS (nm_route_manager_parent_class)->finalize (object);
 }
@@ -0,0 +1,259 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2016 Red Hat, Inc.
+ */
+
+#include "config.h"
+
+#include "nm-default.h"
+#include "nm-route-trie.h"
+
+#include <string.h>
+#include <sys/socket.h>
+
+#include "nm-macros-internal.h"
+
+typedef struct _NMRouteTrieNode NMRouteTrieNode;
+
+struct _NMRouteTrieNode {
+	NMRouteTrieNode *child[2];
+
+	/* the values of the prefix. Nodes without values are
+	 * only there to branch. */
+	gpointer *values;
+	guint n_values;
+	guint n_alloc;
+
+	guint8 plen;
+
+	/* the prefix, with the host part cleared. */
+	guint8 prefix[16];
+};
+
+struct _NMRouteTrie {
+	NMRouteTrieNode *root;
+	guint8 addr_len;
+	guint n_prefixes;
+};
+
+/******************************************************************************************/
+
+static inline guint
+_bit (const guint8 *addr, guint8 pos)
+{
+	return (addr[pos / 8] >> (7 - (pos % 8))) & 1;
+}
+
+static guint8
+_common_plen (const guint8 *a, const guint8 *b, guint8 max_plen)
+{
+	guint8 n = 0;
+
+	/* compare whole bytes first. */
+	while (n + 8 <= max_plen && a[n / 8] == b[n / 8])
+		n += 8;
+	while (n < max_plen && _bit (a, n) == _bit (b, n))
+		n++;
+	return n;
+}
+
+static void
+_prefix_init (guint8 *dst, const guint8 *src, guint8 plen)
+{
+	guint8 i = plen / 8;
+
+	memset (dst, 0, 16);
+	memcpy (dst, src, i);
+	if (plen % 8)
+		dst[i] = src[i] & (0xFF << (8 - (plen % 8)));
+}
+
+static NMRouteTrieNode *
+_node_new (const guint8 *prefix, guint8 plen)
+{
+	NMRouteTrieNode *node;
+
+	node = g_slice_new0 (NMRouteTrieNode);
+	node->plen = plen;
+	_prefix_init (node->prefix, prefix, plen);
+	return node;
+}
+
+static void
+_node_add_value (NMRouteTrie *trie, NMRouteTrieNode *node, gpointer value)
+{
+	if (node->n_values == 0)
+		trie->n_prefixes++;
+	if (node->n_values == node->n_alloc) {
+		node->n_alloc = MAX (2u, node->n_alloc * 2);
+		node->values = g_renew (gpointer, node->values, node->n_alloc);
+	}
+	node->values[node->n_values++] = value;
+}
+
+static void
+_node_free (NMRouteTrieNode *node)
+{
+	if (!node)
+		return;
+	_node_free (node->child[0]);
+	_node_free (node->child[1]);
+	g_free (node->values);
+	g_slice_free (NMRouteTrieNode, node);
+}
+
+/******************************************************************************************/
+
+/**
+ * nm_route_trie_insert:
+ * @trie: the #NMRouteTrie
+ * @network: the network address, 4 or 16 bytes depending on the
+ *   address family of @trie. The host part is ignored.
+ * @plen: the prefix length
+ * @value: the value to add for the prefix
+ *
+ * Adds @value for the prefix @network/@plen. Adding the same
+ * value twice results in it being reported twice.
+ */
+void
+nm_route_trie_insert (NMRouteTrie *trie,
+                      gconstpointer network,
+                      guint8 plen,
+                      gpointer value)
+{
+	const guint8 *key = network;
+	NMRouteTrieNode **p_node;
+	NMRouteTrieNode *node, *n;
+	guint8 common;
+
+	g_return_if_fail (trie);
+	g_return_if_fail (network);
+	g_return_if_fail (plen <= trie->addr_len * 8);
+
+	p_node = &trie->root;
+	while ((node = *p_node)) {
+		common = _common_plen (node->prefix, key, MIN (node->plen, plen));
+
+		if (common < node->plen) {
+			/* @node is not below the new prefix. Split the path at @common. */
+			n = _node_new (key, common);
+			n->child[_bit (node->prefix, common)] = node;
+			*p_node = n;
+			if (common == plen) {
+				/* the new prefix itself becomes the parent of @node. */
+				node = n;
+			} else {
+				node = _node_new (key, plen);
+				n->child[_bit (key, common)] = node;
+			}
+			goto out;
+		}
+
+		if (node->plen == plen)
+			goto out;
+
+		p_node = &node->child[_bit (key, node->plen)];
+	}
+	node = *p_node = _node_new (key, plen);
+
+out:
+	nm_assert (node->plen == plen);
+	_node_add_value (trie, node, value);
+}
+
+guint
+nm_route_trie_get_num_prefixes (const NMRouteTrie *trie)
+{
+	g_return_val_if_fail (trie, 0);
+
+	return trie->n_prefixes;
+}
+
+/**
+ * nm_route_trie_foreach_covering:
+ * @trie: the #NMRouteTrie
+ * @host: the address to look up
+ * @max_plen: only consider prefixes not longer than @max_plen
+ * @func: the function called for each value
+ * @user_data: the user data for @func
+ *
+ * Calls @func for every value of every prefix that contains @host,
+ * starting with the longest prefix. The iteration stops when @func
+ * returns %FALSE. This costs O(@max_plen) to find the prefixes.
+ */
+void
+nm_route_trie_foreach_covering (const NMRouteTrie *trie,
+                                gconstpointer host,
+                                guint8 max_plen,
+                                NMRouteTrieFunc func,
+                                gpointer user_data)
+{
+	const guint8 *key = host;
+	const NMRouteTrieNode *stack[129];
+	const NMRouteTrieNode *node;
+	guint n_stack = 0;
+	guint i;
+
+	g_return_if_fail (trie);
+	g_return_if_fail (host);
+	g_return_if_fail (func);
+
+	max_plen = MIN (max_plen, trie->addr_len * 8);
+
+	node = trie->root;
+	while (node && node->plen <= max_plen) {
+		if (_common_plen (node->prefix, key, node->plen) < node->plen)
+			break;
+		if (node->n_values)
+			stack[n_stack++] = node;
+		if (node->plen == trie->addr_len * 8)
+			break;
+		node = node->child[_bit (key, node->plen)];
+	}
+
+	while (n_stack > 0) {
+		node = stack[--n_stack];
+		for (i = 0; i < node->n_values; i++) {
+			if (!func (node->values[i], node->plen, user_data))
+				return;
+		}
+	}
+}
+
+/******************************************************************************************/
+
+NMRouteTrie *
+nm_route_trie_new (int addr_family)
+{
+	NMRouteTrie *trie;
+
+	g_return_val_if_fail (NM_IN_SET (addr_family, AF_INET, AF_INET6), NULL);
+
+	trie = g_slice_new0 (NMRouteTrie);
+	trie->addr_len = addr_family == AF_INET ? 4 : 16;
+	return trie;
+}
+
+void
+nm_route_trie_free (NMRouteTrie *trie)
+{
+	g_return_if_fail (trie);
+
+	_node_free (trie->root);
+	g_slice_free (NMRouteTrie, trie);
+}
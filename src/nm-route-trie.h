@@ -0,0 +1,65 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2016 Red Hat, Inc.
+ */
+
+#ifndef __NM_ROUTE_TRIE__
+#define __NM_ROUTE_TRIE__
+
+#include "nm-default.h"
+
+G_BEGIN_DECLS
+
+/* NMRouteTrie is a path-compressed binary trie of IPv4 or IPv6 prefixes
+ * for longest-prefix-match lookups. Every prefix can carry several
+ * values (e.g. routes with different metrics or addresses).
+ *
+ * The trie does not own the values and does not support removal.
+ * Users are expected to build it lazily from their list of routes
+ * or addresses and drop it whenever the list changes.
+ *
+ * The platform cache does not keep a trie. It changes with every
+ * netlink event, so it would need removal, and none of its users does
+ * a longest-prefix-match: routes are only looked up by their ID or by
+ * ifindex, for which the cache already has indexes. */
+
+typedef struct _NMRouteTrie NMRouteTrie;
+
+/* Returns %FALSE to stop the iteration. */
+typedef gboolean (*NMRouteTrieFunc) (gpointer value, guint8 plen, gpointer user_data);
+
+NMRouteTrie *nm_route_trie_new (int addr_family);
+
+void nm_route_trie_free (NMRouteTrie *trie);
+
+void nm_route_trie_insert (NMRouteTrie *trie,
+                           gconstpointer network,
+                           guint8 plen,
+                           gpointer value);
+
+guint nm_route_trie_get_num_prefixes (const NMRouteTrie *trie);
+
+void nm_route_trie_foreach_covering (const NMRouteTrie *trie,
+                                     gconstpointer host,
+                                     guint8 max_plen,
+                                     NMRouteTrieFunc func,
+                                     gpointer user_data);
+
+G_END_DECLS
+
+#endif /* __NM_ROUTE_TRIE__ */
@@ -139,6 +139,8 @@ typedef enum {
 	NMP_OBJECT_TYPE_IP4_ROUTE,
 	NMP_OBJECT_TYPE_IP6_ROUTE,
 
+	NMP_OBJECT_TYPE_LNK_BOND,
+	NMP_OBJECT_TYPE_LNK_BRIDGE,
 	NMP_OBJECT_TYPE_LNK_GRE,
 	NMP_OBJECT_TYPE_LNK_INFINIBAND,
 	NMP_OBJECT_TYPE_LNK_IP6TNL,
@@ -895,6 +895,10 @@ ip4_address_add (NMPlatform *platform,
 	NMPlatformIP4Address address;
 	int i;
 
+	/* like the kernel, reject invalid prefix lengths. */
+	if (plen > 32)
+		return FALSE;
+
 	memset (&address, 0, sizeof (address));
 	address.source = NM_IP_CONFIG_SOURCE_KERNEL;
 	address.ifindex = ifindex;
@@ -944,6 +948,9 @@ ip6_address_add (NMPlatform *platform,
 	NMPlatformIP6Address address;
 	int i;
 
+	if (plen > 128)
+		return FALSE;
+
 	memset (&address, 0, sizeof (address));
 	address.source = NM_IP_CONFIG_SOURCE_KERNEL;
 	address.ifindex = ifindex;
@@ -1348,6 +1355,38 @@ ip6_route_get (NMPlatform *platform, int ifindex, struct in6_addr network, int p
 	return NULL;
 }
 
+static gboolean
+ip4_route_replace (NMPlatform *platform, int ifindex, NMIPConfigSource source,
+                   in_addr_t network, int plen, in_addr_t gateway,
+                   in_addr_t pref_src, guint32 metric, guint32 mss)
+{
+	network = nm_utils_ip4_address_clear_host_address (network, plen);
+
+	if (!ip4_route_get (platform, ifindex, network, plen, metric)) {
+		nm_log_warn (LOGD_PLATFORM, "Fake platform: failure replacing ip4-route '%d: %s/%d %d': No such route",
+		             ifindex, nm_utils_inet4_ntop (network, NULL), plen, metric);
+		return FALSE;
+	}
+	return ip4_route_add (platform, ifindex, source, network, plen, gateway, pref_src, metric, mss);
+}
+
+static gboolean
+ip6_route_replace (NMPlatform *platform, int ifindex, NMIPConfigSource source,
+                   struct in6_addr network, int plen, struct in6_addr gateway,
+                   guint32 metric, guint32 mss)
+{
+	struct in6_addr n;
+
+	nm_utils_ip6_address_clear_host_address (&n, &network, plen);
+
+	if (!ip6_route_get (platform, ifindex, n, plen, metric)) {
+		nm_log_warn (LOGD_PLATFORM, "Fake platform: failure replacing ip6-route '%d: %s/%d %d': No such route",
+		             ifindex, nm_utils_inet6_ntop (&n, NULL), plen, metric);
+		return FALSE;
+	}
+	return ip6_route_add (platform, ifindex, source, n, plen, gateway, metric, mss);
+}
+
 /******************************************************************/
 
 static void
@@ -1484,6 +1523,8 @@ nm_fake_platform_class_init (NMFakePlatformClass *klass)
 	platform_class->ip6_route_get_all = ip6_route_get_all;
 	platform_class->ip4_route_add = ip4_route_add;
 	platform_class->ip6_route_add = ip6_route_add;
+	platform_class->ip4_route_replace = ip4_route_replace;
+	platform_class->ip6_route_replace = ip6_route_replace;
 	platform_class->ip4_route_delete = ip4_route_delete;
 	platform_class->ip6_route_delete = ip6_route_delete;
 }
@@ -61,6 +61,13 @@
 /* nm-internal error codes for libnl. Make sure they don't overlap. */
 #define _NLE_NM_NOBUFS 500
 
+/* Number of datagrams read from the netlink socket with one recvmmsg() call
+ * and the initial buffer size for each. Kernel limits the size of dump
+ * datagrams to 32K, if the receive buffer is large enough. Single messages
+ * can be larger (e.g. a link with many SR-IOV VFs); then the buffers grow. */
+#define RECV_DGRAMS_MAX                 8
+#define RECV_DGRAM_SIZE                 (32 * 1024)
+
 /*********************************************************************************************/
 
 #define IFQDISCSIZ                      32
@@ -105,10 +112,66 @@
 #define IFLA_IPTUN_MAX                  (__IFLA_IPTUN_MAX - 1)
 #endif
 
+/* IFLA_BOND_* were added to if_link.h over several kernel releases and
+ * the headers we build against might lack some of them. Define the ones
+ * we use ourselves, the values are fixed by the kernel ABI.
+ */
+#define IFLA_BOND_UNSPEC                0
+#define IFLA_BOND_MODE                  1
+#define IFLA_BOND_ACTIVE_SLAVE          2
+#define IFLA_BOND_MIIMON                3
+#define IFLA_BOND_UPDELAY               4
+#define IFLA_BOND_DOWNDELAY             5
+#define IFLA_BOND_USE_CARRIER           6
+#define IFLA_BOND_ARP_INTERVAL          7
+#define IFLA_BOND_ARP_IP_TARGET         8
+#define IFLA_BOND_ARP_VALIDATE          9
+#define IFLA_BOND_ARP_ALL_TARGETS       10
+#define IFLA_BOND_PRIMARY               11
+#define IFLA_BOND_PRIMARY_RESELECT      12
+#define IFLA_BOND_FAIL_OVER_MAC         13
+#define IFLA_BOND_XMIT_HASH_POLICY      14
+#define IFLA_BOND_RESEND_IGMP           15
+#define IFLA_BOND_NUM_PEER_NOTIF        16
+#define IFLA_BOND_ALL_SLAVES_ACTIVE     17
+#define IFLA_BOND_MIN_LINKS             18
+#define IFLA_BOND_LP_INTERVAL           19
+#define IFLA_BOND_PACKETS_PER_SLAVE     20
+#define IFLA_BOND_AD_LACP_RATE          21
+#define IFLA_BOND_AD_SELECT             22
+#undef IFLA_BOND_MAX
+#define IFLA_BOND_MAX                   IFLA_BOND_AD_SELECT
+
+/* Bridges can be configured via netlink since kernel 4.1, the multicast
+ * options were only added in 4.4. Define the attributes ourselves in
+ * case the headers are older than that.
+ */
+#define IFLA_INFO_SLAVE_KIND            4
+#define IFLA_INFO_SLAVE_DATA            5
+
+#define IFLA_BR_UNSPEC                  0
+#define IFLA_BR_FORWARD_DELAY           1
+#define IFLA_BR_HELLO_TIME              2
+#define IFLA_BR_MAX_AGE                 3
+#define IFLA_BR_AGEING_TIME             4
+#define IFLA_BR_STP_STATE               5
+#define IFLA_BR_PRIORITY                6
+#define IFLA_BR_MCAST_SNOOPING          23
+#undef IFLA_BR_MAX
+#define IFLA_BR_MAX                     IFLA_BR_MCAST_SNOOPING
+
+#define IFLA_BRPORT_PRIORITY            2
+#define IFLA_BRPORT_COST                3
+#define IFLA_BRPORT_MODE                4
+
 #ifndef MACVLAN_FLAG_NOPROMISC
 #define MACVLAN_FLAG_NOPROMISC          1
 #endif
 
+#ifndef RTM_F_FIB_MATCH
+#define RTM_F_FIB_MATCH                 0x2000
+#endif
+
 #define IP6_FLOWINFO_TCLASS_MASK        0x0FF00000
 #define IP6_FLOWINFO_TCLASS_SHIFT       20
 #define IP6_FLOWINFO_FLOWLABEL_MASK     0x000FFFFF
@@ -190,6 +253,7 @@ typedef void (*WaitForNlResponseCallback) (NMPlatform *platform,
 
 static void delayed_action_schedule (NMPlatform *platform, DelayedActionType action_type, gpointer user_data);
 static gboolean delayed_action_handle_all (NMPlatform *platform, gboolean read_netlink);
+static void resync_finish (NMPlatform *platform);
 static void do_request_link_no_delayed_actions (NMPlatform *platform, int ifindex, const char *name);
 static void do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType action_type);
 static void cache_pre_hook (NMPCache *cache, const NMPObject *old, const NMPObject *new, NMPCacheOpsType ops_type, gpointer user_data);
@@ -876,6 +940,130 @@ errout:
 
 /*****************************************************************************/
 
+static NMPObject *
+_parse_lnk_bond (const char *kind, struct nlattr *info_data)
+{
+	static struct nla_policy policy[IFLA_BOND_MAX + 1] = {
+		[IFLA_BOND_MODE]             = { .type = NLA_U8 },
+		[IFLA_BOND_MIIMON]           = { .type = NLA_U32 },
+		[IFLA_BOND_UPDELAY]          = { .type = NLA_U32 },
+		[IFLA_BOND_DOWNDELAY]        = { .type = NLA_U32 },
+		[IFLA_BOND_USE_CARRIER]      = { .type = NLA_U8 },
+		[IFLA_BOND_ARP_INTERVAL]     = { .type = NLA_U32 },
+		[IFLA_BOND_ARP_IP_TARGET]    = { .type = NLA_NESTED },
+		[IFLA_BOND_ARP_VALIDATE]     = { .type = NLA_U32 },
+		[IFLA_BOND_PRIMARY]          = { .type = NLA_U32 },
+		[IFLA_BOND_PRIMARY_RESELECT] = { .type = NLA_U8 },
+		[IFLA_BOND_FAIL_OVER_MAC]    = { .type = NLA_U8 },
+		[IFLA_BOND_XMIT_HASH_POLICY] = { .type = NLA_U8 },
+		[IFLA_BOND_RESEND_IGMP]      = { .type = NLA_U32 },
+		[IFLA_BOND_AD_LACP_RATE]     = { .type = NLA_U8 },
+		[IFLA_BOND_AD_SELECT]        = { .type = NLA_U8 },
+	};
+	struct nlattr *tb[IFLA_BOND_MAX + 1];
+	int err;
+	NMPObject *obj;
+	NMPlatformLnkBond *props;
+
+	if (!info_data || g_strcmp0 (kind, "bond"))
+		return NULL;
+
+	err = nla_parse_nested (tb, IFLA_BOND_MAX, info_data, policy);
+	if (err < 0)
+		return NULL;
+
+	/* kernels that cannot configure bonds via netlink don't report
+	 * any IFLA_BOND_* attributes either. */
+	if (!tb[IFLA_BOND_MODE])
+		return NULL;
+
+	obj = nmp_object_new (NMP_OBJECT_TYPE_LNK_BOND, NULL);
+	props = &obj->lnk_bond;
+
+	props->mode = nla_get_u8 (tb[IFLA_BOND_MODE]);
+	props->miimon = tb[IFLA_BOND_MIIMON] ? nla_get_u32 (tb[IFLA_BOND_MIIMON]) : 0;
+	props->updelay = tb[IFLA_BOND_UPDELAY] ? nla_get_u32 (tb[IFLA_BOND_UPDELAY]) : 0;
+	props->downdelay = tb[IFLA_BOND_DOWNDELAY] ? nla_get_u32 (tb[IFLA_BOND_DOWNDELAY]) : 0;
+	props->use_carrier = !tb[IFLA_BOND_USE_CARRIER] || !!nla_get_u8 (tb[IFLA_BOND_USE_CARRIER]);
+	props->arp_interval = tb[IFLA_BOND_ARP_INTERVAL] ? nla_get_u32 (tb[IFLA_BOND_ARP_INTERVAL]) : 0;
+	props->arp_validate = tb[IFLA_BOND_ARP_VALIDATE] ? nla_get_u32 (tb[IFLA_BOND_ARP_VALIDATE]) : 0;
+	props->primary = tb[IFLA_BOND_PRIMARY] ? nla_get_u32 (tb[IFLA_BOND_PRIMARY]) : 0;
+	props->primary_reselect = tb[IFLA_BOND_PRIMARY_RESELECT] ? nla_get_u8 (tb[IFLA_BOND_PRIMARY_RESELECT]) : 0;
+	props->fail_over_mac = tb[IFLA_BOND_FAIL_OVER_MAC] ? nla_get_u8 (tb[IFLA_BOND_FAIL_OVER_MAC]) : 0;
+	props->xmit_hash_policy = tb[IFLA_BOND_XMIT_HASH_POLICY] ? nla_get_u8 (tb[IFLA_BOND_XMIT_HASH_POLICY]) : 0;
+	props->resend_igmp = tb[IFLA_BOND_RESEND_IGMP] ? nla_get_u32 (tb[IFLA_BOND_RESEND_IGMP]) : 0;
+	props->lacp_rate = tb[IFLA_BOND_AD_LACP_RATE] ? nla_get_u8 (tb[IFLA_BOND_AD_LACP_RATE]) : 0;
+	props->ad_select = tb[IFLA_BOND_AD_SELECT] ? nla_get_u8 (tb[IFLA_BOND_AD_SELECT]) : 0;
+
+	if (tb[IFLA_BOND_ARP_IP_TARGET]) {
+		struct nlattr *attr;
+		int rem;
+
+		nla_for_each_nested (attr, tb[IFLA_BOND_ARP_IP_TARGET], rem) {
+			if (props->num_arp_ip_targets >= NM_PLATFORM_LNK_BOND_MAX_ARP_TARGETS)
+				break;
+			if (nla_len (attr) < (int) sizeof (in_addr_t))
+				continue;
+			props->arp_ip_targets[props->num_arp_ip_targets++] = nla_get_u32 (attr);
+		}
+	}
+
+	return obj;
+}
+
+/*****************************************************************************/
+
+static NMPObject *
+_parse_lnk_bridge (const char *kind, struct nlattr *info_data)
+{
+	static struct nla_policy policy[IFLA_BR_MAX + 1] = {
+		[IFLA_BR_FORWARD_DELAY]  = { .type = NLA_U32 },
+		[IFLA_BR_HELLO_TIME]     = { .type = NLA_U32 },
+		[IFLA_BR_MAX_AGE]        = { .type = NLA_U32 },
+		[IFLA_BR_AGEING_TIME]    = { .type = NLA_U32 },
+		[IFLA_BR_STP_STATE]      = { .type = NLA_U32 },
+		[IFLA_BR_PRIORITY]       = { .type = NLA_U16 },
+		[IFLA_BR_MCAST_SNOOPING] = { .type = NLA_U8 },
+	};
+	struct nlattr *tb[IFLA_BR_MAX + 1];
+	int err;
+	NMPObject *obj;
+	NMPlatformLnkBridge *props;
+
+	if (!info_data || g_strcmp0 (kind, "bridge"))
+		return NULL;
+
+	err = nla_parse_nested (tb, IFLA_BR_MAX, info_data, policy);
+	if (err < 0)
+		return NULL;
+
+	/* Kernel ignores attributes that it doesn't know. Only create the lnk
+	 * object if all options that we set are supported. */
+	if (   !tb[IFLA_BR_FORWARD_DELAY]
+	    || !tb[IFLA_BR_HELLO_TIME]
+	    || !tb[IFLA_BR_MAX_AGE]
+	    || !tb[IFLA_BR_AGEING_TIME]
+	    || !tb[IFLA_BR_STP_STATE]
+	    || !tb[IFLA_BR_PRIORITY]
+	    || !tb[IFLA_BR_MCAST_SNOOPING])
+		return NULL;
+
+	obj = nmp_object_new (NMP_OBJECT_TYPE_LNK_BRIDGE, NULL);
+	props = &obj->lnk_bridge;
+
+	props->forward_delay = nla_get_u32 (tb[IFLA_BR_FORWARD_DELAY]);
+	props->hello_time = nla_get_u32 (tb[IFLA_BR_HELLO_TIME]);
+	props->max_age = nla_get_u32 (tb[IFLA_BR_MAX_AGE]);
+	props->ageing_time = nla_get_u32 (tb[IFLA_BR_AGEING_TIME]);
+	props->stp_state = !!nla_get_u32 (tb[IFLA_BR_STP_STATE]);
+	props->priority = nla_get_u16 (tb[IFLA_BR_PRIORITY]);
+	props->mcast_snooping = !!nla_get_u8 (tb[IFLA_BR_MCAST_SNOOPING]);
+
+	return obj;
+}
+
+/*****************************************************************************/
+
 static NMPObject *
 _parse_lnk_gre (const char *kind, struct nlattr *info_data)
 {
@@ -1529,6 +1717,12 @@ _new_from_nl_link (NMPlatform *platform, const NMPCache *cache, struct nlmsghdr
 		obj->link.mtu = nla_get_u32 (tb[IFLA_MTU]);
 
 	switch (obj->link.type) {
+	case NM_LINK_TYPE_BOND:
+		lnk_data = _parse_lnk_bond (nl_info_kind, nl_info_data);
+		break;
+	case NM_LINK_TYPE_BRIDGE:
+		lnk_data = _parse_lnk_bridge (nl_info_kind, nl_info_data);
+		break;
 	case NM_LINK_TYPE_GRE:
 		lnk_data = _parse_lnk_gre (nl_info_kind, nl_info_data);
 		break;
@@ -1902,21 +2096,15 @@ errout:
  *   be correctly detected.
  * @cache: (allow-none): for certain objects, the netlink message doesn't contain all the information.
  *   If a cache is given, the object is completed with information from the cache.
- * @nlh: the netlink message header
+ * @msghdr: the netlink message header. The message is parsed in place,
+ *   it is usually part of the receive buffer.
  * @id_only: whether only to create an empty object with only the ID fields set.
  *
  * Returns: %NULL or a newly created NMPObject instance.
  **/
 static NMPObject *
-nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nl_msg *msg, gboolean id_only)
+nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nlmsghdr *msghdr, gboolean id_only)
 {
-	struct nlmsghdr *msghdr;
-
-	if (nlmsg_get_proto (msg) != NETLINK_ROUTE)
-		return NULL;
-
-	msghdr = nlmsg_hdr (msg);
-
 	switch (msghdr->nlmsg_type) {
 	case RTM_NEWLINK:
 	case RTM_DELLINK:
@@ -2100,6 +2288,139 @@ nla_put_failure:
 	return FALSE;
 }
 
+static gboolean
+_nl_msg_new_link_set_linkinfo_bond (struct nl_msg *msg,
+                                    const NMPlatformLnkBond *props,
+                                    NMPlatformLnkBondAttrs attrs)
+{
+	struct nlattr *info;
+	struct nlattr *data;
+	struct nlattr *targets;
+	guint i;
+
+	nm_assert (msg);
+	nm_assert (props);
+	nm_assert (attrs != NM_PLATFORM_LNK_BOND_ATTR_NONE);
+
+	if (!(info = nla_nest_start (msg, IFLA_LINKINFO)))
+		goto nla_put_failure;
+
+	NLA_PUT_STRING (msg, IFLA_INFO_KIND, "bond");
+
+	if (!(data = nla_nest_start (msg, IFLA_INFO_DATA)))
+		goto nla_put_failure;
+
+	/* kernel applies the attributes in the order of the IFLA_BOND_* values,
+	 * thus the mode is always set first. */
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_MODE))
+		NLA_PUT_U8 (msg, IFLA_BOND_MODE, props->mode);
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_MIIMON))
+		NLA_PUT_U32 (msg, IFLA_BOND_MIIMON, props->miimon);
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_UPDELAY))
+		NLA_PUT_U32 (msg, IFLA_BOND_UPDELAY, props->updelay);
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_DOWNDELAY))
+		NLA_PUT_U32 (msg, IFLA_BOND_DOWNDELAY, props->downdelay);
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_USE_CARRIER))
+		NLA_PUT_U8 (msg, IFLA_BOND_USE_CARRIER, !!props->use_carrier);
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_ARP_INTERVAL))
+		NLA_PUT_U32 (msg, IFLA_BOND_ARP_INTERVAL, props->arp_interval);
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_ARP_IP_TARGETS)) {
+		/* an empty list clears all targets. */
+		if (!(targets = nla_nest_start (msg, IFLA_BOND_ARP_IP_TARGET)))
+			goto nla_put_failure;
+		for (i = 0; i < props->num_arp_ip_targets; i++)
+			NLA_PUT_U32 (msg, i, props->arp_ip_targets[i]);
+		nla_nest_end (msg, targets);
+	}
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_ARP_VALIDATE))
+		NLA_PUT_U32 (msg, IFLA_BOND_ARP_VALIDATE, props->arp_validate);
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_PRIMARY))
+		NLA_PUT_U32 (msg, IFLA_BOND_PRIMARY, props->primary);
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_PRIMARY_RESELECT))
+		NLA_PUT_U8 (msg, IFLA_BOND_PRIMARY_RESELECT, props->primary_reselect);
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_FAIL_OVER_MAC))
+		NLA_PUT_U8 (msg, IFLA_BOND_FAIL_OVER_MAC, props->fail_over_mac);
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_XMIT_HASH_POLICY))
+		NLA_PUT_U8 (msg, IFLA_BOND_XMIT_HASH_POLICY, props->xmit_hash_policy);
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_RESEND_IGMP))
+		NLA_PUT_U32 (msg, IFLA_BOND_RESEND_IGMP, props->resend_igmp);
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_LACP_RATE))
+		NLA_PUT_U8 (msg, IFLA_BOND_AD_LACP_RATE, props->lacp_rate);
+	if (NM_FLAGS_HAS (attrs, NM_PLATFORM_LNK_BOND_ATTR_AD_SELECT))
+		NLA_PUT_U8 (msg, IFLA_BOND_AD_SELECT, props->ad_select);
+
+	nla_nest_end (msg, data);
+	nla_nest_end (msg, info);
+
+	return TRUE;
+nla_put_failure:
+	return FALSE;
+}
+
+static gboolean
+_nl_msg_new_link_set_linkinfo_bridge (struct nl_msg *msg,
+                                      const NMPlatformLnkBridge *props)
+{
+	struct nlattr *info;
+	struct nlattr *data;
+
+	nm_assert (msg);
+	nm_assert (props);
+
+	if (!(info = nla_nest_start (msg, IFLA_LINKINFO)))
+		goto nla_put_failure;
+
+	NLA_PUT_STRING (msg, IFLA_INFO_KIND, "bridge");
+
+	if (!(data = nla_nest_start (msg, IFLA_INFO_DATA)))
+		goto nla_put_failure;
+
+	NLA_PUT_U32 (msg, IFLA_BR_FORWARD_DELAY, props->forward_delay);
+	NLA_PUT_U32 (msg, IFLA_BR_HELLO_TIME, props->hello_time);
+	NLA_PUT_U32 (msg, IFLA_BR_MAX_AGE, props->max_age);
+	NLA_PUT_U32 (msg, IFLA_BR_AGEING_TIME, props->ageing_time);
+	NLA_PUT_U32 (msg, IFLA_BR_STP_STATE, !!props->stp_state);
+	NLA_PUT_U16 (msg, IFLA_BR_PRIORITY, props->priority);
+	NLA_PUT_U8 (msg, IFLA_BR_MCAST_SNOOPING, !!props->mcast_snooping);
+
+	nla_nest_end (msg, data);
+	nla_nest_end (msg, info);
+
+	return TRUE;
+nla_put_failure:
+	return FALSE;
+}
+
+static gboolean
+_nl_msg_new_link_set_linkinfo_bridge_port (struct nl_msg *msg,
+                                           const NMPlatformBridgePort *props)
+{
+	struct nlattr *info;
+	struct nlattr *data;
+
+	nm_assert (msg);
+	nm_assert (props);
+
+	if (!(info = nla_nest_start (msg, IFLA_LINKINFO)))
+		goto nla_put_failure;
+
+	NLA_PUT_STRING (msg, IFLA_INFO_SLAVE_KIND, "bridge");
+
+	if (!(data = nla_nest_start (msg, IFLA_INFO_SLAVE_DATA)))
+		goto nla_put_failure;
+
+	NLA_PUT_U16 (msg, IFLA_BRPORT_PRIORITY, props->priority);
+	NLA_PUT_U32 (msg, IFLA_BRPORT_COST, props->path_cost);
+	NLA_PUT_U8 (msg, IFLA_BRPORT_MODE, !!props->hairpin_mode);
+
+	nla_nest_end (msg, data);
+	nla_nest_end (msg, info);
+
+	return TRUE;
+nla_put_failure:
+	return FALSE;
+}
+
 static struct nl_msg *
 _nl_msg_new_link (int nlmsg_type,
                   int nlmsg_flags,
@@ -2304,6 +2625,70 @@ nla_put_failure:
 	g_return_val_if_reached (NULL);
 }
 
+/* Request a single IPv6 address from kernel. Kernel does not support
+ * requesting single IPv4 addresses (RTM_GETADDR without NLM_F_DUMP). */
+static struct nl_msg *
+_nl_msg_new_ip6_address_get (int ifindex, const struct in6_addr *address, int plen)
+{
+	struct nl_msg *msg;
+	struct ifaddrmsg am = {
+		.ifa_family = AF_INET6,
+		.ifa_index = ifindex,
+		.ifa_prefixlen = plen,
+	};
+
+	msg = nlmsg_alloc_simple (RTM_GETADDR, 0);
+	if (!msg)
+		g_return_val_if_reached (NULL);
+
+	if (nlmsg_append (msg, &am, sizeof (am), NLMSG_ALIGNTO) < 0)
+		goto nla_put_failure;
+
+	NLA_PUT (msg, IFA_ADDRESS, sizeof (*address), address);
+
+	return msg;
+
+nla_put_failure:
+	nlmsg_free (msg);
+	g_return_val_if_reached (NULL);
+}
+
+/* Request the route that kernel would select for @network via @ifindex.
+ * With RTM_F_FIB_MATCH, kernel returns the matching FIB entry instead of
+ * the resulting (cloned) route. */
+static struct nl_msg *
+_nl_msg_new_route_get (int family, int ifindex, gconstpointer network, int plen)
+{
+	struct nl_msg *msg;
+	struct rtmsg rtmsg = {
+		.rtm_family = family,
+		.rtm_flags = RTM_F_FIB_MATCH,
+	};
+	NMIPAddr network_clean;
+	gsize addr_len;
+
+	nm_assert (NM_IN_SET (family, AF_INET, AF_INET6));
+
+	msg = nlmsg_alloc_simple (RTM_GETROUTE, 0);
+	if (!msg)
+		g_return_val_if_reached (NULL);
+
+	if (nlmsg_append (msg, &rtmsg, sizeof (rtmsg), NLMSG_ALIGNTO) < 0)
+		goto nla_put_failure;
+
+	addr_len = family == AF_INET ? sizeof (in_addr_t) : sizeof (struct in6_addr);
+
+	clear_host_address (family, network, plen, &network_clean);
+	NLA_PUT (msg, RTA_DST, addr_len, &network_clean);
+	NLA_PUT_U32 (msg, RTA_OIF, ifindex);
+
+	return msg;
+
+nla_put_failure:
+	nlmsg_free (msg);
+	g_return_val_if_reached (NULL);
+}
+
 /******************************************************************/
 
 static int _support_kernel_extended_ifa_flags = -1;
@@ -2311,14 +2696,11 @@ static int _support_kernel_extended_ifa_flags = -1;
 #define _support_kernel_extended_ifa_flags_still_undecided() (G_UNLIKELY (_support_kernel_extended_ifa_flags == -1))
 
 static void
-_support_kernel_extended_ifa_flags_detect (struct nl_msg *msg)
+_support_kernel_extended_ifa_flags_detect (struct nlmsghdr *msg_hdr)
 {
-	struct nlmsghdr *msg_hdr;
-
 	if (!_support_kernel_extended_ifa_flags_still_undecided ())
 		return;
 
-	msg_hdr = nlmsg_hdr (msg);
 	if (msg_hdr->nlmsg_type != RTM_NEWADDR)
 		return;
 
@@ -2344,6 +2726,29 @@ _support_kernel_extended_ifa_flags_get (void)
 	return _support_kernel_extended_ifa_flags;
 }
 
+/* Kernels before 4.13 ignore RTM_F_FIB_MATCH and reply to a RTM_GETROUTE
+ * with a cloned host route. We detect that from the first reply and then
+ * stop requesting single routes. */
+static int _support_rtm_f_fib_match = -1;
+
+#define _support_rtm_f_fib_match_still_undecided() (G_UNLIKELY (_support_rtm_f_fib_match == -1))
+
+static void
+_support_rtm_f_fib_match_detect (struct nlmsghdr *msg_hdr)
+{
+	const struct rtmsg *rtm = nlmsg_data (msg_hdr);
+
+	if (NM_FLAGS_HAS (rtm->rtm_flags, RTM_F_CLONED))
+		_support_rtm_f_fib_match = 0;
+	else if (rtm->rtm_family == AF_INET) {
+		/* a reply for IPv6 is not necessarily a cloned route, even
+		 * if kernel ignored the flag. Only decide by IPv4. */
+		_support_rtm_f_fib_match = 1;
+	} else
+		return;
+	_LOG2D ("support: rtm-f-fib-match: %ssupported", _support_rtm_f_fib_match ? "" : "not ");
+}
+
 /******************************************************************
  * NMPlatform types and functions
  ******************************************************************/
@@ -2351,12 +2756,32 @@ _support_kernel_extended_ifa_flags_get (void)
 typedef struct {
 	guint32 seq_number;
 	gint64 timeout_abs_ns;
+	/* for dump requests, when the request was sent. Otherwise zero. */
+	gint64 dump_started_ns;
 	WaitForNlResponseResult seq_result;
 	WaitForNlResponseResult *out_seq_result;
 } DelayedActionWaitForNlResponseData;
 
+/* a pending RTM_GETROUTE request for a single route. */
+typedef struct {
+	guint32 seq_number;
+	NMPObject *obj_id;
+} RouteGetData;
+
 typedef struct _NMLinuxPlatformPrivate NMLinuxPlatformPrivate;
 
+typedef struct {
+	struct mmsghdr msgs[RECV_DGRAMS_MAX];
+	struct iovec iov[RECV_DGRAMS_MAX];
+	struct sockaddr_nl nla[RECV_DGRAMS_MAX];
+	union {
+		struct cmsghdr cmsghdr;
+		char buf[CMSG_SPACE (sizeof (struct ucred))];
+	} cmsg[RECV_DGRAMS_MAX];
+	gsize dgram_size;
+	guint8 *buf;
+} RecvBuffers;
+
 struct _NMLinuxPlatformPrivate {
 	struct nl_sock *nlh;
 	guint32 nlh_seq_next;
@@ -2368,6 +2793,9 @@ struct _NMLinuxPlatformPrivate {
 	gboolean sysctl_get_warned;
 	GHashTable *sysctl_get_prev_values;
 
+	/* ifindex -> SysctlDirfds */
+	GHashTable *sysctl_dirfds;
+
 	GUdevClient *udev_client;
 
 	struct {
@@ -2380,6 +2808,39 @@ struct _NMLinuxPlatformPrivate {
 
 	GHashTable *prune_candidates;
 
+	/* buffers to receive several netlink datagrams at once. The messages
+	 * are parsed in place, without copying them. */
+	RecvBuffers *recv_buffers;
+	gboolean recv_buffers_in_use;
+
+	/* the size of the largest datagram seen so far, at least RECV_DGRAM_SIZE. */
+	gsize recv_dgram_size;
+
+	/* how often we had to refetch all objects of a type, because a
+	 * targeted refetch of a single object was not possible or failed. */
+	guint refetch_all_count;
+
+	/* RouteGetData for the replies to single route requests, which
+	 * must be checked before updating the cache. */
+	GArray *route_get;
+
+	/* state to recover from a netlink receive buffer overrun (ENOBUFS). */
+	struct {
+		DelayedActionType pending;
+		guint idle_id;
+		gint64 started_at_ns;
+		guint overruns;
+		guint overruns_total;
+		guint recoveries_total;
+	} resync;
+
+	/* counters for nm_platform_get_stats(). */
+	struct {
+		guint64 netlink_msgs[_NM_PLATFORM_STATS_MSG_LAST];
+		NMPlatformStatsDuration dumps;
+		guint64 delayed_actions;
+	} stats;
+
 	GHashTable *wifi_data;
 };
 
@@ -2434,32 +2895,13 @@ _log_dbg_sysctl_set_impl (NMPlatform *platform, const char *path, const char *va
 	} G_STMT_END
 
 static gboolean
-sysctl_set (NMPlatform *platform, const char *path, const char *value)
+_sysctl_write_fd (NMPlatform *platform, int fd, const char *path, const char *value)
 {
-	int fd, len, nwrote, tries;
+	int len, nwrote, tries;
+	char buf[64];
+	gs_free char *actual_free = NULL;
 	char *actual;
 
-	g_return_val_if_fail (path != NULL, FALSE);
-	g_return_val_if_fail (value != NULL, FALSE);
-
-	/* Don't write outside known locations */
-	g_assert (g_str_has_prefix (path, "/proc/sys/")
-	          || g_str_has_prefix (path, "/sys/"));
-	/* Don't write to suspicious locations */
-	g_assert (!strstr (path, "/../"));
-
-	fd = open (path, O_WRONLY | O_TRUNC);
-	if (fd == -1) {
-		if (errno == ENOENT) {
-			_LOGD ("sysctl: failed to open '%s': (%d) %s",
-			       path, errno, strerror (errno));
-		} else {
-			_LOGE ("sysctl: failed to open '%s': (%d) %s",
-			       path, errno, strerror (errno));
-		}
-		return FALSE;
-	}
-
 	_log_dbg_sysctl_set (platform, path, value);
 
 	/* Most sysfs and sysctl options don't care about a trailing LF, while some
@@ -2467,10 +2909,16 @@ sysctl_set (NMPlatform *platform, const char *path, const char *value)
 	 * sysctl support partial writes so the LF must be added to the string we're
 	 * about to write.
 	 */
-	actual = g_strdup_printf ("%s\n", value);
+	len = strlen (value) + 1;
+	if (len < sizeof (buf))
+		actual = buf;
+	else
+		actual = actual_free = g_malloc (len + 1);
+	memcpy (actual, value, len - 1);
+	actual[len - 1] = '\n';
+	actual[len] = '\0';
 
 	/* Try to write the entire value three times if a partial write occurs */
-	len = strlen (actual);
 	for (tries = 0, nwrote = 0; tries < 3 && nwrote != len; tries++) {
 		nwrote = write (fd, actual, len);
 		if (nwrote == -1) {
@@ -2489,11 +2937,47 @@ sysctl_set (NMPlatform *platform, const char *path, const char *value)
 		       path, value);
 	}
 
-	g_free (actual);
-	close (fd);
 	return (nwrote == len);
 }
 
+static void
+_log_sysctl_open_failed (NMPlatform *platform, const char *path, int errsv)
+{
+	if (NM_IN_SET (errsv, ENOENT, ENODEV)) {
+		_LOGD ("sysctl: failed to open '%s': (%d) %s",
+		       path, errsv, strerror (errsv));
+	} else {
+		_LOGE ("sysctl: failed to open '%s': (%d) %s",
+		       path, errsv, strerror (errsv));
+	}
+}
+
+static gboolean
+sysctl_set (NMPlatform *platform, const char *path, const char *value)
+{
+	int fd;
+	gboolean success;
+
+	g_return_val_if_fail (path != NULL, FALSE);
+	g_return_val_if_fail (value != NULL, FALSE);
+
+	/* Don't write outside known locations */
+	g_assert (g_str_has_prefix (path, "/proc/sys/")
+	          || g_str_has_prefix (path, "/sys/"));
+	/* Don't write to suspicious locations */
+	g_assert (!strstr (path, "/../"));
+
+	fd = open (path, O_WRONLY | O_TRUNC);
+	if (fd == -1) {
+		_log_sysctl_open_failed (platform, path, errno);
+		return FALSE;
+	}
+
+	success = _sysctl_write_fd (platform, fd, path, value);
+	close (fd);
+	return success;
+}
+
 static GSList *sysctl_clear_cache_list;
 
 void
@@ -2585,16 +3069,213 @@ sysctl_get (NMPlatform *platform, const char *path)
 
 /******************************************************************/
 
-static gboolean
-check_support_kernel_extended_ifa_flags (NMPlatform *platform)
-{
-	g_return_val_if_fail (NM_IS_LINUX_PLATFORM (platform), FALSE);
+/* Keep the directories of at most that many interfaces open. Activating
+ * an interface accesses its options in a short time, so a small cache
+ * suffices and we don't run out of file descriptors with many interfaces. */
+#define SYSCTL_DIRFDS_MAX 128
 
-	return _support_kernel_extended_ifa_flags_get ();
-}
+typedef struct {
+	char ifname[IFNAMSIZ];
+	int dirfd[_NM_PLATFORM_SYSCTL_DIR_NUM];
+} SysctlDirfds;
 
-static gboolean
-check_support_user_ipv6ll (NMPlatform *platform)
+static void
+_sysctl_dirfds_close (SysctlDirfds *dirfds)
+{
+	guint i;
+
+	for (i = 0; i < _NM_PLATFORM_SYSCTL_DIR_NUM; i++) {
+		if (dirfds->dirfd[i] >= 0) {
+			close (dirfds->dirfd[i]);
+			dirfds->dirfd[i] = -1;
+		}
+	}
+}
+
+static void
+_sysctl_dirfds_free (SysctlDirfds *dirfds)
+{
+	_sysctl_dirfds_close (dirfds);
+	g_slice_free (SysctlDirfds, dirfds);
+}
+
+static void
+_sysctl_dirfds_drop (NMPlatform *platform, int ifindex)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	g_hash_table_remove (priv->sysctl_dirfds, GINT_TO_POINTER (ifindex));
+}
+
+/* Returns an O_PATH file descriptor of the directory @dir of @ifindex.
+ * With @reopen, a cached descriptor is not trusted. */
+static int
+_sysctl_dirfd_get (NMPlatform *platform, int ifindex, NMPlatformSysctlDir dir, gboolean reopen, const char **out_ifname)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	SysctlDirfds *dirfds;
+	const char *ifname;
+	char path[NM_PLATFORM_SYSCTL_PATH_MAX];
+	guint i;
+
+	ifname = nm_platform_link_get_name (platform, ifindex);
+	if (!ifname) {
+		errno = ENODEV;
+		return -1;
+	}
+
+	dirfds = g_hash_table_lookup (priv->sysctl_dirfds, GINT_TO_POINTER (ifindex));
+	if (!dirfds) {
+		if (g_hash_table_size (priv->sysctl_dirfds) >= SYSCTL_DIRFDS_MAX) {
+			GHashTableIter iter;
+
+			g_hash_table_iter_init (&iter, priv->sysctl_dirfds);
+			if (g_hash_table_iter_next (&iter, NULL, NULL))
+				g_hash_table_iter_remove (&iter);
+		}
+		dirfds = g_slice_new (SysctlDirfds);
+		dirfds->ifname[0] = '\0';
+		for (i = 0; i < _NM_PLATFORM_SYSCTL_DIR_NUM; i++)
+			dirfds->dirfd[i] = -1;
+		g_hash_table_insert (priv->sysctl_dirfds, GINT_TO_POINTER (ifindex), dirfds);
+	}
+
+	if (strcmp (dirfds->ifname, ifname) != 0) {
+		/* the interface was renamed, which re-creates its directories in /proc/sys. */
+		_sysctl_dirfds_close (dirfds);
+		g_strlcpy (dirfds->ifname, ifname, sizeof (dirfds->ifname));
+	} else if (reopen && dirfds->dirfd[dir] >= 0) {
+		close (dirfds->dirfd[dir]);
+		dirfds->dirfd[dir] = -1;
+	}
+
+	*out_ifname = dirfds->ifname;
+
+	if (dirfds->dirfd[dir] < 0) {
+		dirfds->dirfd[dir] = open (_nm_platform_sysctl_dir_path (dir, ifname, NULL, path, sizeof (path)),
+		                           O_PATH | O_DIRECTORY | O_CLOEXEC);
+	}
+	return dirfds->dirfd[dir];
+}
+
+static int
+_sysctl_openat (NMPlatform *platform, int ifindex, NMPlatformSysctlDir dir, const char *name, int flags,
+                char *path, gsize path_len)
+{
+	const char *ifname = NULL;
+	gboolean reopen = FALSE;
+	int dirfd, fd, errsv;
+
+	g_return_val_if_fail (name != NULL, -1);
+
+	/* Don't open anything outside of the directory, like sysctl_set() */
+	g_assert (name[0] != '/');
+	g_assert (!g_str_has_prefix (name, "../"));
+	g_assert (!strstr (name, "/../"));
+
+again:
+	dirfd = _sysctl_dirfd_get (platform, ifindex, dir, reopen, &ifname);
+	if (ifname)
+		_nm_platform_sysctl_dir_path (dir, ifname, name, path, path_len);
+	else
+		g_snprintf (path, path_len, "ifindex %d: %s", ifindex, name);
+	if (dirfd < 0)
+		return -1;
+
+	fd = openat (dirfd, name, flags | O_CLOEXEC);
+	if (fd < 0) {
+		errsv = errno;
+		if (errsv == ENOENT && !reopen) {
+			/* the directory might belong to an interface that was already
+			 * removed or renamed, but we did not yet process the notification. */
+			reopen = TRUE;
+			goto again;
+		}
+		errno = errsv;
+	}
+	return fd;
+}
+
+static gboolean
+sysctl_ifindex_set (NMPlatform *platform, int ifindex, NMPlatformSysctlDir dir, const char *name, const char *value)
+{
+	char path[NM_PLATFORM_SYSCTL_PATH_MAX];
+	gboolean success;
+	int fd;
+
+	fd = _sysctl_openat (platform, ifindex, dir, name, O_WRONLY | O_TRUNC, path, sizeof (path));
+	if (fd < 0) {
+		_log_sysctl_open_failed (platform, path, errno);
+		return FALSE;
+	}
+
+	success = _sysctl_write_fd (platform, fd, path, value);
+	close (fd);
+	return success;
+}
+
+static char *
+sysctl_ifindex_get (NMPlatform *platform, int ifindex, NMPlatformSysctlDir dir, const char *name)
+{
+	char path[NM_PLATFORM_SYSCTL_PATH_MAX];
+	char *contents = NULL;
+	gsize len = 0, alloc = 128;
+	ssize_t n;
+	int fd, errsv = 0;
+
+	fd = _sysctl_openat (platform, ifindex, dir, name, O_RDONLY, path, sizeof (path));
+	if (fd < 0)
+		errsv = errno;
+	else {
+		contents = g_malloc (alloc);
+		for (;;) {
+			if (len + 1 >= alloc) {
+				alloc *= 2;
+				contents = g_realloc (contents, alloc);
+			}
+			n = read (fd, &contents[len], alloc - len - 1);
+			if (n < 0) {
+				if (errno == EINTR)
+					continue;
+				errsv = errno;
+				break;
+			}
+			if (n == 0)
+				break;
+			len += n;
+		}
+		close (fd);
+	}
+
+	if (errsv) {
+		if (NM_IN_SET (errsv, ENOENT, ENODEV, EOPNOTSUPP))
+			_LOGD ("error reading %s: %s", path, g_strerror (errsv));
+		else
+			_LOGE ("error reading %s: %s", path, g_strerror (errsv));
+		g_free (contents);
+		return NULL;
+	}
+
+	contents[len] = '\0';
+	g_strstrip (contents);
+
+	_log_dbg_sysctl_get (platform, path, contents);
+
+	return contents;
+}
+
+/******************************************************************/
+
+static gboolean
+check_support_kernel_extended_ifa_flags (NMPlatform *platform)
+{
+	g_return_val_if_fail (NM_IS_LINUX_PLATFORM (platform), FALSE);
+
+	return _support_kernel_extended_ifa_flags_get ();
+}
+
+static gboolean
+check_support_user_ipv6ll (NMPlatform *platform)
 {
 	g_return_val_if_fail (NM_IS_LINUX_PLATFORM (platform), FALSE);
 
@@ -2607,6 +3288,40 @@ process_events (NMPlatform *platform)
 	delayed_action_handle_all (platform, TRUE);
 }
 
+static void
+get_stats (NMPlatform *platform, NMPlatformStats *stats)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	static const NMPObjectType cached_types[] = {
+		NMP_OBJECT_TYPE_LINK,
+		NMP_OBJECT_TYPE_IP4_ADDRESS,
+		NMP_OBJECT_TYPE_IP6_ADDRESS,
+		NMP_OBJECT_TYPE_IP4_ROUTE,
+		NMP_OBJECT_TYPE_IP6_ROUTE,
+	};
+	guint i;
+
+	memcpy (stats->netlink_msgs, priv->stats.netlink_msgs, sizeof (stats->netlink_msgs));
+	stats->dumps = priv->stats.dumps;
+	stats->overruns = priv->resync.overruns_total;
+	stats->resyncs = priv->resync.recoveries_total;
+	stats->delayed_actions = priv->stats.delayed_actions;
+	stats->refetches_all = priv->refetch_all_count;
+
+	for (i = 0; i < G_N_ELEMENTS (cached_types); i++) {
+		NMPObjectType obj_type = cached_types[i];
+		NMPObjectPoolStats pool_stats;
+		guint len;
+
+		nmp_cache_lookup_multi (priv->cache,
+		                        nmp_cache_id_init_object_type (NMP_CACHE_ID_STATIC, obj_type, FALSE),
+		                        &len);
+		nmp_object_pool_get_stats (obj_type, &pool_stats);
+		stats->cache_objs[obj_type] = len;
+		stats->cache_bytes[obj_type] = (guint64) len * pool_stats.obj_size;
+	}
+}
+
 /******************************************************************/
 
 #define cache_lookup_all_objects(type, platform, obj_type, visible_only) \
@@ -2672,13 +3387,12 @@ do_emit_signal (NMPlatform *platform, const NMPObject *obj, NMPCacheOpsType cach
 	/* don't expose @obj directly, but clone the public fields. A signal handler might
 	 * call back into NMPlatform which could invalidate (or modify) @obj. */
 	memcpy (&obj_clone.object, &obj->object, klass->sizeof_public);
-	g_signal_emit (platform,
-	               _nm_platform_signal_id_get (klass->signal_type_id),
-	               0,
-	               klass->obj_type,
-	               obj_clone.object.ifindex,
-	               &obj_clone.object,
-	               (NMPlatformSignalChangeType) cache_op);
+	_nm_platform_signal_emit (platform,
+	                          klass->signal_type_id,
+	                          klass->obj_type,
+	                          obj_clone.object.ifindex,
+	                          &obj_clone.object,
+	                          (NMPlatformSignalChangeType) cache_op);
 }
 
 /******************************************************************/
@@ -2776,6 +3490,27 @@ delayed_action_to_string_full (DelayedActionType action_type, gpointer user_data
 
 /*****************************************************************************/
 
+/* Returns (transfer full) the requested route ID for a pending single
+ * route request with sequence number @seq_number and forgets the request. */
+static NMPObject *
+route_get_take (NMPlatform *platform, guint32 seq_number)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	guint i;
+
+	for (i = 0; i < priv->route_get->len; i++) {
+		RouteGetData *data = &g_array_index (priv->route_get, RouteGetData, i);
+
+		if (data->seq_number == seq_number) {
+			NMPObject *obj_id = data->obj_id;
+
+			g_array_remove_index_fast (priv->route_get, i);
+			return obj_id;
+		}
+	}
+	return NULL;
+}
+
 static void
 delayed_action_wait_for_nl_response_complete (NMPlatform *platform,
                                               guint idx,
@@ -2793,8 +3528,13 @@ delayed_action_wait_for_nl_response_complete (NMPlatform *platform,
 
 	_LOGt_delayed_action (DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE, data, "complete");
 
+	if (data->dump_started_ns && seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK)
+		nm_platform_stats_duration_add (&priv->stats.dumps, nm_utils_get_monotonic_timestamp_ns () - data->dump_started_ns);
+
 	out_seq_result = data->out_seq_result;
 
+	nmp_object_unref (route_get_take (platform, data->seq_number));
+
 	g_array_remove_index_fast (priv->delayed_action.list_wait_for_nl_response, idx);
 	/* Note: @data is invalidated at this point */
 
@@ -2947,8 +3687,12 @@ delayed_action_handle_one (NMPlatform *platform)
 	return FALSE;
 }
 
+/* Only the netlink event handler and the resync idle handler pass
+ * @finish_resync as %FALSE. Everybody else expects an up to date cache
+ * afterwards, so the refresh of object types that are still pending
+ * after an overrun is done right away. */
 static gboolean
-delayed_action_handle_all (NMPlatform *platform, gboolean read_netlink)
+_delayed_action_handle_all (NMPlatform *platform, gboolean read_netlink, gboolean finish_resync)
 {
 	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
 	gboolean any = FALSE;
@@ -2958,15 +3702,58 @@ delayed_action_handle_all (NMPlatform *platform, gboolean read_netlink)
 	priv->delayed_action.is_handling++;
 	if (read_netlink)
 		delayed_action_schedule (platform, DELAYED_ACTION_TYPE_READ_NETLINK, NULL);
-	while (delayed_action_handle_one (platform))
-		any = TRUE;
+	while (TRUE) {
+		while (delayed_action_handle_one (platform)) {
+			priv->stats.delayed_actions++;
+			any = TRUE;
+		}
+		if (!finish_resync || !priv->resync.pending)
+			break;
+		_LOGD ("netlink: resync: refresh all pending object types now");
+		delayed_action_schedule (platform, priv->resync.pending, NULL);
+		priv->resync.pending = DELAYED_ACTION_TYPE_NONE;
+	}
 	priv->delayed_action.is_handling--;
 
 	cache_prune_candidates_prune (platform);
 
+	if (   finish_resync
+	    && priv->resync.idle_id
+	    && !priv->resync.pending) {
+		nm_clear_g_source (&priv->resync.idle_id);
+		resync_finish (platform);
+	}
+
 	return any;
 }
 
+static gboolean
+delayed_action_handle_all (NMPlatform *platform, gboolean read_netlink)
+{
+	return _delayed_action_handle_all (platform, read_netlink, TRUE);
+}
+
+/* While a resync after an overrun is in progress, reads are served from
+ * the cache. Only if the object type being read still waits for its
+ * refresh, dump that type right away. The other types and delayed actions
+ * are left to resync_idle_cb(). The kernel can't dump addresses or routes
+ * of a single interface, so the whole type is refreshed. */
+static void
+cache_ensure_resynced (NMPlatform *platform, NMPObjectType obj_type)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	DelayedActionType action_type = delayed_action_refresh_from_object_type (obj_type);
+
+	if (   !NM_FLAGS_HAS (priv->resync.pending, action_type)
+	    || priv->delayed_action.is_handling)
+		return;
+
+	_LOGD ("netlink: resync: refresh %s now", nmp_class_from_type (obj_type)->obj_type_name);
+	do_request_all_no_delayed_actions (platform, action_type);
+	event_handler_read_netlink (platform, TRUE);
+	cache_prune_candidates_prune (platform);
+}
+
 static void
 delayed_action_schedule (NMPlatform *platform, DelayedActionType action_type, gpointer user_data)
 {
@@ -3008,11 +3795,14 @@ delayed_action_schedule (NMPlatform *platform, DelayedActionType action_type, gp
 static void
 delayed_action_schedule_WAIT_FOR_NL_RESPONSE (NMPlatform *platform,
                                               guint32 seq_number,
+                                              gboolean is_dump,
                                               WaitForNlResponseResult *out_seq_result)
 {
+	gint64 now_ns = nm_utils_get_monotonic_timestamp_ns ();
 	DelayedActionWaitForNlResponseData data = {
 		.seq_number = seq_number,
-		.timeout_abs_ns = nm_utils_get_monotonic_timestamp_ns () + (200 * (NM_UTILS_NS_PER_SECOND / 1000)),
+		.timeout_abs_ns = now_ns + (200 * (NM_UTILS_NS_PER_SECOND / 1000)),
+		.dump_started_ns = is_dump ? now_ns : 0,
 		.out_seq_result = out_seq_result,
 	};
 
@@ -3134,6 +3924,12 @@ cache_pre_hook (NMPCache *cache, const NMPObject *old, const NMPObject *new, NMP
 
 	switch (klass->obj_type) {
 	case NMP_OBJECT_TYPE_LINK:
+		{
+			/* the cached sysctl directories of a removed link are stale. */
+			if (   ops_type == NMP_CACHE_OPS_REMOVED
+			    && old /* <-- nonsensical, make coverity happy */)
+				_sysctl_dirfds_drop (platform, old->link.ifindex);
+		}
 		{
 			/* check whether changing a slave link can cause a master link (bridge or bond) to go up/down */
 			if (   old
@@ -3330,7 +4126,10 @@ _nl_send_auto_with_seq (NMPlatform *platform,
 
 	if (nle >= 0) {
 		nle = 0;
-		delayed_action_schedule_WAIT_FOR_NL_RESPONSE (platform, seq, out_seq_result);
+		delayed_action_schedule_WAIT_FOR_NL_RESPONSE (platform,
+		                                              seq,
+		                                              NM_FLAGS_ALL (nlmsg_hdr (nlmsg)->nlmsg_flags, NLM_F_DUMP),
+		                                              out_seq_result);
 	} else
 		_LOGD ("netlink: send: failed sending message: %s (%d)", nl_geterror (nle), nle);
 
@@ -3400,6 +4199,7 @@ do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType actio
 
 			/* clear any delayed action that request a refresh of this object type. */
 			priv->delayed_action.flags &= ~iflags;
+			priv->resync.pending &= ~iflags;
 			_LOGt_delayed_action (iflags, NULL, "handle (do-request-all)");
 			if (obj_type == NMP_OBJECT_TYPE_LINK) {
 				priv->delayed_action.flags &= ~DELAYED_ACTION_TYPE_REFRESH_LINK;
@@ -3435,15 +4235,101 @@ do_request_one_type (NMPlatform *platform, NMPObjectType obj_type)
 	delayed_action_handle_all (platform, FALSE);
 }
 
+static gboolean
+do_request_object_no_delayed_actions (NMPlatform *platform, const NMPObject *obj_id)
+{
+	nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+
+	switch (NMP_OBJECT_GET_TYPE (obj_id)) {
+	case NMP_OBJECT_TYPE_IP6_ADDRESS:
+		nlmsg = _nl_msg_new_ip6_address_get (obj_id->ip6_address.ifindex,
+		                                     &obj_id->ip6_address.address,
+		                                     obj_id->ip6_address.plen);
+		break;
+	case NMP_OBJECT_TYPE_IP4_ROUTE:
+		if (!_support_rtm_f_fib_match)
+			return FALSE;
+		nlmsg = _nl_msg_new_route_get (AF_INET,
+		                               obj_id->ip4_route.ifindex,
+		                               &obj_id->ip4_route.network,
+		                               obj_id->ip4_route.plen);
+		break;
+	case NMP_OBJECT_TYPE_IP6_ROUTE:
+		if (!_support_rtm_f_fib_match)
+			return FALSE;
+		nlmsg = _nl_msg_new_route_get (AF_INET6,
+		                               obj_id->ip6_route.ifindex,
+		                               &obj_id->ip6_route.network,
+		                               obj_id->ip6_route.plen);
+		break;
+	default:
+		/* there is no way to request a single object of this type. */
+		return FALSE;
+	}
+
+	if (!nlmsg)
+		return FALSE;
+
+	_LOGD ("do-request-object: %s", nmp_object_to_string (obj_id, NMP_OBJECT_TO_STRING_ID, NULL, 0));
+	if (_nl_send_auto_with_seq (platform, nlmsg, NULL) < 0)
+		return FALSE;
+
+	if (NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id), NMP_OBJECT_TYPE_IP4_ROUTE, NMP_OBJECT_TYPE_IP6_ROUTE)) {
+		RouteGetData data = {
+			.seq_number = nlmsg_hdr (nlmsg)->nlmsg_seq,
+			.obj_id = nmp_object_clone (obj_id, TRUE),
+		};
+
+		/* the reply is the best matching route, not necessarily the
+		 * requested one. Remember the request, to check the reply. */
+		g_array_append_val (NM_LINUX_PLATFORM_GET_PRIVATE (platform)->route_get, data);
+	}
+	return TRUE;
+}
+
+static void
+do_request_all_fallback_no_delayed_actions (NMPlatform *platform, DelayedActionType action_type, const char *reason)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	priv->refetch_all_count++;
+	_LOGD ("do-request-all: refetch all objects because %s (happened %u times)",
+	       reason, priv->refetch_all_count);
+	do_request_all_no_delayed_actions (platform, action_type);
+}
+
+/* Refetch an object which we just added but which is not yet in the cache.
+ * First try to request only that object and only fall back to dumping
+ * all objects of the type if that doesn't bring the object into the cache. */
+static const NMPObject *
+do_request_object_after_add (NMPlatform *platform, const NMPObject *obj_id)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	const NMPObject *obj;
+
+	if (do_request_object_no_delayed_actions (platform, obj_id)) {
+		delayed_action_handle_all (platform, FALSE);
+		obj = nmp_cache_lookup_obj (priv->cache, obj_id);
+		if (obj)
+			return obj;
+	}
+
+	do_request_all_fallback_no_delayed_actions (platform,
+	                                            delayed_action_refresh_from_object_type (NMP_OBJECT_GET_TYPE (obj_id)),
+	                                            "added object is missing in cache");
+	delayed_action_handle_all (platform, FALSE);
+	return nmp_cache_lookup_obj (priv->cache, obj_id);
+}
+
 static void
-event_seq_check (NMPlatform *platform, struct nl_msg *msg, WaitForNlResponseResult seq_result)
+event_seq_check (NMPlatform *platform, struct nlmsghdr *msghdr, WaitForNlResponseResult seq_result)
 {
 	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
 	DelayedActionWaitForNlResponseData *data;
 	guint32 seq_number;
 	guint i;
 
-	seq_number = nlmsg_hdr (msg)->nlmsg_seq;
+	seq_number = msghdr->nlmsg_seq;
 
 	if (seq_number == 0)
 		return;
@@ -3473,22 +4359,46 @@ event_seq_check (NMPlatform *platform, struct nl_msg *msg, WaitForNlResponseResu
 	priv->nlh_seq_last_handled = seq_number;
 }
 
+static NMPlatformStatsMsgType
+_stats_msg_type (guint16 nlmsg_type)
+{
+	switch (nlmsg_type) {
+	case RTM_NEWLINK:  return NM_PLATFORM_STATS_MSG_NEWLINK;
+	case RTM_DELLINK:  return NM_PLATFORM_STATS_MSG_DELLINK;
+	case RTM_NEWADDR:  return NM_PLATFORM_STATS_MSG_NEWADDR;
+	case RTM_DELADDR:  return NM_PLATFORM_STATS_MSG_DELADDR;
+	case RTM_NEWROUTE: return NM_PLATFORM_STATS_MSG_NEWROUTE;
+	case RTM_DELROUTE: return NM_PLATFORM_STATS_MSG_DELROUTE;
+	default:           return NM_PLATFORM_STATS_MSG_OTHER;
+	}
+}
+
 static void
-event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_events)
+event_valid_msg (NMPlatform *platform, struct nlmsghdr *msghdr, gboolean handle_events)
 {
 	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
 	nm_auto_nmpobj NMPObject *obj = NULL;
 	nm_auto_nmpobj NMPObject *obj_cache = NULL;
+	nm_auto_nmpobj NMPObject *obj_route_get = NULL;
 	NMPCacheOpsType cache_op;
-	struct nlmsghdr *msghdr;
 	char buf_nlmsg_type[16];
 	gboolean id_only = FALSE;
+	gboolean route_get_only = FALSE;
 	gboolean was_visible;
 
-	msghdr = nlmsg_hdr (msg);
+	priv->stats.netlink_msgs[_stats_msg_type (msghdr->nlmsg_type)]++;
 
 	if (_support_kernel_extended_ifa_flags_still_undecided () && msghdr->nlmsg_type == RTM_NEWADDR)
-		_support_kernel_extended_ifa_flags_detect (msg);
+		_support_kernel_extended_ifa_flags_detect (msghdr);
+
+	if (   msghdr->nlmsg_type == RTM_NEWROUTE
+	    && priv->route_get->len > 0
+	    && (obj_route_get = route_get_take (platform, msghdr->nlmsg_seq))) {
+		/* a reply to a single route request. */
+		if (_support_rtm_f_fib_match_still_undecided ())
+			_support_rtm_f_fib_match_detect (msghdr);
+		route_get_only = TRUE;
+	}
 
 	if (!handle_events)
 		return;
@@ -3499,7 +4409,7 @@ event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_event
 		id_only = TRUE;
 	}
 
-	obj = nmp_object_new_from_nl (platform, priv->cache, msg, id_only);
+	obj = nmp_object_new_from_nl (platform, priv->cache, msghdr, id_only);
 	if (!obj) {
 		_LOGT ("event-notification: %s, seq %u: ignore",
 		       _nl_nlmsg_type_to_str (msghdr->nlmsg_type, buf_nlmsg_type, sizeof (buf_nlmsg_type)),
@@ -3512,6 +4422,17 @@ event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_event
 	       msghdr->nlmsg_seq, nmp_object_to_string (obj,
 	           id_only ? NMP_OBJECT_TO_STRING_ID : NMP_OBJECT_TO_STRING_PUBLIC, NULL, 0));
 
+	if (   route_get_only
+	    && (   obj->ip_route.source == _NM_IP_CONFIG_SOURCE_RTM_F_CLONED
+	        || !nmp_object_id_equal (obj, obj_route_get))) {
+		/* kernel replied with a cloned route or with another route that
+		 * matches better. Neither may replace the cached route with the same
+		 * ID. The caller falls back to a dump, as the object is still missing. */
+		_LOGD ("event-notification: ignore reply for requested route %s",
+		       nmp_object_to_string (obj_route_get, NMP_OBJECT_TO_STRING_ID, NULL, 0));
+		return;
+	}
+
 	switch (msghdr->nlmsg_type) {
 
 	case RTM_NEWLINK:
@@ -3743,22 +4664,44 @@ do_add_addrroute (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *
 	 * kernel. Need to refetch.
 	 *
 	 * We want to safe the expensive refetch, thus we look first into the cache
-	 * whether the object exists.
+	 * whether the object exists. If kernel reported a failure, there is no
+	 * point in refetching at all.
 	 *
 	 * FIXME: if the object already existed previously, we might not notice a
 	 * missing update. It's not clear how to fix that reliably without refechting
 	 * all the time. */
 	obj = nmp_cache_lookup_obj (priv->cache, obj_id);
-	if (!obj) {
-		do_request_one_type (platform, NMP_OBJECT_GET_TYPE (obj_id));
-		obj = nmp_cache_lookup_obj (priv->cache, obj_id);
-	}
+	if (   !obj
+	    && seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK)
+		obj = do_request_object_after_add (platform, obj_id);
 
 	/* Adding is only successful, if kernel reported success *and* we have the
 	 * expected object in cache afterwards. */
 	return obj && seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
 }
 
+static const char *
+_delete_object_get_log_detail (const NMPObject *obj_id, WaitForNlResponseResult seq_result, gboolean *out_success)
+{
+	*out_success = TRUE;
+
+	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK)
+		return "";
+	if (NM_IN_SET (-((int) seq_result), ESRCH, ENOENT))
+		return ", meaning the object was already removed";
+	if (   NM_IN_SET (-((int) seq_result), ENXIO)
+	    && NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id), NMP_OBJECT_TYPE_IP6_ADDRESS)) {
+		/* On RHEL7 kernel, deleting a non existing address fails with ENXIO */
+		return ", meaning the address was already removed";
+	}
+	if (   NM_IN_SET (-((int) seq_result), EADDRNOTAVAIL)
+	    && NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id), NMP_OBJECT_TYPE_IP4_ADDRESS, NMP_OBJECT_TYPE_IP6_ADDRESS))
+		return ", meaning the address was already removed";
+
+	*out_success = FALSE;
+	return "";
+}
+
 static gboolean
 do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *nlmsg)
 {
@@ -3766,8 +4709,8 @@ do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *
 	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
 	int nle;
 	char s_buf[256];
-	gboolean success = TRUE;
-	const char *log_detail = "";
+	gboolean success;
+	const char *log_detail;
 
 	event_handler_read_netlink (platform, FALSE);
 
@@ -3784,19 +4727,7 @@ do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *
 
 	nm_assert (seq_result);
 
-	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK) {
-		/* ok */
-	} else if (NM_IN_SET (-((int) seq_result), ESRCH, ENOENT))
-		log_detail = ", meaning the object was already removed";
-	else if (   NM_IN_SET (-((int) seq_result), ENXIO)
-	         && NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id), NMP_OBJECT_TYPE_IP6_ADDRESS)) {
-		/* On RHEL7 kernel, deleting a non existing address fails with ENXIO */
-		log_detail = ", meaning the address was already removed";
-	} else if (   NM_IN_SET (-((int) seq_result), EADDRNOTAVAIL)
-	           && NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id), NMP_OBJECT_TYPE_IP4_ADDRESS, NMP_OBJECT_TYPE_IP6_ADDRESS))
-		log_detail = ", meaning the address was already removed";
-	else
-		success = FALSE;
+	log_detail = _delete_object_get_log_detail (obj_id, seq_result, &success);
 
 	_NMLOG (success ? LOGL_DEBUG : LOGL_ERR,
 	        "do-delete-%s[%s]: %s%s",
@@ -3811,8 +4742,307 @@ out:
 
 	/* such an object still exists in the cache. To be sure, refetch it (and
 	 * hope it's gone) */
-	do_request_one_type (platform, NMP_OBJECT_GET_TYPE (obj_id));
-	return !!nmp_cache_lookup_obj (priv->cache, obj_id);
+	do_request_all_fallback_no_delayed_actions (platform,
+	                                            delayed_action_refresh_from_object_type (NMP_OBJECT_GET_TYPE (obj_id)),
+	                                            "deleted object is still in cache");
+	delayed_action_handle_all (platform, FALSE);
+	return !nmp_cache_lookup_obj (priv->cache, obj_id);
+}
+
+/* The maximum number of requests of a batch that we send before reading
+ * the pending responses from the socket. This avoids overflowing the
+ * receive buffer with ACKs and notifications for our own requests. */
+#define BATCH_MAX_IN_FLIGHT 256
+
+static const char *
+_batch_op_type_to_string (NMPlatformBatchOpType op_type)
+{
+	switch (op_type) {
+	case NM_PLATFORM_BATCH_OP_ADD:
+		return "add";
+	case NM_PLATFORM_BATCH_OP_REPLACE:
+		return "replace";
+	case NM_PLATFORM_BATCH_OP_DELETE:
+		return "delete";
+	}
+	g_return_val_if_reached ("unknown");
+}
+
+static struct nl_msg *
+_nl_msg_new_from_batch_op (const NMPlatformBatchOp *op)
+{
+	const NMPObject *obj = op->obj;
+	int route_flags;
+
+	if (op->op_type == NM_PLATFORM_BATCH_OP_DELETE) {
+		switch (NMP_OBJECT_GET_TYPE (obj)) {
+		case NMP_OBJECT_TYPE_IP4_ADDRESS:
+			return _nl_msg_new_address (RTM_DELADDR,
+			                            0,
+			                            AF_INET,
+			                            obj->ip4_address.ifindex,
+			                            &obj->ip4_address.address,
+			                            obj->ip4_address.plen,
+			                            &obj->ip4_address.peer_address,
+			                            0,
+			                            RT_SCOPE_NOWHERE,
+			                            NM_PLATFORM_LIFETIME_PERMANENT,
+			                            NM_PLATFORM_LIFETIME_PERMANENT,
+			                            NULL);
+		case NMP_OBJECT_TYPE_IP6_ADDRESS:
+			return _nl_msg_new_address (RTM_DELADDR,
+			                            0,
+			                            AF_INET6,
+			                            obj->ip6_address.ifindex,
+			                            &obj->ip6_address.address,
+			                            obj->ip6_address.plen,
+			                            NULL,
+			                            0,
+			                            RT_SCOPE_NOWHERE,
+			                            NM_PLATFORM_LIFETIME_PERMANENT,
+			                            NM_PLATFORM_LIFETIME_PERMANENT,
+			                            NULL);
+		case NMP_OBJECT_TYPE_IP4_ROUTE:
+			return _nl_msg_new_route (RTM_DELROUTE,
+			                          0,
+			                          AF_INET,
+			                          obj->ip4_route.ifindex,
+			                          NM_IP_CONFIG_SOURCE_UNKNOWN,
+			                          RT_SCOPE_NOWHERE,
+			                          &obj->ip4_route.network,
+			                          obj->ip4_route.plen,
+			                          NULL,
+			                          obj->ip4_route.metric,
+			                          0,
+			                          NULL);
+		case NMP_OBJECT_TYPE_IP6_ROUTE:
+			return _nl_msg_new_route (RTM_DELROUTE,
+			                          0,
+			                          AF_INET6,
+			                          obj->ip6_route.ifindex,
+			                          NM_IP_CONFIG_SOURCE_UNKNOWN,
+			                          RT_SCOPE_NOWHERE,
+			                          &obj->ip6_route.network,
+			                          obj->ip6_route.plen,
+			                          NULL,
+			                          obj->ip6_route.metric,
+			                          0,
+			                          NULL);
+		default:
+			break;
+		}
+		g_return_val_if_reached (NULL);
+	}
+
+	/* a replace only updates an existing route and fails with ENOENT otherwise. */
+	route_flags = op->op_type == NM_PLATFORM_BATCH_OP_REPLACE
+	              ? NLM_F_REPLACE
+	              : NLM_F_CREATE | NLM_F_REPLACE;
+
+	switch (NMP_OBJECT_GET_TYPE (obj)) {
+	case NMP_OBJECT_TYPE_IP4_ADDRESS:
+		return _nl_msg_new_address (RTM_NEWADDR,
+		                            NLM_F_CREATE | NLM_F_REPLACE,
+		                            AF_INET,
+		                            obj->ip4_address.ifindex,
+		                            &obj->ip4_address.address,
+		                            obj->ip4_address.plen,
+		                            &obj->ip4_address.peer_address,
+		                            0,
+		                            ip4_address_is_link_local (obj->ip4_address.address) ? RT_SCOPE_LINK : RT_SCOPE_UNIVERSE,
+		                            obj->ip4_address.lifetime,
+		                            obj->ip4_address.preferred,
+		                            obj->ip4_address.label[0] ? obj->ip4_address.label : NULL);
+	case NMP_OBJECT_TYPE_IP6_ADDRESS:
+		return _nl_msg_new_address (RTM_NEWADDR,
+		                            NLM_F_CREATE | NLM_F_REPLACE,
+		                            AF_INET6,
+		                            obj->ip6_address.ifindex,
+		                            &obj->ip6_address.address,
+		                            obj->ip6_address.plen,
+		                            &obj->ip6_address.peer_address,
+		                            obj->ip6_address.flags,
+		                            RT_SCOPE_UNIVERSE,
+		                            obj->ip6_address.lifetime,
+		                            obj->ip6_address.preferred,
+		                            NULL);
+	case NMP_OBJECT_TYPE_IP4_ROUTE:
+		return _nl_msg_new_route (RTM_NEWROUTE,
+		                          route_flags,
+		                          AF_INET,
+		                          obj->ip4_route.ifindex,
+		                          obj->ip4_route.source,
+		                          obj->ip4_route.gateway ? RT_SCOPE_UNIVERSE : RT_SCOPE_LINK,
+		                          &obj->ip4_route.network,
+		                          obj->ip4_route.plen,
+		                          &obj->ip4_route.gateway,
+		                          obj->ip4_route.metric,
+		                          obj->ip4_route.mss,
+		                          obj->ip4_route.pref_src ? &obj->ip4_route.pref_src : NULL);
+	case NMP_OBJECT_TYPE_IP6_ROUTE:
+		return _nl_msg_new_route (RTM_NEWROUTE,
+		                          route_flags,
+		                          AF_INET6,
+		                          obj->ip6_route.ifindex,
+		                          obj->ip6_route.source,
+		                          !IN6_IS_ADDR_UNSPECIFIED (&obj->ip6_route.gateway) ? RT_SCOPE_UNIVERSE : RT_SCOPE_LINK,
+		                          &obj->ip6_route.network,
+		                          obj->ip6_route.plen,
+		                          &obj->ip6_route.gateway,
+		                          obj->ip6_route.metric,
+		                          obj->ip6_route.mss,
+		                          NULL);
+	default:
+		break;
+	}
+	g_return_val_if_reached (NULL);
+}
+
+static gboolean
+_batch_op_needs_refetch (NMPlatform *platform, const NMPlatformBatchOp *op, WaitForNlResponseResult seq_result)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	const NMPObject *obj;
+
+	obj = nmp_cache_lookup_obj (priv->cache, op->obj);
+	if (op->op_type != NM_PLATFORM_BATCH_OP_DELETE) {
+		/* see do_add_addrroute(): in rare cases the object is not yet
+		 * in the cache when we receive the ACK. */
+		return !obj && seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
+	}
+	return !!obj;
+}
+
+static void
+object_batch_commit (NMPlatform *platform, NMPlatformBatchOp *ops, guint len)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	gs_free WaitForNlResponseResult *seq_results = NULL;
+	DelayedActionType refresh_types = DELAYED_ACTION_TYPE_NONE;
+	guint i, n_in_flight = 0;
+	char s_buf[256];
+
+	seq_results = g_new0 (WaitForNlResponseResult, len);
+
+	for (i = 0; i < len; i++) {
+		nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (ops[i].obj),
+		                      NMP_OBJECT_TYPE_IP4_ADDRESS, NMP_OBJECT_TYPE_IP6_ADDRESS,
+		                      NMP_OBJECT_TYPE_IP4_ROUTE, NMP_OBJECT_TYPE_IP6_ROUTE));
+
+		if (   ops[i].op_type == NM_PLATFORM_BATCH_OP_DELETE
+		    && NMP_OBJECT_GET_TYPE (ops[i].obj) == NMP_OBJECT_TYPE_IP4_ROUTE
+		    && ops[i].obj->ip4_route.metric == 0)
+			break;
+	}
+	if (i < len) {
+		/* see ip4_route_delete(): we must only send a delete request for an IPv4
+		 * route with metric 0 if such a route exists. Make sure the cache is
+		 * up to date before checking that below. */
+		delayed_action_handle_all (platform, TRUE);
+
+		/* Be extra careful and reload the IPv4 routes if one of them is still
+		 * missing, e.g. the kernel-added device route of an address that we
+		 * just added. Do that only once for the whole batch. */
+		for (; i < len; i++) {
+			if (   ops[i].op_type == NM_PLATFORM_BATCH_OP_DELETE
+			    && NMP_OBJECT_GET_TYPE (ops[i].obj) == NMP_OBJECT_TYPE_IP4_ROUTE
+			    && ops[i].obj->ip4_route.metric == 0
+			    && !nmp_cache_lookup_obj (priv->cache, ops[i].obj)) {
+				do_request_one_type (platform, NMP_OBJECT_TYPE_IP4_ROUTE);
+				break;
+			}
+		}
+	} else
+		event_handler_read_netlink (platform, FALSE);
+
+	for (i = 0; i < len; i++) {
+		NMPlatformBatchOp *op = &ops[i];
+		nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+		int nle;
+
+		if (   op->op_type == NM_PLATFORM_BATCH_OP_DELETE
+		    && NMP_OBJECT_GET_TYPE (op->obj) == NMP_OBJECT_TYPE_IP4_ROUTE
+		    && op->obj->ip4_route.metric == 0
+		    && !nmp_cache_lookup_obj (priv->cache, op->obj))
+			continue;
+
+		nlmsg = _nl_msg_new_from_batch_op (op);
+		if (!nlmsg)
+			continue;
+
+		nle = _nl_send_auto_with_seq (platform, nlmsg, &seq_results[i]);
+		if (nle < 0) {
+			_LOGE ("do-batch-%s-%s[%s]: failure sending netlink request \"%s\" (%d)",
+			       _batch_op_type_to_string (op->op_type),
+			       NMP_OBJECT_GET_CLASS (op->obj)->obj_type_name,
+			       nmp_object_to_string (op->obj, NMP_OBJECT_TO_STRING_ID, NULL, 0),
+			       nl_geterror (nle), -nle);
+			continue;
+		}
+
+		if (++n_in_flight >= BATCH_MAX_IN_FLIGHT) {
+			event_handler_read_netlink (platform, FALSE);
+			n_in_flight = 0;
+		}
+	}
+
+	/* wait for all outstanding ACKs at once. */
+	delayed_action_handle_all (platform, FALSE);
+
+	/* Added objects that are missing in the cache are first requested
+	 * individually (see do_request_object_after_add()). */
+	n_in_flight = 0;
+	for (i = 0; i < len; i++) {
+		if (   ops[i].op_type != NM_PLATFORM_BATCH_OP_DELETE
+		    && _batch_op_needs_refetch (platform, &ops[i], seq_results[i])
+		    && do_request_object_no_delayed_actions (platform, ops[i].obj))
+			n_in_flight++;
+	}
+	if (n_in_flight > 0)
+		delayed_action_handle_all (platform, FALSE);
+
+	for (i = 0; i < len; i++) {
+		if (_batch_op_needs_refetch (platform, &ops[i], seq_results[i]))
+			refresh_types |= delayed_action_refresh_from_object_type (NMP_OBJECT_GET_TYPE (ops[i].obj));
+	}
+	if (refresh_types) {
+		/* Refetch each affected object type only once for the whole batch. */
+		do_request_all_fallback_no_delayed_actions (platform, refresh_types, "objects of a batch are not in sync with the cache");
+		delayed_action_handle_all (platform, FALSE);
+	}
+
+	for (i = 0; i < len; i++) {
+		NMPlatformBatchOp *op = &ops[i];
+		const NMPObject *obj;
+
+		obj = nmp_cache_lookup_obj (priv->cache, op->obj);
+
+		if (op->op_type != NM_PLATFORM_BATCH_OP_DELETE) {
+			/* Adding is only successful, if kernel reported success *and* we have the
+			 * expected object in cache afterwards. */
+			op->success = obj && seq_results[i] == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
+
+			_NMLOG (op->success ? LOGL_DEBUG : LOGL_ERR,
+			        "do-batch-%s-%s[%s]: %s",
+			        _batch_op_type_to_string (op->op_type),
+			        NMP_OBJECT_GET_CLASS (op->obj)->obj_type_name,
+			        nmp_object_to_string (op->obj, NMP_OBJECT_TO_STRING_ID, NULL, 0),
+			        wait_for_nl_response_to_string (seq_results[i], s_buf, sizeof (s_buf)));
+		} else {
+			gboolean success;
+			const char *log_detail;
+
+			log_detail = _delete_object_get_log_detail (op->obj, seq_results[i], &success);
+			op->success = !obj;
+
+			_NMLOG (op->success ? LOGL_DEBUG : LOGL_ERR,
+			        "do-batch-delete-%s[%s]: %s%s",
+			        NMP_OBJECT_GET_CLASS (op->obj)->obj_type_name,
+			        nmp_object_to_string (op->obj, NMP_OBJECT_TO_STRING_ID, NULL, 0),
+			        wait_for_nl_response_to_string (seq_results[i], s_buf, sizeof (s_buf)),
+			        log_detail);
+		}
+	}
 }
 
 static NMPlatformError
@@ -4786,6 +6016,173 @@ link_vlan_change (NMPlatform *platform,
 	return do_change_link (platform, ifindex, nlmsg) == NM_PLATFORM_ERROR_SUCCESS;
 }
 
+static NMPlatformLnkBondAttrs
+_lnk_bond_attrs_changed (const NMPlatformLnkBond *a,
+                         const NMPlatformLnkBond *b,
+                         NMPlatformLnkBondAttrs attrs)
+{
+	NMPlatformLnkBondAttrs changed = NM_PLATFORM_LNK_BOND_ATTR_NONE;
+
+#define _CHECK_ATTR(attr, cond) \
+	G_STMT_START { \
+		if (NM_FLAGS_HAS (attrs, (attr)) && (cond)) \
+			changed |= (attr); \
+	} G_STMT_END
+
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_MODE, a->mode != b->mode);
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_MIIMON, a->miimon != b->miimon);
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_UPDELAY, a->updelay != b->updelay);
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_DOWNDELAY, a->downdelay != b->downdelay);
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_USE_CARRIER, !a->use_carrier != !b->use_carrier);
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_ARP_INTERVAL, a->arp_interval != b->arp_interval);
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_ARP_IP_TARGETS,
+	                a->num_arp_ip_targets != b->num_arp_ip_targets
+	             || memcmp (a->arp_ip_targets, b->arp_ip_targets, a->num_arp_ip_targets * sizeof (a->arp_ip_targets[0])));
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_ARP_VALIDATE, a->arp_validate != b->arp_validate);
+	/* kernel reports the primary only while it is enslaved, but remembers
+	 * the name otherwise. We cannot know whether it is set, always send it. */
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_PRIMARY, TRUE);
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_PRIMARY_RESELECT, a->primary_reselect != b->primary_reselect);
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_FAIL_OVER_MAC, a->fail_over_mac != b->fail_over_mac);
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_XMIT_HASH_POLICY, a->xmit_hash_policy != b->xmit_hash_policy);
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_RESEND_IGMP, a->resend_igmp != b->resend_igmp);
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_LACP_RATE, a->lacp_rate != b->lacp_rate);
+	_CHECK_ATTR (NM_PLATFORM_LNK_BOND_ATTR_AD_SELECT, a->ad_select != b->ad_select);
+
+#undef _CHECK_ATTR
+
+	return changed;
+}
+
+static gboolean
+link_bond_change (NMPlatform *platform,
+                  int ifindex,
+                  const NMPlatformLnkBond *props,
+                  NMPlatformLnkBondAttrs attrs)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	const NMPObject *obj_cache;
+	nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+
+	obj_cache = nmp_cache_lookup_link (priv->cache, ifindex);
+	if (   !obj_cache
+	    || !obj_cache->_link.netlink.is_in_netlink
+	    || obj_cache->link.type != NM_LINK_TYPE_BOND) {
+		_LOGD ("link: change %d: %s: link does not exist", ifindex, "bond");
+		return FALSE;
+	}
+
+	/* Without a cached lnk object, the kernel does not report the
+	 * bonding options via netlink and probably cannot change them either. */
+	if (!obj_cache->_link.netlink.lnk) {
+		_LOGD ("link: change %d: %s: kernel does not support bonding options via netlink", ifindex, "bond");
+		return FALSE;
+	}
+
+	/* Only send the options that differ. Some options cannot be changed
+	 * while the bond has slaves, even when setting the same value. */
+	attrs = _lnk_bond_attrs_changed (props, &obj_cache->_link.netlink.lnk->lnk_bond, attrs);
+	if (attrs == NM_PLATFORM_LNK_BOND_ATTR_NONE) {
+		_LOGD ("link: change %d: %s: options already set", ifindex, "bond");
+		return TRUE;
+	}
+
+	_LOGD ("link: change %d: bond: attrs 0x%x", ifindex, (unsigned) attrs);
+
+	nlmsg = _nl_msg_new_link (RTM_NEWLINK,
+	                          0,
+	                          ifindex,
+	                          NULL,
+	                          0,
+	                          0);
+	if (   !nlmsg
+	    || !_nl_msg_new_link_set_linkinfo_bond (nlmsg, props, attrs))
+		g_return_val_if_reached (FALSE);
+
+	return do_change_link (platform, ifindex, nlmsg) == NM_PLATFORM_ERROR_SUCCESS;
+}
+
+static gboolean
+link_bridge_change (NMPlatform *platform,
+                    int ifindex,
+                    const NMPlatformLnkBridge *props)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	const NMPObject *obj_cache;
+	nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+
+	obj_cache = nmp_cache_lookup_link (priv->cache, ifindex);
+	if (   !obj_cache
+	    || !obj_cache->_link.netlink.is_in_netlink
+	    || obj_cache->link.type != NM_LINK_TYPE_BRIDGE) {
+		_LOGD ("link: change %d: %s: link does not exist", ifindex, "bridge");
+		return FALSE;
+	}
+
+	if (!obj_cache->_link.netlink.lnk) {
+		_LOGD ("link: change %d: %s: kernel does not support bridge options via netlink", ifindex, "bridge");
+		return FALSE;
+	}
+
+	if (nm_platform_lnk_bridge_cmp (props, &obj_cache->_link.netlink.lnk->lnk_bridge) == 0) {
+		_LOGD ("link: change %d: %s: options already set", ifindex, "bridge");
+		return TRUE;
+	}
+
+	nlmsg = _nl_msg_new_link (RTM_NEWLINK,
+	                          0,
+	                          ifindex,
+	                          NULL,
+	                          0,
+	                          0);
+	if (   !nlmsg
+	    || !_nl_msg_new_link_set_linkinfo_bridge (nlmsg, props))
+		g_return_val_if_reached (FALSE);
+
+	return do_change_link (platform, ifindex, nlmsg) == NM_PLATFORM_ERROR_SUCCESS;
+}
+
+static gboolean
+link_bridge_port_change (NMPlatform *platform,
+                         int ifindex,
+                         const NMPlatformBridgePort *props)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	const NMPObject *obj_cache;
+	const NMPObject *obj_master;
+	nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+
+	obj_cache = nmp_cache_lookup_link (priv->cache, ifindex);
+	if (   !obj_cache
+	    || !obj_cache->_link.netlink.is_in_netlink) {
+		_LOGD ("link: change %d: %s: link does not exist", ifindex, "bridge-port");
+		return FALSE;
+	}
+
+	/* The port options are not cached. But kernels that report the bridge
+	 * options via netlink also support changing port options, while older
+	 * ones would silently ignore the request. */
+	obj_master = obj_cache->link.master > 0 ? nmp_cache_lookup_link (priv->cache, obj_cache->link.master) : NULL;
+	if (   !obj_master
+	    || obj_master->link.type != NM_LINK_TYPE_BRIDGE
+	    || !obj_master->_link.netlink.lnk) {
+		_LOGD ("link: change %d: %s: master does not support bridge port options via netlink", ifindex, "bridge-port");
+		return FALSE;
+	}
+
+	nlmsg = _nl_msg_new_link (RTM_NEWLINK,
+	                          0,
+	                          ifindex,
+	                          NULL,
+	                          0,
+	                          0);
+	if (   !nlmsg
+	    || !_nl_msg_new_link_set_linkinfo_bridge_port (nlmsg, props))
+		g_return_val_if_reached (FALSE);
+
+	return do_change_link (platform, ifindex, nlmsg) == NM_PLATFORM_ERROR_SUCCESS;
+}
+
 static int
 tun_add (NMPlatform *platform, const char *name, gboolean tap,
          gint64 owner, gint64 group, gboolean pi, gboolean vnet_hdr,
@@ -5122,6 +6519,8 @@ ipx_address_get_all (NMPlatform *platform, int ifindex, NMPObjectType obj_type)
 
 	nm_assert (NM_IN_SET (obj_type, NMP_OBJECT_TYPE_IP4_ADDRESS, NMP_OBJECT_TYPE_IP6_ADDRESS));
 
+	cache_ensure_resynced (platform, obj_type);
+
 	return nmp_cache_lookup_multi_to_array (priv->cache,
 	                                        obj_type,
 	                                        nmp_cache_id_init_addrroute_visible_by_ifindex (NMP_CACHE_ID_STATIC,
@@ -5258,6 +6657,7 @@ ip4_address_get (NMPlatform *platform, int ifindex, in_addr_t addr, int plen, in
 	const NMPObject *obj;
 
 	nmp_object_stackinit_id_ip4_address (&obj_id, ifindex, addr, plen, peer_address);
+	cache_ensure_resynced (platform, NMP_OBJECT_TYPE_IP4_ADDRESS);
 	obj = nmp_cache_lookup_obj (NM_LINUX_PLATFORM_GET_PRIVATE (platform)->cache, &obj_id);
 	if (nmp_object_is_visible (obj))
 		return &obj->ip4_address;
@@ -5271,6 +6671,7 @@ ip6_address_get (NMPlatform *platform, int ifindex, struct in6_addr addr, int pl
 	const NMPObject *obj;
 
 	nmp_object_stackinit_id_ip6_address (&obj_id, ifindex, &addr, plen);
+	cache_ensure_resynced (platform, NMP_OBJECT_TYPE_IP6_ADDRESS);
 	obj = nmp_cache_lookup_obj (NM_LINUX_PLATFORM_GET_PRIVATE (platform)->cache, &obj_id);
 	if (nmp_object_is_visible (obj))
 		return &obj->ip6_address;
@@ -5292,6 +6693,8 @@ ipx_route_get_all (NMPlatform *platform, int ifindex, NMPObjectType obj_type, NM
 
 	nm_assert (NM_IN_SET (obj_type, NMP_OBJECT_TYPE_IP4_ROUTE, NMP_OBJECT_TYPE_IP6_ROUTE));
 
+	cache_ensure_resynced (platform, obj_type);
+
 	if (!NM_FLAGS_ANY (flags, NM_PLATFORM_GET_ROUTE_FLAGS_WITH_DEFAULT | NM_PLATFORM_GET_ROUTE_FLAGS_WITH_NON_DEFAULT))
 		flags |= NM_PLATFORM_GET_ROUTE_FLAGS_WITH_DEFAULT | NM_PLATFORM_GET_ROUTE_FLAGS_WITH_NON_DEFAULT;
 
@@ -5331,15 +6734,15 @@ ip6_route_get_all (NMPlatform *platform, int ifindex, NMPlatformGetRouteFlags fl
 }
 
 static gboolean
-ip4_route_add (NMPlatform *platform, int ifindex, NMIPConfigSource source,
-               in_addr_t network, int plen, in_addr_t gateway,
-               in_addr_t pref_src, guint32 metric, guint32 mss)
+do_ip4_route_add (NMPlatform *platform, int nlmsg_flags, int ifindex, NMIPConfigSource source,
+                  in_addr_t network, int plen, in_addr_t gateway,
+                  in_addr_t pref_src, guint32 metric, guint32 mss)
 {
 	NMPObject obj_id;
 	nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
 
 	nlmsg = _nl_msg_new_route (RTM_NEWROUTE,
-	                           NLM_F_CREATE | NLM_F_REPLACE,
+	                           nlmsg_flags,
 	                           AF_INET,
 	                           ifindex,
 	                           source,
@@ -5356,15 +6759,15 @@ ip4_route_add (NMPlatform *platform, int ifindex, NMIPConfigSource source,
 }
 
 static gboolean
-ip6_route_add (NMPlatform *platform, int ifindex, NMIPConfigSource source,
-               struct in6_addr network, int plen, struct in6_addr gateway,
-               guint32 metric, guint32 mss)
+do_ip6_route_add (NMPlatform *platform, int nlmsg_flags, int ifindex, NMIPConfigSource source,
+                  struct in6_addr network, int plen, struct in6_addr gateway,
+                  guint32 metric, guint32 mss)
 {
 	NMPObject obj_id;
 	nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
 
 	nlmsg = _nl_msg_new_route (RTM_NEWROUTE,
-	                           NLM_F_CREATE | NLM_F_REPLACE,
+	                           nlmsg_flags,
 	                           AF_INET6,
 	                           ifindex,
 	                           source,
@@ -5380,6 +6783,44 @@ ip6_route_add (NMPlatform *platform, int ifindex, NMIPConfigSource source,
 	return do_add_addrroute (platform, &obj_id, nlmsg);
 }
 
+static gboolean
+ip4_route_add (NMPlatform *platform, int ifindex, NMIPConfigSource source,
+               in_addr_t network, int plen, in_addr_t gateway,
+               in_addr_t pref_src, guint32 metric, guint32 mss)
+{
+	return do_ip4_route_add (platform, NLM_F_CREATE | NLM_F_REPLACE, ifindex, source,
+	                         network, plen, gateway, pref_src, metric, mss);
+}
+
+static gboolean
+ip6_route_add (NMPlatform *platform, int ifindex, NMIPConfigSource source,
+               struct in6_addr network, int plen, struct in6_addr gateway,
+               guint32 metric, guint32 mss)
+{
+	return do_ip6_route_add (platform, NLM_F_CREATE | NLM_F_REPLACE, ifindex, source,
+	                         network, plen, gateway, metric, mss);
+}
+
+/* Without NLM_F_CREATE, kernel only updates the attributes of the route
+ * with the same destination and metric, and fails if there is none. */
+static gboolean
+ip4_route_replace (NMPlatform *platform, int ifindex, NMIPConfigSource source,
+                   in_addr_t network, int plen, in_addr_t gateway,
+                   in_addr_t pref_src, guint32 metric, guint32 mss)
+{
+	return do_ip4_route_add (platform, NLM_F_REPLACE, ifindex, source,
+	                         network, plen, gateway, pref_src, metric, mss);
+}
+
+static gboolean
+ip6_route_replace (NMPlatform *platform, int ifindex, NMIPConfigSource source,
+                   struct in6_addr network, int plen, struct in6_addr gateway,
+                   guint32 metric, guint32 mss)
+{
+	return do_ip6_route_add (platform, NLM_F_REPLACE, ifindex, source,
+	                         network, plen, gateway, metric, mss);
+}
+
 static gboolean
 ip4_route_delete (NMPlatform *platform, int ifindex, in_addr_t network, int plen, guint32 metric)
 {
@@ -5471,6 +6912,7 @@ ip4_route_get (NMPlatform *platform, int ifindex, in_addr_t network, int plen, g
 	const NMPObject *obj;
 
 	nmp_object_stackinit_id_ip4_route (&obj_id, ifindex, network, plen, metric);
+	cache_ensure_resynced (platform, NMP_OBJECT_TYPE_IP4_ROUTE);
 	obj = nmp_cache_lookup_obj (NM_LINUX_PLATFORM_GET_PRIVATE (platform)->cache, &obj_id);
 	if (nmp_object_is_visible (obj))
 		return &obj->ip4_route;
@@ -5486,6 +6928,7 @@ ip6_route_get (NMPlatform *platform, int ifindex, struct in6_addr network, int p
 	metric = nm_utils_ip6_route_metric_normalize (metric);
 
 	nmp_object_stackinit_id_ip6_route (&obj_id, ifindex, &network, plen, metric);
+	cache_ensure_resynced (platform, NMP_OBJECT_TYPE_IP6_ROUTE);
 	obj = nmp_cache_lookup_obj (NM_LINUX_PLATFORM_GET_PRIVATE (platform)->cache, &obj_id);
 	if (nmp_object_is_visible (obj))
 		return &obj->ip6_route;
@@ -5498,183 +6941,376 @@ ip6_route_get (NMPlatform *platform, int ifindex, struct in6_addr network, int p
 #define ERROR_CONDITIONS      ((GIOCondition) (G_IO_ERR | G_IO_NVAL))
 #define DISCONNECT_CONDITIONS ((GIOCondition) (G_IO_HUP))
 
+/* After a receive buffer overrun we lost an unknown number of events and
+ * must resynchronize the whole cache. Instead of dumping all object types
+ * at once (which on busy hosts easily causes the next overrun), refresh
+ * them one type per main loop iteration: links first (so that the
+ * addresses and routes can be associated with the links), then
+ * addresses and finally routes. */
+static gboolean
+resync_idle_cb (gpointer user_data)
+{
+	NMPlatform *platform = user_data;
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	DelayedActionType iflags;
+
+	for (iflags = (DelayedActionType) 0x1LL; iflags <= DELAYED_ACTION_TYPE_MAX; iflags <<= 1) {
+		if (NM_FLAGS_HAS (priv->resync.pending, iflags)) {
+			priv->resync.pending &= ~iflags;
+			_LOGD ("netlink: resync: refresh %s",
+			       nmp_class_from_type (delayed_action_refresh_to_object_type (iflags))->obj_type_name);
+			delayed_action_schedule (platform, iflags, NULL);
+			_delayed_action_handle_all (platform, FALSE, FALSE);
+			break;
+		}
+	}
+
+	if (priv->resync.pending)
+		return G_SOURCE_CONTINUE;
+
+	priv->resync.idle_id = 0;
+	resync_finish (platform);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+resync_finish (NMPlatform *platform)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	priv->resync.recoveries_total++;
+	_LOGI ("netlink: resync: platform cache resynchronized after %u overrun(s) in %"G_GINT64_FORMAT" msec (%u overruns, %u recoveries in total)",
+	       priv->resync.overruns,
+	       (nm_utils_get_monotonic_timestamp_ns () - priv->resync.started_at_ns) / (NM_UTILS_NS_PER_SECOND / 1000),
+	       priv->resync.overruns_total,
+	       priv->resync.recoveries_total);
+	priv->resync.overruns = 0;
+}
+
+static void
+resync_start (NMPlatform *platform)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	priv->resync.overruns_total++;
+	if (!priv->resync.overruns++)
+		priv->resync.started_at_ns = nm_utils_get_monotonic_timestamp_ns ();
+
+	/* Restart the recovery, even if one is already in progress. Links are
+	 * refreshed right away, everything else later. */
+	delayed_action_schedule (platform, DELAYED_ACTION_TYPE_REFRESH_ALL_LINKS, NULL);
+	priv->resync.pending = DELAYED_ACTION_TYPE_REFRESH_ALL & ~DELAYED_ACTION_TYPE_REFRESH_ALL_LINKS;
+	if (!priv->resync.idle_id)
+		priv->resync.idle_id = g_idle_add (resync_idle_cb, platform);
+}
+
 static gboolean
 event_handler (GIOChannel *channel,
                GIOCondition io_condition,
                gpointer user_data)
 {
-	delayed_action_handle_all (NM_PLATFORM (user_data), TRUE);
+	/* don't finish a resync here, but spread it over the following
+	 * main loop iterations (see resync_idle_cb()). */
+	_delayed_action_handle_all (NM_PLATFORM (user_data), TRUE, FALSE);
 	return TRUE;
 }
 
 /*****************************************************************************/
 
-/* copied from libnl3's recvmsgs() */
+static RecvBuffers *
+recv_buffers_new (gsize dgram_size)
+{
+	RecvBuffers *rb;
+
+	rb = g_new (RecvBuffers, 1);
+	rb->dgram_size = dgram_size;
+	rb->buf = g_malloc (RECV_DGRAMS_MAX * dgram_size);
+	return rb;
+}
+
+static void
+recv_buffers_free (RecvBuffers *rb)
+{
+	if (rb) {
+		g_free (rb->buf);
+		g_free (rb);
+	}
+}
+
 static int
-event_handler_recvmsgs (NMPlatform *platform, gboolean handle_events)
+event_handler_recv_errno (NMPlatform *platform, int errsv)
+{
+	switch (errsv) {
+	case EAGAIN:
+		/* EAGAIN is equal to EWOULDBLOCK. */
+		G_STATIC_ASSERT (EAGAIN == EWOULDBLOCK);
+		return -NLE_AGAIN;
+	case ENOBUFS:
+		/* we are very much interested in a overrun of the receive buffer.
+		 * Hack our own return code to signal the overrun. */
+		return -_NLE_NM_NOBUFS;
+	default:
+		_LOGD ("netlink: recvmsg: failed to receive: %s (%d)", strerror (errsv), errsv);
+		return -nl_syserr2nlerr (errsv);
+	}
+}
+
+/* Read up to RECV_DGRAMS_MAX datagrams from the netlink socket with
+ * one syscall. Returns the number of received datagrams or a negative
+ * libnl error code.
+ *
+ * Like libnl's nl_recv(), peek at the size of the next datagram first
+ * and grow the buffers if it doesn't fit. */
+static int
+event_handler_recv (NMPlatform *platform, RecvBuffers *rb)
 {
 	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
-	struct nl_sock *sk = priv->nlh;
-	int n, err = 0, multipart = 0, interrupted = 0, nrecv = 0;
-	unsigned char *buf = NULL;
-	struct nlmsghdr *hdr;
-	WaitForNlResponseResult seq_result;
+	int fd = nl_socket_get_fd (priv->nlh);
+	guint i;
+	ssize_t size;
+	int n;
+
+again_peek:
+	size = recv (fd, NULL, 0, MSG_PEEK | MSG_TRUNC);
+	if (size < 0) {
+		if (errno == EINTR)
+			goto again_peek;
+		return event_handler_recv_errno (platform, errno);
+	}
+
+	if ((gsize) size > priv->recv_dgram_size) {
+		_LOGD ("netlink: recvmsg: grow receive buffers for datagrams of %zd bytes", size);
+		priv->recv_dgram_size = ((gsize) size + 4095) & ~((gsize) 4095);
+	}
+	if (rb->dgram_size < priv->recv_dgram_size) {
+		rb->dgram_size = priv->recv_dgram_size;
+		g_free (rb->buf);
+		rb->buf = g_malloc (RECV_DGRAMS_MAX * rb->dgram_size);
+	}
 
-	/*
-	nla is passed on to not only to nl_recv() but may also be passed
-	to a function pointer provided by the caller which may or may not
-	initialize the variable. Thomas Graf.
-	*/
-	struct sockaddr_nl nla = {0};
-	struct nl_msg *msg = NULL;
-	struct ucred *creds = NULL;
+	for (i = 0; i < RECV_DGRAMS_MAX; i++) {
+		struct msghdr *mhdr = &rb->msgs[i].msg_hdr;
 
-continue_reading:
-	errno = 0;
-	n = nl_recv (sk, &nla, &buf, &creds);
-
-	switch (n) {
-	case 0:
-		/* Work around a libnl bug fixed in 3.2.22 (375a6294) */
-		if (errno == EAGAIN) {
-			/* EAGAIN is equal to EWOULDBLOCK. If it would not be, we'd have to
-			 * workaround libnl3 mapping EWOULDBLOCK to -NLE_FAILURE. */
-			G_STATIC_ASSERT (EAGAIN == EWOULDBLOCK);
-			n = -NLE_AGAIN;
+		rb->iov[i].iov_base = &rb->buf[i * rb->dgram_size];
+		rb->iov[i].iov_len = rb->dgram_size;
+
+		memset (mhdr, 0, sizeof (*mhdr));
+		mhdr->msg_name = &rb->nla[i];
+		mhdr->msg_namelen = sizeof (rb->nla[i]);
+		mhdr->msg_iov = &rb->iov[i];
+		mhdr->msg_iovlen = 1;
+		mhdr->msg_control = rb->cmsg[i].buf;
+		mhdr->msg_controllen = sizeof (rb->cmsg[i].buf);
+		rb->msgs[i].msg_len = 0;
+	}
+
+again:
+	/* with MSG_TRUNC, msg_len is the real size of a truncated datagram. */
+	n = recvmmsg (fd, rb->msgs, RECV_DGRAMS_MAX, MSG_TRUNC, NULL);
+	if (n < 0) {
+		if (errno == EINTR)
+			goto again;
+		return event_handler_recv_errno (platform, errno);
+	}
+	return n;
+}
+
+/* Only the size of the first datagram is known before reading. A later
+ * one might still be truncated. Its complete messages are handled as
+ * usual, for the lost rest refresh the affected objects. The buffers grow
+ * on the next read, so that the refresh is not truncated again. */
+static void
+event_handler_recv_truncated (NMPlatform *platform, struct nlmsghdr *hdr, int n, gsize dgram_len)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	_LOGD ("netlink: recvmsg: datagram truncated (%zu bytes)", dgram_len);
+
+	priv->recv_dgram_size = MAX (priv->recv_dgram_size, (dgram_len + 4095) & ~((gsize) 4095));
+
+	if (n < (int) NLMSG_HDRLEN) {
+		delayed_action_schedule (platform, DELAYED_ACTION_TYPE_REFRESH_ALL, NULL);
+		return;
+	}
+
+	switch (hdr->nlmsg_type) {
+	case RTM_NEWLINK:
+	case RTM_DELLINK:
+		if (n >= (int) NLMSG_SPACE (sizeof (struct ifinfomsg))) {
+			const struct ifinfomsg *ifi = nlmsg_data (hdr);
+
+			if (ifi->ifi_index > 0) {
+				delayed_action_schedule (platform, DELAYED_ACTION_TYPE_REFRESH_LINK, GINT_TO_POINTER (ifi->ifi_index));
+				break;
+			}
 		}
+		delayed_action_schedule (platform, DELAYED_ACTION_TYPE_REFRESH_ALL_LINKS, NULL);
 		break;
-	case -NLE_NOMEM:
-		if (errno == ENOBUFS) {
-			/* we are very much interested in a overrun of the receive buffer.
-			 * nl_recv() maps all kinds of errors to NLE_NOMEM, so check also
-			 * for errno explicitly. And if so, hack our own return code to signal
-			 * the overrun. */
-			n = -_NLE_NM_NOBUFS;
-		}
+	case RTM_NEWADDR:
+	case RTM_DELADDR:
+		delayed_action_schedule (platform,
+		                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ADDRESSES |
+		                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ADDRESSES,
+		                         NULL);
+		break;
+	case RTM_NEWROUTE:
+	case RTM_DELROUTE:
+		delayed_action_schedule (platform,
+		                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES |
+		                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES,
+		                         NULL);
+		break;
+	default:
 		break;
 	}
+}
+
+static const struct ucred *
+event_handler_recv_get_creds (struct msghdr *mhdr)
+{
+	struct cmsghdr *cmsg;
+
+	for (cmsg = CMSG_FIRSTHDR (mhdr); cmsg; cmsg = CMSG_NXTHDR (mhdr, cmsg)) {
+		if (   cmsg->cmsg_level == SOL_SOCKET
+		    && cmsg->cmsg_type == SCM_CREDENTIALS)
+			return (const struct ucred *) CMSG_DATA (cmsg);
+	}
+	return NULL;
+}
 
-	if (n <= 0)
-		return n;
+/* copied from libnl3's recvmsgs(), but modified to parse the messages
+ * in place and to receive several datagrams at once. */
+static int
+_event_handler_recvmsgs (NMPlatform *platform, RecvBuffers *rb, gboolean handle_events)
+{
+	int n, n_dgrams, err = 0, multipart = 0, interrupted = 0, nrecv = 0;
+	int i_dgram;
+	struct nlmsghdr *hdr;
+	WaitForNlResponseResult seq_result;
 
-	hdr = (struct nlmsghdr *) buf;
-	while (nlmsg_ok (hdr, n)) {
-		gboolean abort_parsing = FALSE;
+continue_reading:
+	n_dgrams = event_handler_recv (platform, rb);
+	if (n_dgrams <= 0)
+		return n_dgrams;
 
-		nlmsg_free (msg);
-		msg = nlmsg_convert (hdr);
-		if (!msg) {
-			err = -NLE_NOMEM;
-			goto out;
-		}
+	for (i_dgram = 0; i_dgram < n_dgrams; i_dgram++) {
+		struct msghdr *mhdr = &rb->msgs[i_dgram].msg_hdr;
+		const struct ucred *creds;
+		gboolean truncated;
+		int abort_err = 0;
 
-		nlmsg_set_proto (msg, NETLINK_ROUTE);
-		nlmsg_set_src (msg, &nla);
-		nrecv++;
+		truncated = NM_FLAGS_HAS (mhdr->msg_flags, MSG_TRUNC);
+		n = (int) MIN ((gsize) rb->msgs[i_dgram].msg_len, rb->iov[i_dgram].iov_len);
 
+		creds = event_handler_recv_get_creds (mhdr);
 		if (!creds || creds->pid) {
 			if (creds)
 				_LOGD ("netlink: recvmsg: received non-kernel message (pid %d)", creds->pid);
 			else
 				_LOGD ("netlink: recvmsg: received message without credentials");
-			goto stop;
+			continue;
 		}
 
-		_LOGt ("netlink: recvmsg: new message type %d, seq %u",
-		       hdr->nlmsg_type, hdr->nlmsg_seq);
+		hdr = (struct nlmsghdr *) rb->iov[i_dgram].iov_base;
+		while (nlmsg_ok (hdr, n)) {
+			nrecv++;
 
-		if (creds)
-			nlmsg_set_creds (msg, creds);
+			_LOGt ("netlink: recvmsg: new message type %d, seq %u",
+			       hdr->nlmsg_type, hdr->nlmsg_seq);
 
-		if (hdr->nlmsg_flags & NLM_F_MULTI)
-			multipart = 1;
+			if (hdr->nlmsg_flags & NLM_F_MULTI)
+				multipart = 1;
 
-		if (hdr->nlmsg_flags & NLM_F_DUMP_INTR) {
-			/*
-			 * We have to continue reading to clear
-			 * all messages until a NLMSG_DONE is
-			 * received and report the inconsistency.
-			 */
-			interrupted = 1;
-		}
+			if (hdr->nlmsg_flags & NLM_F_DUMP_INTR) {
+				/*
+				 * We have to continue reading to clear
+				 * all messages until a NLMSG_DONE is
+				 * received and report the inconsistency.
+				 */
+				interrupted = 1;
+			}
 
-		/* Other side wishes to see an ack for this message */
-		if (hdr->nlmsg_flags & NLM_F_ACK) {
-			/* FIXME: implement */
-		}
+			/* Other side wishes to see an ack for this message */
+			if (hdr->nlmsg_flags & NLM_F_ACK) {
+				/* FIXME: implement */
+			}
 
-		seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_UNKNOWN;
-
-		if (hdr->nlmsg_type == NLMSG_DONE) {
-			/* messages terminates a multipart message, this is
-			 * usually the end of a message and therefore we slip
-			 * out of the loop by default. the user may overrule
-			 * this action by skipping this packet. */
-			multipart = 0;
-			seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
-		} else if (hdr->nlmsg_type == NLMSG_NOOP) {
-			/* Message to be ignored, the default action is to
-			 * skip this message if no callback is specified. The
-			 * user may overrule this action by returning
-			 * NL_PROCEED. */
-		} else if (hdr->nlmsg_type == NLMSG_OVERRUN) {
-			/* Data got lost, report back to user. The default action is to
-			 * quit parsing. The user may overrule this action by retuning
-			 * NL_SKIP or NL_PROCEED (dangerous) */
-			err = -NLE_MSG_OVERFLOW;
-			abort_parsing = TRUE;
-		} else if (hdr->nlmsg_type == NLMSG_ERROR) {
-			/* Message carries a nlmsgerr */
-			struct nlmsgerr *e = nlmsg_data (hdr);
-
-			if (hdr->nlmsg_len < nlmsg_size (sizeof (*e))) {
-				/* Truncated error message, the default action
-				 * is to stop parsing. The user may overrule
-				 * this action by returning NL_SKIP or
-				 * NL_PROCEED (dangerous) */
-				err = -NLE_MSG_TRUNC;
-				abort_parsing = TRUE;
-			} else if (e->error) {
-				int errsv = e->error > 0 ? e->error : -e->error;
-
-				/* Error message reported back from kernel. */
-				_LOGD ("netlink: recvmsg: error message from kernel: %s (%d) for request %d",
-				       strerror (errsv),
-				       errsv,
-				       nlmsg_hdr (msg)->nlmsg_seq);
-				seq_result = -errsv;
-			} else
+			seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_UNKNOWN;
+
+			if (hdr->nlmsg_type == NLMSG_DONE) {
+				/* messages terminates a multipart message, this is
+				 * usually the end of a message and therefore we slip
+				 * out of the loop by default. the user may overrule
+				 * this action by skipping this packet. */
+				multipart = 0;
 				seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
-		} else {
-			/* Valid message (not checking for MULTIPART bit to
-			 * get along with broken kernels. NL_SKIP has no
-			 * effect on this.  */
+			} else if (hdr->nlmsg_type == NLMSG_NOOP) {
+				/* Message to be ignored, the default action is to
+				 * skip this message if no callback is specified. The
+				 * user may overrule this action by returning
+				 * NL_PROCEED. */
+			} else if (hdr->nlmsg_type == NLMSG_OVERRUN) {
+				/* Data got lost, report back to user. The default action is to
+				 * quit parsing. The user may overrule this action by retuning
+				 * NL_SKIP or NL_PROCEED (dangerous) */
+				abort_err = -NLE_MSG_OVERFLOW;
+			} else if (hdr->nlmsg_type == NLMSG_ERROR) {
+				/* Message carries a nlmsgerr */
+				struct nlmsgerr *e = nlmsg_data (hdr);
+
+				if (hdr->nlmsg_len < nlmsg_size (sizeof (*e))) {
+					/* Truncated error message, the default action
+					 * is to stop parsing. The user may overrule
+					 * this action by returning NL_SKIP or
+					 * NL_PROCEED (dangerous) */
+					abort_err = -NLE_MSG_TRUNC;
+					/* it is unknown whether the request succeeded. Complete
+					 * it now instead of waiting for the timeout. */
+					seq_result = WAIT_FOR_NL_RESPONSE_RESULT_FAILED_RESYNC;
+				} else if (e->error) {
+					int errsv = e->error > 0 ? e->error : -e->error;
+
+					/* Error message reported back from kernel. */
+					_LOGD ("netlink: recvmsg: error message from kernel: %s (%d) for request %d",
+					       strerror (errsv),
+					       errsv,
+					       hdr->nlmsg_seq);
+					seq_result = -errsv;
+				} else
+					seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
+			} else {
+				/* Valid message (not checking for MULTIPART bit to
+				 * get along with broken kernels. NL_SKIP has no
+				 * effect on this.  */
+
+				event_valid_msg (platform, hdr, handle_events);
+
+				seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
+			}
 
-			event_valid_msg (platform, msg, handle_events);
+			event_seq_check (platform, hdr, seq_result);
+			err = 0;
+			hdr = nlmsg_next (hdr, &n);
 
-			seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
+			if (abort_err)
+				break;
 		}
 
-		event_seq_check (platform, msg, seq_result);
-		err = 0;
-		hdr = nlmsg_next (hdr, &n);
-
-		if (abort_parsing)
-			goto out;
+		if (abort_err) {
+			/* Only the rest of this datagram is skipped, the following
+			 * ones are handled as usual. But events may have been lost,
+			 * so resynchronize the cache like after ENOBUFS. */
+			_LOGD ("netlink: recvmsg: skip rest of datagram and resynchronize: %s (%d)",
+			       nl_geterror (abort_err), abort_err);
+			resync_start (platform);
+		} else if (truncated)
+			event_handler_recv_truncated (platform, hdr, n, rb->msgs[i_dgram].msg_len);
 	}
 
-	nlmsg_free (msg);
-	free (buf);
-	free (creds);
-	buf = NULL;
-	msg = NULL;
-	creds = NULL;
-
 	if (multipart) {
 		/* Multipart message not yet complete, continue reading */
 		goto continue_reading;
 	}
-stop:
 	if (!handle_events) {
 		/* when we don't handle events, we want to drain all messages from the socket
 		 * without handling the messages (but still check for sequence numbers).
@@ -5682,11 +7318,6 @@ stop:
 		goto continue_reading;
 	}
 	err = 0;
-out:
-	nlmsg_free (msg);
-	free (buf);
-	free (creds);
-
 	if (interrupted)
 		err = -NLE_DUMP_INTR;
 
@@ -5696,6 +7327,33 @@ out:
 	return err;
 }
 
+static int
+event_handler_recvmsgs (NMPlatform *platform, gboolean handle_events)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	RecvBuffers *rb_free = NULL;
+	RecvBuffers *rb;
+	int r;
+
+	/* While handling the messages, we emit signals and the signal handlers might
+	 * call back into platform and read from netlink again. Only the outermost
+	 * call uses the preallocated buffers. */
+	if (priv->recv_buffers_in_use)
+		rb = rb_free = recv_buffers_new (priv->recv_dgram_size);
+	else {
+		rb = priv->recv_buffers;
+		priv->recv_buffers_in_use = TRUE;
+	}
+
+	r = _event_handler_recvmsgs (platform, rb, handle_events);
+
+	if (!rb_free)
+		priv->recv_buffers_in_use = FALSE;
+	else
+		recv_buffers_free (rb_free);
+	return r;
+}
+
 /*****************************************************************************/
 
 static gboolean
@@ -5730,13 +7388,7 @@ event_handler_read_netlink (NMPlatform *platform, gboolean wait_for_acks)
 					_LOGI ("netlink: read: too many netlink events. Need to resynchronize platform cache");
 					event_handler_recvmsgs (platform, FALSE);
 					delayed_action_wait_for_nl_response_complete_all (platform, WAIT_FOR_NL_RESPONSE_RESULT_FAILED_RESYNC);
-					delayed_action_schedule (platform,
-					                         DELAYED_ACTION_TYPE_REFRESH_ALL_LINKS |
-					                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ADDRESSES |
-					                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ADDRESSES |
-					                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES |
-					                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES,
-					                         NULL);
+					resync_start (platform);
 					break;
 				default:
 					_LOGE ("netlink: read: failed to retrieve incoming events: %s (%d)", nl_geterror (nle), nle);
@@ -5926,6 +7578,10 @@ nm_linux_platform_init (NMLinuxPlatform *self)
 	priv->delayed_action.list_refresh_link = g_ptr_array_new ();
 	priv->delayed_action.list_wait_for_nl_response = g_array_new (FALSE, TRUE, sizeof (DelayedActionWaitForNlResponseData));
 	priv->wifi_data = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) wifi_utils_deinit);
+	priv->recv_dgram_size = RECV_DGRAM_SIZE;
+	priv->recv_buffers = recv_buffers_new (priv->recv_dgram_size);
+	priv->route_get = g_array_new (FALSE, FALSE, sizeof (RouteGetData));
+	priv->sysctl_dirfds = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) _sysctl_dirfds_free);
 }
 
 static void
@@ -6027,6 +7683,9 @@ dispose (GObject *object)
 
 	g_clear_pointer (&priv->prune_candidates, g_hash_table_unref);
 
+	nm_clear_g_source (&priv->resync.idle_id);
+	priv->resync.pending = DELAYED_ACTION_TYPE_NONE;
+
 	G_OBJECT_CLASS (nm_linux_platform_parent_class)->dispose (object);
 }
 
@@ -6036,11 +7695,18 @@ nm_linux_platform_finalize (GObject *object)
 	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (object);
 
 	nmp_cache_free (priv->cache);
+	nmp_object_pool_log_stats (LOGL_DEBUG);
 
 	g_ptr_array_unref (priv->delayed_action.list_master_connected);
 	g_ptr_array_unref (priv->delayed_action.list_refresh_link);
 	g_array_unref (priv->delayed_action.list_wait_for_nl_response);
 
+	while (priv->route_get->len > 0) {
+		nmp_object_unref (g_array_index (priv->route_get, RouteGetData, priv->route_get->len - 1).obj_id);
+		g_array_set_size (priv->route_get, priv->route_get->len - 1);
+	}
+	g_array_unref (priv->route_get);
+
 	/* Free netlink resources */
 	g_source_remove (priv->event_id);
 	g_io_channel_unref (priv->event_channel);
@@ -6048,11 +7714,13 @@ nm_linux_platform_finalize (GObject *object)
 
 	g_object_unref (priv->udev_client);
 	g_hash_table_unref (priv->wifi_data);
+	recv_buffers_free (priv->recv_buffers);
 
 	if (priv->sysctl_get_prev_values) {
 		sysctl_clear_cache_list = g_slist_remove (sysctl_clear_cache_list, object);
 		g_hash_table_destroy (priv->sysctl_get_prev_values);
 	}
+	g_hash_table_unref (priv->sysctl_dirfds);
 
 	G_OBJECT_CLASS (nm_linux_platform_parent_class)->finalize (object);
 }
@@ -6074,6 +7742,8 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 
 	platform_class->sysctl_set = sysctl_set;
 	platform_class->sysctl_get = sysctl_get;
+	platform_class->sysctl_ifindex_set = sysctl_ifindex_set;
+	platform_class->sysctl_ifindex_get = sysctl_ifindex_get;
 
 	platform_class->link_get = _nm_platform_link_get;
 	platform_class->link_get_by_ifname = _nm_platform_link_get_by_ifname;
@@ -6115,6 +7785,9 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 
 	platform_class->vlan_add = vlan_add;
 	platform_class->link_vlan_change = link_vlan_change;
+	platform_class->link_bond_change = link_bond_change;
+	platform_class->link_bridge_change = link_bridge_change;
+	platform_class->link_bridge_port_change = link_bridge_port_change;
 	platform_class->link_vxlan_add = link_vxlan_add;
 
 	platform_class->tun_add = tun_add;
@@ -6157,12 +7830,17 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	platform_class->ip6_route_get_all = ip6_route_get_all;
 	platform_class->ip4_route_add = ip4_route_add;
 	platform_class->ip6_route_add = ip6_route_add;
+	platform_class->ip4_route_replace = ip4_route_replace;
+	platform_class->ip6_route_replace = ip6_route_replace;
 	platform_class->ip4_route_delete = ip4_route_delete;
 	platform_class->ip6_route_delete = ip6_route_delete;
 
+	platform_class->object_batch_commit = object_batch_commit;
+
 	platform_class->check_support_kernel_extended_ifa_flags = check_support_kernel_extended_ifa_flags;
 	platform_class->check_support_user_ipv6ll = check_support_user_ipv6ll;
 
 	platform_class->process_events = process_events;
+	platform_class->get_stats = get_stats;
 }
 
@@ -80,6 +80,7 @@ G_STATIC_ASSERT (G_STRUCT_OFFSET (NMPlatformIPRoute, network_ptr) == G_STRUCT_OF
 G_DEFINE_TYPE (NMPlatform, nm_platform, G_TYPE_OBJECT)
 
 static guint signals[_NM_PLATFORM_SIGNAL_ID_LAST] = { 0 };
+static guint signal_changes = 0;
 
 enum {
 	PROP_0,
@@ -89,6 +90,11 @@ enum {
 
 typedef struct {
 	gboolean register_singleton;
+	NMPlatformAddressSyncStats address_sync_stats;
+	NMPlatformStatsDuration ip4_address_sync_duration;
+	NMPlatformStatsDuration ip6_address_sync_duration;
+	NMPlatformChanges changes;
+	guint changes_idle_id;
 } NMPlatformPrivate;
 
 /******************************************************************/
@@ -380,6 +386,171 @@ nm_platform_sysctl_get_int_checked (NMPlatform *self, const char *path, guint ba
 
 /******************************************************************/
 
+/**
+ * _nm_platform_sysctl_dir_path:
+ * @dir: the sysctl directory
+ * @ifname: the interface name
+ * @name: (allow-none): the option, relative to the directory
+ * @buf: the buffer for the result
+ * @len: the size of @buf
+ *
+ * Returns: the absolute path of @name inside @dir for @ifname, or the
+ *   path of the directory itself if @name is %NULL.
+ */
+const char *
+_nm_platform_sysctl_dir_path (NMPlatformSysctlDir dir, const char *ifname, const char *name,
+                              char *buf, gsize len)
+{
+	static const char *const prefixes[_NM_PLATFORM_SYSCTL_DIR_NUM] = {
+		[NM_PLATFORM_SYSCTL_DIR_IP4_CONF]   = "/proc/sys/net/ipv4/conf/",
+		[NM_PLATFORM_SYSCTL_DIR_IP6_CONF]   = "/proc/sys/net/ipv6/conf/",
+		[NM_PLATFORM_SYSCTL_DIR_SYSFS]      = "/sys/class/net/",
+	};
+
+	int l;
+
+	nm_assert (dir >= 0 && dir < _NM_PLATFORM_SYSCTL_DIR_NUM);
+
+	l = g_snprintf (buf, len, "%s%s%s%s",
+	                prefixes[dir],
+	                ASSERT_VALID_PATH_COMPONENT (ifname),
+	                name ? "/" : "",
+	                name ?: "");
+	g_assert (l < len);
+	return buf;
+}
+
+static gboolean
+sysctl_ifindex_set (NMPlatform *self, int ifindex, NMPlatformSysctlDir dir, const char *name, const char *value)
+{
+	const char *ifname = nm_platform_link_get_name (self, ifindex);
+	char path[NM_PLATFORM_SYSCTL_PATH_MAX];
+
+	if (!ifname)
+		return FALSE;
+
+	return nm_platform_sysctl_set (self, _nm_platform_sysctl_dir_path (dir, ifname, name, path, sizeof (path)), value);
+}
+
+static char *
+sysctl_ifindex_get (NMPlatform *self, int ifindex, NMPlatformSysctlDir dir, const char *name)
+{
+	const char *ifname = nm_platform_link_get_name (self, ifindex);
+	char path[NM_PLATFORM_SYSCTL_PATH_MAX];
+
+	if (!ifname)
+		return NULL;
+
+	return nm_platform_sysctl_get (self, _nm_platform_sysctl_dir_path (dir, ifname, name, path, sizeof (path)));
+}
+
+#define _CHECK_SYSCTL_NAME(name) \
+	(   (name) \
+	 && (name)[0] \
+	 && (name)[0] != '/' \
+	 && !strstr ((name), ".."))
+
+/**
+ * nm_platform_sysctl_ifindex_set:
+ * @self: platform instance
+ * @ifindex: the interface
+ * @dir: the directory of the option
+ * @name: the option, relative to @dir. For %NM_PLATFORM_SYSCTL_DIR_SYSFS
+ *   this can contain a subdirectory, like "bonding/mode".
+ * @value: Value to write
+ *
+ * Like nm_platform_sysctl_set(), but for an option of an interface.
+ * Unlike paths, the interface index does not change when the interface
+ * gets renamed and the platform can avoid resolving the path of the
+ * interface directory on every access.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean
+nm_platform_sysctl_ifindex_set (NMPlatform *self, int ifindex, NMPlatformSysctlDir dir, const char *name, const char *value)
+{
+	_CHECK_SELF (self, klass, FALSE);
+
+	g_return_val_if_fail (ifindex > 0, FALSE);
+	g_return_val_if_fail (dir >= 0 && dir < _NM_PLATFORM_SYSCTL_DIR_NUM, FALSE);
+	g_return_val_if_fail (_CHECK_SYSCTL_NAME (name), FALSE);
+	g_return_val_if_fail (value, FALSE);
+
+	return klass->sysctl_ifindex_set (self, ifindex, dir, name, value);
+}
+
+/**
+ * nm_platform_sysctl_ifindex_get:
+ * @self: platform instance
+ * @ifindex: the interface
+ * @dir: the directory of the option
+ * @name: the option, relative to @dir
+ *
+ * Returns: (transfer full): Contents of the virtual sysctl file.
+ */
+char *
+nm_platform_sysctl_ifindex_get (NMPlatform *self, int ifindex, NMPlatformSysctlDir dir, const char *name)
+{
+	_CHECK_SELF (self, klass, NULL);
+
+	g_return_val_if_fail (ifindex > 0, NULL);
+	g_return_val_if_fail (dir >= 0 && dir < _NM_PLATFORM_SYSCTL_DIR_NUM, NULL);
+	g_return_val_if_fail (_CHECK_SYSCTL_NAME (name), NULL);
+
+	return klass->sysctl_ifindex_get (self, ifindex, dir, name);
+}
+
+/**
+ * nm_platform_sysctl_ifindex_set_many:
+ * @self: platform instance
+ * @ifindex: the interface
+ * @dir: the directory of the options
+ * @settings: the options to set, in order
+ * @n_settings: the number of @settings
+ *
+ * Applies several options of one interface. Options that already have
+ * the requested value are not written, because writing some options
+ * (like "disable_ipv6" or "mtu") has side effects in the kernel even if
+ * the value does not change.
+ *
+ * Returns: %TRUE if all options have the requested value.
+ */
+gboolean
+nm_platform_sysctl_ifindex_set_many (NMPlatform *self, int ifindex, NMPlatformSysctlDir dir,
+                                     const NMPlatformSysctlSetting *settings, guint n_settings)
+{
+	gboolean success = TRUE;
+	guint i, n_skipped = 0;
+
+	_CHECK_SELF (self, klass, FALSE);
+
+	g_return_val_if_fail (ifindex > 0, FALSE);
+	g_return_val_if_fail (dir >= 0 && dir < _NM_PLATFORM_SYSCTL_DIR_NUM, FALSE);
+	g_return_val_if_fail (settings || !n_settings, FALSE);
+
+	for (i = 0; i < n_settings; i++) {
+		gs_free char *current = NULL;
+
+		g_return_val_if_fail (_CHECK_SYSCTL_NAME (settings[i].name), FALSE);
+		g_return_val_if_fail (settings[i].value, FALSE);
+
+		current = klass->sysctl_ifindex_get (self, ifindex, dir, settings[i].name);
+		if (current && strcmp (current, settings[i].value) == 0) {
+			n_skipped++;
+			continue;
+		}
+
+		if (!klass->sysctl_ifindex_set (self, ifindex, dir, settings[i].name, settings[i].value))
+			success = FALSE;
+	}
+
+	_LOGD ("sysctl: set %u options on ifindex %d, %u already had the requested value",
+	       n_settings, ifindex, n_skipped);
+	return success;
+}
+
+/******************************************************************/
+
 /**
  * nm_platform_link_get_all:
  * self: platform instance
@@ -1388,6 +1559,18 @@ _link_get_lnk (NMPlatform *self, int ifindex, NMLinkType link_type, const NMPlat
 	return lnk ? &lnk->object : NULL;
 }
 
+const NMPlatformLnkBond *
+nm_platform_link_get_lnk_bond (NMPlatform *self, int ifindex, const NMPlatformLink **out_link)
+{
+	return _link_get_lnk (self, ifindex, NM_LINK_TYPE_BOND, out_link);
+}
+
+const NMPlatformLnkBridge *
+nm_platform_link_get_lnk_bridge (NMPlatform *self, int ifindex, const NMPlatformLink **out_link)
+{
+	return _link_get_lnk (self, ifindex, NM_LINK_TYPE_BRIDGE, out_link);
+}
+
 const NMPlatformLnkGre *
 nm_platform_link_get_lnk_gre (NMPlatform *self, int ifindex, const NMPlatformLink **out_link)
 {
@@ -1609,34 +1792,37 @@ nm_platform_link_tun_add (NMPlatform *self,
 
 /*****************************************************************************/
 
-static char *
-link_option_path (NMPlatform *self, int master, const char *category, const char *option)
+static const char *
+link_option_name (const char *category, const char *option, char *buf, gsize len)
 {
-	const char *name = nm_platform_link_get_name (self, master);
+	int l;
 
-	if (!name || !category || !option)
+	if (!category || !option)
 		return NULL;
 
-	return g_strdup_printf ("/sys/class/net/%s/%s/%s",
-	                        ASSERT_VALID_PATH_COMPONENT (name),
-	                        ASSERT_VALID_PATH_COMPONENT (category),
-	                        ASSERT_VALID_PATH_COMPONENT (option));
+	l = g_snprintf (buf, len, "%s/%s",
+	                ASSERT_VALID_PATH_COMPONENT (category),
+	                ASSERT_VALID_PATH_COMPONENT (option));
+	g_assert (l < len);
+	return buf;
 }
 
 static gboolean
 link_set_option (NMPlatform *self, int master, const char *category, const char *option, const char *value)
 {
-	gs_free char *path = link_option_path (self, master, category, option);
+	char buf[NM_PLATFORM_SYSCTL_PATH_MAX];
+	const char *name = link_option_name (category, option, buf, sizeof (buf));
 
-	return path && nm_platform_sysctl_set (self, path, value);
+	return name && nm_platform_sysctl_ifindex_set (self, master, NM_PLATFORM_SYSCTL_DIR_SYSFS, name, value);
 }
 
 static char *
 link_get_option (NMPlatform *self, int master, const char *category, const char *option)
 {
-	gs_free char *path = link_option_path (self, master, category, option);
+	char buf[NM_PLATFORM_SYSCTL_PATH_MAX];
+	const char *name = link_option_name (category, option, buf, sizeof (buf));
 
-	return path ? nm_platform_sysctl_get (self, path) : NULL;
+	return name ? nm_platform_sysctl_ifindex_get (self, master, NM_PLATFORM_SYSCTL_DIR_SYSFS, name) : NULL;
 }
 
 static const char *
@@ -1804,6 +1990,100 @@ nm_platform_link_vlan_set_egress_map (NMPlatform *self, int ifindex, int from, i
 	return nm_platform_link_vlan_change (self, ifindex, 0, 0, FALSE, NULL, 0, FALSE, &map, 1);
 }
 
+/**
+ * nm_platform_link_bond_change:
+ * @self: platform instance
+ * @ifindex: the ifindex of the bond
+ * @props: the bonding options
+ * @attrs: the options of @props to set
+ *
+ * Sets the options selected by @attrs with a single netlink request,
+ * instead of writing each file in sysfs. Options that already have
+ * the requested value might be skipped.
+ *
+ * Returns: %FALSE if the options could not be set, for example because
+ *   the kernel does not support configuring bonds via netlink. Callers
+ *   should fall back to sysfs in that case.
+ */
+gboolean
+nm_platform_link_bond_change (NMPlatform *self,
+                              int ifindex,
+                              const NMPlatformLnkBond *props,
+                              NMPlatformLnkBondAttrs attrs)
+{
+	_CHECK_SELF (self, klass, FALSE);
+
+	g_return_val_if_fail (ifindex > 0, FALSE);
+	g_return_val_if_fail (props, FALSE);
+	g_return_val_if_fail (props->num_arp_ip_targets <= NM_PLATFORM_LNK_BOND_MAX_ARP_TARGETS, FALSE);
+
+	if (!klass->link_bond_change)
+		return FALSE;
+
+	_LOGD ("link: change bond %d: attrs 0x%x, %s",
+	       ifindex, (unsigned) attrs,
+	       nm_platform_lnk_bond_to_string (props, NULL, 0));
+	return klass->link_bond_change (self, ifindex, props, attrs);
+}
+
+/**
+ * nm_platform_link_bridge_change:
+ * @self: platform instance
+ * @ifindex: the ifindex of the bridge
+ * @props: the bridge options
+ *
+ * Sets all options of the bridge with a single netlink request.
+ *
+ * Returns: %FALSE if the options could not be set, for example because
+ *   the kernel does not support configuring bridges via netlink. Callers
+ *   should fall back to sysfs in that case.
+ */
+gboolean
+nm_platform_link_bridge_change (NMPlatform *self,
+                                int ifindex,
+                                const NMPlatformLnkBridge *props)
+{
+	_CHECK_SELF (self, klass, FALSE);
+
+	g_return_val_if_fail (ifindex > 0, FALSE);
+	g_return_val_if_fail (props, FALSE);
+
+	if (!klass->link_bridge_change)
+		return FALSE;
+
+	_LOGD ("link: change bridge %d: %s", ifindex, nm_platform_lnk_bridge_to_string (props, NULL, 0));
+	return klass->link_bridge_change (self, ifindex, props);
+}
+
+/**
+ * nm_platform_link_bridge_port_change:
+ * @self: platform instance
+ * @ifindex: the ifindex of the bridge port
+ * @props: the port options
+ *
+ * Like nm_platform_link_bridge_change(), but for the options
+ * of a port, which must already be attached to the bridge.
+ *
+ * Returns: %FALSE if the options could not be set.
+ */
+gboolean
+nm_platform_link_bridge_port_change (NMPlatform *self,
+                                     int ifindex,
+                                     const NMPlatformBridgePort *props)
+{
+	_CHECK_SELF (self, klass, FALSE);
+
+	g_return_val_if_fail (ifindex > 0, FALSE);
+	g_return_val_if_fail (props, FALSE);
+
+	if (!klass->link_bridge_port_change)
+		return FALSE;
+
+	_LOGD ("link: change bridge port %d: priority %u path_cost %u hairpin_mode %d",
+	       ifindex, props->priority, props->path_cost, !!props->hairpin_mode);
+	return klass->link_bridge_port_change (self, ifindex, props);
+}
+
 /**
  * nm_platform_link_gre_add:
  * @self: platform instance
@@ -2530,48 +2810,277 @@ nm_platform_ip6_address_get (NMPlatform *self, int ifindex, struct in6_addr addr
 	return klass->ip6_address_get (self, ifindex, address, plen);
 }
 
+/* The identity of an address, as the kernel sees it. For IPv4, that is the
+ * address, the prefix length and the peer network. */
+static guint
+_ip4_address_id_hash (gconstpointer ptr)
+{
+	const NMPlatformIP4Address *a = ptr;
+	guint h = 1839;
+
+	h = (h * 33) + a->address;
+	h = (h * 33) + a->plen;
+	h = (h * 33) + (a->peer_address & nm_utils_ip4_prefix_to_netmask (a->plen));
+	return h;
+}
+
 static gboolean
-array_contains_ip4_address (const GArray *addresses, const NMPlatformIP4Address *address, gint64 now, guint32 padding)
+_ip4_address_id_equal (gconstpointer ptr_a, gconstpointer ptr_b)
 {
-	guint len = addresses ? addresses->len : 0;
+	const NMPlatformIP4Address *a = ptr_a;
+	const NMPlatformIP4Address *b = ptr_b;
+
+	return    a->address == b->address
+	       && a->plen == b->plen
+	       && ((a->peer_address ^ b->peer_address) & nm_utils_ip4_prefix_to_netmask (a->plen)) == 0;
+}
+
+static guint
+_ip6_address_id_hash (gconstpointer ptr)
+{
+	const NMPlatformIP6Address *a = ptr;
+	guint h = 3691;
 	guint i;
 
-	for (i = 0; i < len; i++) {
-		NMPlatformIP4Address *candidate = &g_array_index (addresses, NMPlatformIP4Address, i);
+	for (i = 0; i < G_N_ELEMENTS (a->address.s6_addr32); i++)
+		h = (h * 33) + a->address.s6_addr32[i];
+	h = (h * 33) + a->plen;
+	return h;
+}
 
-		if (   candidate->address == address->address
-		    && candidate->plen == address->plen
-		    && ((candidate->peer_address ^ address->peer_address) & nm_utils_ip4_prefix_to_netmask (address->plen)) == 0) {
-			guint32 lifetime, preferred;
+static gboolean
+_ip6_address_id_equal (gconstpointer ptr_a, gconstpointer ptr_b)
+{
+	const NMPlatformIP6Address *a = ptr_a;
+	const NMPlatformIP6Address *b = ptr_b;
 
-			if (nmp_utils_lifetime_get (candidate->timestamp, candidate->lifetime, candidate->preferred,
-			                            now, padding, &lifetime, &preferred))
-				return TRUE;
-		}
+	return    IN6_ARE_ADDR_EQUAL (&a->address, &b->address)
+	       && a->plen == b->plen;
+}
+
+/* Seconds that the remaining lifetime of an address in the kernel may
+ * deviate from the requested one, before we re-add the address. The
+ * cached lifetimes are only accurate to the second. */
+#define ADDRESS_LIFETIME_SLACK 2
+
+static gboolean
+_address_lifetime_unchanged (const NMPlatformIPAddress *existing,
+                             guint32 lifetime,
+                             guint32 preferred,
+                             guint32 now)
+{
+	guint32 e_lifetime, e_preferred;
+
+	if (!nmp_utils_lifetime_get (existing->timestamp, existing->lifetime, existing->preferred,
+	                             now, 0, &e_lifetime, &e_preferred))
+		return FALSE;
+
+	if (   lifetime == NM_PLATFORM_LIFETIME_PERMANENT
+	    || e_lifetime == NM_PLATFORM_LIFETIME_PERMANENT) {
+		if (lifetime != e_lifetime)
+			return FALSE;
+	} else if (ABS ((gint64) lifetime - (gint64) e_lifetime) > ADDRESS_LIFETIME_SLACK)
+		return FALSE;
+
+	if (   preferred == NM_PLATFORM_LIFETIME_PERMANENT
+	    || e_preferred == NM_PLATFORM_LIFETIME_PERMANENT)
+		return preferred == e_preferred;
+	return ABS ((gint64) preferred - (gint64) e_preferred) <= ADDRESS_LIFETIME_SLACK;
+}
+
+/* Creates a set of the addresses in @addresses that are not expired. */
+static GHashTable *
+_address_set_new (const GArray *addresses,
+                  gboolean is_v4,
+                  guint32 now)
+{
+	GHashTable *set;
+	guint i;
+
+	set = is_v4
+	      ? g_hash_table_new (_ip4_address_id_hash, _ip4_address_id_equal)
+	      : g_hash_table_new (_ip6_address_id_hash, _ip6_address_id_equal);
+
+	for (i = 0; addresses && i < addresses->len; i++) {
+		const NMPlatformIPAddress *a;
+		guint32 lifetime, preferred;
+
+		a = is_v4
+		    ? (NMPlatformIPAddress *) &g_array_index (addresses, NMPlatformIP4Address, i)
+		    : (NMPlatformIPAddress *) &g_array_index (addresses, NMPlatformIP6Address, i);
+
+		if (nmp_utils_lifetime_get (a->timestamp, a->lifetime, a->preferred,
+		                            now, ADDRESS_LIFETIME_PADDING, &lifetime, &preferred))
+			g_hash_table_add (set, (gpointer) a);
 	}
+	return set;
+}
 
-	return FALSE;
+static void
+_address_sync_account (NMPlatform *self,
+                       int ifindex,
+                       gboolean is_v4,
+                       gint64 start_ns,
+                       guint added,
+                       guint refreshed,
+                       guint deleted,
+                       guint unchanged)
+{
+	NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE (self);
+
+	nm_platform_stats_duration_add (is_v4 ? &priv->ip4_address_sync_duration : &priv->ip6_address_sync_duration,
+	                                nm_utils_get_monotonic_timestamp_ns () - start_ns);
+	priv->address_sync_stats.added += added;
+	priv->address_sync_stats.refreshed += refreshed;
+	priv->address_sync_stats.deleted += deleted;
+	priv->address_sync_stats.unchanged += unchanged;
+
+	_LOGD ("address: sync IPv%c addresses on ifindex %d: %u added, %u refreshed, %u deleted, %u unchanged",
+	       is_v4 ? '4' : '6', ifindex, added, refreshed, deleted, unchanged);
 }
 
-static gboolean
-array_contains_ip6_address (const GArray *addresses, const NMPlatformIP6Address *address, gint64 now, guint32 padding)
+/**
+ * nm_platform_address_sync_get_stats:
+ * @self: platform instance
+ *
+ * Returns: the number of address operations done by nm_platform_ip4_address_sync()
+ *   and nm_platform_ip6_address_sync() so far. @unchanged counts the addresses
+ *   that were already configured and thus did not cause a netlink request.
+ */
+const NMPlatformAddressSyncStats *
+nm_platform_address_sync_get_stats (NMPlatform *self)
+{
+	_CHECK_SELF (self, klass, NULL);
+
+	return &NM_PLATFORM_GET_PRIVATE (self)->address_sync_stats;
+}
+
+/*****************************************************************************/
+
+/**
+ * nm_platform_stats_duration_add:
+ * @duration: the histogram
+ * @duration_ns: the measured duration in nanoseconds
+ */
+void
+nm_platform_stats_duration_add (NMPlatformStatsDuration *duration, gint64 duration_ns)
 {
-	guint len = addresses ? addresses->len : 0;
+	guint64 usec, msec;
 	guint i;
 
-	for (i = 0; i < len; i++) {
-		NMPlatformIP6Address *candidate = &g_array_index (addresses, NMPlatformIP6Address, i);
+	g_return_if_fail (duration);
 
-		if (IN6_ARE_ADDR_EQUAL (&candidate->address, &address->address) && candidate->plen == address->plen) {
-			guint32 lifetime, preferred;
+	usec = MAX (duration_ns, 0) / 1000;
+	msec = usec / 1000;
 
-			if (nmp_utils_lifetime_get (candidate->timestamp, candidate->lifetime, candidate->preferred,
-			                            now, padding, &lifetime, &preferred))
-				return TRUE;
-		}
+	for (i = 0; i < NM_PLATFORM_STATS_DURATION_BUCKETS - 1; i++) {
+		if (msec < (((guint64) 1) << i))
+			break;
 	}
 
-	return FALSE;
+	duration->count++;
+	duration->total_usec += usec;
+	duration->max_usec = MAX (duration->max_usec, usec);
+	duration->buckets[i]++;
+}
+
+/**
+ * nm_platform_get_stats:
+ * @self: platform instance
+ * @out_stats: (out): the statistics
+ *
+ * Collects the counters of the platform. The platform implementation
+ * adds its own counters, like the number of netlink messages and the
+ * content of the cache.
+ */
+void
+nm_platform_get_stats (NMPlatform *self, NMPlatformStats *out_stats)
+{
+	NMPlatformPrivate *priv;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	g_return_if_fail (out_stats);
+
+	priv = NM_PLATFORM_GET_PRIVATE (self);
+
+	memset (out_stats, 0, sizeof (*out_stats));
+	out_stats->ip4_address_sync = priv->ip4_address_sync_duration;
+	out_stats->ip6_address_sync = priv->ip6_address_sync_duration;
+
+	if (klass->get_stats)
+		klass->get_stats (self, out_stats);
+}
+
+static const char *
+_stats_duration_to_string (const NMPlatformStatsDuration *duration, char *buf, gsize len)
+{
+	char *b = buf;
+	guint i;
+
+	nm_utils_strbuf_append (&b, &len, "%" G_GUINT64_FORMAT " times, avg %" G_GUINT64_FORMAT " usec, max %" G_GUINT64_FORMAT " usec, histogram",
+	                        duration->count,
+	                        duration->count ? duration->total_usec / duration->count : (guint64) 0,
+	                        duration->max_usec);
+	for (i = 0; i < NM_PLATFORM_STATS_DURATION_BUCKETS; i++)
+		nm_utils_strbuf_append (&b, &len, " %" G_GUINT64_FORMAT, duration->buckets[i]);
+	return buf;
+}
+
+/**
+ * nm_platform_stats_log:
+ * @self: platform instance
+ * @level: the log level
+ *
+ * Logs the statistics of nm_platform_get_stats() in the platform
+ * logging domain. The histograms are printed as counts per bucket,
+ * starting with durations below 1 msec and doubling with each bucket.
+ */
+void
+nm_platform_stats_log (NMPlatform *self, NMLogLevel level)
+{
+	static const char *const msg_names[_NM_PLATFORM_STATS_MSG_LAST] = {
+		[NM_PLATFORM_STATS_MSG_NEWLINK]  = "newlink",
+		[NM_PLATFORM_STATS_MSG_DELLINK]  = "dellink",
+		[NM_PLATFORM_STATS_MSG_NEWADDR]  = "newaddr",
+		[NM_PLATFORM_STATS_MSG_DELADDR]  = "deladdr",
+		[NM_PLATFORM_STATS_MSG_NEWROUTE] = "newroute",
+		[NM_PLATFORM_STATS_MSG_DELROUTE] = "delroute",
+		[NM_PLATFORM_STATS_MSG_OTHER]    = "other",
+	};
+	NMPlatformStats stats;
+	char buf[512];
+	char *b;
+	gsize l;
+	guint i;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	if (!nm_logging_enabled (level, _NMLOG_DOMAIN))
+		return;
+
+	nm_platform_get_stats (self, &stats);
+
+	b = buf;
+	l = sizeof (buf);
+	for (i = 0; i < _NM_PLATFORM_STATS_MSG_LAST; i++)
+		nm_utils_strbuf_append (&b, &l, "%s%s %" G_GUINT64_FORMAT, i ? ", " : "", msg_names[i], stats.netlink_msgs[i]);
+	_NMLOG (level, "stats: netlink messages: %s", buf);
+	_NMLOG (level, "stats: netlink dumps: %s", _stats_duration_to_string (&stats.dumps, buf, sizeof (buf)));
+	_NMLOG (level, "stats: overruns %" G_GUINT64_FORMAT ", resyncs %" G_GUINT64_FORMAT ", delayed actions %" G_GUINT64_FORMAT ", refetches of all objects %" G_GUINT64_FORMAT,
+	        stats.overruns, stats.resyncs, stats.delayed_actions, stats.refetches_all);
+
+	for (i = NMP_OBJECT_TYPE_UNKNOWN + 1; i <= NMP_OBJECT_TYPE_MAX; i++) {
+		if (!stats.cache_objs[i])
+			continue;
+		_NMLOG (level, "stats: cache %s: %u objects, %" G_GUINT64_FORMAT " bytes",
+		        nmp_class_from_type (i)->obj_type_name, stats.cache_objs[i], stats.cache_bytes[i]);
+	}
+
+	_NMLOG (level, "stats: ip4-address-sync: %s", _stats_duration_to_string (&stats.ip4_address_sync, buf, sizeof (buf)));
+	_NMLOG (level, "stats: ip6-address-sync: %s", _stats_duration_to_string (&stats.ip6_address_sync, buf, sizeof (buf)));
+
+	nmp_object_pool_log_stats (level);
 }
 
 /**
@@ -2582,62 +3091,130 @@ array_contains_ip6_address (const GArray *addresses, const NMPlatformIP6Address
  * @out_added_addresses: (out): (allow-none): if not %NULL, return a #GPtrArray
  *   with the addresses added. The pointers point into @known_addresses.
  *   It possibly does not contain all addresses from @known_address because
- *   some addresses might be expired.
+ *   some addresses might be expired. Addresses that were already configured
+ *   are considered added as well.
  *
  * A convenience function to synchronize addresses for a specific interface
  * with the least possible disturbance. It simply removes addresses that are
- * not listed and adds addresses that are.
+ * not listed and adds addresses that are. Addresses that are already configured
+ * with the same label and lifetimes are not touched.
  *
- * Returns: %TRUE on success.
+ * All changes are sent as one batch. A failed add doesn't stop the sync,
+ * the remaining addresses are still added. Failed addresses are not part of
+ * @out_added_addresses.
+ *
+ * Returns: %TRUE on success, %FALSE if any address could not be added.
+ *   Failing to delete an address is not considered an error.
  */
 gboolean
 nm_platform_ip4_address_sync (NMPlatform *self, int ifindex, const GArray *known_addresses, GPtrArray **out_added_addresses)
 {
 	GArray *addresses;
 	NMPlatformIP4Address *address;
+	NMPlatformBatch *batch;
 	guint32 now = nm_utils_get_monotonic_timestamp_s ();
+	gs_free guint *added_idx = NULL;
+	GHashTable *known_set, *existing_set;
+	guint n_added = 0, n_refreshed = 0, n_deleted = 0, n_unchanged = 0;
+	gboolean success = TRUE;
+	gint64 start_ns = nm_utils_get_monotonic_timestamp_ns ();
 	int i;
 
 	_CHECK_SELF (self, klass, FALSE);
 
+	if (out_added_addresses)
+		*out_added_addresses = NULL;
+
+	/* Deletions and additions are sent to the platform as one batch,
+	 * so that they can be pipelined. */
+	batch = nm_platform_batch_new (self);
+
+	known_set = _address_set_new (known_addresses, TRUE, now);
+	existing_set = g_hash_table_new (_ip4_address_id_hash, _ip4_address_id_equal);
+
 	/* Delete unknown addresses */
 	addresses = nm_platform_ip4_address_get_all (self, ifindex);
 	for (i = 0; i < addresses->len; i++) {
 		address = &g_array_index (addresses, NMPlatformIP4Address, i);
 
-		if (!array_contains_ip4_address (known_addresses, address, now, ADDRESS_LIFETIME_PADDING))
-			nm_platform_ip4_address_delete (self, ifindex, address->address, address->plen, address->peer_address);
+		if (!g_hash_table_contains (known_set, address)) {
+			nm_platform_batch_ip4_address_delete (batch, ifindex, address->address, address->plen, address->peer_address);
+			n_deleted++;
+		} else
+			g_hash_table_add (existing_set, address);
 	}
-	g_array_free (addresses, TRUE);
 
-	if (out_added_addresses)
-		*out_added_addresses = NULL;
+	/* Add missing addresses */
+	if (known_addresses) {
+		added_idx = g_new (guint, known_addresses->len);
+		for (i = 0; i < known_addresses->len; i++) {
+			const NMPlatformIP4Address *known_address = &g_array_index (known_addresses, NMPlatformIP4Address, i);
+			const NMPlatformIP4Address *existing;
+			guint32 lifetime, preferred;
 
-	if (!known_addresses)
-		return TRUE;
+			added_idx[i] = G_MAXUINT;
+			if (!nmp_utils_lifetime_get (known_address->timestamp, known_address->lifetime, known_address->preferred,
+			                             now, ADDRESS_LIFETIME_PADDING, &lifetime, &preferred))
+				continue;
 
-	/* Add missing addresses */
-	for (i = 0; i < known_addresses->len; i++) {
-		const NMPlatformIP4Address *known_address = &g_array_index (known_addresses, NMPlatformIP4Address, i);
-		guint32 lifetime, preferred;
+			existing = g_hash_table_lookup (existing_set, known_address);
+			if (   existing
+			    && existing->peer_address == known_address->peer_address
+			    && strcmp (existing->label, known_address->label) == 0
+			    && _address_lifetime_unchanged ((const NMPlatformIPAddress *) existing, lifetime, preferred, now)) {
+				/* the address is configured already, there is nothing to do. */
+				added_idx[i] = G_MAXUINT - 1;
+				n_unchanged++;
+				continue;
+			}
 
-		if (!nmp_utils_lifetime_get (known_address->timestamp, known_address->lifetime, known_address->preferred,
-		                             now, ADDRESS_LIFETIME_PADDING, &lifetime, &preferred))
-			continue;
+			added_idx[i] = nm_platform_batch_ip4_address_add (batch, ifindex, known_address->address, known_address->plen,
+			                                                  known_address->peer_address, lifetime, preferred, known_address->label);
+			if (added_idx[i] == G_MAXUINT)
+				success = FALSE;
+			if (existing)
+				n_refreshed++;
+			else
+				n_added++;
+		}
+	}
 
-		if (!nm_platform_ip4_address_add (self, ifindex, known_address->address, known_address->plen, known_address->peer_address, lifetime, preferred, known_address->label))
-			return FALSE;
+	g_hash_table_unref (existing_set);
+	g_hash_table_unref (known_set);
+	g_array_free (addresses, TRUE);
+
+	nm_platform_batch_commit (batch);
 
-		if (out_added_addresses) {
-			if (!*out_added_addresses)
-				*out_added_addresses = g_ptr_array_new ();
-			g_ptr_array_add (*out_added_addresses, (gpointer) known_address);
+	/* Failing to delete an address is not considered fatal. */
+	if (known_addresses) {
+		for (i = 0; i < known_addresses->len; i++) {
+			if (added_idx[i] == G_MAXUINT)
+				continue;
+
+			if (   added_idx[i] != G_MAXUINT - 1
+			    && !nm_platform_batch_get_result (batch, added_idx[i])) {
+				success = FALSE;
+				continue;
+			}
+
+			if (out_added_addresses) {
+				if (!*out_added_addresses)
+					*out_added_addresses = g_ptr_array_new ();
+				g_ptr_array_add (*out_added_addresses, (gpointer) &g_array_index (known_addresses, NMPlatformIP4Address, i));
+			}
 		}
 	}
 
-	return TRUE;
+	nm_platform_batch_free (batch);
+
+	_address_sync_account (self, ifindex, TRUE, start_ns, n_added, n_refreshed, n_deleted, n_unchanged);
+	return success;
 }
 
+/* Address flags that NetworkManager sets itself. Other flags like
+ * IFA_F_TENTATIVE are maintained by the kernel. */
+#define IP6_ADDRESS_FLAGS_MANAGED (IFA_F_NODAD | IFA_F_HOMEADDRESS | IFA_F_MANAGETEMPADDR | IFA_F_NOPREFIXROUTE)
+
 /**
  * nm_platform_ip6_address_sync:
  * @self: platform instance
@@ -2647,51 +3224,107 @@ nm_platform_ip4_address_sync (NMPlatform *self, int ifindex, const GArray *known
  *
  * A convenience function to synchronize addresses for a specific interface
  * with the least possible disturbance. It simply removes addresses that are
- * not listed and adds addresses that are.
+ * not listed and adds addresses that are. Addresses that are already configured
+ * with the same flags and lifetimes are not touched.
  *
- * Returns: %TRUE on success.
+ * All changes are sent as one batch. A failed add doesn't stop the sync,
+ * the remaining addresses are still added.
+ *
+ * Returns: %TRUE on success, %FALSE if any address could not be added.
+ *   Failing to delete an address is not considered an error.
  */
 gboolean
 nm_platform_ip6_address_sync (NMPlatform *self, int ifindex, const GArray *known_addresses, gboolean keep_link_local)
 {
 	GArray *addresses;
 	NMPlatformIP6Address *address;
+	NMPlatformBatch *batch;
 	guint32 now = nm_utils_get_monotonic_timestamp_s ();
+	gs_free guint *added_idx = NULL;
+	GHashTable *known_set, *existing_set;
+	guint n_added = 0, n_refreshed = 0, n_deleted = 0, n_unchanged = 0;
+	gboolean success = TRUE;
+	gint64 start_ns = nm_utils_get_monotonic_timestamp_ns ();
 	int i;
 
+	_CHECK_SELF (self, klass, FALSE);
+
+	batch = nm_platform_batch_new (self);
+
+	known_set = _address_set_new (known_addresses, FALSE, now);
+	existing_set = g_hash_table_new (_ip6_address_id_hash, _ip6_address_id_equal);
+
 	/* Delete unknown addresses */
 	addresses = nm_platform_ip6_address_get_all (self, ifindex);
 	for (i = 0; i < addresses->len; i++) {
 		address = &g_array_index (addresses, NMPlatformIP6Address, i);
 
+		if (g_hash_table_contains (known_set, address)) {
+			g_hash_table_add (existing_set, address);
+			continue;
+		}
+
 		/* Leave link local address management to the kernel */
 		if (keep_link_local && IN6_IS_ADDR_LINKLOCAL (&address->address))
 			continue;
 
-		if (!array_contains_ip6_address (known_addresses, address, now, ADDRESS_LIFETIME_PADDING))
-			nm_platform_ip6_address_delete (self, ifindex, address->address, address->plen);
+		nm_platform_batch_ip6_address_delete (batch, ifindex, address->address, address->plen);
+		n_deleted++;
 	}
-	g_array_free (addresses, TRUE);
-
-	if (!known_addresses)
-		return TRUE;
 
 	/* Add missing addresses */
-	for (i = 0; i < known_addresses->len; i++) {
-		const NMPlatformIP6Address *known_address = &g_array_index (known_addresses, NMPlatformIP6Address, i);
-		guint32 lifetime, preferred;
+	if (known_addresses) {
+		added_idx = g_new (guint, known_addresses->len);
+		for (i = 0; i < known_addresses->len; i++) {
+			const NMPlatformIP6Address *known_address = &g_array_index (known_addresses, NMPlatformIP6Address, i);
+			const NMPlatformIP6Address *existing;
+			guint32 lifetime, preferred;
 
-		if (!nmp_utils_lifetime_get (known_address->timestamp, known_address->lifetime, known_address->preferred,
-		                             now, ADDRESS_LIFETIME_PADDING, &lifetime, &preferred))
-			continue;
+			added_idx[i] = G_MAXUINT;
+			if (!nmp_utils_lifetime_get (known_address->timestamp, known_address->lifetime, known_address->preferred,
+			                             now, ADDRESS_LIFETIME_PADDING, &lifetime, &preferred))
+				continue;
 
-		if (!nm_platform_ip6_address_add (self, ifindex, known_address->address,
-		                                  known_address->plen, known_address->peer_address,
-		                                  lifetime, preferred, known_address->flags))
-			return FALSE;
+			existing = g_hash_table_lookup (existing_set, known_address);
+			if (   existing
+			    && (existing->flags & IP6_ADDRESS_FLAGS_MANAGED) == (known_address->flags & IP6_ADDRESS_FLAGS_MANAGED)
+			    && (   IN6_IS_ADDR_UNSPECIFIED (&known_address->peer_address)
+			        || IN6_ARE_ADDR_EQUAL (&existing->peer_address, &known_address->peer_address))
+			    && _address_lifetime_unchanged ((const NMPlatformIPAddress *) existing, lifetime, preferred, now)) {
+				n_unchanged++;
+				continue;
+			}
+
+			added_idx[i] = nm_platform_batch_ip6_address_add (batch, ifindex, known_address->address,
+			                                                  known_address->plen, known_address->peer_address,
+			                                                  lifetime, preferred, known_address->flags);
+			if (added_idx[i] == G_MAXUINT)
+				success = FALSE;
+			if (existing)
+				n_refreshed++;
+			else
+				n_added++;
+		}
 	}
 
-	return TRUE;
+	g_hash_table_unref (existing_set);
+	g_hash_table_unref (known_set);
+	g_array_free (addresses, TRUE);
+
+	nm_platform_batch_commit (batch);
+
+	if (known_addresses) {
+		for (i = 0; i < known_addresses->len; i++) {
+			if (   added_idx[i] != G_MAXUINT
+			    && !nm_platform_batch_get_result (batch, added_idx[i]))
+				success = FALSE;
+		}
+	}
+
+	nm_platform_batch_free (batch);
+
+	_address_sync_account (self, ifindex, FALSE, start_ns, n_added, n_refreshed, n_deleted, n_unchanged);
+	return success;
 }
 
 gboolean
@@ -2809,6 +3442,81 @@ nm_platform_ip6_route_add (NMPlatform *self,
 	return klass->ip6_route_add (self, ifindex, source, network, plen, gateway, metric, mss);
 }
 
+/**
+ * nm_platform_ip4_route_replace:
+ * @self: platform instance
+ * @ifindex: the interface of the route
+ * @source: the source of the route
+ * @network: the destination network of the route
+ * @plen: the prefix length
+ * @gateway: the gateway of the route
+ * @pref_src: the preferred source address or 0
+ * @metric: the metric of the route
+ * @mss: the MSS of the route
+ *
+ * Like nm_platform_ip4_route_add(), but only updates the attributes of an
+ * existing route in place (NLM_F_REPLACE without NLM_F_CREATE). The route
+ * is never removed in the meantime, so traffic keeps flowing. The kernel
+ * identifies a route by its destination and its metric, so changing the
+ * metric is not possible this way.
+ *
+ * Returns: %TRUE in case of success, %FALSE if the route does not exist
+ *   or cannot be updated.
+ */
+gboolean
+nm_platform_ip4_route_replace (NMPlatform *self,
+                               int ifindex, NMIPConfigSource source,
+                               in_addr_t network, int plen,
+                               in_addr_t gateway, in_addr_t pref_src,
+                               guint32 metric, guint32 mss)
+{
+	_CHECK_SELF (self, klass, FALSE);
+
+	g_return_val_if_fail (0 <= plen && plen <= 32, FALSE);
+
+	if (_LOGD_ENABLED ()) {
+		NMPlatformIP4Route route = { 0 };
+
+		route.ifindex = ifindex;
+		route.source = source;
+		route.network = network;
+		route.plen = plen;
+		route.gateway = gateway;
+		route.metric = metric;
+		route.mss = mss;
+		route.pref_src = pref_src;
+
+		_LOGD ("route: replacing IPv4 route: %s", nm_platform_ip4_route_to_string (&route, NULL, 0));
+	}
+	return klass->ip4_route_replace (self, ifindex, source, network, plen, gateway, pref_src, metric, mss);
+}
+
+gboolean
+nm_platform_ip6_route_replace (NMPlatform *self,
+                               int ifindex, NMIPConfigSource source,
+                               struct in6_addr network, int plen, struct in6_addr gateway,
+                               guint32 metric, guint32 mss)
+{
+	_CHECK_SELF (self, klass, FALSE);
+
+	g_return_val_if_fail (0 <= plen && plen <= 128, FALSE);
+
+	if (_LOGD_ENABLED ()) {
+		NMPlatformIP6Route route = { 0 };
+
+		route.ifindex = ifindex;
+		route.source = source;
+		route.network = network;
+		route.plen = plen;
+		route.gateway = gateway;
+		route.metric = metric;
+		route.mss = mss;
+
+		_LOGD ("route: replacing IPv6 route: %s", nm_platform_ip6_route_to_string (&route, NULL, 0));
+	}
+	return klass->ip6_route_replace (self, ifindex, source, network, plen, gateway, metric, mss);
+}
+
 gboolean
 nm_platform_ip4_route_delete (NMPlatform *self, int ifindex, in_addr_t network, int plen, guint32 metric)
 {
@@ -2853,6 +3561,487 @@ nm_platform_ip6_route_get (NMPlatform *self, int ifindex, struct in6_addr networ
 
 /******************************************************************/
 
+struct _NMPlatformBatch {
+	NMPlatform *platform;
+	GArray *ops;
+	bool committed;
+};
+
+/**
+ * nm_platform_batch_new:
+ * @self: platform instance
+ *
+ * Creates a new batch of address and route operations. Operations
+ * are only queued and are sent to the platform all at once by
+ * nm_platform_batch_commit(). Contrary to calling the single operations
+ * one after another, this allows the platform to pipeline the requests
+ * instead of waiting for each response.
+ *
+ * The operations are performed in the order in which they were queued.
+ *
+ * Returns: (transfer full): the new batch. Free with nm_platform_batch_free().
+ */
+NMPlatformBatch *
+nm_platform_batch_new (NMPlatform *self)
+{
+	NMPlatformBatch *batch;
+
+	_CHECK_SELF (self, klass, NULL);
+
+	batch = g_slice_new0 (NMPlatformBatch);
+	batch->platform = g_object_ref (self);
+	batch->ops = g_array_new (FALSE, FALSE, sizeof (NMPlatformBatchOp));
+	return batch;
+}
+
+void
+nm_platform_batch_free (NMPlatformBatch *batch)
+{
+	guint i;
+
+	if (!batch)
+		return;
+
+	for (i = 0; i < batch->ops->len; i++)
+		nmp_object_unref (g_array_index (batch->ops, NMPlatformBatchOp, i).obj);
+	g_array_free (batch->ops, TRUE);
+	g_object_unref (batch->platform);
+	g_slice_free (NMPlatformBatch, batch);
+}
+
+guint
+nm_platform_batch_get_len (const NMPlatformBatch *batch)
+{
+	g_return_val_if_fail (batch, 0);
+
+	return batch->ops->len;
+}
+
+static guint
+_batch_append (NMPlatformBatch *batch,
+               NMPlatformBatchOpType op_type,
+               NMPObjectType obj_type,
+               const NMPlatformObject *plobj)
+{
+	NMPlatformBatchOp op = {
+		.op_type = op_type,
+		.obj = nmp_object_new (obj_type, plobj),
+	};
+
+	nm_assert (!batch->committed);
+
+	g_array_append_val (batch->ops, op);
+	return batch->ops->len - 1;
+}
+
+guint
+nm_platform_batch_ip4_address_add (NMPlatformBatch *batch,
+                                   int ifindex,
+                                   in_addr_t address,
+                                   int plen,
+                                   in_addr_t peer_address,
+                                   guint32 lifetime,
+                                   guint32 preferred,
+                                   const char *label)
+{
+	NMPlatformIP4Address addr = { 0 };
+	NMPlatform *self;
+
+	g_return_val_if_fail (batch, G_MAXUINT);
+	g_return_val_if_fail (!batch->committed, G_MAXUINT);
+	g_return_val_if_fail (ifindex > 0, G_MAXUINT);
+	g_return_val_if_fail (plen > 0, G_MAXUINT);
+	g_return_val_if_fail (lifetime > 0, G_MAXUINT);
+	g_return_val_if_fail (preferred <= lifetime, G_MAXUINT);
+	g_return_val_if_fail (!label || strlen (label) < sizeof (((NMPlatformIP4Address *) NULL)->label), G_MAXUINT);
+
+	self = batch->platform;
+
+	addr.ifindex = ifindex;
+	addr.address = address;
+	addr.peer_address = peer_address;
+	addr.plen = plen;
+	addr.timestamp = 0; /* set it at zero, which to_string will treat as *now* */
+	addr.lifetime = lifetime;
+	addr.preferred = preferred;
+	if (label)
+		g_strlcpy (addr.label, label, sizeof (addr.label));
+
+	_LOGD ("address: batch adding or updating IPv4 address: %s", nm_platform_ip4_address_to_string (&addr, NULL, 0));
+	return _batch_append (batch, NM_PLATFORM_BATCH_OP_ADD, NMP_OBJECT_TYPE_IP4_ADDRESS, (const NMPlatformObject *) &addr);
+}
+
+guint
+nm_platform_batch_ip6_address_add (NMPlatformBatch *batch,
+                                   int ifindex,
+                                   struct in6_addr address,
+                                   int plen,
+                                   struct in6_addr peer_address,
+                                   guint32 lifetime,
+                                   guint32 preferred,
+                                   guint flags)
+{
+	NMPlatformIP6Address addr = { 0 };
+	NMPlatform *self;
+
+	g_return_val_if_fail (batch, G_MAXUINT);
+	g_return_val_if_fail (!batch->committed, G_MAXUINT);
+	g_return_val_if_fail (ifindex > 0, G_MAXUINT);
+	g_return_val_if_fail (plen > 0, G_MAXUINT);
+	g_return_val_if_fail (lifetime > 0, G_MAXUINT);
+	g_return_val_if_fail (preferred <= lifetime, G_MAXUINT);
+
+	self = batch->platform;
+
+	addr.ifindex = ifindex;
+	addr.address = address;
+	addr.peer_address = peer_address;
+	addr.plen = plen;
+	addr.timestamp = 0; /* set it to zero, which to_string will treat as *now* */
+	addr.lifetime = lifetime;
+	addr.preferred = preferred;
+	addr.flags = flags;
+
+	_LOGD ("address: batch adding or updating IPv6 address: %s", nm_platform_ip6_address_to_string (&addr, NULL, 0));
+	return _batch_append (batch, NM_PLATFORM_BATCH_OP_ADD, NMP_OBJECT_TYPE_IP6_ADDRESS, (const NMPlatformObject *) &addr);
+}
+
+guint
+nm_platform_batch_ip4_address_delete (NMPlatformBatch *batch, int ifindex, in_addr_t address, int plen, in_addr_t peer_address)
+{
+	NMPlatformIP4Address addr = { 0 };
+	NMPlatform *self;
+	char str_dev[TO_STRING_DEV_BUF_SIZE];
+	char str_peer2[NM_UTILS_INET_ADDRSTRLEN];
+	char str_peer[100];
+
+	g_return_val_if_fail (batch, G_MAXUINT);
+	g_return_val_if_fail (!batch->committed, G_MAXUINT);
+	g_return_val_if_fail (ifindex > 0, G_MAXUINT);
+	g_return_val_if_fail (plen > 0, G_MAXUINT);
+
+	self = batch->platform;
+
+	_LOGD ("address: batch deleting IPv4 address %s/%d, %sifindex %d%s",
+	       nm_utils_inet4_ntop (address, NULL), plen,
+	       peer_address != address
+	           ? nm_sprintf_buf (str_peer, "peer %s, ", nm_utils_inet4_ntop (peer_address, str_peer2)) : "",
+	       ifindex,
+	       _to_string_dev (self, ifindex, str_dev, sizeof (str_dev)));
+
+	addr.ifindex = ifindex;
+	addr.address = address;
+	addr.peer_address = peer_address;
+	addr.plen = plen;
+	return _batch_append (batch, NM_PLATFORM_BATCH_OP_DELETE, NMP_OBJECT_TYPE_IP4_ADDRESS, (const NMPlatformObject *) &addr);
+}
+
+guint
+nm_platform_batch_ip6_address_delete (NMPlatformBatch *batch, int ifindex, struct in6_addr address, int plen)
+{
+	NMPlatformIP6Address addr = { 0 };
+	NMPlatform *self;
+	char str_dev[TO_STRING_DEV_BUF_SIZE];
+
+	g_return_val_if_fail (batch, G_MAXUINT);
+	g_return_val_if_fail (!batch->committed, G_MAXUINT);
+	g_return_val_if_fail (ifindex > 0, G_MAXUINT);
+	g_return_val_if_fail (plen > 0, G_MAXUINT);
+
+	self = batch->platform;
+
+	_LOGD ("address: batch deleting IPv6 address %s/%d, ifindex %d%s",
+	       nm_utils_inet6_ntop (&address, NULL), plen, ifindex,
+	       _to_string_dev (self, ifindex, str_dev, sizeof (str_dev)));
+
+	addr.ifindex = ifindex;
+	addr.address = address;
+	addr.plen = plen;
+	return _batch_append (batch, NM_PLATFORM_BATCH_OP_DELETE, NMP_OBJECT_TYPE_IP6_ADDRESS, (const NMPlatformObject *) &addr);
+}
+
+guint
+nm_platform_batch_ip4_route_add (NMPlatformBatch *batch,
+                                 int ifindex, NMIPConfigSource source,
+                                 in_addr_t network, int plen,
+                                 in_addr_t gateway, in_addr_t pref_src,
+                                 guint32 metric, guint32 mss)
+{
+	NMPlatformIP4Route route = { 0 };
+	NMPlatform *self;
+
+	g_return_val_if_fail (batch, G_MAXUINT);
+	g_return_val_if_fail (!batch->committed, G_MAXUINT);
+	g_return_val_if_fail (0 <= plen && plen <= 32, G_MAXUINT);
+
+	self = batch->platform;
+
+	route.ifindex = ifindex;
+	route.source = source;
+	route.network = network;
+	route.plen = plen;
+	route.gateway = gateway;
+	route.metric = metric;
+	route.mss = mss;
+	route.pref_src = pref_src;
+
+	_LOGD ("route: batch adding or updating IPv4 route: %s", nm_platform_ip4_route_to_string (&route, NULL, 0));
+	return _batch_append (batch, NM_PLATFORM_BATCH_OP_ADD, NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &route);
+}
+
+guint
+nm_platform_batch_ip6_route_add (NMPlatformBatch *batch,
+                                 int ifindex, NMIPConfigSource source,
+                                 struct in6_addr network, int plen, struct in6_addr gateway,
+                                 guint32 metric, guint32 mss)
+{
+	NMPlatformIP6Route route = { 0 };
+	NMPlatform *self;
+
+	g_return_val_if_fail (batch, G_MAXUINT);
+	g_return_val_if_fail (!batch->committed, G_MAXUINT);
+	g_return_val_if_fail (0 <= plen && plen <= 128, G_MAXUINT);
+
+	self = batch->platform;
+
+	route.ifindex = ifindex;
+	route.source = source;
+	route.network = network;
+	route.plen = plen;
+	route.gateway = gateway;
+	route.metric = metric;
+	route.mss = mss;
+
+	_LOGD ("route: batch adding or updating IPv6 route: %s", nm_platform_ip6_route_to_string (&route, NULL, 0));
+	return _batch_append (batch, NM_PLATFORM_BATCH_OP_ADD, NMP_OBJECT_TYPE_IP6_ROUTE, (const NMPlatformObject *) &route);
+}
+
+/* see nm_platform_ip4_route_replace() */
+guint
+nm_platform_batch_ip4_route_replace (NMPlatformBatch *batch,
+                                     int ifindex, NMIPConfigSource source,
+                                     in_addr_t network, int plen,
+                                     in_addr_t gateway, in_addr_t pref_src,
+                                     guint32 metric, guint32 mss)
+{
+	NMPlatformIP4Route route = { 0 };
+	NMPlatform *self;
+
+	g_return_val_if_fail (batch, G_MAXUINT);
+	g_return_val_if_fail (!batch->committed, G_MAXUINT);
+	g_return_val_if_fail (0 <= plen && plen <= 32, G_MAXUINT);
+
+	self = batch->platform;
+
+	route.ifindex = ifindex;
+	route.source = source;
+	route.network = network;
+	route.plen = plen;
+	route.gateway = gateway;
+	route.metric = metric;
+	route.mss = mss;
+	route.pref_src = pref_src;
+
+	_LOGD ("route: batch replacing IPv4 route: %s", nm_platform_ip4_route_to_string (&route, NULL, 0));
+	return _batch_append (batch, NM_PLATFORM_BATCH_OP_REPLACE, NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &route);
+}
+
+guint
+nm_platform_batch_ip6_route_replace (NMPlatformBatch *batch,
+                                     int ifindex, NMIPConfigSource source,
+                                     struct in6_addr network, int plen, struct in6_addr gateway,
+                                     guint32 metric, guint32 mss)
+{
+	NMPlatformIP6Route route = { 0 };
+	NMPlatform *self;
+
+	g_return_val_if_fail (batch, G_MAXUINT);
+	g_return_val_if_fail (!batch->committed, G_MAXUINT);
+	g_return_val_if_fail (0 <= plen && plen <= 128, G_MAXUINT);
+
+	self = batch->platform;
+
+	route.ifindex = ifindex;
+	route.source = source;
+	route.network = network;
+	route.plen = plen;
+	route.gateway = gateway;
+	route.metric = metric;
+	route.mss = mss;
+
+	_LOGD ("route: batch replacing IPv6 route: %s", nm_platform_ip6_route_to_string (&route, NULL, 0));
+	return _batch_append (batch, NM_PLATFORM_BATCH_OP_REPLACE, NMP_OBJECT_TYPE_IP6_ROUTE, (const NMPlatformObject *) &route);
+}
+
+guint
+nm_platform_batch_ip4_route_delete (NMPlatformBatch *batch, int ifindex, in_addr_t network, int plen, guint32 metric)
+{
+	NMPlatformIP4Route route = { 0 };
+	NMPlatform *self;
+	char str_dev[TO_STRING_DEV_BUF_SIZE];
+
+	g_return_val_if_fail (batch, G_MAXUINT);
+	g_return_val_if_fail (!batch->committed, G_MAXUINT);
+
+	self = batch->platform;
+
+	_LOGD ("route: batch deleting IPv4 route %s/%d, metric=%"G_GUINT32_FORMAT", ifindex %d%s",
+	       nm_utils_inet4_ntop (network, NULL), plen, metric, ifindex,
+	       _to_string_dev (self, ifindex, str_dev, sizeof (str_dev)));
+
+	route.ifindex = ifindex;
+	route.network = network;
+	route.plen = plen;
+	route.metric = metric;
+	return _batch_append (batch, NM_PLATFORM_BATCH_OP_DELETE, NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &route);
+}
+
+guint
+nm_platform_batch_ip6_route_delete (NMPlatformBatch *batch, int ifindex, struct in6_addr network, int plen, guint32 metric)
+{
+	NMPlatformIP6Route route = { 0 };
+	NMPlatform *self;
+	char str_dev[TO_STRING_DEV_BUF_SIZE];
+
+	g_return_val_if_fail (batch, G_MAXUINT);
+	g_return_val_if_fail (!batch->committed, G_MAXUINT);
+
+	self = batch->platform;
+
+	_LOGD ("route: batch deleting IPv6 route %s/%d, metric=%"G_GUINT32_FORMAT", ifindex %d%s",
+	       nm_utils_inet6_ntop (&network, NULL), plen, metric, ifindex,
+	       _to_string_dev (self, ifindex, str_dev, sizeof (str_dev)));
+
+	route.ifindex = ifindex;
+	route.network = network;
+	route.plen = plen;
+	route.metric = nm_utils_ip6_route_metric_normalize (metric);
+	return _batch_append (batch, NM_PLATFORM_BATCH_OP_DELETE, NMP_OBJECT_TYPE_IP6_ROUTE, (const NMPlatformObject *) &route);
+}
+
+static void
+object_batch_commit (NMPlatform *self, NMPlatformBatchOp *ops, guint len)
+{
+	NMPlatformClass *klass = NM_PLATFORM_GET_CLASS (self);
+	guint i;
+
+	/* Fallback for platform implementations that cannot pipeline
+	 * requests: perform the operations one by one. */
+	for (i = 0; i < len; i++) {
+		NMPlatformBatchOp *op = &ops[i];
+		const NMPObject *obj = op->obj;
+		gboolean is_add = (op->op_type == NM_PLATFORM_BATCH_OP_ADD);
+
+		switch (NMP_OBJECT_GET_TYPE (obj)) {
+		case NMP_OBJECT_TYPE_IP4_ADDRESS:
+			op->success = is_add
+			              ? klass->ip4_address_add (self, obj->ip4_address.ifindex, obj->ip4_address.address,
+			                                        obj->ip4_address.plen, obj->ip4_address.peer_address,
+			                                        obj->ip4_address.lifetime, obj->ip4_address.preferred,
+			                                        obj->ip4_address.label[0] ? obj->ip4_address.label : NULL)
+			              : klass->ip4_address_delete (self, obj->ip4_address.ifindex, obj->ip4_address.address,
+			                                           obj->ip4_address.plen, obj->ip4_address.peer_address);
+			break;
+		case NMP_OBJECT_TYPE_IP6_ADDRESS:
+			op->success = is_add
+			              ? klass->ip6_address_add (self, obj->ip6_address.ifindex, obj->ip6_address.address,
+			                                        obj->ip6_address.plen, obj->ip6_address.peer_address,
+			                                        obj->ip6_address.lifetime, obj->ip6_address.preferred,
+			                                        obj->ip6_address.flags)
+			              : klass->ip6_address_delete (self, obj->ip6_address.ifindex, obj->ip6_address.address,
+			                                           obj->ip6_address.plen);
+			break;
+		case NMP_OBJECT_TYPE_IP4_ROUTE:
+			if (op->op_type == NM_PLATFORM_BATCH_OP_REPLACE) {
+				op->success = klass->ip4_route_replace (self, obj->ip4_route.ifindex, obj->ip4_route.source,
+				                                        obj->ip4_route.network, obj->ip4_route.plen,
+				                                        obj->ip4_route.gateway, obj->ip4_route.pref_src,
+				                                        obj->ip4_route.metric, obj->ip4_route.mss);
+				break;
+			}
+			op->success = is_add
+			              ? klass->ip4_route_add (self, obj->ip4_route.ifindex, obj->ip4_route.source,
+			                                      obj->ip4_route.network, obj->ip4_route.plen,
+			                                      obj->ip4_route.gateway, obj->ip4_route.pref_src,
+			                                      obj->ip4_route.metric, obj->ip4_route.mss)
+			              : klass->ip4_route_delete (self, obj->ip4_route.ifindex, obj->ip4_route.network,
+			                                         obj->ip4_route.plen, obj->ip4_route.metric);
+			break;
+		case NMP_OBJECT_TYPE_IP6_ROUTE:
+			if (op->op_type == NM_PLATFORM_BATCH_OP_REPLACE) {
+				op->success = klass->ip6_route_replace (self, obj->ip6_route.ifindex, obj->ip6_route.source,
+				                                        obj->ip6_route.network, obj->ip6_route.plen,
+				                                        obj->ip6_route.gateway,
+				                                        obj->ip6_route.metric, obj->ip6_route.mss);
+				break;
+			}
+			op->success = is_add
+			              ? klass->ip6_route_add (self, obj->ip6_route.ifindex, obj->ip6_route.source,
+			                                      obj->ip6_route.network, obj->ip6_route.plen,
+			                                      obj->ip6_route.gateway,
+			                                      obj->ip6_route.metric, obj->ip6_route.mss)
+			              : klass->ip6_route_delete (self, obj->ip6_route.ifindex, obj->ip6_route.network,
+			                                         obj->ip6_route.plen, obj->ip6_route.metric);
+			break;
+		default:
+			g_return_if_reached ();
+		}
+	}
+}
+
+/**
+ * nm_platform_batch_commit:
+ * @batch: the batch
+ *
+ * Performs all queued operations. A batch can only be committed once.
+ * Afterwards, the result of each single operation can be looked up with
+ * nm_platform_batch_get_result().
+ *
+ * Returns: %TRUE if all operations succeeded.
+ */
+gboolean
+nm_platform_batch_commit (NMPlatformBatch *batch)
+{
+	NMPlatformClass *klass;
+	NMPlatform *self;
+	guint i, n_failed = 0;
+
+	g_return_val_if_fail (batch, FALSE);
+	g_return_val_if_fail (!batch->committed, FALSE);
+
+	batch->committed = TRUE;
+
+	if (!batch->ops->len)
+		return TRUE;
+
+	self = batch->platform;
+	klass = NM_PLATFORM_GET_CLASS (self);
+
+	_LOGD ("batch: commit %u operations", batch->ops->len);
+
+	klass->object_batch_commit (self, (NMPlatformBatchOp *) batch->ops->data, batch->ops->len);
+
+	for (i = 0; i < batch->ops->len; i++) {
+		if (!g_array_index (batch->ops, NMPlatformBatchOp, i).success)
+			n_failed++;
+	}
+
+	_LOGD ("batch: committed %u operations (%u failed)", batch->ops->len, n_failed);
+	return n_failed == 0;
+}
+
+gboolean
+nm_platform_batch_get_result (const NMPlatformBatch *batch, guint idx)
+{
+	g_return_val_if_fail (batch, FALSE);
+	g_return_val_if_fail (batch->committed, FALSE);
+	g_return_val_if_fail (idx < batch->ops->len, FALSE);
+
+	return g_array_index (batch->ops, NMPlatformBatchOp, idx).success;
+}
+
+/******************************************************************/
+
 const char *
 nm_platform_vlan_qos_mapping_to_string (const char *name,
                                         const NMVlanQosMapping *map,
@@ -3052,6 +4241,90 @@ nm_platform_link_to_string (const NMPlatformLink *link, char *buf, gsize len)
 	return buf;
 }
 
+const char *
+nm_platform_lnk_bond_to_string (const NMPlatformLnkBond *lnk, char *buf, gsize len)
+{
+	char str_primary[30];
+	char str_targets[NM_PLATFORM_LNK_BOND_MAX_ARP_TARGETS * (NM_UTILS_INET_ADDRSTRLEN + 1) + 30];
+	char str_addr[NM_UTILS_INET_ADDRSTRLEN];
+	char *b;
+	gsize l;
+	guint i;
+
+	if (!nm_utils_to_string_buffer_init_null (lnk, &buf, &len))
+		return buf;
+
+	b = str_targets;
+	l = sizeof (str_targets);
+	str_targets[0] = '\0';
+	for (i = 0; i < lnk->num_arp_ip_targets; i++) {
+		nm_utils_strbuf_append (&b, &l, "%s%s",
+		                        i == 0 ? " arp_ip_target " : ",",
+		                        nm_utils_inet4_ntop (lnk->arp_ip_targets[i], str_addr));
+	}
+
+	g_snprintf (buf, len,
+	            "bond"
+	            " mode %u"
+	            " miimon %u"
+	            " updelay %u"
+	            " downdelay %u"
+	            " use_carrier %d"
+	            " arp_interval %u"
+	            "%s" /* arp_ip_target */
+	            " arp_validate %u"
+	            "%s" /* primary */
+	            " primary_reselect %u"
+	            " fail_over_mac %u"
+	            " xmit_hash_policy %u"
+	            " resend_igmp %u"
+	            " lacp_rate %u"
+	            " ad_select %u"
+	            "",
+	            lnk->mode,
+	            lnk->miimon,
+	            lnk->updelay,
+	            lnk->downdelay,
+	            !!lnk->use_carrier,
+	            lnk->arp_interval,
+	            str_targets,
+	            lnk->arp_validate,
+	            lnk->primary ? nm_sprintf_buf (str_primary, " primary %d", lnk->primary) : "",
+	            lnk->primary_reselect,
+	            lnk->fail_over_mac,
+	            lnk->xmit_hash_policy,
+	            lnk->resend_igmp,
+	            lnk->lacp_rate,
+	            lnk->ad_select);
+	return buf;
+}
+
+const char *
+nm_platform_lnk_bridge_to_string (const NMPlatformLnkBridge *lnk, char *buf, gsize len)
+{
+	if (!nm_utils_to_string_buffer_init_null (lnk, &buf, &len))
+		return buf;
+
+	g_snprintf (buf, len,
+	            "bridge"
+	            " stp %d"
+	            " priority %u"
+	            " forward_delay %u"
+	            " hello_time %u"
+	            " max_age %u"
+	            " ageing_time %u"
+	            " mcast_snooping %d"
+	            "",
+	            !!lnk->stp_state,
+	            lnk->priority,
+	            lnk->forward_delay,
+	            lnk->hello_time,
+	            lnk->max_age,
+	            lnk->ageing_time,
+	            !!lnk->mcast_snooping);
+	return buf;
+}
+
 const char *
 nm_platform_lnk_gre_to_string (const NMPlatformLnkGre *lnk, char *buf, gsize len)
 {
@@ -3711,6 +4984,43 @@ nm_platform_link_cmp (const NMPlatformLink *a, const NMPlatformLink *b)
 	return 0;
 }
 
+int
+nm_platform_lnk_bond_cmp (const NMPlatformLnkBond *a, const NMPlatformLnkBond *b)
+{
+	_CMP_SELF (a, b);
+	_CMP_FIELD (a, b, mode);
+	_CMP_FIELD (a, b, miimon);
+	_CMP_FIELD (a, b, updelay);
+	_CMP_FIELD (a, b, downdelay);
+	_CMP_FIELD_BOOL (a, b, use_carrier);
+	_CMP_FIELD (a, b, arp_interval);
+	_CMP_FIELD (a, b, arp_validate);
+	_CMP_FIELD (a, b, primary);
+	_CMP_FIELD (a, b, primary_reselect);
+	_CMP_FIELD (a, b, fail_over_mac);
+	_CMP_FIELD (a, b, xmit_hash_policy);
+	_CMP_FIELD (a, b, resend_igmp);
+	_CMP_FIELD (a, b, lacp_rate);
+	_CMP_FIELD (a, b, ad_select);
+	_CMP_FIELD (a, b, num_arp_ip_targets);
+	_CMP_FIELD_MEMCMP_LEN (a, b, arp_ip_targets, a->num_arp_ip_targets * sizeof (a->arp_ip_targets[0]));
+	return 0;
+}
+
+int
+nm_platform_lnk_bridge_cmp (const NMPlatformLnkBridge *a, const NMPlatformLnkBridge *b)
+{
+	_CMP_SELF (a, b);
+	_CMP_FIELD (a, b, forward_delay);
+	_CMP_FIELD (a, b, hello_time);
+	_CMP_FIELD (a, b, max_age);
+	_CMP_FIELD (a, b, ageing_time);
+	_CMP_FIELD (a, b, priority);
+	_CMP_FIELD_BOOL (a, b, stp_state);
+	_CMP_FIELD_BOOL (a, b, mcast_snooping);
+	return 0;
+}
+
 int
 nm_platform_lnk_gre_cmp (const NMPlatformLnkGre *a, const NMPlatformLnkGre *b)
 {
@@ -3957,6 +5267,153 @@ nm_platform_signal_change_type_to_string (NMPlatformSignalChangeType change_type
 	}
 }
 
+static const gsize _signal_obj_size[_NM_PLATFORM_SIGNAL_ID_LAST] = {
+	[NM_PLATFORM_SIGNAL_ID_IP4_ADDRESS] = sizeof (NMPlatformIP4Address),
+	[NM_PLATFORM_SIGNAL_ID_IP6_ADDRESS] = sizeof (NMPlatformIP6Address),
+	[NM_PLATFORM_SIGNAL_ID_IP4_ROUTE]   = sizeof (NMPlatformIP4Route),
+	[NM_PLATFORM_SIGNAL_ID_IP6_ROUTE]   = sizeof (NMPlatformIP6Route),
+};
+
+/**
+ * nm_platform_changes_lookup_ifindex:
+ * @changes: the changes passed to the NM_PLATFORM_SIGNAL_CHANGES handler
+ * @ifindex: the interface index
+ * @out_len: (out): the number of returned changes
+ *
+ * Returns: the changes of objects on @ifindex in the order they happened,
+ *   or %NULL if there were none. Use nm_platform_changes_get_object() to
+ *   access the changed object.
+ */
+const NMPlatformChange *
+nm_platform_changes_lookup_ifindex (const NMPlatformChanges *changes, int ifindex, guint *out_len)
+{
+	GArray *arr = NULL;
+
+	g_return_val_if_fail (changes, NULL);
+	g_return_val_if_fail (out_len, NULL);
+
+	if (changes->by_ifindex)
+		arr = g_hash_table_lookup (changes->by_ifindex, GINT_TO_POINTER (ifindex));
+	if (!arr) {
+		*out_len = 0;
+		return NULL;
+	}
+	*out_len = arr->len;
+	return &g_array_index (arr, NMPlatformChange, 0);
+}
+
+const NMPlatformObject *
+nm_platform_changes_get_object (const NMPlatformChanges *changes, const NMPlatformChange *change)
+{
+	GArray *objs;
+
+	objs = changes->objs[change->signal_id][change->change_type];
+	nm_assert (objs && change->idx < objs->len);
+	return (const NMPlatformObject *) &objs->data[change->idx * _signal_obj_size[change->signal_id]];
+}
+
+static void
+_changes_clear (NMPlatformChanges *changes)
+{
+	guint i, j;
+
+	for (i = 0; i < _NM_PLATFORM_SIGNAL_ID_LAST; i++) {
+		for (j = 0; j <= NM_PLATFORM_SIGNAL_REMOVED; j++) {
+			if (changes->objs[i][j]) {
+				g_array_unref (changes->objs[i][j]);
+				changes->objs[i][j] = NULL;
+			}
+		}
+	}
+	if (changes->by_ifindex) {
+		g_hash_table_unref (changes->by_ifindex);
+		changes->by_ifindex = NULL;
+	}
+	changes->n_changes = 0;
+}
+
+static gboolean
+_changes_emit_cb (gpointer user_data)
+{
+	NMPlatform *self = user_data;
+	NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE (self);
+	NMPlatformChanges changes;
+
+	priv->changes_idle_id = 0;
+
+	/* take the changes, a handler might cause new ones. */
+	changes = priv->changes;
+	memset (&priv->changes, 0, sizeof (priv->changes));
+
+	_LOGt ("signal: changes: %u", changes.n_changes);
+	g_signal_emit (self, signal_changes, 0, &changes);
+
+	_changes_clear (&changes);
+	return G_SOURCE_REMOVE;
+}
+
+/**
+ * nm_platform_changes_flush:
+ * @self: platform instance
+ *
+ * Emits NM_PLATFORM_SIGNAL_CHANGES right away if changes are pending,
+ * instead of waiting for the idle handler. Call it before relying on
+ * state that a handler keeps up to date from the changes.
+ */
+void
+nm_platform_changes_flush (NMPlatform *self)
+{
+	_CHECK_SELF_VOID (self, klass);
+
+	if (nm_clear_g_source (&NM_PLATFORM_GET_PRIVATE (self)->changes_idle_id))
+		_changes_emit_cb (self);
+}
+
+static void
+_changes_add (NMPlatform *self,
+              NMPlatformSignalIdType signal_id,
+              const NMPlatformObject *obj,
+              NMPlatformSignalChangeType change_type)
+{
+	NMPlatformPrivate *priv;
+	GArray **p_arr;
+	GArray *by_ifindex;
+	NMPlatformChange change;
+
+	nm_assert (signal_id > NM_PLATFORM_SIGNAL_ID_LINK && signal_id < _NM_PLATFORM_SIGNAL_ID_LAST);
+	nm_assert (change_type > NM_PLATFORM_SIGNAL_NONE && change_type <= NM_PLATFORM_SIGNAL_REMOVED);
+
+	if (!g_signal_has_handler_pending (self, signal_changes, 0, TRUE))
+		return;
+
+	priv = NM_PLATFORM_GET_PRIVATE (self);
+
+	p_arr = &priv->changes.objs[signal_id][change_type];
+	if (!*p_arr)
+		*p_arr = g_array_new (FALSE, FALSE, _signal_obj_size[signal_id]);
+	g_array_append_vals (*p_arr, obj, 1);
+	priv->changes.n_changes++;
+
+	/* group the changes by interface once here, so that handlers that only
+	 * care about one interface don't have to walk all changes. */
+	if (!priv->changes.by_ifindex) {
+		priv->changes.by_ifindex = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+		                                                  NULL, (GDestroyNotify) g_array_unref);
+	}
+	by_ifindex = g_hash_table_lookup (priv->changes.by_ifindex, GINT_TO_POINTER (obj->ifindex));
+	if (!by_ifindex) {
+		by_ifindex = g_array_new (FALSE, FALSE, sizeof (NMPlatformChange));
+		g_hash_table_insert (priv->changes.by_ifindex, GINT_TO_POINTER (obj->ifindex), by_ifindex);
+	}
+	change.signal_id = signal_id;
+	change.change_type = change_type;
+	change.idx = (*p_arr)->len - 1;
+	g_array_append_val (by_ifindex, change);
+
+	if (!priv->changes_idle_id)
+		priv->changes_idle_id = g_idle_add (_changes_emit_cb, self);
+}
+
 static void
 log_link (NMPlatform *self, NMPObjectType obj_type, int ifindex, NMPlatformLink *device, NMPlatformSignalChangeType change_type, gpointer user_data)
 {
@@ -3968,24 +5425,78 @@ static void
 log_ip4_address (NMPlatform *self, NMPObjectType obj_type, int ifindex, NMPlatformIP4Address *address, NMPlatformSignalChangeType change_type, gpointer user_data)
 {
 	_LOGD ("signal: address 4 %7s: %s", nm_platform_signal_change_type_to_string (change_type), nm_platform_ip4_address_to_string (address, NULL, 0));
+	_changes_add (self, NM_PLATFORM_SIGNAL_ID_IP4_ADDRESS, (const NMPlatformObject *) address, change_type);
 }
 
 static void
 log_ip6_address (NMPlatform *self, NMPObjectType obj_type, int ifindex, NMPlatformIP6Address *address, NMPlatformSignalChangeType change_type, gpointer user_data)
 {
 	_LOGD ("signal: address 6 %7s: %s", nm_platform_signal_change_type_to_string (change_type), nm_platform_ip6_address_to_string (address, NULL, 0));
+	_changes_add (self, NM_PLATFORM_SIGNAL_ID_IP6_ADDRESS, (const NMPlatformObject *) address, change_type);
 }
 
 static void
 log_ip4_route (NMPlatform *self, NMPObjectType obj_type, int ifindex, NMPlatformIP4Route *route, NMPlatformSignalChangeType change_type, gpointer user_data)
 {
 	_LOGD ("signal: route   4 %7s: %s", nm_platform_signal_change_type_to_string (change_type), nm_platform_ip4_route_to_string (route, NULL, 0));
+	_changes_add (self, NM_PLATFORM_SIGNAL_ID_IP4_ROUTE, (const NMPlatformObject *) route, change_type);
 }
 
 static void
 log_ip6_route (NMPlatform *self, NMPObjectType obj_type, int ifindex, NMPlatformIP6Route *route, NMPlatformSignalChangeType change_type, gpointer user_data)
 {
 	_LOGD ("signal: route   6 %7s: %s", nm_platform_signal_change_type_to_string (change_type), nm_platform_ip6_route_to_string (route, NULL, 0));
+	_changes_add (self, NM_PLATFORM_SIGNAL_ID_IP6_ROUTE, (const NMPlatformObject *) route, change_type);
+}
+
+/**
+ * _nm_platform_signal_emit:
+ * @self: platform instance
+ * @signal_id: the signal to emit
+ * @obj_type: the type of @obj
+ * @ifindex: the ifindex of @obj
+ * @obj: the changed object. It is copied, if necessary.
+ * @change_type: how @obj changed
+ *
+ * Emits the per-object signal for @obj, but only if somebody is connected
+ * to it. The class handler, that logs the change and records it for
+ * NM_PLATFORM_SIGNAL_CHANGES, is always invoked.
+ */
+void
+_nm_platform_signal_emit (NMPlatform *self,
+                          NMPlatformSignalIdType signal_id,
+                          NMPObjectType obj_type,
+                          int ifindex,
+                          const NMPlatformObject *obj,
+                          NMPlatformSignalChangeType change_type)
+{
+	nm_assert (NM_IS_PLATFORM (self));
+	nm_assert (signal_id > NM_PLATFORM_SIGNAL_ID_NONE && signal_id < _NM_PLATFORM_SIGNAL_ID_LAST);
+
+	if (g_signal_has_handler_pending (self, signals[signal_id], 0, FALSE)) {
+		g_signal_emit (self, signals[signal_id], 0, obj_type, ifindex, obj, change_type);
+		return;
+	}
+
+	switch (signal_id) {
+	case NM_PLATFORM_SIGNAL_ID_LINK:
+		log_link (self, obj_type, ifindex, (NMPlatformLink *) obj, change_type, NULL);
+		break;
+	case NM_PLATFORM_SIGNAL_ID_IP4_ADDRESS:
+		log_ip4_address (self, obj_type, ifindex, (NMPlatformIP4Address *) obj, change_type, NULL);
+		break;
+	case NM_PLATFORM_SIGNAL_ID_IP6_ADDRESS:
+		log_ip6_address (self, obj_type, ifindex, (NMPlatformIP6Address *) obj, change_type, NULL);
+		break;
+	case NM_PLATFORM_SIGNAL_ID_IP4_ROUTE:
+		log_ip4_route (self, obj_type, ifindex, (NMPlatformIP4Route *) obj, change_type, NULL);
+		break;
+	case NM_PLATFORM_SIGNAL_ID_IP6_ROUTE:
+		log_ip6_route (self, obj_type, ifindex, (NMPlatformIP6Route *) obj, change_type, NULL);
+		break;
+	default:
+		g_return_if_reached ();
+	}
 }
 
 /******************************************************************/
@@ -4017,6 +5528,33 @@ _vtr_v6_route_add (NMPlatform *self, int ifindex, const NMPlatformIPXRoute *rout
 	                                  route->rx.mss);
 }
 
+static gboolean
+_vtr_v4_route_replace (NMPlatform *self, int ifindex, const NMPlatformIPXRoute *route, gint64 metric)
+{
+	return nm_platform_ip4_route_replace (self,
+	                                      ifindex > 0 ? ifindex : route->rx.ifindex,
+	                                      route->rx.source,
+	                                      route->r4.network,
+	                                      route->rx.plen,
+	                                      route->r4.gateway,
+	                                      route->r4.pref_src,
+	                                      metric >= 0 ? (guint32) metric : route->rx.metric,
+	                                      route->rx.mss);
+}
+
+static gboolean
+_vtr_v6_route_replace (NMPlatform *self, int ifindex, const NMPlatformIPXRoute *route, gint64 metric)
+{
+	return nm_platform_ip6_route_replace (self,
+	                                      ifindex > 0 ? ifindex : route->rx.ifindex,
+	                                      route->rx.source,
+	                                      route->r6.network,
+	                                      route->rx.plen,
+	                                      route->r6.gateway,
+	                                      metric >= 0 ? (guint32) metric : route->rx.metric,
+	                                      route->rx.mss);
+}
+
 static gboolean
 _vtr_v4_route_delete (NMPlatform *self, int ifindex, const NMPlatformIPXRoute *route)
 {
@@ -4037,6 +5575,80 @@ _vtr_v6_route_delete (NMPlatform *self, int ifindex, const NMPlatformIPXRoute *r
 	                                     route->rx.metric);
 }
 
+static guint
+_vtr_v4_batch_route_add (NMPlatformBatch *batch, int ifindex, const NMPlatformIPXRoute *route, gint64 metric)
+{
+	return nm_platform_batch_ip4_route_add (batch,
+	                                        ifindex > 0 ? ifindex : route->rx.ifindex,
+	                                        route->rx.source,
+	                                        route->r4.network,
+	                                        route->rx.plen,
+	                                        route->r4.gateway,
+	                                        route->r4.pref_src,
+	                                        metric >= 0 ? (guint32) metric : route->rx.metric,
+	                                        route->rx.mss);
+}
+
+static guint
+_vtr_v6_batch_route_add (NMPlatformBatch *batch, int ifindex, const NMPlatformIPXRoute *route, gint64 metric)
+{
+	return nm_platform_batch_ip6_route_add (batch,
+	                                        ifindex > 0 ? ifindex : route->rx.ifindex,
+	                                        route->rx.source,
+	                                        route->r6.network,
+	                                        route->rx.plen,
+	                                        route->r6.gateway,
+	                                        metric >= 0 ? (guint32) metric : route->rx.metric,
+	                                        route->rx.mss);
+}
+
+static guint
+_vtr_v4_batch_route_replace (NMPlatformBatch *batch, int ifindex, const NMPlatformIPXRoute *route, gint64 metric)
+{
+	return nm_platform_batch_ip4_route_replace (batch,
+	                                            ifindex > 0 ? ifindex : route->rx.ifindex,
+	                                            route->rx.source,
+	                                            route->r4.network,
+	                                            route->rx.plen,
+	                                            route->r4.gateway,
+	                                            route->r4.pref_src,
+	                                            metric >= 0 ? (guint32) metric : route->rx.metric,
+	                                            route->rx.mss);
+}
+
+static guint
+_vtr_v6_batch_route_replace (NMPlatformBatch *batch, int ifindex, const NMPlatformIPXRoute *route, gint64 metric)
+{
+	return nm_platform_batch_ip6_route_replace (batch,
+	                                            ifindex > 0 ? ifindex : route->rx.ifindex,
+	                                            route->rx.source,
+	                                            route->r6.network,
+	                                            route->rx.plen,
+	                                            route->r6.gateway,
+	                                            metric >= 0 ? (guint32) metric : route->rx.metric,
+	                                            route->rx.mss);
+}
+
+static guint
+_vtr_v4_batch_route_delete (NMPlatformBatch *batch, int ifindex, const NMPlatformIPXRoute *route)
+{
+	return nm_platform_batch_ip4_route_delete (batch,
+	                                           ifindex > 0 ? ifindex : route->rx.ifindex,
+	                                           route->r4.network,
+	                                           route->rx.plen,
+	                                           route->rx.metric);
+}
+
+static guint
+_vtr_v6_batch_route_delete (NMPlatformBatch *batch, int ifindex, const NMPlatformIPXRoute *route)
+{
+	return nm_platform_batch_ip6_route_delete (batch,
+	                                           ifindex > 0 ? ifindex : route->rx.ifindex,
+	                                           route->r6.network,
+	                                           route->rx.plen,
+	                                           route->rx.metric);
+}
+
 static guint32
 _vtr_v4_metric_normalize (guint32 metric)
 {
@@ -4065,7 +5677,11 @@ const NMPlatformVTableRoute nm_platform_vtable_route_v4 = {
 	.route_to_string                = (const char *(*) (const NMPlatformIPXRoute *route, char *buf, gsize len)) nm_platform_ip4_route_to_string,
 	.route_get_all                  = nm_platform_ip4_route_get_all,
 	.route_add                      = _vtr_v4_route_add,
+	.route_replace                  = _vtr_v4_route_replace,
 	.route_delete                   = _vtr_v4_route_delete,
+	.batch_route_add                = _vtr_v4_batch_route_add,
+	.batch_route_replace            = _vtr_v4_batch_route_replace,
+	.batch_route_delete             = _vtr_v4_batch_route_delete,
 	.route_delete_default           = _vtr_v4_route_delete_default,
 	.metric_normalize               = _vtr_v4_metric_normalize,
 };
@@ -4078,7 +5694,11 @@ const NMPlatformVTableRoute nm_platform_vtable_route_v6 = {
 	.route_to_string                = (const char *(*) (const NMPlatformIPXRoute *route, char *buf, gsize len)) nm_platform_ip6_route_to_string,
 	.route_get_all                  = nm_platform_ip6_route_get_all,
 	.route_add                      = _vtr_v6_route_add,
+	.route_replace                  = _vtr_v6_route_replace,
 	.route_delete                   = _vtr_v6_route_delete,
+	.batch_route_add                = _vtr_v6_batch_route_add,
+	.batch_route_replace            = _vtr_v6_batch_route_replace,
+	.batch_route_delete             = _vtr_v6_batch_route_delete,
 	.route_delete_default           = _vtr_v6_route_delete_default,
 	.metric_normalize               = nm_utils_ip6_route_metric_normalize,
 };
@@ -4119,6 +5739,17 @@ nm_platform_init (NMPlatform *object)
 {
 }
 
+static void
+finalize (GObject *object)
+{
+	NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE (object);
+
+	nm_clear_g_source (&priv->changes_idle_id);
+	_changes_clear (&priv->changes);
+
+	G_OBJECT_CLASS (nm_platform_parent_class)->finalize (object);
+}
+
 static void
 nm_platform_class_init (NMPlatformClass *platform_class)
 {
@@ -4128,8 +5759,12 @@ nm_platform_class_init (NMPlatformClass *platform_class)
 
 	object_class->set_property = set_property;
 	object_class->constructed = constructed;
+	object_class->finalize = finalize;
 
+	platform_class->sysctl_ifindex_set = sysctl_ifindex_set;
+	platform_class->sysctl_ifindex_get = sysctl_ifindex_get;
 	platform_class->wifi_set_powersave = wifi_set_powersave;
+	platform_class->object_batch_commit = object_batch_commit;
 
 	g_object_class_install_property
 	 (object_class, PROP_REGISTER_SINGLETON,
@@ -4156,4 +5791,12 @@ nm_platform_class_init (NMPlatformClass *platform_class)
 	SIGNAL (NM_PLATFORM_SIGNAL_ID_IP6_ADDRESS, NM_PLATFORM_SIGNAL_IP6_ADDRESS_CHANGED, log_ip6_address);
 	SIGNAL (NM_PLATFORM_SIGNAL_ID_IP4_ROUTE,   NM_PLATFORM_SIGNAL_IP4_ROUTE_CHANGED,   log_ip4_route);
 	SIGNAL (NM_PLATFORM_SIGNAL_ID_IP6_ROUTE,   NM_PLATFORM_SIGNAL_IP6_ROUTE_CHANGED,   log_ip6_route);
+
+	signal_changes =
+	    g_signal_new (NM_PLATFORM_SIGNAL_CHANGES,
+	                  G_OBJECT_CLASS_TYPE (object_class),
+	                  G_SIGNAL_RUN_FIRST,
+	                  0,
+	                  NULL, NULL, NULL,
+	                  G_TYPE_NONE, 1, G_TYPE_POINTER);
 }
@@ -46,6 +46,7 @@
 /******************************************************************/
 
 typedef struct _NMPlatform NMPlatform;
+typedef struct _NMPlatformBatch NMPlatformBatch;
 
 /* workaround for older libnl version, that does not define these flags. */
 #ifndef IFA_F_MANAGETEMPADDR
@@ -176,6 +177,31 @@ typedef enum {
 	NM_PLATFORM_SIGNAL_REMOVED,
 } NMPlatformSignalChangeType;
 
+/* One change in #NMPlatformChanges:by_ifindex. @idx is the position of the
+ * object in the array @objs[@signal_id][@change_type]. */
+typedef struct {
+	NMPlatformSignalIdType signal_id;
+	NMPlatformSignalChangeType change_type;
+	guint idx;
+} NMPlatformChange;
+
+/* The argument of the NM_PLATFORM_SIGNAL_CHANGES signal. @objs has an array
+ * for each signal id and change type, or %NULL if there were no such changes.
+ * The arrays contain copies of the public objects (#NMPlatformIP4Address,
+ * #NMPlatformIP4Route, ...) in the order the changes happened. The order
+ * between different arrays is lost, so an object that was added and removed
+ * again is contained in both arrays. Link changes are not collected, use
+ * NM_PLATFORM_SIGNAL_LINK_CHANGED for them.
+ *
+ * @by_ifindex maps the ifindex to an array of #NMPlatformChange in the
+ * order the changes happened on that interface. Use
+ * nm_platform_changes_lookup_ifindex() to access it. */
+typedef struct {
+	GArray *objs[_NM_PLATFORM_SIGNAL_ID_LAST][NM_PLATFORM_SIGNAL_REMOVED + 1];
+	GHashTable *by_ifindex;
+	guint n_changes;
+} NMPlatformChanges;
+
 #define NM_PLATFORM_LIFETIME_PERMANENT G_MAXUINT32
 
 typedef enum { /*< skip >*/
@@ -353,7 +379,11 @@ typedef struct {
 	const char *(*route_to_string) (const NMPlatformIPXRoute *route, char *buf, gsize len);
 	GArray *(*route_get_all) (NMPlatform *self, int ifindex, NMPlatformGetRouteFlags flags);
 	gboolean (*route_add) (NMPlatform *self, int ifindex, const NMPlatformIPXRoute *route, gint64 metric);
+	gboolean (*route_replace) (NMPlatform *self, int ifindex, const NMPlatformIPXRoute *route, gint64 metric);
 	gboolean (*route_delete) (NMPlatform *self, int ifindex, const NMPlatformIPXRoute *route);
+	guint (*batch_route_add) (NMPlatformBatch *batch, int ifindex, const NMPlatformIPXRoute *route, gint64 metric);
+	guint (*batch_route_replace) (NMPlatformBatch *batch, int ifindex, const NMPlatformIPXRoute *route, gint64 metric);
+	guint (*batch_route_delete) (NMPlatformBatch *batch, int ifindex, const NMPlatformIPXRoute *route);
 	gboolean (*route_delete_default) (NMPlatform *self, int ifindex, guint32 metric);
 	guint32 (*metric_normalize) (guint32 metric);
 } NMPlatformVTableRoute;
@@ -361,6 +391,147 @@ typedef struct {
 extern const NMPlatformVTableRoute nm_platform_vtable_route_v4;
 extern const NMPlatformVTableRoute nm_platform_vtable_route_v6;
 
+typedef enum { /*< skip >*/
+	NM_PLATFORM_BATCH_OP_ADD,
+	NM_PLATFORM_BATCH_OP_REPLACE,
+	NM_PLATFORM_BATCH_OP_DELETE,
+} NMPlatformBatchOpType;
+
+/* A single queued address/route operation of a #NMPlatformBatch.
+ *
+ * For %NM_PLATFORM_BATCH_OP_ADD of addresses, the lifetime and preferred
+ * fields of @obj are relative to the time of commit (timestamp is zero). */
+typedef struct {
+	NMPlatformBatchOpType op_type;
+	NMPObject *obj;
+	gboolean success;
+} NMPlatformBatchOp;
+
+/* Counters of nm_platform_ip4_address_sync() and nm_platform_ip6_address_sync().
+ * @refreshed are addresses that were re-added to update their lifetime,
+ * label or flags. @unchanged are addresses that were already configured
+ * as requested, each of them is a netlink request saved. */
+typedef struct {
+	guint64 added;
+	guint64 refreshed;
+	guint64 deleted;
+	guint64 unchanged;
+} NMPlatformAddressSyncStats;
+
+#define NM_PLATFORM_STATS_DURATION_BUCKETS 12
+
+/* A histogram of durations. Bucket 0 counts durations below one
+ * millisecond, bucket i those below 2^i milliseconds. The last bucket
+ * counts everything longer. */
+typedef struct {
+	guint64 count;
+	guint64 total_usec;
+	guint64 max_usec;
+	guint64 buckets[NM_PLATFORM_STATS_DURATION_BUCKETS];
+} NMPlatformStatsDuration;
+
+typedef enum {
+	NM_PLATFORM_STATS_MSG_NEWLINK,
+	NM_PLATFORM_STATS_MSG_DELLINK,
+	NM_PLATFORM_STATS_MSG_NEWADDR,
+	NM_PLATFORM_STATS_MSG_DELADDR,
+	NM_PLATFORM_STATS_MSG_NEWROUTE,
+	NM_PLATFORM_STATS_MSG_DELROUTE,
+	NM_PLATFORM_STATS_MSG_OTHER,
+	_NM_PLATFORM_STATS_MSG_LAST,
+} NMPlatformStatsMsgType;
+
+/* Counters to explain the load caused by the platform. All counters
+ * accumulate from the start, except @cache_objs and @cache_bytes, which
+ * describe the current content of the cache. Platform implementations
+ * without a cache only fill the address sync durations. */
+typedef struct {
+	/* netlink messages received, by type of the message. */
+	guint64 netlink_msgs[_NM_PLATFORM_STATS_MSG_LAST];
+
+	/* time from requesting a netlink dump until it completed. */
+	NMPlatformStatsDuration dumps;
+
+	/* receive buffer overruns (ENOBUFS) and the resyncs of the cache
+	 * that recovered from them. */
+	guint64 overruns;
+	guint64 resyncs;
+
+	guint64 delayed_actions;
+
+	/* dumps of a whole object type, because refetching a single
+	 * object was not possible or didn't bring it into the cache. */
+	guint64 refetches_all;
+
+	guint cache_objs[__NMP_OBJECT_TYPE_LAST];
+	guint64 cache_bytes[__NMP_OBJECT_TYPE_LAST];
+
+	NMPlatformStatsDuration ip4_address_sync;
+	NMPlatformStatsDuration ip6_address_sync;
+} NMPlatformStats;
+
+#define NM_PLATFORM_LNK_BOND_MAX_ARP_TARGETS 16
+
+/* The numeric option values are those of the kernel (and of the
+ * sysfs files of the bonding driver). */
+typedef struct {
+	guint8 mode;
+	guint8 arp_validate;
+	guint8 primary_reselect;
+	guint8 fail_over_mac;
+	guint8 xmit_hash_policy;
+	guint8 lacp_rate;
+	guint8 ad_select;
+	gboolean use_carrier;
+	int primary;
+	guint32 miimon;
+	guint32 updelay;
+	guint32 downdelay;
+	guint32 arp_interval;
+	guint32 resend_igmp;
+	guint num_arp_ip_targets;
+	in_addr_t arp_ip_targets[NM_PLATFORM_LNK_BOND_MAX_ARP_TARGETS];
+} NMPlatformLnkBond;
+
+/* Selects the fields of #NMPlatformLnkBond for nm_platform_link_bond_change(). */
+typedef enum {
+	NM_PLATFORM_LNK_BOND_ATTR_NONE                  = 0,
+	NM_PLATFORM_LNK_BOND_ATTR_MODE                  = (1LL <<  0),
+	NM_PLATFORM_LNK_BOND_ATTR_MIIMON                = (1LL <<  1),
+	NM_PLATFORM_LNK_BOND_ATTR_UPDELAY               = (1LL <<  2),
+	NM_PLATFORM_LNK_BOND_ATTR_DOWNDELAY             = (1LL <<  3),
+	NM_PLATFORM_LNK_BOND_ATTR_USE_CARRIER           = (1LL <<  4),
+	NM_PLATFORM_LNK_BOND_ATTR_ARP_INTERVAL          = (1LL <<  5),
+	NM_PLATFORM_LNK_BOND_ATTR_ARP_IP_TARGETS        = (1LL <<  6),
+	NM_PLATFORM_LNK_BOND_ATTR_ARP_VALIDATE          = (1LL <<  7),
+	NM_PLATFORM_LNK_BOND_ATTR_PRIMARY               = (1LL <<  8),
+	NM_PLATFORM_LNK_BOND_ATTR_PRIMARY_RESELECT      = (1LL <<  9),
+	NM_PLATFORM_LNK_BOND_ATTR_FAIL_OVER_MAC         = (1LL << 10),
+	NM_PLATFORM_LNK_BOND_ATTR_XMIT_HASH_POLICY      = (1LL << 11),
+	NM_PLATFORM_LNK_BOND_ATTR_RESEND_IGMP           = (1LL << 12),
+	NM_PLATFORM_LNK_BOND_ATTR_LACP_RATE             = (1LL << 13),
+	NM_PLATFORM_LNK_BOND_ATTR_AD_SELECT             = (1LL << 14),
+} NMPlatformLnkBondAttrs;
+
+/* The times are in USER_HZ (centiseconds), like in sysfs. */
+typedef struct {
+	guint32 forward_delay;
+	guint32 hello_time;
+	guint32 max_age;
+	guint32 ageing_time;
+	guint16 priority;
+	gboolean stp_state;
+	gboolean mcast_snooping;
+} NMPlatformLnkBridge;
+
+/* The options of a bridge port. Not a lnk object, they belong to the
+ * slave and are only set via nm_platform_link_bridge_port_change(). */
+typedef struct {
+	guint16 priority;
+	guint32 path_cost;
+	gboolean hairpin_mode;
+} NMPlatformBridgePort;
+
 typedef struct {
 	int parent_ifindex;
 	guint16 input_flags;
@@ -454,6 +625,21 @@ typedef struct {
 	gboolean multi_queue;
 } NMPlatformTunProperties;
 
+/* The per-interface directories that hold sysctl-style options. */
+typedef enum { /*< skip >*/
+	NM_PLATFORM_SYSCTL_DIR_IP4_CONF,        /* /proc/sys/net/ipv4/conf/$IFNAME */
+	NM_PLATFORM_SYSCTL_DIR_IP6_CONF,        /* /proc/sys/net/ipv6/conf/$IFNAME */
+	NM_PLATFORM_SYSCTL_DIR_SYSFS,           /* /sys/class/net/$IFNAME */
+	_NM_PLATFORM_SYSCTL_DIR_NUM,
+} NMPlatformSysctlDir;
+
+#define NM_PLATFORM_SYSCTL_PATH_MAX 256
+
+typedef struct {
+	const char *name;
+	const char *value;
+} NMPlatformSysctlSetting;
+
 /******************************************************************/
 
 struct _NMPlatform {
@@ -465,6 +651,8 @@ typedef struct {
 
 	gboolean (*sysctl_set) (NMPlatform *, const char *path, const char *value);
 	char * (*sysctl_get) (NMPlatform *, const char *path);
+	gboolean (*sysctl_ifindex_set) (NMPlatform *, int ifindex, NMPlatformSysctlDir dir, const char *name, const char *value);
+	char * (*sysctl_ifindex_get) (NMPlatform *, int ifindex, NMPlatformSysctlDir dir, const char *name);
 
 	const NMPlatformLink *(*link_get) (NMPlatform *platform, int ifindex);
 	const NMPlatformLink *(*link_get_by_ifname) (NMPlatform *platform, const char *ifname);
@@ -529,6 +717,16 @@ typedef struct {
 	                              gboolean egress_reset_all,
 	                              const NMVlanQosMapping *egress_map,
 	                              gsize n_egress_map);
+	gboolean (*link_bond_change) (NMPlatform *self,
+	                              int ifindex,
+	                              const NMPlatformLnkBond *props,
+	                              NMPlatformLnkBondAttrs attrs);
+	gboolean (*link_bridge_change) (NMPlatform *self,
+	                                int ifindex,
+	                                const NMPlatformLnkBridge *props);
+	gboolean (*link_bridge_port_change) (NMPlatform *self,
+	                                     int ifindex,
+	                                     const NMPlatformBridgePort *props);
 	gboolean (*link_vxlan_add) (NMPlatform *,
 	                            const char *name,
 	                            const NMPlatformLnkVxlan *props,
@@ -607,13 +805,23 @@ typedef struct {
 	gboolean (*ip6_route_add) (NMPlatform *, int ifindex, NMIPConfigSource source,
 	                           struct in6_addr network, int plen, struct in6_addr gateway,
 	                           guint32 metric, guint32 mss);
+	gboolean (*ip4_route_replace) (NMPlatform *, int ifindex, NMIPConfigSource source,
+	                               in_addr_t network, int plen, in_addr_t gateway,
+	                               in_addr_t pref_src, guint32 metric, guint32 mss);
+	gboolean (*ip6_route_replace) (NMPlatform *, int ifindex, NMIPConfigSource source,
+	                               struct in6_addr network, int plen, struct in6_addr gateway,
+	                               guint32 metric, guint32 mss);
 	gboolean (*ip4_route_delete) (NMPlatform *, int ifindex, in_addr_t network, int plen, guint32 metric);
 	gboolean (*ip6_route_delete) (NMPlatform *, int ifindex, struct in6_addr network, int plen, guint32 metric);
 	const NMPlatformIP4Route *(*ip4_route_get) (NMPlatform *, int ifindex, in_addr_t network, int plen, guint32 metric);
 	const NMPlatformIP6Route *(*ip6_route_get) (NMPlatform *, int ifindex, struct in6_addr network, int plen, guint32 metric);
 
+	void (*object_batch_commit) (NMPlatform *, NMPlatformBatchOp *ops, guint len);
+
 	gboolean (*check_support_kernel_extended_ifa_flags) (NMPlatform *);
 	gboolean (*check_support_user_ipv6ll) (NMPlatform *);
+
+	void (*get_stats) (NMPlatform *, NMPlatformStats *stats);
 } NMPlatformClass;
 
 /* NMPlatform signals
@@ -633,6 +841,23 @@ typedef struct {
 #define NM_PLATFORM_SIGNAL_IP4_ROUTE_CHANGED "ip4-route-changed"
 #define NM_PLATFORM_SIGNAL_IP6_ROUTE_CHANGED "ip6-route-changed"
 
+/* Emitted once per main loop iteration with all changes since the last
+ * emission as #NMPlatformChanges. This is an alternative to the signals
+ * above for handlers that are expensive per object. Changes are only
+ * collected while a handler is connected. */
+#define NM_PLATFORM_SIGNAL_CHANGES "changes"
+
+const NMPlatformChange *nm_platform_changes_lookup_ifindex (const NMPlatformChanges *changes, int ifindex, guint *out_len);
+const NMPlatformObject *nm_platform_changes_get_object (const NMPlatformChanges *changes, const NMPlatformChange *change);
+void nm_platform_changes_flush (NMPlatform *self);
+
+void _nm_platform_signal_emit (NMPlatform *self,
+                               NMPlatformSignalIdType signal_id,
+                               NMPObjectType obj_type,
+                               int ifindex,
+                               const NMPlatformObject *obj,
+                               NMPlatformSignalChangeType change_type);
+
 const char *nm_platform_signal_change_type_to_string (NMPlatformSignalChangeType change_type);
 
 /******************************************************************/
@@ -674,6 +899,13 @@ char *nm_platform_sysctl_get (NMPlatform *self, const char *path);
 gint32 nm_platform_sysctl_get_int32 (NMPlatform *self, const char *path, gint32 fallback);
 gint64 nm_platform_sysctl_get_int_checked (NMPlatform *self, const char *path, guint base, gint64 min, gint64 max, gint64 fallback);
 
+const char *_nm_platform_sysctl_dir_path (NMPlatformSysctlDir dir, const char *ifname, const char *name,
+                                         char *buf, gsize len);
+gboolean nm_platform_sysctl_ifindex_set (NMPlatform *self, int ifindex, NMPlatformSysctlDir dir, const char *name, const char *value);
+char *nm_platform_sysctl_ifindex_get (NMPlatform *self, int ifindex, NMPlatformSysctlDir dir, const char *name);
+gboolean nm_platform_sysctl_ifindex_set_many (NMPlatform *self, int ifindex, NMPlatformSysctlDir dir,
+                                              const NMPlatformSysctlSetting *settings, guint n_settings);
+
 gboolean nm_platform_sysctl_set_ip6_hop_limit_safe (NMPlatform *self, const char *iface, int value);
 
 const NMPlatformLink *nm_platform_link_get (NMPlatform *self, int ifindex);
@@ -744,6 +976,8 @@ gboolean nm_platform_sysctl_slave_set_option (NMPlatform *self, int ifindex, con
 char *nm_platform_sysctl_slave_get_option (NMPlatform *self, int ifindex, const char *option);
 
 const NMPObject *nm_platform_link_get_lnk (NMPlatform *self, int ifindex, NMLinkType link_type, const NMPlatformLink **out_link);
+const NMPlatformLnkBond *nm_platform_link_get_lnk_bond (NMPlatform *self, int ifindex, const NMPlatformLink **out_link);
+const NMPlatformLnkBridge *nm_platform_link_get_lnk_bridge (NMPlatform *self, int ifindex, const NMPlatformLink **out_link);
 const NMPlatformLnkGre *nm_platform_link_get_lnk_gre (NMPlatform *self, int ifindex, const NMPlatformLink **out_link);
 const NMPlatformLnkIp6Tnl *nm_platform_link_get_lnk_ip6tnl (NMPlatform *self, int ifindex, const NMPlatformLink **out_link);
 const NMPlatformLnkIpIp *nm_platform_link_get_lnk_ipip (NMPlatform *self, int ifindex, const NMPlatformLink **out_link);
@@ -774,6 +1008,18 @@ gboolean nm_platform_link_vlan_change (NMPlatform *self,
                                        const NMVlanQosMapping *egress_map,
                                        gsize n_egress_map);
 
+gboolean nm_platform_link_bond_change (NMPlatform *self,
+                                       int ifindex,
+                                       const NMPlatformLnkBond *props,
+                                       NMPlatformLnkBondAttrs attrs);
+
+gboolean nm_platform_link_bridge_change (NMPlatform *self,
+                                         int ifindex,
+                                         const NMPlatformLnkBridge *props);
+gboolean nm_platform_link_bridge_port_change (NMPlatform *self,
+                                              int ifindex,
+                                              const NMPlatformBridgePort *props);
+
 NMPlatformError nm_platform_link_vxlan_add (NMPlatform *self,
                                             const char *name,
                                             const NMPlatformLnkVxlan *props,
@@ -866,6 +1112,11 @@ gboolean nm_platform_ip6_address_delete (NMPlatform *self, int ifindex, struct i
 gboolean nm_platform_ip4_address_sync (NMPlatform *self, int ifindex, const GArray *known_addresses, GPtrArray **out_added_addresses);
 gboolean nm_platform_ip6_address_sync (NMPlatform *self, int ifindex, const GArray *known_addresses, gboolean keep_link_local);
 gboolean nm_platform_address_flush (NMPlatform *self, int ifindex);
+const NMPlatformAddressSyncStats *nm_platform_address_sync_get_stats (NMPlatform *self);
+
+void nm_platform_stats_duration_add (NMPlatformStatsDuration *duration, gint64 duration_ns);
+void nm_platform_get_stats (NMPlatform *self, NMPlatformStats *out_stats);
+void nm_platform_stats_log (NMPlatform *self, NMLogLevel level);
 
 const NMPlatformIP4Route *nm_platform_ip4_route_get (NMPlatform *self, int ifindex, in_addr_t network, int plen, guint32 metric);
 const NMPlatformIP6Route *nm_platform_ip6_route_get (NMPlatform *self, int ifindex, struct in6_addr network, int plen, guint32 metric);
@@ -877,10 +1128,56 @@ gboolean nm_platform_ip4_route_add (NMPlatform *self, int ifindex, NMIPConfigSou
 gboolean nm_platform_ip6_route_add (NMPlatform *self, int ifindex, NMIPConfigSource source,
                                     struct in6_addr network, int plen, struct in6_addr gateway,
                                     guint32 metric, guint32 mss);
+gboolean nm_platform_ip4_route_replace (NMPlatform *self, int ifindex, NMIPConfigSource source,
+                                        in_addr_t network, int plen, in_addr_t gateway,
+                                        in_addr_t pref_src, guint32 metric, guint32 mss);
+gboolean nm_platform_ip6_route_replace (NMPlatform *self, int ifindex, NMIPConfigSource source,
+                                        struct in6_addr network, int plen, struct in6_addr gateway,
+                                        guint32 metric, guint32 mss);
 gboolean nm_platform_ip4_route_delete (NMPlatform *self, int ifindex, in_addr_t network, int plen, guint32 metric);
 gboolean nm_platform_ip6_route_delete (NMPlatform *self, int ifindex, struct in6_addr network, int plen, guint32 metric);
 
+NMPlatformBatch *nm_platform_batch_new (NMPlatform *self);
+void nm_platform_batch_free (NMPlatformBatch *batch);
+guint nm_platform_batch_get_len (const NMPlatformBatch *batch);
+guint nm_platform_batch_ip4_address_add (NMPlatformBatch *batch,
+                                         int ifindex,
+                                         in_addr_t address,
+                                         int plen,
+                                         in_addr_t peer_address,
+                                         guint32 lifetime,
+                                         guint32 preferred_lft,
+                                         const char *label);
+guint nm_platform_batch_ip6_address_add (NMPlatformBatch *batch,
+                                         int ifindex,
+                                         struct in6_addr address,
+                                         int plen,
+                                         struct in6_addr peer_address,
+                                         guint32 lifetime,
+                                         guint32 preferred_lft,
+                                         guint flags);
+guint nm_platform_batch_ip4_address_delete (NMPlatformBatch *batch, int ifindex, in_addr_t address, int plen, in_addr_t peer_address);
+guint nm_platform_batch_ip6_address_delete (NMPlatformBatch *batch, int ifindex, struct in6_addr address, int plen);
+guint nm_platform_batch_ip4_route_add (NMPlatformBatch *batch, int ifindex, NMIPConfigSource source,
+                                       in_addr_t network, int plen, in_addr_t gateway,
+                                       in_addr_t pref_src, guint32 metric, guint32 mss);
+guint nm_platform_batch_ip6_route_add (NMPlatformBatch *batch, int ifindex, NMIPConfigSource source,
+                                       struct in6_addr network, int plen, struct in6_addr gateway,
+                                       guint32 metric, guint32 mss);
+guint nm_platform_batch_ip4_route_replace (NMPlatformBatch *batch, int ifindex, NMIPConfigSource source,
+                                           in_addr_t network, int plen, in_addr_t gateway,
+                                           in_addr_t pref_src, guint32 metric, guint32 mss);
+guint nm_platform_batch_ip6_route_replace (NMPlatformBatch *batch, int ifindex, NMIPConfigSource source,
+                                           struct in6_addr network, int plen, struct in6_addr gateway,
+                                           guint32 metric, guint32 mss);
+guint nm_platform_batch_ip4_route_delete (NMPlatformBatch *batch, int ifindex, in_addr_t network, int plen, guint32 metric);
+guint nm_platform_batch_ip6_route_delete (NMPlatformBatch *batch, int ifindex, struct in6_addr network, int plen, guint32 metric);
+gboolean nm_platform_batch_commit (NMPlatformBatch *batch);
+gboolean nm_platform_batch_get_result (const NMPlatformBatch *batch, guint idx);
+
 const char *nm_platform_link_to_string (const NMPlatformLink *link, char *buf, gsize len);
+const char *nm_platform_lnk_bond_to_string (const NMPlatformLnkBond *lnk, char *buf, gsize len);
+const char *nm_platform_lnk_bridge_to_string (const NMPlatformLnkBridge *lnk, char *buf, gsize len);
 const char *nm_platform_lnk_gre_to_string (const NMPlatformLnkGre *lnk, char *buf, gsize len);
 const char *nm_platform_lnk_infiniband_to_string (const NMPlatformLnkInfiniband *lnk, char *buf, gsize len);
 const char *nm_platform_lnk_ip6tnl_to_string (const NMPlatformLnkIp6Tnl *lnk, char *buf, gsize len);
@@ -901,6 +1198,8 @@ const char *nm_platform_vlan_qos_mapping_to_string (const char *name,
                                                     gsize len);
 
 int nm_platform_link_cmp (const NMPlatformLink *a, const NMPlatformLink *b);
+int nm_platform_lnk_bond_cmp (const NMPlatformLnkBond *a, const NMPlatformLnkBond *b);
+int nm_platform_lnk_bridge_cmp (const NMPlatformLnkBridge *a, const NMPlatformLnkBridge *b);
 int nm_platform_lnk_gre_cmp (const NMPlatformLnkGre *a, const NMPlatformLnkGre *b);
 int nm_platform_lnk_infiniband_cmp (const NMPlatformLnkInfiniband *a, const NMPlatformLnkInfiniband *b);
 int nm_platform_lnk_ip6tnl_cmp (const NMPlatformLnkIp6Tnl *a, const NMPlatformLnkIp6Tnl *b);
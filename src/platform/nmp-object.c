@@ -20,6 +20,7 @@
 
 #include "config.h"
 
+#include <stdlib.h>
 #include <unistd.h>
 
 #include "nm-default.h"
@@ -50,7 +51,7 @@
 
 struct _NMPCache {
 	/* the cache contains only one hash table for all object types, and similarly
-	 * it contains only one NMMultiIndex.
+	 * it contains only one NMGroupIndex.
 	 * This works, because different object types don't ever compare equal and
 	 * because their index ids also don't overlap.
 	 *
@@ -64,7 +65,7 @@ struct _NMPCache {
 	 */
 
 	GHashTable *idx_main;
-	NMMultiIndex *idx_multi;
+	NMGroupIndex *idx_multi;
 
 	gboolean use_udev;
 };
@@ -205,6 +206,202 @@ nmp_class_from_type (NMPObjectType obj_type)
 	return &_nmp_classes[obj_type - 1];
 }
 
+/******************************************************************
+ * Object pools
+ *
+ * The platform cache can contain a very large number of objects (e.g.
+ * routes). Instead of allocating each object individually, objects are
+ * allocated from a pool per object type. A pool consists of chunks of
+ * POOL_CHUNK_SIZE bytes, aligned to their size, so that the chunk of an
+ * object can be found by masking its address. Each chunk has its own
+ * free list. Chunks that have free slots are kept in a list, at most one
+ * completely unused chunk is kept around per pool.
+ *
+ * Like the rest of platform, the pools are not thread-safe.
+ ******************************************************************/
+
+#define POOL_CHUNK_SIZE  ((gsize) (64 * 1024))
+#define POOL_ALIGN       (2 * sizeof (gpointer))
+#define POOL_ALIGN_UP(x) (((x) + POOL_ALIGN - 1) & ~(POOL_ALIGN - 1))
+
+typedef struct _NMPObjectPoolChunk NMPObjectPoolChunk;
+
+typedef struct {
+	gsize obj_size;
+	guint objs_per_chunk;
+
+	/* list of chunks that have unused slots. */
+	NMPObjectPoolChunk *partial;
+
+	guint n_chunks;
+	guint n_chunks_empty;
+	guint64 n_used;
+	guint64 n_used_peak;
+	guint64 n_allocated;
+} NMPObjectPool;
+
+struct _NMPObjectPoolChunk {
+	NMPObjectPool *pool;
+	NMPObjectPoolChunk *prev;
+	NMPObjectPoolChunk *next;
+	gpointer free_list;
+	guint n_used;
+	guint n_untouched_from;
+};
+
+#define POOL_CHUNK_HEADER_SIZE POOL_ALIGN_UP (sizeof (NMPObjectPoolChunk))
+
+static NMPObjectPool _pools[NMP_OBJECT_TYPE_MAX];
+
+static NMPObjectPool *
+_pool_get (const NMPClass *klass)
+{
+	NMPObjectPool *pool = &_pools[klass->obj_type - 1];
+
+	if (G_UNLIKELY (!pool->obj_size)) {
+		pool->obj_size = POOL_ALIGN_UP (klass->sizeof_data + G_STRUCT_OFFSET (NMPObject, object));
+		pool->objs_per_chunk = (POOL_CHUNK_SIZE - POOL_CHUNK_HEADER_SIZE) / pool->obj_size;
+		g_assert (pool->objs_per_chunk > 0);
+	}
+	return pool;
+}
+
+static void
+_pool_chunk_link (NMPObjectPool *pool, NMPObjectPoolChunk *chunk)
+{
+	chunk->prev = NULL;
+	chunk->next = pool->partial;
+	if (pool->partial)
+		pool->partial->prev = chunk;
+	pool->partial = chunk;
+}
+
+static void
+_pool_chunk_unlink (NMPObjectPool *pool, NMPObjectPoolChunk *chunk)
+{
+	if (chunk->prev)
+		chunk->prev->next = chunk->next;
+	else
+		pool->partial = chunk->next;
+	if (chunk->next)
+		chunk->next->prev = chunk->prev;
+	chunk->prev = NULL;
+	chunk->next = NULL;
+}
+
+static gpointer
+_pool_alloc0 (NMPObjectPool *pool)
+{
+	NMPObjectPoolChunk *chunk = pool->partial;
+	gpointer slot;
+
+	if (G_UNLIKELY (!chunk)) {
+		gpointer mem;
+
+		if (posix_memalign (&mem, POOL_CHUNK_SIZE, POOL_CHUNK_SIZE) != 0)
+			g_error ("nmp-object: failed to allocate %" G_GSIZE_FORMAT " bytes", POOL_CHUNK_SIZE);
+		chunk = mem;
+		memset (chunk, 0, sizeof (*chunk));
+		chunk->pool = pool;
+		pool->n_chunks++;
+		pool->n_chunks_empty++;
+		_pool_chunk_link (pool, chunk);
+	}
+
+	if (chunk->free_list) {
+		slot = chunk->free_list;
+		chunk->free_list = *((gpointer *) slot);
+	} else {
+		nm_assert (chunk->n_untouched_from < pool->objs_per_chunk);
+		slot = ((char *) chunk) + POOL_CHUNK_HEADER_SIZE + (chunk->n_untouched_from++ * pool->obj_size);
+	}
+
+	if (chunk->n_used++ == 0)
+		pool->n_chunks_empty--;
+	if (chunk->n_used == pool->objs_per_chunk)
+		_pool_chunk_unlink (pool, chunk);
+
+	pool->n_allocated++;
+	if (++pool->n_used > pool->n_used_peak)
+		pool->n_used_peak = pool->n_used;
+
+	memset (slot, 0, pool->obj_size);
+	return slot;
+}
+
+static void
+_pool_free (NMPObjectPool *pool, gpointer slot)
+{
+	NMPObjectPoolChunk *chunk = (NMPObjectPoolChunk *) (((gsize) slot) & ~(POOL_CHUNK_SIZE - 1));
+
+	nm_assert (chunk->pool == pool);
+	nm_assert (chunk->n_used > 0);
+
+	if (chunk->n_used == pool->objs_per_chunk)
+		_pool_chunk_link (pool, chunk);
+
+	*((gpointer *) slot) = chunk->free_list;
+	chunk->free_list = slot;
+
+	pool->n_used--;
+	if (--chunk->n_used == 0) {
+		if (pool->n_chunks_empty > 0) {
+			/* we already have an unused chunk. Release this one. */
+			_pool_chunk_unlink (pool, chunk);
+			pool->n_chunks--;
+			free (chunk);
+		} else
+			pool->n_chunks_empty++;
+	}
+}
+
+/**
+ * nmp_object_pool_get_stats:
+ * @obj_type: the object type
+ * @out_stats: (out): the statistics of the pool for @obj_type
+ *
+ * Returns the memory usage of the pool from which all objects
+ * of @obj_type are allocated.
+ */
+void
+nmp_object_pool_get_stats (NMPObjectType obj_type, NMPObjectPoolStats *out_stats)
+{
+	const NMPObjectPool *pool = _pool_get (nmp_class_from_type (obj_type));
+
+	g_return_if_fail (out_stats);
+
+	out_stats->obj_size = pool->obj_size;
+	out_stats->n_chunks = pool->n_chunks;
+	out_stats->n_used = pool->n_used;
+	out_stats->n_used_peak = pool->n_used_peak;
+	out_stats->n_allocated = pool->n_allocated;
+	out_stats->bytes_reserved = pool->n_chunks * POOL_CHUNK_SIZE;
+	out_stats->bytes_used = pool->n_used * pool->obj_size;
+}
+
+void
+nmp_object_pool_log_stats (NMLogLevel level)
+{
+	NMPObjectType obj_type;
+
+	if (!nm_logging_enabled (level, _NMLOG_DOMAIN))
+		return;
+
+	for (obj_type = NMP_OBJECT_TYPE_UNKNOWN + 1; obj_type <= NMP_OBJECT_TYPE_MAX; obj_type++) {
+		NMPObjectPoolStats stats;
+
+		nmp_object_pool_get_stats (obj_type, &stats);
+		if (!stats.n_allocated)
+			continue;
+		_nm_log (level, _NMLOG_DOMAIN, 0,
+		         "nmp-object: pool %-12s: %" G_GUINT64_FORMAT " objects of %" G_GSIZE_FORMAT " bytes (peak %" G_GUINT64_FORMAT
+		         ", %" G_GUINT64_FORMAT " allocations), %" G_GSIZE_FORMAT " of %" G_GSIZE_FORMAT " bytes used in %u chunks",
+		         nmp_class_from_type (obj_type)->obj_type_name,
+		         stats.n_used, stats.obj_size, stats.n_used_peak, stats.n_allocated,
+		         stats.bytes_used, stats.bytes_reserved, stats.n_chunks);
+	}
+}
+
 /******************************************************************/
 
 NMPObject *
@@ -234,7 +431,7 @@ nmp_object_unref (NMPObject *obj)
 			nm_assert (!obj->is_cached);
 			if (klass->cmd_obj_dispose)
 				klass->cmd_obj_dispose (obj);
-			g_slice_free1 (klass->sizeof_data + G_STRUCT_OFFSET (NMPObject, object), obj);
+			_pool_free (_pool_get (klass), obj);
 		}
 	}
 }
@@ -262,7 +459,7 @@ _nmp_object_new_from_class (const NMPClass *klass)
 	nm_assert (klass->sizeof_data > 0);
 	nm_assert (klass->sizeof_public > 0 && klass->sizeof_public <= klass->sizeof_data);
 
-	obj = g_slice_alloc0 (klass->sizeof_data + G_STRUCT_OFFSET (NMPObject, object));
+	obj = _pool_alloc0 (_pool_get (klass));
 	obj->_class = klass;
 	obj->_ref_count = 1;
 	_LOGt (obj, "new");
@@ -979,22 +1176,6 @@ nmp_cache_id_hash (const NMPCacheId *id)
 	return hash;
 }
 
-NMPCacheId *
-nmp_cache_id_clone (const NMPCacheId *id)
-{
-	NMPCacheId *id2;
-
-	id2 = g_slice_new (NMPCacheId);
-	memcpy (id2, id, sizeof (NMPCacheId));
-	return id2;
-}
-
-void
-nmp_cache_id_destroy (NMPCacheId *id)
-{
-	g_slice_free (NMPCacheId, id);
-}
-
 /******************************************************************/
 
 NMPCacheId _nmp_cache_id_static;
@@ -1082,6 +1263,37 @@ nmp_cache_id_init_link_by_ifname (NMPCacheId *id,
 
 /******************************************************************/
 
+static const NMPCacheIdType _cache_id_types_link[] = {
+	NMP_CACHE_ID_TYPE_OBJECT_TYPE,
+	NMP_CACHE_ID_TYPE_OBJECT_TYPE_VISIBLE_ONLY,
+	NMP_CACHE_ID_TYPE_LINK_BY_IFNAME,
+};
+
+static const NMPCacheIdType _cache_id_types_ipx_address[] = {
+	NMP_CACHE_ID_TYPE_OBJECT_TYPE,
+	NMP_CACHE_ID_TYPE_OBJECT_TYPE_VISIBLE_ONLY,
+	NMP_CACHE_ID_TYPE_ADDRROUTE_VISIBLE_BY_IFINDEX,
+};
+
+static const NMPCacheIdType _cache_id_types_ipx_route[] = {
+	NMP_CACHE_ID_TYPE_OBJECT_TYPE,
+	NMP_CACHE_ID_TYPE_OBJECT_TYPE_VISIBLE_ONLY,
+	NMP_CACHE_ID_TYPE_ROUTES_VISIBLE_NO_DEFAULT,
+	NMP_CACHE_ID_TYPE_ROUTES_VISIBLE_ONLY_DEFAULT,
+	NMP_CACHE_ID_TYPE_ADDRROUTE_VISIBLE_BY_IFINDEX,
+	NMP_CACHE_ID_TYPE_ROUTES_VISIBLE_BY_IFINDEX_NO_DEFAULT,
+	NMP_CACHE_ID_TYPE_ROUTES_VISIBLE_BY_IFINDEX_ONLY_DEFAULT,
+};
+
+static const NMPCacheIdType _cache_id_types_lnk[] = {
+	NMP_CACHE_ID_TYPE_OBJECT_TYPE,
+	NMP_CACHE_ID_TYPE_OBJECT_TYPE_VISIBLE_ONLY,
+};
+
+#define _CACHE_ID_TYPES(types) \
+	.cache_id_types                     = types, \
+	.n_cache_id_types                   = G_N_ELEMENTS (types)
+
 static gboolean
 _nmp_object_init_cache_id (const NMPObject *obj, NMPCacheIdType id_type, NMPCacheId *id, const NMPCacheId **out_id)
 {
@@ -1327,8 +1539,8 @@ nmp_cache_link_connected_needs_toggle_by_ifindex (const NMPCache *cache, int mas
 const NMPlatformObject *const *
 nmp_cache_lookup_multi (const NMPCache *cache, const NMPCacheId *cache_id, guint *out_len)
 {
-	return (const NMPlatformObject *const *) nm_multi_index_lookup (cache->idx_multi,
-	                                                                (const NMMultiIndexId *) cache_id,
+	return (const NMPlatformObject *const *) nm_group_index_lookup (cache->idx_multi,
+	                                                                cache_id,
 	                                                                out_len);
 }
 
@@ -1425,18 +1637,16 @@ nmp_cache_lookup_all_to_hash (const NMPCache *cache,
                               NMPCacheId *cache_id,
                               GHashTable *hash)
 {
-	NMMultiIndexIdIter iter;
-	gpointer plobj;
-
-	nm_multi_index_id_iter_init (&iter, cache->idx_multi, (const NMMultiIndexId *) cache_id);
+	const NMPlatformObject *const *list;
+	guint i, len;
 
-	if (nm_multi_index_id_iter_next (&iter, &plobj)) {
+	list = nmp_cache_lookup_multi (cache, cache_id, &len);
+	if (len > 0) {
 		if (!hash)
 			hash = g_hash_table_new_full (NULL, NULL, (GDestroyNotify) nmp_object_unref, NULL);
 
-		do {
-			g_hash_table_add (hash, nmp_object_ref (NMP_OBJECT_UP_CAST (plobj)));
-		} while (nm_multi_index_id_iter_next (&iter, &plobj));
+		for (i = 0; i < len; i++)
+			g_hash_table_add (hash, nmp_object_ref (NMP_OBJECT_UP_CAST (list[i])));
 	}
 
 	return hash;
@@ -1445,16 +1655,26 @@ nmp_cache_lookup_all_to_hash (const NMPCache *cache,
 /******************************************************************/
 
 static void
-_nmp_cache_update_cache (NMPCache *cache, NMPObject *obj, gboolean remove)
+_nmp_cache_update_add (NMPCache *cache, NMPObject *obj)
 {
-	NMPCacheIdType id_type;
+	const NMPClass *klass = NMP_OBJECT_GET_CLASS (obj);
+	guint i;
+
+	nm_assert (!obj->is_cached);
+	nm_assert (!obj->_idx_nodes);
+
+	nmp_object_ref (obj);
+	if (!nm_g_hash_table_add (cache->idx_main, obj))
+		g_assert_not_reached ();
+	obj->is_cached = TRUE;
+	obj->_idx_nodes = g_slice_alloc0 (sizeof (NMGroupIndexNode) * klass->n_cache_id_types);
 
-	for (id_type = 0; id_type <= NMP_CACHE_ID_TYPE_MAX; id_type++) {
+	for (i = 0; i < klass->n_cache_id_types; i++) {
 		NMPCacheId cache_id_storage;
 		const NMPCacheId *cache_id;
 
-		if (!_nmp_object_init_cache_id (obj, id_type, &cache_id_storage, &cache_id))
-			continue;
+		if (!_nmp_object_init_cache_id (obj, klass->cache_id_types[i], &cache_id_storage, &cache_id))
+			g_assert_not_reached ();
 		if (!cache_id)
 			continue;
 
@@ -1463,61 +1683,61 @@ _nmp_cache_update_cache (NMPCache *cache, NMPObject *obj, gboolean remove)
 		 * You can use NMP_OBJECT_UP_CAST() to retrieve the original @obj pointer.
 		 *
 		 * If need be, we could determine based on @id_type which pointer we want to store. */
-
-		if (remove) {
-			if (!nm_multi_index_remove (cache->idx_multi, &cache_id->base, &obj->object))
-				g_assert_not_reached ();
-		} else {
-			if (!nm_multi_index_add (cache->idx_multi, &cache_id->base, &obj->object))
-				g_assert_not_reached ();
-		}
+		if (!nm_group_index_add (cache->idx_multi, cache_id, &obj->object, &obj->_idx_nodes[i]))
+			g_assert_not_reached ();
 	}
 }
 
-static void
-_nmp_cache_update_add (NMPCache *cache, NMPObject *obj)
-{
-	nm_assert (!obj->is_cached);
-	nmp_object_ref (obj);
-	nm_assert (!nm_multi_index_lookup_first_by_value (cache->idx_multi, &obj->object));
-	if (!nm_g_hash_table_add (cache->idx_main, obj))
-		g_assert_not_reached ();
-	obj->is_cached = TRUE;
-	_nmp_cache_update_cache (cache, obj, FALSE);
-}
-
 static void
 _nmp_cache_update_remove (NMPCache *cache, NMPObject *obj)
 {
+	const NMPClass *klass = NMP_OBJECT_GET_CLASS (obj);
+	guint i;
+
 	nm_assert (obj->is_cached);
-	_nmp_cache_update_cache (cache, obj, TRUE);
+
+	/* every node knows the group it belongs to. There is no need to
+	 * recompute the cache ids of @obj. */
+	for (i = 0; i < klass->n_cache_id_types; i++) {
+		if (nm_group_index_node_is_linked (&obj->_idx_nodes[i]))
+			nm_group_index_remove (cache->idx_multi, &obj->object, &obj->_idx_nodes[i]);
+	}
+	g_slice_free1 (sizeof (NMGroupIndexNode) * klass->n_cache_id_types, obj->_idx_nodes);
+	obj->_idx_nodes = NULL;
+
 	obj->is_cached = FALSE;
 	if (!g_hash_table_remove (cache->idx_main, obj))
 		g_assert_not_reached ();
-
-	/* @obj is possibly a dangling pointer at this point. No problem, multi-index doesn't dereference. */
-	nm_assert (!nm_multi_index_lookup_first_by_value (cache->idx_multi, &obj->object));
 }
 
 static void
 _nmp_cache_update_update (NMPCache *cache, NMPObject *obj, const NMPObject *new)
 {
-	NMPCacheIdType id_type;
+	const NMPClass *klass = NMP_OBJECT_GET_CLASS (obj);
+	guint i;
 
-	nm_assert (NMP_OBJECT_GET_CLASS (obj) == NMP_OBJECT_GET_CLASS (new));
+	nm_assert (klass == NMP_OBJECT_GET_CLASS (new));
 	nm_assert (obj->is_cached);
 	nm_assert (!new->is_cached);
 
-	for (id_type = 0; id_type <= NMP_CACHE_ID_TYPE_MAX; id_type++) {
-		NMPCacheId cache_id_storage_obj, cache_id_storage_new;
+	for (i = 0; i < klass->n_cache_id_types; i++) {
+		NMGroupIndexNode *node = &obj->_idx_nodes[i];
+		NMPCacheId cache_id_storage_new;
 		const NMPCacheId *cache_id_obj, *cache_id_new;
 
-		if (!_nmp_object_init_cache_id (obj, id_type, &cache_id_storage_obj, &cache_id_obj))
-			continue;
-		if (!_nmp_object_init_cache_id (new, id_type, &cache_id_storage_new, &cache_id_new))
-			g_assert_not_reached ();
-		if (!nm_multi_index_move (cache->idx_multi, (NMMultiIndexId *) cache_id_obj, (NMMultiIndexId *) cache_id_new, &obj->object))
+		if (!_nmp_object_init_cache_id (new, klass->cache_id_types[i], &cache_id_storage_new, &cache_id_new))
 			g_assert_not_reached ();
+
+		cache_id_obj = nm_group_index_node_get_id (node);
+		if (cache_id_obj && cache_id_new && nmp_cache_id_equal (cache_id_obj, cache_id_new))
+			continue;
+
+		if (cache_id_obj)
+			nm_group_index_remove (cache->idx_multi, &obj->object, node);
+		if (cache_id_new) {
+			if (!nm_group_index_add (cache->idx_multi, cache_id_new, &obj->object, node))
+				g_assert_not_reached ();
+		}
 	}
 	nmp_object_copy (obj, new, FALSE);
 }
@@ -1671,17 +1891,10 @@ nmp_cache_update_netlink (NMPCache *cache, NMPObject *obj, NMPObject **out_obj,
 		return NMP_CACHE_OPS_ADDED;
 	} else if (old == obj) {
 		/* updating a cached object inplace is not supported because the object contributes to hash-key
-		 * for NMMultiIndex. Modifying an object that is inside NMMultiIndex means that these
-		 * keys change.
-		 * The problem is, that for a given object NMMultiIndex does not support (efficient)
-		 * reverse lookup to get all the NMPCacheIds to which it belongs. If that would be implemented,
-		 * it would be possible to implement inplace-update.
-		 *
-		 * There is an un-optimized reverse lookup via nm_multi_index_iter_init(), but we don't want
-		 * that because we might have a large number of indexes to search.
-		 *
-		 * We could add efficient reverse lookup by adding a reverse index to NMMultiIndex. But that
-		 * also adds some cost to support an (uncommon?) usage pattern.
+		 * for NMGroupIndex. Modifying an object that is inside NMGroupIndex means that these
+		 * keys change. _nmp_cache_update_update() compares the ids of the old and the
+		 * new instance to move the object between the groups, which requires two
+		 * distinct instances.
 		 *
 		 * Instead we just don't support it, instead we expect the user to
 		 * create a new instance from netlink.
@@ -1865,10 +2078,9 @@ nmp_cache_new ()
 	                                         (GEqualFunc) nmp_object_id_equal,
 	                                         (GDestroyNotify) nmp_object_unref,
 	                                         NULL);
-	cache->idx_multi = nm_multi_index_new ((NMMultiIndexFuncHash) nmp_cache_id_hash,
-	                                       (NMMultiIndexFuncEqual) nmp_cache_id_equal,
-	                                       (NMMultiIndexFuncClone) nmp_cache_id_clone,
-	                                       (NMMultiIndexFuncDestroy) nmp_cache_id_destroy);
+	cache->idx_multi = nm_group_index_new ((GHashFunc) nmp_cache_id_hash,
+	                                       (GEqualFunc) nmp_cache_id_equal,
+	                                       sizeof (NMPCacheId));
 	cache->use_udev = nmp_cache_use_udev_detect ();
 	return cache;
 }
@@ -1882,14 +2094,18 @@ nmp_cache_free (NMPCache *cache)
 	/* No need to cumbersomely remove the objects properly. They are not hooked up
 	 * in a complicated way, we can just unref them together with cache->idx_main.
 	 *
-	 * But we must clear the @is_cached flag. */
+	 * But we must clear the @is_cached flag and release the index nodes. Freeing
+	 * the index first unlinks all nodes. */
+	nm_group_index_free (cache->idx_multi);
+
 	g_hash_table_iter_init (&iter, cache->idx_main);
 	while (g_hash_table_iter_next (&iter, (gpointer *) &obj, NULL)) {
 		nm_assert (obj->is_cached);
+		g_slice_free1 (sizeof (NMGroupIndexNode) * NMP_OBJECT_GET_CLASS (obj)->n_cache_id_types, obj->_idx_nodes);
+		obj->_idx_nodes = NULL;
 		obj->is_cached = FALSE;
 	}
 
-	nm_multi_index_free (cache->idx_multi);
 	g_hash_table_unref (cache->idx_main);
 
 	g_free (cache);
@@ -1901,7 +2117,7 @@ void
 ASSERT_nmp_cache_is_consistent (const NMPCache *cache)
 {
 #if NM_MORE_ASSERTS
-	NMMultiIndexIter iter_multi;
+	NMGroupIndexIter iter_multi;
 	GHashTableIter iter_hash;
 	guint i, len;
 	NMPCacheId cache_id_storage;
@@ -1913,23 +2129,35 @@ ASSERT_nmp_cache_is_consistent (const NMPCache *cache)
 
 	g_hash_table_iter_init (&iter_hash, cache->idx_main);
 	while (g_hash_table_iter_next (&iter_hash, (gpointer *) &obj, NULL)) {
+		const NMPClass *klass = NMP_OBJECT_GET_CLASS (obj);
 		NMPCacheIdType id_type;
 
 		g_assert (NMP_OBJECT_IS_VALID (obj));
 		g_assert (nmp_object_is_alive (obj));
+		g_assert (obj->_idx_nodes);
 
 		for (id_type = 0; id_type <= NMP_CACHE_ID_TYPE_MAX; id_type++) {
-			if (!_nmp_object_init_cache_id (obj, id_type, &cache_id_storage, &cache_id))
+			gboolean has_type = _nmp_object_init_cache_id (obj, id_type, &cache_id_storage, &cache_id);
+
+			for (i = 0; i < klass->n_cache_id_types; i++) {
+				if (klass->cache_id_types[i] == id_type)
+					break;
+			}
+			g_assert (has_type == (i < klass->n_cache_id_types));
+			if (!has_type)
 				continue;
 			if (!cache_id)
-				continue;
-			g_assert (nm_multi_index_contains (cache->idx_multi, &cache_id->base, &obj->object));
+				g_assert (!nm_group_index_node_is_linked (&obj->_idx_nodes[i]));
+			else {
+				g_assert (nm_group_index_node_is_linked (&obj->_idx_nodes[i]));
+				g_assert (nmp_cache_id_equal (cache_id, nm_group_index_node_get_id (&obj->_idx_nodes[i])));
+			}
 		}
 	}
 
-	nm_multi_index_iter_init (&iter_multi, cache->idx_multi, NULL);
-	while (nm_multi_index_iter_next (&iter_multi,
-	                                 (const NMMultiIndexId **) &cache_id,
+	nm_group_index_iter_init (&iter_multi, cache->idx_multi);
+	while (nm_group_index_iter_next (&iter_multi,
+	                                 (gconstpointer *) &cache_id,
 	                                 (void *const**) &objects,
 	                                 &len)) {
 		g_assert (len > 0 && objects && objects[len] == NULL);
@@ -1961,6 +2189,7 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.sizeof_data                        = sizeof (NMPObjectLink),
 		.sizeof_public                      = sizeof (NMPlatformLink),
 		.obj_type_name                      = "link",
+		_CACHE_ID_TYPES (_cache_id_types_link),
 		.addr_family                        = AF_UNSPEC,
 		.rtm_gettype                        = RTM_GETLINK,
 		.signal_type_id                     = NM_PLATFORM_SIGNAL_ID_LINK,
@@ -1985,6 +2214,7 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.sizeof_data                        = sizeof (NMPObjectIP4Address),
 		.sizeof_public                      = sizeof (NMPlatformIP4Address),
 		.obj_type_name                      = "ip4-address",
+		_CACHE_ID_TYPES (_cache_id_types_ipx_address),
 		.addr_family                        = AF_INET,
 		.rtm_gettype                        = RTM_GETADDR,
 		.signal_type_id                     = NM_PLATFORM_SIGNAL_ID_IP4_ADDRESS,
@@ -2004,6 +2234,7 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.sizeof_data                        = sizeof (NMPObjectIP6Address),
 		.sizeof_public                      = sizeof (NMPlatformIP6Address),
 		.obj_type_name                      = "ip6-address",
+		_CACHE_ID_TYPES (_cache_id_types_ipx_address),
 		.addr_family                        = AF_INET6,
 		.rtm_gettype                        = RTM_GETADDR,
 		.signal_type_id                     = NM_PLATFORM_SIGNAL_ID_IP6_ADDRESS,
@@ -2023,6 +2254,7 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.sizeof_data                        = sizeof (NMPObjectIP4Route),
 		.sizeof_public                      = sizeof (NMPlatformIP4Route),
 		.obj_type_name                      = "ip4-route",
+		_CACHE_ID_TYPES (_cache_id_types_ipx_route),
 		.addr_family                        = AF_INET,
 		.rtm_gettype                        = RTM_GETROUTE,
 		.signal_type_id                     = NM_PLATFORM_SIGNAL_ID_IP4_ROUTE,
@@ -2042,6 +2274,7 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.sizeof_data                        = sizeof (NMPObjectIP6Route),
 		.sizeof_public                      = sizeof (NMPlatformIP6Route),
 		.obj_type_name                      = "ip6-route",
+		_CACHE_ID_TYPES (_cache_id_types_ipx_route),
 		.addr_family                        = AF_INET6,
 		.rtm_gettype                        = RTM_GETROUTE,
 		.signal_type_id                     = NM_PLATFORM_SIGNAL_ID_IP6_ROUTE,
@@ -2056,11 +2289,32 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.cmd_plobj_to_string                = (const char *(*) (const NMPlatformObject *obj, char *buf, gsize len)) nm_platform_ip6_route_to_string,
 		.cmd_plobj_cmp                      = (int (*) (const NMPlatformObject *obj1, const NMPlatformObject *obj2)) nm_platform_ip6_route_cmp,
 	},
+	[NMP_OBJECT_TYPE_LNK_BOND - 1] = {
+		.obj_type                           = NMP_OBJECT_TYPE_LNK_BOND,
+		.sizeof_data                        = sizeof (NMPObjectLnkBond),
+		.sizeof_public                      = sizeof (NMPlatformLnkBond),
+		.obj_type_name                      = "bond",
+		_CACHE_ID_TYPES (_cache_id_types_lnk),
+		.lnk_link_type                      = NM_LINK_TYPE_BOND,
+		.cmd_plobj_to_string                = (const char *(*) (const NMPlatformObject *obj, char *buf, gsize len)) nm_platform_lnk_bond_to_string,
+		.cmd_plobj_cmp                      = (int (*) (const NMPlatformObject *obj1, const NMPlatformObject *obj2)) nm_platform_lnk_bond_cmp,
+	},
+	[NMP_OBJECT_TYPE_LNK_BRIDGE - 1] = {
+		.obj_type                           = NMP_OBJECT_TYPE_LNK_BRIDGE,
+		.sizeof_data                        = sizeof (NMPObjectLnkBridge),
+		.sizeof_public                      = sizeof (NMPlatformLnkBridge),
+		.obj_type_name                      = "bridge",
+		_CACHE_ID_TYPES (_cache_id_types_lnk),
+		.lnk_link_type                      = NM_LINK_TYPE_BRIDGE,
+		.cmd_plobj_to_string                = (const char *(*) (const NMPlatformObject *obj, char *buf, gsize len)) nm_platform_lnk_bridge_to_string,
+		.cmd_plobj_cmp                      = (int (*) (const NMPlatformObject *obj1, const NMPlatformObject *obj2)) nm_platform_lnk_bridge_cmp,
+	},
 	[NMP_OBJECT_TYPE_LNK_GRE - 1] = {
 		.obj_type                           = NMP_OBJECT_TYPE_LNK_GRE,
 		.sizeof_data                        = sizeof (NMPObjectLnkGre),
 		.sizeof_public                      = sizeof (NMPlatformLnkGre),
 		.obj_type_name                      = "gre",
+		_CACHE_ID_TYPES (_cache_id_types_lnk),
 		.lnk_link_type                      = NM_LINK_TYPE_GRE,
 		.cmd_plobj_to_string                = (const char *(*) (const NMPlatformObject *obj, char *buf, gsize len)) nm_platform_lnk_gre_to_string,
 		.cmd_plobj_cmp                      = (int (*) (const NMPlatformObject *obj1, const NMPlatformObject *obj2)) nm_platform_lnk_gre_cmp,
@@ -2070,6 +2324,7 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.sizeof_data                        = sizeof (NMPObjectLnkInfiniband),
 		.sizeof_public                      = sizeof (NMPlatformLnkInfiniband),
 		.obj_type_name                      = "infiniband",
+		_CACHE_ID_TYPES (_cache_id_types_lnk),
 		.lnk_link_type                      = NM_LINK_TYPE_INFINIBAND,
 		.cmd_plobj_to_string                = (const char *(*) (const NMPlatformObject *obj, char *buf, gsize len)) nm_platform_lnk_infiniband_to_string,
 		.cmd_plobj_cmp                      = (int (*) (const NMPlatformObject *obj1, const NMPlatformObject *obj2)) nm_platform_lnk_infiniband_cmp,
@@ -2079,6 +2334,7 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.sizeof_data                        = sizeof (NMPObjectLnkIp6Tnl),
 		.sizeof_public                      = sizeof (NMPlatformLnkIp6Tnl),
 		.obj_type_name                      = "ip6tnl",
+		_CACHE_ID_TYPES (_cache_id_types_lnk),
 		.lnk_link_type                      = NM_LINK_TYPE_IP6TNL,
 		.cmd_plobj_to_string                = (const char *(*) (const NMPlatformObject *obj, char *buf, gsize len)) nm_platform_lnk_ip6tnl_to_string,
 		.cmd_plobj_cmp                      = (int (*) (const NMPlatformObject *obj1, const NMPlatformObject *obj2)) nm_platform_lnk_ip6tnl_cmp,
@@ -2088,6 +2344,7 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.sizeof_data                        = sizeof (NMPObjectLnkIpIp),
 		.sizeof_public                      = sizeof (NMPlatformLnkIpIp),
 		.obj_type_name                      = "ipip",
+		_CACHE_ID_TYPES (_cache_id_types_lnk),
 		.lnk_link_type                      = NM_LINK_TYPE_IPIP,
 		.cmd_plobj_to_string                = (const char *(*) (const NMPlatformObject *obj, char *buf, gsize len)) nm_platform_lnk_ipip_to_string,
 		.cmd_plobj_cmp                      = (int (*) (const NMPlatformObject *obj1, const NMPlatformObject *obj2)) nm_platform_lnk_ipip_cmp,
@@ -2097,6 +2354,7 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.sizeof_data                        = sizeof (NMPObjectLnkMacvlan),
 		.sizeof_public                      = sizeof (NMPlatformLnkMacvlan),
 		.obj_type_name                      = "macvlan",
+		_CACHE_ID_TYPES (_cache_id_types_lnk),
 		.lnk_link_type                      = NM_LINK_TYPE_MACVLAN,
 		.cmd_plobj_to_string                = (const char *(*) (const NMPlatformObject *obj, char *buf, gsize len)) nm_platform_lnk_macvlan_to_string,
 		.cmd_plobj_cmp                      = (int (*) (const NMPlatformObject *obj1, const NMPlatformObject *obj2)) nm_platform_lnk_macvlan_cmp,
@@ -2106,6 +2364,7 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.sizeof_data                        = sizeof (NMPObjectLnkMacvtap),
 		.sizeof_public                      = sizeof (NMPlatformLnkMacvtap),
 		.obj_type_name                      = "macvtap",
+		_CACHE_ID_TYPES (_cache_id_types_lnk),
 		.lnk_link_type                      = NM_LINK_TYPE_MACVTAP,
 		.cmd_plobj_to_string                = (const char *(*) (const NMPlatformObject *obj, char *buf, gsize len)) nm_platform_lnk_macvlan_to_string,
 		.cmd_plobj_cmp                      = (int (*) (const NMPlatformObject *obj1, const NMPlatformObject *obj2)) nm_platform_lnk_macvlan_cmp,
@@ -2115,6 +2374,7 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.sizeof_data                        = sizeof (NMPObjectLnkSit),
 		.sizeof_public                      = sizeof (NMPlatformLnkSit),
 		.obj_type_name                      = "sit",
+		_CACHE_ID_TYPES (_cache_id_types_lnk),
 		.lnk_link_type                      = NM_LINK_TYPE_SIT,
 		.cmd_plobj_to_string                = (const char *(*) (const NMPlatformObject *obj, char *buf, gsize len)) nm_platform_lnk_sit_to_string,
 		.cmd_plobj_cmp                      = (int (*) (const NMPlatformObject *obj1, const NMPlatformObject *obj2)) nm_platform_lnk_sit_cmp,
@@ -2124,6 +2384,7 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.sizeof_data                        = sizeof (NMPObjectLnkVlan),
 		.sizeof_public                      = sizeof (NMPlatformLnkVlan),
 		.obj_type_name                      = "vlan",
+		_CACHE_ID_TYPES (_cache_id_types_lnk),
 		.lnk_link_type                      = NM_LINK_TYPE_VLAN,
 		.cmd_obj_cmp                        = _vt_cmd_obj_cmp_lnk_vlan,
 		.cmd_obj_copy                       = _vt_cmd_obj_copy_lnk_vlan,
@@ -2137,6 +2398,7 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
 		.sizeof_data                        = sizeof (NMPObjectLnkVxlan),
 		.sizeof_public                      = sizeof (NMPlatformLnkVxlan),
 		.obj_type_name                      = "vxlan",
+		_CACHE_ID_TYPES (_cache_id_types_lnk),
 		.lnk_link_type                      = NM_LINK_TYPE_VXLAN,
 		.cmd_plobj_to_string                = (const char *(*) (const NMPlatformObject *obj, char *buf, gsize len)) nm_platform_lnk_vxlan_to_string,
 		.cmd_plobj_cmp                      = (int (*) (const NMPlatformObject *obj1, const NMPlatformObject *obj2)) nm_platform_lnk_vxlan_cmp,
@@ -24,7 +24,7 @@
 #include "config.h"
 
 #include "nm-platform.h"
-#include "nm-multi-index.h"
+#include "nm-group-index.h"
 #include "nm-macros-internal.h"
 
 #include <netlink/netlink.h>
@@ -89,7 +89,6 @@ typedef struct _NMPObject NMPObject;
 
 typedef struct {
 	union {
-		NMMultiIndexId base;
 		guint8 _id_type; /* NMPCacheIdType as guint8 */
 		struct {
 			/* NMP_CACHE_ID_TYPE_OBJECT_TYPE */
@@ -131,6 +130,11 @@ typedef struct {
 	/* Only for NMPObjectLnk* types. */
 	NMLinkType lnk_link_type;
 
+	/* the index types that objects of this class can be indexed by.
+	 * A cached object has one NMGroupIndexNode per entry. */
+	const NMPCacheIdType *cache_id_types;
+	guint n_cache_id_types;
+
 	/* returns %FALSE, if the obj type would never have an entry for index type @id_type. If @obj has an index,
 	 * initialize @id and set @out_id to it. Otherwise, @out_id is NULL. */
 	gboolean (*cmd_obj_init_cache_id) (const NMPObject *obj, NMPCacheIdType id_type, NMPCacheId *id, const NMPCacheId **out_id);
@@ -169,6 +173,14 @@ typedef struct {
 	} udev;
 } NMPObjectLink;
 
+typedef struct {
+	NMPlatformLnkBond _public;
+} NMPObjectLnkBond;
+
+typedef struct {
+	NMPlatformLnkBridge _public;
+} NMPObjectLnkBridge;
+
 typedef struct {
 	NMPlatformLnkGre _public;
 } NMPObjectLnkGre;
@@ -228,12 +240,23 @@ struct _NMPObject {
 	const NMPClass *_class;
 	int _ref_count;
 	bool is_cached;
+
+	/* for a cached object, the membership in the groups of
+	 * the multi index, one node per entry in the cache_id_types
+	 * of the class. Only allocated while the object is cached. */
+	NMGroupIndexNode *_idx_nodes;
 	union {
 		NMPlatformObject        object;
 
 		NMPlatformLink          link;
 		NMPObjectLink           _link;
 
+		NMPlatformLnkBond       lnk_bond;
+		NMPObjectLnkBond        _lnk_bond;
+
+		NMPlatformLnkBridge     lnk_bridge;
+		NMPObjectLnkBridge      _lnk_bridge;
+
 		NMPlatformLnkGre        lnk_gre;
 		NMPObjectLnkGre         _lnk_gre;
 
@@ -362,6 +385,19 @@ gboolean nmp_object_is_visible (const NMPObject *obj);
 
 void _nmp_object_fixup_link_udev_fields (NMPObject *obj, gboolean use_udev);
 
+typedef struct {
+	gsize obj_size;
+	guint n_chunks;
+	guint64 n_used;
+	guint64 n_used_peak;
+	guint64 n_allocated;
+	gsize bytes_reserved;
+	gsize bytes_used;
+} NMPObjectPoolStats;
+
+void nmp_object_pool_get_stats (NMPObjectType obj_type, NMPObjectPoolStats *out_stats);
+void nmp_object_pool_log_stats (NMLogLevel level);
+
 #define nm_auto_nmpobj __attribute__((cleanup(_nm_auto_nmpobj_cleanup)))
 static inline void
 _nm_auto_nmpobj_cleanup (NMPObject **pobj)
@@ -376,8 +412,6 @@ typedef gboolean (*NMPObjectMatchFn) (const NMPObject *obj, gpointer user_data);
 
 gboolean nmp_cache_id_equal (const NMPCacheId *a, const NMPCacheId *b);
 guint nmp_cache_id_hash (const NMPCacheId *id);
-NMPCacheId *nmp_cache_id_clone (const NMPCacheId *id);
-void nmp_cache_id_destroy (NMPCacheId *id);
 
 NMPCacheId *nmp_cache_id_init_object_type (NMPCacheId *id, NMPObjectType obj_type, gboolean visible_only);
 NMPCacheId *nmp_cache_id_init_addrroute_visible_by_ifindex (NMPCacheId *id, NMPObjectType obj_type, int ifindex);
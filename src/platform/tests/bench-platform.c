@@ -0,0 +1,402 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* bench-platform.c - Benchmark the platform cache and the NMPlatform API
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2016 Red Hat, Inc.
+ */
+
+/* Benchmarks for the hot paths of the platform layer. They are not run by
+ * "make check", run bench-platform-fake or bench-platform-linux manually.
+ *
+ * The number of objects can be set via the environment:
+ *
+ *   NMTST_BENCH_CACHE_LINKS, NMTST_BENCH_CACHE_ADDRESSES, NMTST_BENCH_CACHE_ROUTES:
+ *     the size of the NMPCache for the /bench/cache tests
+ *     (default 10000 links, 100000 addresses and 1000000 routes).
+ *
+ *   NMTST_BENCH_LINKS, NMTST_BENCH_ADDRESSES, NMTST_BENCH_ROUTES:
+ *     the number of objects created via NMPlatform for the /bench/platform
+ *     tests (default 100 links, 1000 addresses and 10000 routes). The fake
+ *     platform keeps its objects in plain arrays, so adding objects there
+ *     is quadratic.
+ *
+ * Each measurement prints the number of operations, the operations per
+ * second and the peak RSS of the process. */
+
+#include "config.h"
+
+#include <sys/resource.h>
+#include <linux/rtnetlink.h>
+
+#include "test-common.h"
+#include "nmp-object.h"
+#include "nm-route-manager.h"
+
+#define BENCH_IFNAME_PREFIX "nm-bench-"
+
+/*****************************************************************************/
+
+static guint
+_bench_size (const char *env_name, guint default_value)
+{
+	const char *s = g_getenv (env_name);
+
+	if (!s)
+		return default_value;
+	return _nm_utils_ascii_str_to_int64 (s, 10, 1, G_MAXINT32, default_value);
+}
+
+static void
+_bench_report (const char *name, guint64 n_ops, gint64 start_ns)
+{
+	gint64 duration_ns = nm_utils_get_monotonic_timestamp_ns () - start_ns;
+	struct rusage ru = { { 0 } };
+	double sec;
+
+	sec = MAX (duration_ns, 1) / (double) NM_UTILS_NS_PER_SECOND;
+	getrusage (RUSAGE_SELF, &ru);
+
+	g_print ("bench: %-36s %9" G_GUINT64_FORMAT " ops in %8.3f sec, %12.0f ops/sec, peak rss %ld KiB\n",
+	         name, n_ops, sec, n_ops / sec, (long) ru.ru_maxrss);
+}
+
+/*****************************************************************************/
+
+static NMPObject *
+_cache_obj_link (int ifindex)
+{
+	NMPlatformLink pl = {
+		.ifindex = ifindex,
+		.type = NM_LINK_TYPE_DUMMY,
+		.mtu = 1500,
+	};
+	NMPObject *obj;
+
+	g_snprintf (pl.name, sizeof (pl.name), BENCH_IFNAME_PREFIX "%d", ifindex);
+	obj = nmp_object_new (NMP_OBJECT_TYPE_LINK, (const NMPlatformObject *) &pl);
+	obj->_link.netlink.is_in_netlink = TRUE;
+	return obj;
+}
+
+static NMPObject *
+_cache_obj_ip4_address (int ifindex, guint i)
+{
+	NMPlatformIP4Address pl = {
+		.ifindex = ifindex,
+		.source = NM_IP_CONFIG_SOURCE_KERNEL,
+		.plen = 32,
+		.lifetime = NM_PLATFORM_LIFETIME_PERMANENT,
+		.preferred = NM_PLATFORM_LIFETIME_PERMANENT,
+	};
+
+	pl.address = htonl (0x0a000000 + i);
+	pl.peer_address = pl.address;
+	return nmp_object_new (NMP_OBJECT_TYPE_IP4_ADDRESS, (const NMPlatformObject *) &pl);
+}
+
+static NMPObject *
+_cache_obj_ip4_route (int ifindex, guint i, guint32 mss)
+{
+	NMPlatformIP4Route pl = {
+		.ifindex = ifindex,
+		.source = NM_IP_CONFIG_SOURCE_KERNEL,
+		.plen = 32,
+		.metric = 100,
+		.scope_inv = nm_platform_route_scope_inv (RT_SCOPE_LINK),
+	};
+
+	pl.network = htonl (0x0b000000 + i);
+	pl.mss = mss;
+	return nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &pl);
+}
+
+static void
+_cache_update (NMPCache *cache, NMPObject *obj, NMPCacheOpsType expected_ops_type)
+{
+	NMPCacheOpsType ops_type;
+
+	ops_type = nmp_cache_update_netlink (cache, obj, NULL, NULL, NULL, NULL);
+	g_assert_cmpint (ops_type, ==, expected_ops_type);
+	nmp_object_unref (obj);
+}
+
+static void
+test_bench_cache (void)
+{
+	const guint n_links = _bench_size ("NMTST_BENCH_CACHE_LINKS", 10000);
+	const guint n_addresses = _bench_size ("NMTST_BENCH_CACHE_ADDRESSES", 100000);
+	const guint n_routes = _bench_size ("NMTST_BENCH_CACHE_ROUTES", 1000000);
+	NMPCache *cache;
+	NMPObject obj_needle;
+	gint64 start_ns;
+	guint64 n;
+	guint i;
+
+	cache = nmp_cache_new ();
+
+	start_ns = nm_utils_get_monotonic_timestamp_ns ();
+	for (i = 0; i < n_links; i++)
+		_cache_update (cache, _cache_obj_link (i + 1), NMP_CACHE_OPS_ADDED);
+	_bench_report ("cache: update-netlink link (add)", n_links, start_ns);
+
+	start_ns = nm_utils_get_monotonic_timestamp_ns ();
+	for (i = 0; i < n_addresses; i++)
+		_cache_update (cache, _cache_obj_ip4_address ((i % n_links) + 1, i), NMP_CACHE_OPS_ADDED);
+	_bench_report ("cache: update-netlink ip4-address (add)", n_addresses, start_ns);
+
+	start_ns = nm_utils_get_monotonic_timestamp_ns ();
+	for (i = 0; i < n_routes; i++)
+		_cache_update (cache, _cache_obj_ip4_route ((i % n_links) + 1, i, 0), NMP_CACHE_OPS_ADDED);
+	_bench_report ("cache: update-netlink ip4-route (add)", n_routes, start_ns);
+
+	start_ns = nm_utils_get_monotonic_timestamp_ns ();
+	for (i = 0; i < n_routes; i++)
+		_cache_update (cache, _cache_obj_ip4_route ((i % n_links) + 1, i, 0), NMP_CACHE_OPS_UNCHANGED);
+	_bench_report ("cache: update-netlink ip4-route (same)", n_routes, start_ns);
+
+	start_ns = nm_utils_get_monotonic_timestamp_ns ();
+	for (i = 0; i < n_routes; i++)
+		_cache_update (cache, _cache_obj_ip4_route ((i % n_links) + 1, i, 1400), NMP_CACHE_OPS_UPDATED);
+	_bench_report ("cache: update-netlink ip4-route (change)", n_routes, start_ns);
+
+	start_ns = nm_utils_get_monotonic_timestamp_ns ();
+	n = 0;
+	for (i = 0; i < n_links; i++) {
+		NMPCacheId cache_id;
+		guint len;
+
+		nmp_cache_lookup_multi (cache,
+		                        nmp_cache_id_init_routes_visible (&cache_id, NMP_OBJECT_TYPE_IP4_ROUTE, TRUE, TRUE, i + 1),
+		                        &len);
+		n += len;
+	}
+	g_assert_cmpint (n, ==, n_routes);
+	_bench_report ("cache: lookup ip4-routes by ifindex", n_links, start_ns);
+
+	start_ns = nm_utils_get_monotonic_timestamp_ns ();
+	for (i = 0; i < n_routes; i++) {
+		NMPlatformIP4Route pl = {
+			.ifindex = (i % n_links) + 1,
+			.plen = 32,
+			.metric = 100,
+			.network = htonl (0x0b000000 + i),
+		};
+
+		nmp_object_stackinit (&obj_needle, NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &pl);
+		g_assert_cmpint (nmp_cache_remove_netlink (cache, &obj_needle, NULL, NULL, NULL, NULL), ==, NMP_CACHE_OPS_REMOVED);
+	}
+	_bench_report ("cache: remove-netlink ip4-route", n_routes, start_ns);
+
+	nmp_object_pool_log_stats (LOGL_INFO);
+	nmp_cache_free (cache);
+}
+
+/*****************************************************************************/
+
+static struct {
+	GArray *ifindexes;
+} bench_platform;
+
+static void
+_platform_links_create (guint n_links)
+{
+	gint64 start_ns;
+	guint i;
+
+	bench_platform.ifindexes = g_array_sized_new (FALSE, FALSE, sizeof (int), n_links);
+
+	start_ns = nm_utils_get_monotonic_timestamp_ns ();
+	for (i = 0; i < n_links; i++) {
+		char ifname[IFNAMSIZ];
+		const NMPlatformLink *plink = NULL;
+
+		g_snprintf (ifname, sizeof (ifname), BENCH_IFNAME_PREFIX "%u", i);
+		g_assert_cmpint (nm_platform_link_dummy_add (NM_PLATFORM_GET, ifname, &plink), ==, NM_PLATFORM_ERROR_SUCCESS);
+		g_assert (plink);
+		g_assert (nm_platform_link_set_up (NM_PLATFORM_GET, plink->ifindex, NULL));
+		g_array_append_val (bench_platform.ifindexes, plink->ifindex);
+	}
+	_bench_report ("platform: link add", n_links, start_ns);
+}
+
+static void
+_platform_links_delete (void)
+{
+	guint i;
+
+	for (i = 0; i < bench_platform.ifindexes->len; i++)
+		nm_platform_link_delete (NM_PLATFORM_GET, g_array_index (bench_platform.ifindexes, int, i));
+	g_array_unref (bench_platform.ifindexes);
+	bench_platform.ifindexes = NULL;
+}
+
+static GArray *
+_platform_known_addresses (guint first, guint n)
+{
+	GArray *known = g_array_sized_new (FALSE, TRUE, sizeof (NMPlatformIP4Address), n);
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		NMPlatformIP4Address a = { 0 };
+
+		a.address = htonl (0x0a000000 + first + i);
+		a.peer_address = a.address;
+		a.plen = 32;
+		a.timestamp = nm_utils_get_monotonic_timestamp_s ();
+		a.lifetime = NM_PLATFORM_LIFETIME_PERMANENT;
+		a.preferred = NM_PLATFORM_LIFETIME_PERMANENT;
+		g_array_append_val (known, a);
+	}
+	return known;
+}
+
+static GArray *
+_platform_known_routes (int ifindex, guint first, guint n)
+{
+	GArray *known = g_array_sized_new (FALSE, TRUE, sizeof (NMPlatformIP4Route), n);
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		NMPlatformIP4Route r = { 0 };
+
+		r.ifindex = ifindex;
+		r.source = NM_IP_CONFIG_SOURCE_USER;
+		r.network = htonl (0x0b000000 + first + i);
+		r.plen = 32;
+		r.metric = 100;
+		g_array_append_val (known, r);
+	}
+	return known;
+}
+
+static void
+test_bench_platform (void)
+{
+	const guint n_links = _bench_size ("NMTST_BENCH_LINKS", 100);
+	const guint n_addresses = _bench_size ("NMTST_BENCH_ADDRESSES", 1000);
+	const guint n_routes = _bench_size ("NMTST_BENCH_ROUTES", 10000);
+	const guint n_addresses_per_link = MAX (n_addresses / n_links, 1u);
+	const guint n_routes_per_link = MAX (n_routes / n_links, 1u);
+	GPtrArray *known_addresses;
+	GPtrArray *known_routes;
+	gint64 start_ns;
+	guint64 n;
+	guint i, pass;
+
+	_platform_links_create (n_links);
+
+	known_addresses = g_ptr_array_new_with_free_func ((GDestroyNotify) g_array_unref);
+	known_routes = g_ptr_array_new_with_free_func ((GDestroyNotify) g_array_unref);
+	for (i = 0; i < n_links; i++) {
+		int ifindex = g_array_index (bench_platform.ifindexes, int, i);
+
+		g_ptr_array_add (known_addresses, _platform_known_addresses (i * n_addresses_per_link, n_addresses_per_link));
+		g_ptr_array_add (known_routes, _platform_known_routes (ifindex, i * n_routes_per_link, n_routes_per_link));
+	}
+
+	/* the first pass adds the objects, the second finds them unchanged. */
+	for (pass = 0; pass < 2; pass++) {
+		start_ns = nm_utils_get_monotonic_timestamp_ns ();
+		for (i = 0; i < n_links; i++) {
+			g_assert (nm_platform_ip4_address_sync (NM_PLATFORM_GET,
+			                                        g_array_index (bench_platform.ifindexes, int, i),
+			                                        known_addresses->pdata[i],
+			                                        NULL));
+		}
+		_bench_report (pass == 0
+		                   ? "platform: ip4-address-sync (add)"
+		                   : "platform: ip4-address-sync (same)",
+		               (guint64) n_links * n_addresses_per_link, start_ns);
+	}
+
+	for (pass = 0; pass < 2; pass++) {
+		start_ns = nm_utils_get_monotonic_timestamp_ns ();
+		for (i = 0; i < n_links; i++) {
+			g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (),
+			                                           g_array_index (bench_platform.ifindexes, int, i),
+			                                           known_routes->pdata[i],
+			                                           TRUE,
+			                                           TRUE));
+		}
+		_bench_report (pass == 0
+		                   ? "route-manager: ip4-route-sync (add)"
+		                   : "route-manager: ip4-route-sync (same)",
+		               (guint64) n_links * n_routes_per_link, start_ns);
+	}
+
+	start_ns = nm_utils_get_monotonic_timestamp_ns ();
+	for (i = 0; i < 100; i++) {
+		gs_unref_array GArray *links = nm_platform_link_get_all (NM_PLATFORM_GET);
+
+		g_assert_cmpint (links->len, >=, n_links);
+	}
+	_bench_report ("platform: link-get-all", 100, start_ns);
+
+	start_ns = nm_utils_get_monotonic_timestamp_ns ();
+	n = 0;
+	for (i = 0; i < n_links; i++) {
+		gs_unref_array GArray *addresses = NULL;
+
+		addresses = nm_platform_ip4_address_get_all (NM_PLATFORM_GET, g_array_index (bench_platform.ifindexes, int, i));
+		n += addresses->len;
+	}
+	g_assert_cmpint (n, >=, (guint64) n_links * n_addresses_per_link);
+	_bench_report ("platform: ip4-address-get-all", n_links, start_ns);
+
+	start_ns = nm_utils_get_monotonic_timestamp_ns ();
+	n = 0;
+	for (i = 0; i < n_links; i++) {
+		gs_unref_array GArray *routes = NULL;
+
+		routes = nm_platform_ip4_route_get_all (NM_PLATFORM_GET,
+		                                        g_array_index (bench_platform.ifindexes, int, i),
+		                                        NM_PLATFORM_GET_ROUTE_FLAGS_WITH_DEFAULT | NM_PLATFORM_GET_ROUTE_FLAGS_WITH_NON_DEFAULT);
+		n += routes->len;
+	}
+	g_assert_cmpint (n, >=, (guint64) n_links * n_routes_per_link);
+	_bench_report ("platform: ip4-route-get-all", n_links, start_ns);
+
+	start_ns = nm_utils_get_monotonic_timestamp_ns ();
+	for (i = 0; i < n_links; i++) {
+		g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (),
+		                                           g_array_index (bench_platform.ifindexes, int, i),
+		                                           NULL,
+		                                           TRUE,
+		                                           TRUE));
+	}
+	_bench_report ("route-manager: ip4-route-sync (delete)", (guint64) n_links * n_routes_per_link, start_ns);
+
+	nm_platform_stats_log (NM_PLATFORM_GET, LOGL_INFO);
+
+	g_ptr_array_unref (known_addresses);
+	g_ptr_array_unref (known_routes);
+	_platform_links_delete ();
+}
+
+/*****************************************************************************/
+
+void
+init_tests (int *argc, char ***argv)
+{
+	nmtst_init_with_logging (argc, argv, "INFO", "PLATFORM");
+}
+
+void
+setup_tests (void)
+{
+	g_test_add_func ("/bench/cache", test_bench_cache);
+	g_test_add_func ("/bench/platform", test_bench_platform);
+}
@@ -332,6 +332,161 @@ test_ip4_address_peer_zero (void)
 
 /*****************************************************************************/
 
+static void
+test_ip4_address_batch (void)
+{
+	const int ifindex = DEVICE_IFINDEX;
+	NMPlatformBatch *batch;
+	guint32 lifetime = 2000;
+	guint32 preferred = 1000;
+	const int plen = 24;
+	guint idx[50];
+	const guint n = G_N_ELEMENTS (idx);
+	in_addr_t addr;
+	GArray *addrs;
+	guint i;
+
+	g_assert (ifindex > 0);
+	g_assert (nm_platform_link_set_up (NM_PLATFORM_GET, ifindex, NULL));
+
+	batch = nm_platform_batch_new (NM_PLATFORM_GET);
+	for (i = 0; i < n; i++) {
+		addr = nmtst_inet4_from_string ("192.168.7.0") + htonl (i + 1);
+		idx[i] = nm_platform_batch_ip4_address_add (batch, ifindex, addr, plen, addr, lifetime, preferred, NULL);
+		g_assert_cmpint (idx[i], ==, i);
+	}
+	g_assert_cmpint (nm_platform_batch_get_len (batch), ==, n);
+	g_assert (nm_platform_batch_commit (batch));
+	for (i = 0; i < n; i++)
+		g_assert (nm_platform_batch_get_result (batch, idx[i]));
+	nm_platform_batch_free (batch);
+
+	addrs = nm_platform_ip4_address_get_all (NM_PLATFORM_GET, ifindex);
+	g_assert_cmpint (addrs->len, ==, n);
+	g_array_unref (addrs);
+
+	batch = nm_platform_batch_new (NM_PLATFORM_GET);
+	for (i = 0; i < n; i++) {
+		addr = nmtst_inet4_from_string ("192.168.7.0") + htonl (i + 1);
+		nm_platform_batch_ip4_address_delete (batch, ifindex, addr, plen, addr);
+	}
+	g_assert (nm_platform_batch_commit (batch));
+	nm_platform_batch_free (batch);
+
+	for (i = 0; i < n; i++) {
+		addr = nmtst_inet4_from_string ("192.168.7.0") + htonl (i + 1);
+		g_assert (!nm_platform_ip4_address_get (NM_PLATFORM_GET, ifindex, addr, plen, addr));
+	}
+}
+
+static void
+test_ip4_address_sync (void)
+{
+	const int ifindex = DEVICE_IFINDEX;
+	const NMPlatformAddressSyncStats *stats;
+	NMPlatformAddressSyncStats before;
+	gs_unref_array GArray *known = NULL;
+	GArray *addrs;
+	const guint n = 200;
+	guint i;
+
+	g_assert (ifindex > 0);
+	g_assert (nm_platform_link_set_up (NM_PLATFORM_GET, ifindex, NULL));
+
+	known = g_array_new (FALSE, TRUE, sizeof (NMPlatformIP4Address));
+	for (i = 0; i < n; i++) {
+		NMPlatformIP4Address a = { 0 };
+
+		a.address = nmtst_inet4_from_string ("10.7.0.0") + htonl (i + 1);
+		a.peer_address = a.address;
+		a.plen = 32;
+		a.timestamp = nm_utils_get_monotonic_timestamp_s ();
+		a.lifetime = 2000;
+		a.preferred = 1000;
+		g_array_append_val (known, a);
+	}
+
+	stats = nm_platform_address_sync_get_stats (NM_PLATFORM_GET);
+
+	before = *stats;
+	g_assert (nm_platform_ip4_address_sync (NM_PLATFORM_GET, ifindex, known, NULL));
+	g_assert_cmpint (stats->added - before.added, ==, n);
+	g_assert_cmpint (stats->unchanged - before.unchanged, ==, 0);
+
+	/* syncing again must not touch the addresses. */
+	before = *stats;
+	g_assert (nm_platform_ip4_address_sync (NM_PLATFORM_GET, ifindex, known, NULL));
+	g_assert_cmpint (stats->added - before.added, ==, 0);
+	g_assert_cmpint (stats->refreshed - before.refreshed, ==, 0);
+	g_assert_cmpint (stats->deleted - before.deleted, ==, 0);
+	g_assert_cmpint (stats->unchanged - before.unchanged, ==, n);
+
+	/* a renewed lease refreshes the lifetime, a dropped address is deleted. */
+	g_array_index (known, NMPlatformIP4Address, 0).lifetime = 4000;
+	g_array_remove_index (known, n - 1);
+	before = *stats;
+	g_assert (nm_platform_ip4_address_sync (NM_PLATFORM_GET, ifindex, known, NULL));
+	g_assert_cmpint (stats->refreshed - before.refreshed, ==, 1);
+	g_assert_cmpint (stats->deleted - before.deleted, ==, 1);
+	g_assert_cmpint (stats->unchanged - before.unchanged, ==, n - 2);
+
+	addrs = nm_platform_ip4_address_get_all (NM_PLATFORM_GET, ifindex);
+	g_assert_cmpint (addrs->len, ==, n - 1);
+	g_array_unref (addrs);
+
+	g_assert (nm_platform_ip4_address_sync (NM_PLATFORM_GET, ifindex, NULL, NULL));
+	addrs = nm_platform_ip4_address_get_all (NM_PLATFORM_GET, ifindex);
+	g_assert_cmpint (addrs->len, ==, 0);
+	g_array_unref (addrs);
+}
+
+/* A failed add doesn't stop the sync. The other addresses are added and
+ * the sync reports the failure. */
+static void
+test_ip4_address_sync_failure (void)
+{
+	const int ifindex = DEVICE_IFINDEX;
+	gs_unref_array GArray *known = NULL;
+	gs_unref_ptrarray GPtrArray *added = NULL;
+	GArray *addrs;
+	guint i;
+
+	g_assert (ifindex > 0);
+	g_assert (nm_platform_link_set_up (NM_PLATFORM_GET, ifindex, NULL));
+
+	known = g_array_new (FALSE, TRUE, sizeof (NMPlatformIP4Address));
+	for (i = 0; i < 3; i++) {
+		NMPlatformIP4Address a = { 0 };
+
+		a.address = nmtst_inet4_from_string ("10.8.0.0") + htonl (i + 1);
+		a.peer_address = a.address;
+		/* the kernel rejects a prefix length larger than 32. */
+		a.plen = i == 1 ? 33 : 32;
+		a.timestamp = nm_utils_get_monotonic_timestamp_s ();
+		a.lifetime = 2000;
+		a.preferred = 1000;
+		g_array_append_val (known, a);
+	}
+
+	g_assert (!nm_platform_ip4_address_sync (NM_PLATFORM_GET, ifindex, known, &added));
+
+	g_assert (added);
+	g_assert_cmpint (added->len, ==, 2);
+	g_assert (added->pdata[0] == &g_array_index (known, NMPlatformIP4Address, 0));
+	g_assert (added->pdata[1] == &g_array_index (known, NMPlatformIP4Address, 2));
+
+	addrs = nm_platform_ip4_address_get_all (NM_PLATFORM_GET, ifindex);
+	g_assert_cmpint (addrs->len, ==, 2);
+	g_array_unref (addrs);
+	g_assert (nm_platform_ip4_address_get (NM_PLATFORM_GET, ifindex,
+	                                       g_array_index (known, NMPlatformIP4Address, 2).address, 32,
+	                                       g_array_index (known, NMPlatformIP4Address, 2).address));
+
+	g_assert (nm_platform_ip4_address_sync (NM_PLATFORM_GET, ifindex, NULL, NULL));
+}
+
+/*****************************************************************************/
+
 void
 init_tests (int *argc, char ***argv)
 {
@@ -400,4 +555,8 @@ setup_tests (void)
 
 	_g_test_add_func ("/address/ipv4/peer", test_ip4_address_peer);
 	_g_test_add_func ("/address/ipv4/peer/zero", test_ip4_address_peer_zero);
+
+	_g_test_add_func ("/address/ipv4/batch", test_ip4_address_batch);
+	_g_test_add_func ("/address/ipv4/sync", test_ip4_address_sync);
+	_g_test_add_func ("/address/ipv4/sync/failure", test_ip4_address_sync_failure);
 }
@@ -53,6 +53,44 @@ test_link_get_all (void)
 
 /******************************************************************/
 
+static void
+test_stats_duration (void)
+{
+	NMPlatformStatsDuration d = { 0 };
+
+	nm_platform_stats_duration_add (&d, 500 * 1000);
+	nm_platform_stats_duration_add (&d, 3 * NM_UTILS_NS_PER_SECOND / 1000);
+	nm_platform_stats_duration_add (&d, 100 * NM_UTILS_NS_PER_SECOND);
+
+	g_assert_cmpint (d.count, ==, 3);
+	g_assert_cmpint (d.max_usec, ==, 100 * G_USEC_PER_SEC);
+	g_assert_cmpint (d.buckets[0], ==, 1);
+	g_assert_cmpint (d.buckets[2], ==, 1);
+	g_assert_cmpint (d.buckets[NM_PLATFORM_STATS_DURATION_BUCKETS - 1], ==, 1);
+}
+
+static void
+test_stats (void)
+{
+	gs_unref_object NMPlatform *platform = NULL;
+	gs_unref_array GArray *links = NULL;
+	NMPlatformStats stats;
+
+	platform = g_object_new (NM_TYPE_LINUX_PLATFORM, NULL);
+
+	links = nm_platform_link_get_all (platform);
+	nm_platform_get_stats (platform, &stats);
+
+	/* there is at least the loopback device. */
+	g_assert_cmpint (stats.netlink_msgs[NM_PLATFORM_STATS_MSG_NEWLINK], >, 0);
+	g_assert_cmpint (stats.cache_objs[NMP_OBJECT_TYPE_LINK], >, 0);
+	g_assert_cmpint (stats.cache_bytes[NMP_OBJECT_TYPE_LINK], >, 0);
+	g_assert_cmpint (stats.dumps.count, >, 0);
+	g_assert_cmpint (stats.delayed_actions, >, 0);
+}
+
+/******************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -62,6 +100,8 @@ main (int argc, char **argv)
 
 	g_test_add_func ("/general/init_linux_platform", test_init_linux_platform);
 	g_test_add_func ("/general/link_get_all", test_link_get_all);
+	g_test_add_func ("/general/stats/duration", test_stats_duration);
+	g_test_add_func ("/general/stats", test_stats);
 
 	return g_test_run ();
 }
@@ -1818,6 +1818,166 @@ again:
 	nmtstp_link_del (-1, ifindex_dummy0, IFACE_DUMMY0);
 }
 
+static void
+test_sysctl_ifindex (void)
+{
+	const char *IFACE_DUMMY0 = "nm-test-dummy0";
+	const char *IFACE_DUMMY1 = "nm-test-dummy1";
+	static const NMPlatformSysctlSetting settings[] = {
+		{ "accept_ra",    "0" },
+		{ "use_tempaddr", "2" },
+	};
+	int ifindex;
+	char *value;
+
+	nmtstp_run_command_check ("ip link add %s type dummy", IFACE_DUMMY0);
+	ifindex = nmtstp_assert_wait_for_link (IFACE_DUMMY0, NM_LINK_TYPE_DUMMY, 100)->ifindex;
+
+	g_assert (nm_platform_sysctl_ifindex_set_many (NM_PLATFORM_GET, ifindex, NM_PLATFORM_SYSCTL_DIR_IP6_CONF,
+	                                               settings, G_N_ELEMENTS (settings)));
+	value = nm_platform_sysctl_ifindex_get (NM_PLATFORM_GET, ifindex, NM_PLATFORM_SYSCTL_DIR_IP6_CONF, "use_tempaddr");
+	g_assert_cmpstr (value, ==, "2");
+	g_free (value);
+
+	/* applying the same values again is a no-op. */
+	g_assert (nm_platform_sysctl_ifindex_set_many (NM_PLATFORM_GET, ifindex, NM_PLATFORM_SYSCTL_DIR_IP6_CONF,
+	                                               settings, G_N_ELEMENTS (settings)));
+
+	/* after a rename, the directory of the interface must be looked up again. */
+	nmtstp_run_command_check ("ip link set %s name %s", IFACE_DUMMY0, IFACE_DUMMY1);
+	g_assert_cmpint (nmtstp_assert_wait_for_link (IFACE_DUMMY1, NM_LINK_TYPE_DUMMY, 100)->ifindex, ==, ifindex);
+
+	g_assert (nm_platform_sysctl_ifindex_set (NM_PLATFORM_GET, ifindex, NM_PLATFORM_SYSCTL_DIR_IP6_CONF, "accept_ra", "1"));
+	value = nm_platform_sysctl_get (NM_PLATFORM_GET, nm_utils_ip6_property_path (IFACE_DUMMY1, "accept_ra"));
+	g_assert_cmpstr (value, ==, "1");
+	g_free (value);
+
+	value = nm_platform_sysctl_ifindex_get (NM_PLATFORM_GET, ifindex, NM_PLATFORM_SYSCTL_DIR_SYSFS, "ifindex");
+	g_assert_cmpint (_nm_utils_ascii_str_to_int64 (value, 10, 0, G_MAXINT, -1), ==, ifindex);
+	g_free (value);
+
+	nmtstp_link_del (-1, ifindex, IFACE_DUMMY1);
+
+	g_assert (!nm_platform_sysctl_ifindex_get (NM_PLATFORM_GET, ifindex, NM_PLATFORM_SYSCTL_DIR_IP6_CONF, "accept_ra"));
+}
+
+static void
+test_bond_change (void)
+{
+	const char *IFACE_BOND0 = "nm-test-bond0";
+	NMPlatformLnkBond props = { 0 };
+	const NMPlatformLnkBond *lnk;
+	int ifindex;
+
+	nmtstp_run_command_check ("ip link add %s type bond", IFACE_BOND0);
+	ifindex = nmtstp_assert_wait_for_link (IFACE_BOND0, NM_LINK_TYPE_BOND, 100)->ifindex;
+
+	if (!nm_platform_link_get_lnk_bond (NM_PLATFORM_GET, ifindex, NULL)) {
+		g_test_skip ("Skipping test for bond options: kernel does not report them via netlink");
+		goto out;
+	}
+
+	props.mode = 1; /* active-backup */
+	props.miimon = 200;
+	props.updelay = 400;
+	props.use_carrier = TRUE;
+	props.resend_igmp = 3;
+	g_assert (nm_platform_link_bond_change (NM_PLATFORM_GET, ifindex, &props,
+	                                          NM_PLATFORM_LNK_BOND_ATTR_MODE
+	                                        | NM_PLATFORM_LNK_BOND_ATTR_MIIMON
+	                                        | NM_PLATFORM_LNK_BOND_ATTR_UPDELAY
+	                                        | NM_PLATFORM_LNK_BOND_ATTR_USE_CARRIER
+	                                        | NM_PLATFORM_LNK_BOND_ATTR_RESEND_IGMP));
+
+	lnk = nm_platform_link_get_lnk_bond (NM_PLATFORM_GET, ifindex, NULL);
+	g_assert (lnk);
+	g_assert_cmpint (lnk->mode, ==, 1);
+	g_assert_cmpint (lnk->miimon, ==, 200);
+	g_assert_cmpint (lnk->updelay, ==, 400);
+	g_assert_cmpint (lnk->resend_igmp, ==, 3);
+	g_assert (lnk->use_carrier);
+
+	/* switch to ARP monitoring, which clears miimon. */
+	props = *lnk;
+	props.arp_interval = 1000;
+	props.num_arp_ip_targets = 2;
+	props.arp_ip_targets[0] = nmtst_inet4_from_string ("192.168.5.1");
+	props.arp_ip_targets[1] = nmtst_inet4_from_string ("192.168.5.2");
+	g_assert (nm_platform_link_bond_change (NM_PLATFORM_GET, ifindex, &props,
+	                                          NM_PLATFORM_LNK_BOND_ATTR_ARP_INTERVAL
+	                                        | NM_PLATFORM_LNK_BOND_ATTR_ARP_IP_TARGETS));
+
+	lnk = nm_platform_link_get_lnk_bond (NM_PLATFORM_GET, ifindex, NULL);
+	g_assert (lnk);
+	g_assert_cmpint (lnk->miimon, ==, 0);
+	g_assert_cmpint (lnk->arp_interval, ==, 1000);
+	g_assert_cmpint (lnk->num_arp_ip_targets, ==, 2);
+	g_assert_cmpint (lnk->arp_ip_targets[1], ==, nmtst_inet4_from_string ("192.168.5.2"));
+
+	/* setting the same options again doesn't send a request. */
+	props = *lnk;
+	g_assert (nm_platform_link_bond_change (NM_PLATFORM_GET, ifindex, &props,
+	                                          NM_PLATFORM_LNK_BOND_ATTR_MODE
+	                                        | NM_PLATFORM_LNK_BOND_ATTR_ARP_INTERVAL
+	                                        | NM_PLATFORM_LNK_BOND_ATTR_ARP_IP_TARGETS));
+
+out:
+	nmtstp_link_del (-1, ifindex, IFACE_BOND0);
+}
+
+static void
+test_bridge_change (void)
+{
+	const char *IFACE_BRIDGE0 = "nm-test-bridge0";
+	const char *IFACE_DUMMY0 = "nm-test-dummy0";
+	NMPlatformLnkBridge props;
+	NMPlatformBridgePort port = { 0 };
+	const NMPlatformLnkBridge *lnk;
+	int ifindex, ifindex_dummy0;
+	char *value;
+
+	nmtstp_run_command_check ("ip link add %s type bridge", IFACE_BRIDGE0);
+	ifindex = nmtstp_assert_wait_for_link (IFACE_BRIDGE0, NM_LINK_TYPE_BRIDGE, 100)->ifindex;
+	nmtstp_run_command_check ("ip link add %s type dummy", IFACE_DUMMY0);
+	ifindex_dummy0 = nmtstp_assert_wait_for_link (IFACE_DUMMY0, NM_LINK_TYPE_DUMMY, 100)->ifindex;
+
+	lnk = nm_platform_link_get_lnk_bridge (NM_PLATFORM_GET, ifindex, NULL);
+	if (!lnk) {
+		g_test_skip ("Skipping test for bridge options: kernel does not report them via netlink");
+		goto out;
+	}
+
+	props = *lnk;
+	props.priority = 0x1000;
+	props.forward_delay = 1000;
+	props.ageing_time = 20000;
+	props.mcast_snooping = !lnk->mcast_snooping;
+	g_assert (nm_platform_link_bridge_change (NM_PLATFORM_GET, ifindex, &props));
+
+	lnk = nm_platform_link_get_lnk_bridge (NM_PLATFORM_GET, ifindex, NULL);
+	g_assert (lnk);
+	g_assert_cmpint (nm_platform_lnk_bridge_cmp (lnk, &props), ==, 0);
+
+	nmtstp_run_command_check ("ip link set %s master %s", IFACE_DUMMY0, IFACE_BRIDGE0);
+	nmtstp_assert_wait_for_link (IFACE_DUMMY0, NM_LINK_TYPE_DUMMY, 100);
+
+	port.priority = 7;
+	port.path_cost = 42;
+	port.hairpin_mode = TRUE;
+	g_assert (nm_platform_link_bridge_port_change (NM_PLATFORM_GET, ifindex_dummy0, &port));
+
+	value = nm_platform_sysctl_slave_get_option (NM_PLATFORM_GET, ifindex_dummy0, "path_cost");
+	g_assert_cmpstr (value, ==, "42");
+	g_free (value);
+	value = nm_platform_sysctl_slave_get_option (NM_PLATFORM_GET, ifindex_dummy0, "hairpin_mode");
+	g_assert_cmpstr (value, ==, "1");
+	g_free (value);
+
+out:
+	nmtstp_link_del (-1, ifindex_dummy0, IFACE_DUMMY0);
+	nmtstp_link_del (-1, ifindex, IFACE_BRIDGE0);
+}
+
 /*****************************************************************************/
 
 void
@@ -1866,5 +2026,9 @@ setup_tests (void)
 		g_test_add_func ("/link/nl-bugs/veth", test_nl_bugs_veth);
 		g_test_add_func ("/link/nl-bugs/spurious-newlink", test_nl_bugs_spuroius_newlink);
 		g_test_add_func ("/link/nl-bugs/spurious-dellink", test_nl_bugs_spuroius_dellink);
+
+		g_test_add_func ("/link/sysctl-ifindex", test_sysctl_ifindex);
+		g_test_add_func ("/link/software/bond/change", test_bond_change);
+		g_test_add_func ("/link/software/bridge/change", test_bridge_change);
 	}
 }
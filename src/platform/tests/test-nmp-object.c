@@ -386,6 +386,68 @@ test_cache_link (void)
 
 /******************************************************************/
 
+static void
+test_pool (void)
+{
+	const guint N = 100000;
+	NMPObjectPoolStats stats0, stats;
+	gs_free NMPObject **objs = g_new (NMPObject *, N);
+	NMPlatformIP4Route r = {
+		.ifindex = 2,
+		.plen = 32,
+		.source = NM_IP_CONFIG_SOURCE_KERNEL,
+	};
+	guint i;
+	gdouble elapsed;
+
+	nmp_object_pool_get_stats (NMP_OBJECT_TYPE_IP4_ROUTE, &stats0);
+	g_assert_cmpint (stats0.obj_size, >=, sizeof (NMPlatformIP4Route));
+
+	g_test_timer_start ();
+	for (i = 0; i < N; i++) {
+		r.network = htonl (0x0a000000 + i);
+		r.metric = i % 7;
+		objs[i] = nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &r);
+	}
+	elapsed = g_test_timer_elapsed ();
+
+	nmp_object_pool_get_stats (NMP_OBJECT_TYPE_IP4_ROUTE, &stats);
+	g_test_message ("allocated %u routes in %.3f msec: %" G_GSIZE_FORMAT " bytes in %u chunks",
+	                N, elapsed * 1000, stats.bytes_reserved, stats.n_chunks);
+	g_assert_cmpint (stats.n_used, ==, stats0.n_used + N);
+	g_assert_cmpint (stats.n_allocated, ==, stats0.n_allocated + N);
+	g_assert_cmpint (stats.n_used_peak, >=, stats.n_used);
+	g_assert_cmpint (stats.bytes_used, ==, stats.n_used * stats.obj_size);
+	/* the overhead of the pool must stay below 5% */
+	g_assert_cmpint (stats.bytes_reserved - stats0.bytes_reserved, <=, ((guint64) N) * stats.obj_size * 105 / 100 + 64 * 1024);
+
+	for (i = 0; i < N; i++) {
+		g_assert_cmpint (objs[i]->ip4_route.network, ==, htonl (0x0a000000 + i));
+		g_assert (objs[i]->is_cached == FALSE);
+	}
+
+	/* release in an interleaved order to exercise the free lists. */
+	for (i = 0; i < N; i += 2)
+		nmp_object_unref (objs[i]);
+	nmp_object_pool_get_stats (NMP_OBJECT_TYPE_IP4_ROUTE, &stats);
+	g_assert_cmpint (stats.n_used, ==, stats0.n_used + N / 2);
+
+	/* reallocation reuses the freed slots. */
+	for (i = 0; i < N; i += 2)
+		objs[i] = nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &r);
+	nmp_object_pool_get_stats (NMP_OBJECT_TYPE_IP4_ROUTE, &stats);
+	g_assert_cmpint (stats.n_chunks, <=, stats0.n_chunks + (N * stats.obj_size) / (64 * 1024) + 2);
+
+	for (i = 0; i < N; i++)
+		nmp_object_unref (objs[i]);
+
+	nmp_object_pool_get_stats (NMP_OBJECT_TYPE_IP4_ROUTE, &stats);
+	g_assert_cmpint (stats.n_used, ==, stats0.n_used);
+	g_assert_cmpint (stats.n_chunks, <=, stats0.n_chunks + 1);
+}
+
+/******************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -412,6 +474,7 @@ main (int argc, char **argv)
 	}
 
 	g_test_add_func ("/nmp-object/cache_link", test_cache_link);
+	g_test_add_func ("/nmp-object/pool", test_pool);
 
 	result = g_test_run ();
 
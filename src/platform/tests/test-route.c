@@ -284,6 +284,85 @@ test_ip6_route (void)
 
 /*****************************************************************************/
 
+typedef struct {
+	GMainLoop *loop;
+	int ifindex;
+	guint n_emitted;
+	guint n_added;
+	guint n_removed;
+	guint n_ifindex;
+} ChangesData;
+
+static void
+_count_ip4_routes (GArray *routes, int ifindex, guint *counter)
+{
+	guint i;
+
+	for (i = 0; routes && i < routes->len; i++) {
+		if (g_array_index (routes, NMPlatformIP4Route, i).ifindex == ifindex)
+			(*counter)++;
+	}
+}
+
+static void
+ip4_route_changes_callback (NMPlatform *platform, const NMPlatformChanges *changes, ChangesData *data)
+{
+	const NMPlatformChange *ifindex_changes;
+	guint i, len;
+
+	g_assert (changes);
+	g_assert_cmpint (changes->n_changes, >, 0);
+
+	data->n_emitted++;
+	_count_ip4_routes (changes->objs[NM_PLATFORM_SIGNAL_ID_IP4_ROUTE][NM_PLATFORM_SIGNAL_ADDED], data->ifindex, &data->n_added);
+	_count_ip4_routes (changes->objs[NM_PLATFORM_SIGNAL_ID_IP4_ROUTE][NM_PLATFORM_SIGNAL_REMOVED], data->ifindex, &data->n_removed);
+
+	/* link changes are not collected. */
+	for (i = 0; i <= NM_PLATFORM_SIGNAL_REMOVED; i++)
+		g_assert (!changes->objs[NM_PLATFORM_SIGNAL_ID_LINK][i]);
+
+	ifindex_changes = nm_platform_changes_lookup_ifindex (changes, data->ifindex, &len);
+	for (i = 0; i < len; i++) {
+		g_assert_cmpint (nm_platform_changes_get_object (changes, &ifindex_changes[i])->ifindex, ==, data->ifindex);
+		if (ifindex_changes[i].signal_id == NM_PLATFORM_SIGNAL_ID_IP4_ROUTE)
+			data->n_ifindex++;
+	}
+	g_main_loop_quit (data->loop);
+}
+
+static void
+test_ip4_route_changes (void)
+{
+	ChangesData data = { 0 };
+	gulong id;
+	in_addr_t gateway = nmtst_inet4_from_string ("198.51.100.1");
+	int metric = 22987;
+
+	data.ifindex = nm_platform_link_get_ifindex (NM_PLATFORM_GET, DEVICE_NAME);
+	data.loop = g_main_loop_new (NULL, FALSE);
+	id = g_signal_connect (NM_PLATFORM_GET, NM_PLATFORM_SIGNAL_CHANGES, G_CALLBACK (ip4_route_changes_callback), &data);
+
+	/* both routes are reported together, in one emission. */
+	g_assert (nm_platform_ip4_route_add (NM_PLATFORM_GET, data.ifindex, NM_IP_CONFIG_SOURCE_USER, gateway, 32, INADDR_ANY, 0, metric, 0));
+	g_assert (nm_platform_ip4_route_add (NM_PLATFORM_GET, data.ifindex, NM_IP_CONFIG_SOURCE_USER, nmtst_inet4_from_string ("192.0.4.0"), 24, gateway, 0, metric, 0));
+	g_assert (nmtst_main_loop_run (data.loop, 2000));
+	g_assert_cmpint (data.n_emitted, ==, 1);
+	g_assert_cmpint (data.n_added, ==, 2);
+	g_assert_cmpint (data.n_ifindex, ==, data.n_added + data.n_removed);
+
+	g_assert (nm_platform_ip4_route_delete (NM_PLATFORM_GET, data.ifindex, nmtst_inet4_from_string ("192.0.4.0"), 24, metric));
+	g_assert (nm_platform_ip4_route_delete (NM_PLATFORM_GET, data.ifindex, gateway, 32, metric));
+	g_assert (nmtst_main_loop_run (data.loop, 2000));
+	g_assert_cmpint (data.n_emitted, ==, 2);
+	g_assert_cmpint (data.n_removed, ==, 2);
+	g_assert_cmpint (data.n_ifindex, ==, data.n_added + data.n_removed);
+
+	g_signal_handler_disconnect (NM_PLATFORM_GET, id);
+	g_main_loop_unref (data.loop);
+}
+
+/*****************************************************************************/
+
 static void
 test_ip4_zero_gateway (void)
 {
@@ -329,6 +408,7 @@ setup_tests (void)
 	g_test_add_func ("/route/ip4", test_ip4_route);
 	g_test_add_func ("/route/ip6", test_ip6_route);
 	g_test_add_func ("/route/ip4_metric0", test_ip4_route_metric0);
+	g_test_add_func ("/route/ip4_changes", test_ip4_route_changes);
 
 	if (nmtstp_is_root_test ())
 		g_test_add_func ("/route/ip4_zero_gateway", test_ip4_zero_gateway);
@@ -33,6 +33,7 @@
 #include "NetworkManagerUtils.h"
 #include "nm-core-internal.h"
 #include "nm-audit-manager.h"
+#include "nm-settings-state-db.h"
 
 #include "nmdbus-settings-connection.h"
 
@@ -78,6 +79,7 @@ enum {
 	PROP_READY,
 	PROP_FLAGS,
 	PROP_FILENAME,
+	PROP_TIMESTAMP,
 };
 
 enum {
@@ -697,40 +699,32 @@ nm_settings_connection_delete (NMSettingsConnection *self,
 	}
 }
 
-static void
-remove_entry_from_db (NMSettingsConnection *self, const char* db_name)
+static NMSettingsStateDB *
+_get_state_db (const char *db_name)
 {
-	GKeyFile *key_file;
-	const char *db_file;
-
-	if (strcmp (db_name, "timestamps") == 0)
-		db_file = SETTINGS_TIMESTAMPS_FILE;
-	else if (strcmp (db_name, "seen-bssids") == 0)
-		db_file = SETTINGS_SEEN_BSSIDS_FILE;
-	else
-		return;
-
-	key_file = g_key_file_new ();
-	if (g_key_file_load_from_file (key_file, db_file, G_KEY_FILE_KEEP_COMMENTS, NULL)) {
-		const char *connection_uuid;
-		char *data;
-		gsize len;
-		GError *error = NULL;
-
-		connection_uuid = nm_settings_connection_get_uuid (self);
+	static NMSettingsStateDB *timestamps_db = NULL;
+	static NMSettingsStateDB *seen_bssids_db = NULL;
 
-		g_key_file_remove_key (key_file, db_name, connection_uuid, NULL);
-		data = g_key_file_to_data (key_file, &len, &error);
-		if (data) {
-			g_file_set_contents (db_file, data, len, &error);
-			g_free (data);
-		}
-		if (error) {
-			_LOGW ("error writing %s file '%s': %s", db_name, db_file, error->message);
-			g_error_free (error);
-		}
+	/* The databases are loaded once and kept for the lifetime
+	 * of the process. */
+	if (strcmp (db_name, "timestamps") == 0) {
+		if (!timestamps_db)
+			timestamps_db = nm_settings_state_db_new (SETTINGS_TIMESTAMPS_FILE, db_name);
+		return timestamps_db;
+	}
+	if (strcmp (db_name, "seen-bssids") == 0) {
+		if (!seen_bssids_db)
+			seen_bssids_db = nm_settings_state_db_new (SETTINGS_SEEN_BSSIDS_FILE, db_name);
+		return seen_bssids_db;
 	}
-	g_key_file_free (key_file);
+	g_return_val_if_reached (NULL);
+}
+
+static void
+remove_entry_from_db (NMSettingsConnection *self, const char* db_name)
+{
+	nm_settings_state_db_remove (_get_state_db (db_name),
+	                             nm_settings_connection_get_uuid (self));
 }
 
 static void
@@ -2146,44 +2140,25 @@ nm_settings_connection_update_timestamp (NMSettingsConnection *self,
                                          gboolean flush_to_disk)
 {
 	NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE (self);
-	const char *connection_uuid;
-	GKeyFile *timestamps_file;
-	char *data, *tmp;
-	gsize len;
-	GError *error = NULL;
+	char tmp[30];
 
 	g_return_if_fail (NM_IS_SETTINGS_CONNECTION (self));
 
 	/* Update timestamp in private storage */
-	priv->timestamp = timestamp;
-	priv->timestamp_set = TRUE;
+	if (!priv->timestamp_set || priv->timestamp != timestamp) {
+		priv->timestamp = timestamp;
+		priv->timestamp_set = TRUE;
+		g_object_notify (G_OBJECT (self), NM_SETTINGS_CONNECTION_TIMESTAMP);
+	}
 
 	if (flush_to_disk == FALSE)
 		return;
 
 	/* Save timestamp to timestamps database file */
-	timestamps_file = g_key_file_new ();
-	if (!g_key_file_load_from_file (timestamps_file, SETTINGS_TIMESTAMPS_FILE, G_KEY_FILE_KEEP_COMMENTS, &error)) {
-		if (!(error->domain == G_FILE_ERROR && error->code == G_FILE_ERROR_NOENT))
-			_LOGW ("error parsing timestamps file '%s': %s", SETTINGS_TIMESTAMPS_FILE, error->message);
-		g_clear_error (&error);
-	}
-
-	connection_uuid = nm_settings_connection_get_uuid (self);
-	tmp = g_strdup_printf ("%" G_GUINT64_FORMAT, timestamp);
-	g_key_file_set_value (timestamps_file, "timestamps", connection_uuid, tmp);
-	g_free (tmp);
- 
-	data = g_key_file_to_data (timestamps_file, &len, &error);
-	if (data) {
-		g_file_set_contents (SETTINGS_TIMESTAMPS_FILE, data, len, &error);
-		g_free (data);
-	}
-	if (error) {
-		_LOGW ("error saving timestamp to file '%s': %s", SETTINGS_TIMESTAMPS_FILE, error->message);
-		g_error_free (error);
-	}
-	g_key_file_free (timestamps_file);
+	g_snprintf (tmp, sizeof (tmp), "%" G_GUINT64_FORMAT, timestamp);
+	nm_settings_state_db_set (_get_state_db ("timestamps"),
+	                          nm_settings_connection_get_uuid (self),
+	                          tmp);
 }
 
 /**
@@ -2197,34 +2172,21 @@ void
 nm_settings_connection_read_and_fill_timestamp (NMSettingsConnection *self)
 {
 	NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE (self);
-	const char *connection_uuid;
-	guint64 timestamp = 0;
-	GKeyFile *timestamps_file;
-	GError *err = NULL;
-	char *tmp_str;
+	const char *tmp_str;
 
 	g_return_if_fail (NM_IS_SETTINGS_CONNECTION (self));
 
 	/* Get timestamp from database file */
-	timestamps_file = g_key_file_new ();
-	g_key_file_load_from_file (timestamps_file, SETTINGS_TIMESTAMPS_FILE, G_KEY_FILE_KEEP_COMMENTS, NULL);
-	connection_uuid = nm_settings_connection_get_uuid (self);
-	tmp_str = g_key_file_get_value (timestamps_file, "timestamps", connection_uuid, &err);
-	if (tmp_str) {
-		timestamp = g_ascii_strtoull (tmp_str, NULL, 10);
-		g_free (tmp_str);
-	}
+	tmp_str = nm_settings_state_db_get (_get_state_db ("timestamps"),
+	                                    nm_settings_connection_get_uuid (self));
 
 	/* Update connection's timestamp */
-	if (!err) {
-		priv->timestamp = timestamp;
+	if (tmp_str) {
+		priv->timestamp = g_ascii_strtoull (tmp_str, NULL, 10);
 		priv->timestamp_set = TRUE;
-	} else {
-		_LOGD ("failed to read connection timestamp: (%d) %s",
-		       err->code, err->message);
-		g_clear_error (&err);
-	}
-	g_key_file_free (timestamps_file);
+		g_object_notify (G_OBJECT (self), NM_SETTINGS_CONNECTION_TIMESTAMP);
+	} else
+		_LOGD ("failed to read connection timestamp: no entry");
 }
 
 /**
@@ -2287,14 +2249,9 @@ nm_settings_connection_add_seen_bssid (NMSettingsConnection *self,
                                        const char *seen_bssid)
 {
 	NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE (self);
-	const char *connection_uuid;
-	GKeyFile *seen_bssids_file;
-	char *data, *bssid_str;
-	const char **list;
-	gsize len;
-	GError *error = NULL;
+	GString *list;
+	char *bssid_str;
 	GHashTableIter iter;
-	guint n;
 
 	g_return_if_fail (seen_bssid != NULL);
 
@@ -2305,40 +2262,20 @@ nm_settings_connection_add_seen_bssid (NMSettingsConnection *self,
 	bssid_str = g_strdup (seen_bssid);
 	g_hash_table_insert (priv->seen_bssids, bssid_str, bssid_str);
 
-	/* Build up a list of all the BSSIDs in string form */
-	n = 0;
-	list = g_malloc0 (g_hash_table_size (priv->seen_bssids) * sizeof (char *));
+	/* Build up a list of all the BSSIDs in string form, in the format
+	 * of g_key_file_set_string_list() with ',' as separator. */
+	list = g_string_sized_new (18 * g_hash_table_size (priv->seen_bssids));
 	g_hash_table_iter_init (&iter, priv->seen_bssids);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &bssid_str))
-		list[n++] = bssid_str;
-
-	/* Save BSSID to seen-bssids file */
-	seen_bssids_file = g_key_file_new ();
-	g_key_file_set_list_separator (seen_bssids_file, ',');
-	if (!g_key_file_load_from_file (seen_bssids_file, SETTINGS_SEEN_BSSIDS_FILE, G_KEY_FILE_KEEP_COMMENTS, &error)) {
-		if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
-			_LOGW ("error parsing seen-bssids file '%s': %s",
-			       SETTINGS_SEEN_BSSIDS_FILE, error->message);
-		}
-		g_clear_error (&error);
-	}
-
-	connection_uuid = nm_settings_connection_get_uuid (self);
-	g_key_file_set_string_list (seen_bssids_file, "seen-bssids", connection_uuid, list, n);
-	g_free (list);
-
-	data = g_key_file_to_data (seen_bssids_file, &len, &error);
-	if (data) {
-		g_file_set_contents (SETTINGS_SEEN_BSSIDS_FILE, data, len, &error);
-		g_free (data);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &bssid_str)) {
+		g_string_append (list, bssid_str);
+		g_string_append_c (list, ',');
 	}
-	g_key_file_free (seen_bssids_file);
 
-	if (error) {
-		_LOGW ("error saving seen-bssids to file '%s': %s",
-		       SETTINGS_SEEN_BSSIDS_FILE, error->message);
-		g_error_free (error);
-	}
+	/* Save BSSID to seen-bssids file */
+	nm_settings_state_db_set (_get_state_db ("seen-bssids"),
+	                          nm_settings_connection_get_uuid (self),
+	                          list->str);
+	g_string_free (list, TRUE);
 }
 
 /**
@@ -2352,26 +2289,25 @@ void
 nm_settings_connection_read_and_fill_seen_bssids (NMSettingsConnection *self)
 {
 	NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE (self);
-	const char *connection_uuid;
-	GKeyFile *seen_bssids_file;
-	char **tmp_strv = NULL;
+	const char *tmp_str;
+	char **tmp_strv;
 	gsize i, len = 0;
 	NMSettingWireless *s_wifi;
 
 	/* Get seen BSSIDs from database file */
-	seen_bssids_file = g_key_file_new ();
-	g_key_file_set_list_separator (seen_bssids_file, ',');
-	if (g_key_file_load_from_file (seen_bssids_file, SETTINGS_SEEN_BSSIDS_FILE, G_KEY_FILE_KEEP_COMMENTS, NULL)) {
-		connection_uuid = nm_settings_connection_get_uuid (self);
-		tmp_strv = g_key_file_get_string_list (seen_bssids_file, "seen-bssids", connection_uuid, &len, NULL);
-	}
-	g_key_file_free (seen_bssids_file);
+	tmp_str = nm_settings_state_db_get (_get_state_db ("seen-bssids"),
+	                                    nm_settings_connection_get_uuid (self));
 
 	/* Update connection's seen-bssids */
-	if (tmp_strv) {
+	if (tmp_str) {
 		g_hash_table_remove_all (priv->seen_bssids);
-		for (i = 0; i < len; i++)
-			g_hash_table_insert (priv->seen_bssids, tmp_strv[i], tmp_strv[i]);
+		tmp_strv = g_strsplit (tmp_str, ",", -1);
+		for (i = 0; tmp_strv[i]; i++) {
+			if (tmp_strv[i][0])
+				g_hash_table_insert (priv->seen_bssids, tmp_strv[i], tmp_strv[i]);
+			else
+				g_free (tmp_strv[i]);
+		}
 		g_free (tmp_strv);
 	} else {
 		/* If this connection didn't have an entry in the seen-bssids database,
@@ -2672,6 +2608,9 @@ get_property (GObject *object, guint prop_id,
 	case PROP_FILENAME:
 		g_value_set_string (value, nm_settings_connection_get_filename (self));
 		break;
+	case PROP_TIMESTAMP:
+		g_value_set_uint64 (value, NM_SETTINGS_CONNECTION_GET_PRIVATE (self)->timestamp);
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -2759,6 +2698,13 @@ nm_settings_connection_class_init (NMSettingsConnectionClass *class)
 		                      G_PARAM_READWRITE |
 		                      G_PARAM_STATIC_STRINGS));
 
+	g_object_class_install_property
+		(object_class, PROP_TIMESTAMP,
+		 g_param_spec_uint64 (NM_SETTINGS_CONNECTION_TIMESTAMP, "", "",
+		                      0, G_MAXUINT64, 0,
+		                      G_PARAM_READABLE |
+		                      G_PARAM_STATIC_STRINGS));
+
 	/* Signals */
 
 	/* Emitted when the connection is changed for any reason */
@@ -47,11 +47,12 @@ G_BEGIN_DECLS
 #define NM_SETTINGS_CONNECTION_UPDATED_BY_USER "updated-by-user"
 
 /* Properties */
-#define NM_SETTINGS_CONNECTION_VISIBLE  "visible"
-#define NM_SETTINGS_CONNECTION_UNSAVED  "unsaved"
-#define NM_SETTINGS_CONNECTION_READY    "ready"
-#define NM_SETTINGS_CONNECTION_FLAGS    "flags"
-#define NM_SETTINGS_CONNECTION_FILENAME "filename"
+#define NM_SETTINGS_CONNECTION_VISIBLE   "visible"
+#define NM_SETTINGS_CONNECTION_UNSAVED   "unsaved"
+#define NM_SETTINGS_CONNECTION_READY     "ready"
+#define NM_SETTINGS_CONNECTION_FLAGS     "flags"
+#define NM_SETTINGS_CONNECTION_FILENAME  "filename"
+#define NM_SETTINGS_CONNECTION_TIMESTAMP "timestamp"
 
 
 /**
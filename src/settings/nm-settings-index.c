@@ -0,0 +1,274 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2016 Red Hat, Inc.
+ */
+
+#include "config.h"
+
+#include "nm-default.h"
+#include "nm-settings-index.h"
+
+struct _NMSettingsIndex {
+	/* UUID -> connection. The keys are owned. If several connections
+	 * share a UUID, the first one added owns the entry. */
+	GHashTable *by_uuid;
+
+	/* connection -> the UUID it is indexed with (owned), or %NULL.
+	 * Contains all added connections. */
+	GHashTable *uuids;
+
+	/* the connections whose UUID is already owned by another connection
+	 * in @by_uuid. Usually empty. */
+	GHashTable *shadowed;
+
+	/* all added connections, sorted by @sort_func. */
+	GPtrArray *sorted;
+	GCompareFunc sort_func;
+};
+
+/*****************************************************************************/
+
+static void
+_uuid_unindex (NMSettingsIndex *index, NMConnection *connection, const char *uuid)
+{
+	GHashTableIter iter;
+	gpointer candidate;
+
+	if (!uuid)
+		return;
+
+	if (g_hash_table_remove (index->shadowed, connection))
+		return;
+
+	if (g_hash_table_lookup (index->by_uuid, uuid) != connection)
+		return;
+	g_hash_table_remove (index->by_uuid, uuid);
+
+	/* hand the UUID over to another connection that has it too. */
+	g_hash_table_iter_init (&iter, index->shadowed);
+	while (g_hash_table_iter_next (&iter, &candidate, NULL)) {
+		if (g_strcmp0 (g_hash_table_lookup (index->uuids, candidate), uuid) == 0) {
+			g_hash_table_iter_remove (&iter);
+			g_hash_table_insert (index->by_uuid, g_strdup (uuid), candidate);
+			return;
+		}
+	}
+}
+
+static void
+_uuid_index (NMSettingsIndex *index, NMConnection *connection)
+{
+	const char *uuid = nm_connection_get_uuid (connection);
+
+	g_hash_table_insert (index->uuids, connection, g_strdup (uuid));
+	if (!uuid)
+		return;
+
+	if (g_hash_table_contains (index->by_uuid, uuid))
+		g_hash_table_add (index->shadowed, connection);
+	else
+		g_hash_table_insert (index->by_uuid, g_strdup (uuid), connection);
+}
+
+static guint
+_sorted_find_insert_pos (NMSettingsIndex *index, NMConnection *connection)
+{
+	GPtrArray *sorted = index->sorted;
+	guint lo = 0, hi = sorted->len, mid;
+
+	/* insert after all connections that compare equal, like
+	 * g_slist_insert_sorted() would. */
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (index->sort_func (sorted->pdata[mid], connection) <= 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static int
+_sorted_find (NMSettingsIndex *index, NMConnection *connection)
+{
+	GPtrArray *sorted = index->sorted;
+	guint i;
+
+	for (i = 0; i < sorted->len; i++) {
+		if (sorted->pdata[i] == connection)
+			return i;
+	}
+	return -1;
+}
+
+static void
+_sorted_add (NMSettingsIndex *index, NMConnection *connection)
+{
+	g_ptr_array_insert (index->sorted,
+	                    _sorted_find_insert_pos (index, connection),
+	                    connection);
+}
+
+static void
+_sorted_reorder (NMSettingsIndex *index, NMConnection *connection)
+{
+	GPtrArray *sorted = index->sorted;
+	int idx;
+
+	idx = _sorted_find (index, connection);
+	if (idx < 0)
+		return;
+
+	if (   (idx == 0 || index->sort_func (sorted->pdata[idx - 1], connection) <= 0)
+	    && ((guint) idx + 1 == sorted->len || index->sort_func (connection, sorted->pdata[idx + 1]) <= 0))
+		return;
+
+	g_ptr_array_remove_index (sorted, idx);
+	_sorted_add (index, connection);
+}
+
+static void
+_connection_changed (NMConnection *connection, NMSettingsIndex *index)
+{
+	const char *old_uuid;
+
+	_sorted_reorder (index, connection);
+
+	old_uuid = g_hash_table_lookup (index->uuids, connection);
+	if (g_strcmp0 (old_uuid, nm_connection_get_uuid (connection)) == 0)
+		return;
+
+	_uuid_unindex (index, connection, old_uuid);
+	_uuid_index (index, connection);
+}
+
+/*****************************************************************************/
+
+void
+nm_settings_index_add (NMSettingsIndex *index, NMConnection *connection)
+{
+	g_return_if_fail (index);
+	g_return_if_fail (NM_IS_CONNECTION (connection));
+	g_return_if_fail (!g_hash_table_contains (index->uuids, connection));
+
+	_uuid_index (index, connection);
+	_sorted_add (index, connection);
+	g_signal_connect (connection, NM_CONNECTION_CHANGED,
+	                  G_CALLBACK (_connection_changed), index);
+}
+
+void
+nm_settings_index_remove (NMSettingsIndex *index, NMConnection *connection)
+{
+	gpointer uuid;
+
+	g_return_if_fail (index);
+	g_return_if_fail (NM_IS_CONNECTION (connection));
+
+	if (!g_hash_table_lookup_extended (index->uuids, connection, NULL, &uuid))
+		return;
+
+	g_signal_handlers_disconnect_by_func (connection, G_CALLBACK (_connection_changed), index);
+	_uuid_unindex (index, connection, uuid);
+	g_hash_table_remove (index->uuids, connection);
+	g_ptr_array_remove (index->sorted, connection);
+}
+
+/**
+ * nm_settings_index_reorder:
+ * @index: the #NMSettingsIndex
+ * @connection: the connection
+ *
+ * Moves @connection to its new position after data changed that the
+ * sort function depends on, but that is not part of the settings of
+ * @connection. Changes to the settings are handled by the index itself.
+ */
+void
+nm_settings_index_reorder (NMSettingsIndex *index, NMConnection *connection)
+{
+	g_return_if_fail (index);
+	g_return_if_fail (NM_IS_CONNECTION (connection));
+
+	_sorted_reorder (index, connection);
+}
+
+NMConnection *
+nm_settings_index_lookup_uuid (NMSettingsIndex *index, const char *uuid)
+{
+	g_return_val_if_fail (index, NULL);
+	g_return_val_if_fail (uuid, NULL);
+
+	return g_hash_table_lookup (index->by_uuid, uuid);
+}
+
+/**
+ * nm_settings_index_get_sorted:
+ * @index: the #NMSettingsIndex
+ * @out_len: (allow-none): the number of connections
+ *
+ * Returns: (transfer none): the connections sorted by the sort function
+ *   of @index. The array is only valid until the next connection is
+ *   added, removed or reordered.
+ */
+NMConnection *const*
+nm_settings_index_get_sorted (NMSettingsIndex *index, guint *out_len)
+{
+	g_return_val_if_fail (index, NULL);
+
+	if (out_len)
+		*out_len = index->sorted->len;
+	return (NMConnection *const*) index->sorted->pdata;
+}
+
+/*****************************************************************************/
+
+NMSettingsIndex *
+nm_settings_index_new (GCompareFunc sort_func)
+{
+	NMSettingsIndex *index;
+
+	g_return_val_if_fail (sort_func, NULL);
+
+	index = g_slice_new0 (NMSettingsIndex);
+	index->sort_func = sort_func;
+	index->sorted = g_ptr_array_new ();
+	index->by_uuid = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	index->uuids = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+	index->shadowed = g_hash_table_new (g_direct_hash, g_direct_equal);
+	return index;
+}
+
+void
+nm_settings_index_free (NMSettingsIndex *index)
+{
+	GHashTableIter iter;
+	gpointer connection;
+
+	if (!index)
+		return;
+
+	g_hash_table_iter_init (&iter, index->uuids);
+	while (g_hash_table_iter_next (&iter, &connection, NULL))
+		g_signal_handlers_disconnect_by_func (connection, G_CALLBACK (_connection_changed), index);
+
+	g_ptr_array_unref (index->sorted);
+	g_hash_table_unref (index->shadowed);
+	g_hash_table_unref (index->uuids);
+	g_hash_table_unref (index->by_uuid);
+	g_slice_free (NMSettingsIndex, index);
+}
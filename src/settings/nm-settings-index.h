@@ -0,0 +1,65 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2016 Red Hat, Inc.
+ */
+
+#ifndef __NM_SETTINGS_INDEX_H__
+#define __NM_SETTINGS_INDEX_H__
+
+#include "nm-default.h"
+
+#include <nm-connection.h>
+
+G_BEGIN_DECLS
+
+/* NMSettingsIndex indexes the connections known to NMSettings by UUID and
+ * keeps them sorted by a compare function, e.g. in autoconnect order.
+ *
+ * The index connects to NM_CONNECTION_CHANGED of every added connection
+ * and updates itself synchronously when the UUID or the position changes.
+ * If the sort order depends on data outside of the connection's settings,
+ * call nm_settings_index_reorder() when that data changes. If several
+ * connections share a UUID, a lookup returns the first one added until it
+ * is removed. The index
+ * doesn't take a reference to the connections, they must be removed before
+ * they are destroyed. */
+
+typedef struct _NMSettingsIndex NMSettingsIndex;
+
+NMSettingsIndex *nm_settings_index_new (GCompareFunc sort_func);
+
+void nm_settings_index_free (NMSettingsIndex *index);
+
+void nm_settings_index_add (NMSettingsIndex *index,
+                            NMConnection *connection);
+
+void nm_settings_index_remove (NMSettingsIndex *index,
+                               NMConnection *connection);
+
+void nm_settings_index_reorder (NMSettingsIndex *index,
+                                NMConnection *connection);
+
+NMConnection *nm_settings_index_lookup_uuid (NMSettingsIndex *index,
+                                             const char *uuid);
+
+NMConnection *const*nm_settings_index_get_sorted (NMSettingsIndex *index,
+                                                  guint *out_len);
+
+G_END_DECLS
+
+#endif /* __NM_SETTINGS_INDEX_H__ */
@@ -0,0 +1,289 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2016 Red Hat, Inc.
+ */
+
+#include "config.h"
+
+#include "nm-default.h"
+#include "nm-settings-state-db.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+/* rewrite the file once it contains more superseded lines than
+ * current entries, but not before this many. */
+#define COMPACT_MIN_STALE 64
+
+struct _NMSettingsStateDB {
+	char *filename;
+	char *group;
+
+	/* the current entries. Keys and values are owned. */
+	GHashTable *entries;
+
+	/* the number of "key=value" lines in the file. */
+	guint n_records;
+
+	bool loaded:1;
+
+	/* whether lines can be appended to the file. That requires that
+	 * the file exists, ends with a newline and that its last group
+	 * is @group. */
+	bool can_append:1;
+};
+
+/******************************************************************************************/
+
+static void
+_load (NMSettingsStateDB *db)
+{
+	gs_free char *contents = NULL;
+	GError *error = NULL;
+	gsize len;
+	char *p, *line, *eol, *eq, *key;
+	gboolean in_group = FALSE;
+
+	db->loaded = TRUE;
+	db->can_append = FALSE;
+	db->n_records = 0;
+
+	if (!g_file_get_contents (db->filename, &contents, &len, &error)) {
+		if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+			nm_log_warn (LOGD_SETTINGS, "error reading %s file '%s': %s",
+			             db->group, db->filename, error->message);
+		}
+		g_error_free (error);
+		return;
+	}
+
+	p = contents;
+	while (*p) {
+		eol = strchr (p, '\n');
+		if (!eol) {
+			/* ignore a truncated last line. The next update rewrites
+			 * the file. */
+			in_group = FALSE;
+			break;
+		}
+		*eol = '\0';
+		line = g_strstrip (p);
+		p = eol + 1;
+
+		if (!line[0] || line[0] == '#')
+			continue;
+
+		if (line[0] == '[') {
+			eq = strchr (line, ']');
+			in_group =    eq
+			           && (gsize) (eq - line - 1) == strlen (db->group)
+			           && !strncmp (&line[1], db->group, eq - line - 1);
+			continue;
+		}
+
+		if (!in_group)
+			continue;
+
+		eq = strchr (line, '=');
+		if (!eq)
+			continue;
+		*eq = '\0';
+		key = g_strstrip (line);
+		if (!key[0])
+			continue;
+
+		g_hash_table_insert (db->entries, g_strdup (key), g_strdup (g_strstrip (eq + 1)));
+		db->n_records++;
+	}
+
+	db->can_append = in_group;
+}
+
+static void
+_compact (NMSettingsStateDB *db)
+{
+	GString *str;
+	GHashTableIter iter;
+	const char *key, *value;
+	GError *error = NULL;
+
+	str = g_string_sized_new (64 + 64 * g_hash_table_size (db->entries));
+	g_string_append_printf (str, "[%s]\n", db->group);
+
+	g_hash_table_iter_init (&iter, db->entries);
+	while (g_hash_table_iter_next (&iter, (gpointer *) &key, (gpointer *) &value))
+		g_string_append_printf (str, "%s=%s\n", key, value);
+
+	if (g_file_set_contents (db->filename, str->str, str->len, &error)) {
+		db->n_records = g_hash_table_size (db->entries);
+		db->can_append = TRUE;
+	} else {
+		nm_log_warn (LOGD_SETTINGS, "error writing %s file '%s': %s",
+		             db->group, db->filename, error->message);
+		g_error_free (error);
+		db->can_append = FALSE;
+	}
+	g_string_free (str, TRUE);
+}
+
+static gboolean
+_append (NMSettingsStateDB *db, const char *key, const char *value)
+{
+	gs_free char *line = NULL;
+	gsize len, written = 0;
+	ssize_t n;
+	int fd;
+
+	fd = open (db->filename, O_WRONLY | O_APPEND | O_CLOEXEC);
+	if (fd < 0)
+		return FALSE;
+
+	line = g_strdup_printf ("%s=%s\n", key, value);
+	len = strlen (line);
+	while (written < len) {
+		n = write (fd, &line[written], len - written);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		written += n;
+	}
+	close (fd);
+
+	if (written < len) {
+		/* a partial line might be left. Rewrite the file. */
+		return FALSE;
+	}
+
+	db->n_records++;
+	return TRUE;
+}
+
+static void
+_commit (NMSettingsStateDB *db, const char *key, const char *value)
+{
+	guint n_entries = g_hash_table_size (db->entries);
+
+	/* @key is already in @entries, so after appending the line the file
+	 * has (n_records + 1 - n_entries) superseded lines. */
+	if (   db->can_append
+	    && db->n_records + 1 - n_entries < MAX ((guint) COMPACT_MIN_STALE, n_entries)
+	    && _append (db, key, value))
+		return;
+
+	_compact (db);
+}
+
+/******************************************************************************************/
+
+/**
+ * nm_settings_state_db_get:
+ * @db: the #NMSettingsStateDB
+ * @key: the key to look up
+ *
+ * Returns: the value of @key or %NULL if @key is not set. The
+ *   value is only valid until the next modification of @key.
+ */
+const char *
+nm_settings_state_db_get (NMSettingsStateDB *db, const char *key)
+{
+	g_return_val_if_fail (db, NULL);
+	g_return_val_if_fail (key, NULL);
+
+	if (!db->loaded)
+		_load (db);
+
+	return g_hash_table_lookup (db->entries, key);
+}
+
+/**
+ * nm_settings_state_db_set:
+ * @db: the #NMSettingsStateDB
+ * @key: the key to set
+ * @value: the new value. It must not contain newlines.
+ *
+ * Sets @key to @value and writes the change to disk, usually
+ * by appending one line to the file.
+ */
+void
+nm_settings_state_db_set (NMSettingsStateDB *db, const char *key, const char *value)
+{
+	const char *old;
+
+	g_return_if_fail (db);
+	g_return_if_fail (key && key[0]);
+	g_return_if_fail (value && !strchr (value, '\n'));
+
+	old = nm_settings_state_db_get (db, key);
+	if (old && !strcmp (old, value))
+		return;
+
+	g_hash_table_insert (db->entries, g_strdup (key), g_strdup (value));
+	_commit (db, key, value);
+}
+
+/**
+ * nm_settings_state_db_remove:
+ * @db: the #NMSettingsStateDB
+ * @key: the key to remove
+ *
+ * Removes @key and rewrites the file without it.
+ */
+void
+nm_settings_state_db_remove (NMSettingsStateDB *db, const char *key)
+{
+	g_return_if_fail (db);
+	g_return_if_fail (key);
+
+	if (!nm_settings_state_db_get (db, key))
+		return;
+
+	g_hash_table_remove (db->entries, key);
+	_compact (db);
+}
+
+/******************************************************************************************/
+
+NMSettingsStateDB *
+nm_settings_state_db_new (const char *filename, const char *group)
+{
+	NMSettingsStateDB *db;
+
+	g_return_val_if_fail (filename, NULL);
+	g_return_val_if_fail (group && !strpbrk (group, "[]\n"), NULL);
+
+	db = g_slice_new0 (NMSettingsStateDB);
+	db->filename = g_strdup (filename);
+	db->group = g_strdup (group);
+	db->entries = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	return db;
+}
+
+void
+nm_settings_state_db_free (NMSettingsStateDB *db)
+{
+	g_return_if_fail (db);
+
+	g_hash_table_unref (db->entries);
+	g_free (db->filename);
+	g_free (db->group);
+	g_slice_free (NMSettingsStateDB, db);
+}
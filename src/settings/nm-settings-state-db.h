@@ -0,0 +1,56 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2016 Red Hat, Inc.
+ */
+
+#ifndef __NM_SETTINGS_STATE_DB_H__
+#define __NM_SETTINGS_STATE_DB_H__
+
+#include "nm-default.h"
+
+G_BEGIN_DECLS
+
+/* NMSettingsStateDB is a key-value store backed by a keyfile with a single
+ * group, like the timestamps and seen-bssids databases in NMSTATEDIR.
+ *
+ * The file is read once, on first access. Updates append a "key=value" line
+ * to the end of the file instead of rewriting it. When the same key is
+ * present several times, the last line wins, so the file stays a valid
+ * keyfile. Removing a key, or too many superseded lines, rewrites the file
+ * with only the current entries. */
+
+typedef struct _NMSettingsStateDB NMSettingsStateDB;
+
+NMSettingsStateDB *nm_settings_state_db_new (const char *filename,
+                                             const char *group);
+
+void nm_settings_state_db_free (NMSettingsStateDB *db);
+
+const char *nm_settings_state_db_get (NMSettingsStateDB *db,
+                                      const char *key);
+
+void nm_settings_state_db_set (NMSettingsStateDB *db,
+                               const char *key,
+                               const char *value);
+
+void nm_settings_state_db_remove (NMSettingsStateDB *db,
+                                  const char *key);
+
+G_END_DECLS
+
+#endif /* __NM_SETTINGS_STATE_DB_H__ */
@@ -61,6 +61,7 @@
 #include "nm-device-ethernet.h"
 #include "nm-settings.h"
 #include "nm-settings-connection.h"
+#include "nm-settings-index.h"
 #include "nm-settings-plugin.h"
 #include "nm-default.h"
 #include "nm-bus-manager.h"
@@ -140,6 +141,9 @@ typedef struct {
 	GSList *plugins;
 	gboolean connections_loaded;
 	GHashTable *connections;
+	/* index of @connections by UUID and in autoconnect order,
+	 * see connection_sort(). */
+	NMSettingsIndex *index;
 	GSList *unmanaged_specs;
 	GSList *unrecognized_specs;
 	GSList *get_connections_cache;
@@ -302,21 +306,13 @@ NMSettingsConnection *
 nm_settings_get_connection_by_uuid (NMSettings *self, const char *uuid)
 {
 	NMSettingsPrivate *priv;
-	NMSettingsConnection *candidate;
-	GHashTableIter iter;
 
 	g_return_val_if_fail (NM_IS_SETTINGS (self), NULL);
 	g_return_val_if_fail (uuid != NULL, NULL);
 
 	priv = NM_SETTINGS_GET_PRIVATE (self);
 
-	g_hash_table_iter_init (&iter, priv->connections);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &candidate)) {
-		if (g_strcmp0 (uuid, nm_settings_connection_get_uuid (candidate)) == 0)
-			return candidate;
-	}
-
-	return NULL;
+	return (NMSettingsConnection *) nm_settings_index_lookup_uuid (priv->index, uuid);
 }
 
 static void
@@ -396,6 +392,29 @@ connection_sort (gconstpointer pa, gconstpointer pb)
 	return 1;
 }
 
+/**
+ * nm_settings_get_connections_sorted:
+ * @self: the #NMSettings
+ * @out_len: (allow-none): the number of connections
+ *
+ * Returns: (transfer none): the connections in the order suitable
+ *   for auto-connecting, i.e. first go connections with autoconnect=yes
+ *   and most recent timestamp. The array is owned by @self and is only
+ *   valid until the next connection is added, removed or reordered.
+ *   Don't modify the settings while iterating over it.
+ */
+NMSettingsConnection *const*
+nm_settings_get_connections_sorted (NMSettings *self, guint *out_len)
+{
+	NMSettingsPrivate *priv;
+
+	g_return_val_if_fail (NM_IS_SETTINGS (self), NULL);
+
+	priv = NM_SETTINGS_GET_PRIVATE (self);
+
+	return (NMSettingsConnection *const*) nm_settings_index_get_sorted (priv->index, out_len);
+}
+
 /* Returns a list of NMSettingsConnections.
  * The list is sorted in the order suitable for auto-connecting, i.e.
  * first go connections with autoconnect=yes and most recent timestamp.
@@ -404,15 +423,15 @@ connection_sort (gconstpointer pa, gconstpointer pb)
 GSList *
 nm_settings_get_connections (NMSettings *self)
 {
-	GHashTableIter iter;
-	gpointer data = NULL;
+	NMSettingsConnection *const*sorted;
 	GSList *list = NULL;
+	guint i;
 
 	g_return_val_if_fail (NM_IS_SETTINGS (self), NULL);
 
-	g_hash_table_iter_init (&iter, NM_SETTINGS_GET_PRIVATE (self)->connections);
-	while (g_hash_table_iter_next (&iter, NULL, &data))
-		list = g_slist_insert_sorted (list, data, connection_sort);
+	sorted = nm_settings_get_connections_sorted (self, &i);
+	for (; i > 0; i--)
+		list = g_slist_prepend (list, sorted[i - 1]);
 	return list;
 }
 
@@ -433,13 +452,10 @@ gboolean
 nm_settings_has_connection (NMSettings *self, NMSettingsConnection *connection)
 {
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
-	GHashTableIter iter;
-	gpointer data;
+	const char *path = nm_connection_get_path (NM_CONNECTION (connection));
 
-	g_hash_table_iter_init (&iter, priv->connections);
-	while (g_hash_table_iter_next (&iter, NULL, &data))
-		if (data == connection)
-			return TRUE;
+	if (path && g_hash_table_lookup (priv->connections, path) == connection)
+		return TRUE;
 
 	return FALSE;
 }
@@ -861,6 +877,14 @@ connection_updated_by_user (NMSettingsConnection *connection, gpointer user_data
 	               connection);
 }
 
+static void
+connection_timestamp_changed (NMSettingsConnection *connection,
+                              GParamSpec *pspec,
+                              gpointer user_data)
+{
+	nm_settings_index_reorder (NM_SETTINGS_GET_PRIVATE (user_data)->index, NM_CONNECTION (connection));
+}
+
 static void
 connection_visibility_changed (NMSettingsConnection *connection,
                                GParamSpec *pspec,
@@ -893,10 +917,12 @@ connection_removed (NMSettingsConnection *connection, gpointer user_data)
 	g_signal_handlers_disconnect_by_func (connection, G_CALLBACK (connection_updated), self);
 	g_signal_handlers_disconnect_by_func (connection, G_CALLBACK (connection_updated_by_user), self);
 	g_signal_handlers_disconnect_by_func (connection, G_CALLBACK (connection_visibility_changed), self);
+	g_signal_handlers_disconnect_by_func (connection, G_CALLBACK (connection_timestamp_changed), self);
 	g_signal_handlers_disconnect_by_func (connection, G_CALLBACK (connection_ready_changed), self);
 	g_object_unref (self);
 
 	/* Forget about the connection internally */
+	nm_settings_index_remove (priv->index, NM_CONNECTION (connection));
 	g_hash_table_remove (priv->connections, (gpointer) cpath);
 
 	/* Notify D-Bus */
@@ -970,21 +996,12 @@ claim_connection (NMSettings *self, NMSettingsConnection *connection)
 {
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 	GError *error = NULL;
-	GHashTableIter iter;
-	gpointer data;
 	const char *path;
 	NMSettingsConnection *existing;
 
 	g_return_if_fail (NM_IS_SETTINGS_CONNECTION (connection));
 	g_return_if_fail (nm_connection_get_path (NM_CONNECTION (connection)) == NULL);
 
-	g_hash_table_iter_init (&iter, priv->connections);
-	while (g_hash_table_iter_next (&iter, NULL, &data)) {
-		/* prevent duplicates */
-		if (data == connection)
-			return;
-	}
-
 	if (!nm_connection_normalize (NM_CONNECTION (connection), NULL, NULL, &error)) {
 		nm_log_warn (LOGD_SETTINGS, "plugin provided invalid connection: %s",
 		             error->message);
@@ -993,6 +1010,10 @@ claim_connection (NMSettings *self, NMSettingsConnection *connection)
 	}
 
 	existing = nm_settings_get_connection_by_uuid (self, nm_settings_connection_get_uuid (connection));
+	if (existing == connection) {
+		/* prevent duplicates */
+		return;
+	}
 	if (existing) {
 		/* Cannot add duplicate connections per UUID. Just return without action and
 		 * log a warning.
@@ -1031,6 +1052,9 @@ claim_connection (NMSettings *self, NMSettingsConnection *connection)
 	g_signal_connect (connection, "notify::" NM_SETTINGS_CONNECTION_VISIBLE,
 	                  G_CALLBACK (connection_visibility_changed),
 	                  self);
+	g_signal_connect (connection, "notify::" NM_SETTINGS_CONNECTION_TIMESTAMP,
+	                  G_CALLBACK (connection_timestamp_changed),
+	                  self);
 	if (!priv->startup_complete) {
 		g_signal_connect (connection, "notify::" NM_SETTINGS_CONNECTION_READY,
 		                  G_CALLBACK (connection_ready_changed),
@@ -1045,6 +1069,7 @@ claim_connection (NMSettings *self, NMSettingsConnection *connection)
 	g_hash_table_insert (priv->connections,
 	                     (gpointer) nm_connection_get_path (NM_CONNECTION (connection)),
 	                     g_object_ref (connection));
+	nm_settings_index_add (priv->index, NM_CONNECTION (connection));
 
 	nm_utils_log_connection_diff (NM_CONNECTION (connection), NULL, LOGL_DEBUG, LOGD_CORE, "new connection", "++ ");
 
@@ -1085,20 +1110,16 @@ nm_settings_add_connection (NMSettings *self,
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 	GSList *iter;
 	NMSettingsConnection *added = NULL;
-	GHashTableIter citer;
-	NMConnection *candidate = NULL;
+	const char *uuid;
 
 	/* Make sure a connection with this UUID doesn't already exist */
-	g_hash_table_iter_init (&citer, priv->connections);
-	while (g_hash_table_iter_next (&citer, NULL, (gpointer *) &candidate)) {
-		if (g_strcmp0 (nm_connection_get_uuid (connection),
-		               nm_connection_get_uuid (candidate)) == 0) {
-			g_set_error_literal (error,
-			                     NM_SETTINGS_ERROR,
-			                     NM_SETTINGS_ERROR_UUID_EXISTS,
-			                     "A connection with this UUID already exists.");
-			return NULL;
-		}
+	uuid = nm_connection_get_uuid (connection);
+	if (uuid && nm_settings_index_lookup_uuid (priv->index, uuid)) {
+		g_set_error_literal (error,
+		                     NM_SETTINGS_ERROR,
+		                     NM_SETTINGS_ERROR_UUID_EXISTS,
+		                     "A connection with this UUID already exists.");
+		return NULL;
 	}
 
 	/* 1) plugin writes the NMConnection to disk
@@ -2210,6 +2231,7 @@ nm_settings_init (NMSettings *self)
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 
 	priv->connections = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_object_unref);
+	priv->index = nm_settings_index_new (connection_sort);
 
 	/* Hold a reference to the agent manager so it stays alive; the only
 	 * other holders are NMSettingsConnection objects which are often
@@ -2267,6 +2289,7 @@ finalize (GObject *object)
 	NMSettings *self = NM_SETTINGS (object);
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 
+	nm_settings_index_free (priv->index);
 	g_hash_table_destroy (priv->connections);
 	g_slist_free (priv->get_connections_cache);
 
@@ -103,6 +103,9 @@ void nm_settings_add_connection_dbus (NMSettings *self,
  */
 GSList *nm_settings_get_connections (NMSettings *settings);
 
+NMSettingsConnection *const*nm_settings_get_connections_sorted (NMSettings *settings,
+                                                              guint *out_len);
+
 NMSettingsConnection *nm_settings_add_connection (NMSettings *settings,
                                                   NMConnection *connection,
                                                   gboolean save_to_disk,
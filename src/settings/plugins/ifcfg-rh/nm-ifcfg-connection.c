@@ -215,6 +215,8 @@ files_changed_cb (NMInotifyHelper *ih,
 NMIfcfgConnection *
 nm_ifcfg_connection_new (NMConnection *source,
                          const char *full_path,
+                         NMConnection *read_connection,
+                         const char *read_unhandled_spec,
                          GError **error,
                          gboolean *out_ignore_error)
 {
@@ -225,6 +227,8 @@ nm_ifcfg_connection_new (NMConnection *source,
 	gboolean update_unsaved = TRUE;
 
 	g_assert (source || full_path);
+	g_assert (!read_connection || (!source && full_path));
+	g_assert (!read_unhandled_spec || read_connection);
 
 	if (out_ignore_error)
 		*out_ignore_error = FALSE;
@@ -232,7 +236,12 @@ nm_ifcfg_connection_new (NMConnection *source,
 	/* If we're given a connection already, prefer that instead of re-reading */
 	if (source)
 		tmp = g_object_ref (source);
-	else {
+	else if (read_connection) {
+		/* The file was already read by connections_from_files() */
+		tmp = g_object_ref (read_connection);
+		unhandled_spec = g_strdup (read_unhandled_spec);
+		update_unsaved = FALSE;
+	} else {
 		tmp = connection_from_file (full_path,
 		                            &unhandled_spec,
 		                            error,
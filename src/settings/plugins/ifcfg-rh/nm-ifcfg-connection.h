@@ -48,6 +48,8 @@ GType nm_ifcfg_connection_get_type (void);
 
 NMIfcfgConnection *nm_ifcfg_connection_new (NMConnection *source,
                                             const char *full_path,
+                                            NMConnection *read_connection,
+                                            const char *read_unhandled_spec,
                                             GError **error,
                                             gboolean *out_ignore_error);
 
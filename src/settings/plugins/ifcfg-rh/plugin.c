@@ -68,6 +68,7 @@
 static NMIfcfgConnection *update_connection (SettingsPluginIfcfg *plugin,
                                              NMConnection *source,
                                              const char *full_path,
+                                             const NMIfcfgReadResult *read_result,
                                              NMIfcfgConnection *connection,
                                              gboolean protect_existing_connection,
                                              GHashTable *protected_connections,
@@ -120,7 +121,7 @@ connection_ifcfg_changed (NMIfcfgConnection *connection, gpointer user_data)
 
 	_LOGD ("connection_ifcfg_changed("NM_IFCFG_CONNECTION_LOG_FMTD"): %s", NM_IFCFG_CONNECTION_LOG_ARGD (connection), "reload");
 
-	update_connection (self, NULL, path, connection, TRUE, NULL, NULL);
+	update_connection (self, NULL, path, NULL, connection, TRUE, NULL, NULL);
 }
 
 static void
@@ -178,6 +179,7 @@ static NMIfcfgConnection *
 update_connection (SettingsPluginIfcfg *self,
                    NMConnection *source,
                    const char *full_path,
+                   const NMIfcfgReadResult *read_result,
                    NMIfcfgConnection *connection,
                    gboolean protect_existing_connection,
                    GHashTable *protected_connections,
@@ -195,13 +197,23 @@ update_connection (SettingsPluginIfcfg *self,
 
 	g_return_val_if_fail (!source || NM_IS_CONNECTION (source), NULL);
 	g_return_val_if_fail (full_path || source, NULL);
+	g_return_val_if_fail (!read_result || (!source && !g_strcmp0 (full_path, read_result->filename)), NULL);
 
 	if (full_path)
 		_LOGD ("loading from file \"%s\"...", full_path);
 
-	/* Create a NMIfcfgConnection instance, either by reading from @full_path or
-	 * based on @source. */
-	connection_new = nm_ifcfg_connection_new (source, full_path, &local, &ignore_error);
+	/* Create a NMIfcfgConnection instance, either by reading from @full_path,
+	 * from the already parsed @read_result or based on @source. */
+	if (read_result && !read_result->connection) {
+		connection_new = NULL;
+		local = read_result->error ? g_error_copy (read_result->error) : NULL;
+		ignore_error = read_result->ignore_error;
+	} else {
+		connection_new = nm_ifcfg_connection_new (source, full_path,
+		                                          read_result ? read_result->connection : NULL,
+		                                          read_result ? read_result->unhandled_spec : NULL,
+		                                          &local, &ignore_error);
+	}
 	if (!connection_new) {
 		/* Unexpected failure. Probably the file is invalid? */
 		if (   connection
@@ -420,7 +432,7 @@ ifcfg_dir_changed (GFileMonitor *monitor,
 		case G_FILE_MONITOR_EVENT_CREATED:
 		case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
 			/* Update or new */
-			update_connection (plugin, NULL, ifcfg_path, connection, TRUE, NULL, NULL);
+			update_connection (plugin, NULL, ifcfg_path, NULL, connection, TRUE, NULL, NULL);
 			break;
 		default:
 			break;
@@ -499,6 +511,7 @@ read_connections (SettingsPluginIfcfg *plugin)
 	guint i;
 	GPtrArray *filenames;
 	GHashTable *paths;
+	NMIfcfgReadResult *read_results;
 
 	dir = g_dir_open (IFCFG_DIR, 0, &err);
 	if (!dir) {
@@ -532,11 +545,21 @@ read_connections (SettingsPluginIfcfg *plugin)
 	g_ptr_array_sort_with_data (filenames, (GCompareDataFunc) _sort_paths, paths);
 	g_hash_table_destroy (paths);
 
+	/* Parsing the files is independent of our state, so do it for all
+	 * files first, possibly in parallel. Then merge the results in the
+	 * order of @filenames. */
+	read_results = g_new0 (NMIfcfgReadResult, filenames->len);
+	for (i = 0; i < filenames->len; i++)
+		read_results[i].filename = filenames->pdata[i];
+	connections_from_files (read_results, filenames->len);
+
 	for (i = 0; i < filenames->len; i++) {
-		connection = update_connection (plugin, NULL, filenames->pdata[i], NULL, FALSE, alive_connections, NULL);
+		connection = update_connection (plugin, NULL, filenames->pdata[i], &read_results[i], NULL, FALSE, alive_connections, NULL);
 		if (connection)
 			g_hash_table_add (alive_connections, connection);
+		read_result_clear (&read_results[i]);
 	}
+	g_free (read_results);
 	g_ptr_array_free (filenames, TRUE);
 
 	g_hash_table_iter_init (&iter, priv->connections);
@@ -604,7 +627,7 @@ load_connection (NMSettingsPlugin *config,
 		return FALSE;
 
 	connection = find_by_path (plugin, ifcfg_path);
-	update_connection (plugin, NULL, ifcfg_path, connection, TRUE, NULL, NULL);
+	update_connection (plugin, NULL, ifcfg_path, NULL, connection, TRUE, NULL, NULL);
 	if (!connection)
 		connection = find_by_path (plugin, ifcfg_path);
 
@@ -682,7 +705,7 @@ add_connection (NMSettingsPlugin *config,
 		if (!writer_new_connection (connection, IFCFG_DIR, &path, error))
 			return NULL;
 	}
-	return NM_SETTINGS_CONNECTION (update_connection (self, connection, path, NULL, FALSE, NULL, error));
+	return NM_SETTINGS_CONNECTION (update_connection (self, connection, path, NULL, NULL, FALSE, NULL, error));
 }
 
 static void
@@ -498,13 +498,14 @@ read_one_ip4_route (shvarFile *ifcfg,
 		goto out;
 	if (value) {
 		guint32 netmask;
+		char buf[NM_UTILS_INET_ADDRSTRLEN];
 
 		inet_pton (AF_INET, value, &netmask);
 		prefix = nm_utils_ip4_netmask_to_prefix (netmask);
 		g_free (value);
 		if (prefix == 0 || netmask != nm_utils_ip4_prefix_to_netmask (prefix)) {
 			g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION,
-			             "Invalid IP4 netmask '%s' \"%s\"", netmask_tag, nm_utils_inet4_ntop (netmask, NULL));
+			             "Invalid IP4 netmask '%s' \"%s\"", netmask_tag, nm_utils_inet4_ntop (netmask, buf));
 			goto out;
 		}
 	} else {
@@ -4576,13 +4577,18 @@ is_vlan_device (const char *name, shvarFile *parsed)
 }
 
 static gboolean
-is_wifi_device (const char *name, shvarFile *parsed)
+is_wifi_device (const char *name, shvarFile *parsed, GHashTable *wifi_devices)
 {
 	int ifindex;
 
 	g_return_val_if_fail (name != NULL, FALSE);
 	g_return_val_if_fail (parsed != NULL, FALSE);
 
+	/* off the main thread, the platform cache can't be used. Look the
+	 * name up in the wifi links collected before instead. */
+	if (wifi_devices)
+		return g_hash_table_contains (wifi_devices, name);
+
 	ifindex = nm_platform_link_get_ifindex (NM_PLATFORM_GET, name);
 	if (ifindex == 0)
 		return FALSE;
@@ -4898,6 +4904,7 @@ static NMConnection *
 connection_from_file_full (const char *filename,
                            const char *network_file,  /* for unit tests only */
                            const char *test_type,     /* for unit tests only */
+                           GHashTable *wifi_devices,
                            char **out_unhandled,
                            GError **error,
                            gboolean *out_ignore_error)
@@ -4986,7 +4993,7 @@ connection_from_file_full (const char *filename,
 				type = g_strdup (TYPE_BOND);
 			else if (is_vlan_device (device, parsed))
 				type = g_strdup (TYPE_VLAN);
-			else if (is_wifi_device (device, parsed))
+			else if (is_wifi_device (device, parsed, wifi_devices))
 				type = g_strdup (TYPE_WIRELESS);
 			else
 				type = g_strdup (TYPE_ETHERNET);
@@ -5099,7 +5106,7 @@ connection_from_file (const char *filename,
                       GError **error,
                       gboolean *out_ignore_error)
 {
-	return connection_from_file_full (filename, NULL, NULL,
+	return connection_from_file_full (filename, NULL, NULL, NULL,
 	                                  out_unhandled,
 	                                  error,
 	                                  out_ignore_error);
@@ -5115,11 +5122,126 @@ connection_from_file_test (const char *filename,
 	return connection_from_file_full (filename,
 	                                  network_file,
 	                                  test_type,
+	                                  NULL,
 	                                  out_unhandled,
 	                                  error,
 	                                  NULL);
 }
 
+/*****************************************************************************/
+
+/* below this number of files per thread, spawning threads is not worth it. */
+#define READ_FILES_PER_THREAD_MIN 32
+
+typedef struct {
+	NMIfcfgReadResult *results;
+	guint len;
+	GHashTable *wifi_devices;
+	volatile gint next;
+} ReadFilesData;
+
+static gpointer
+_read_files_thread (gpointer user_data)
+{
+	ReadFilesData *data = user_data;
+	NMIfcfgReadResult *r;
+	guint i;
+
+	while ((i = (guint) g_atomic_int_add (&data->next, 1)) < data->len) {
+		r = &data->results[i];
+		r->connection = connection_from_file_full (r->filename, NULL, NULL,
+		                                           data->wifi_devices,
+		                                           &r->unhandled_spec,
+		                                           &r->error,
+		                                           &r->ignore_error);
+	}
+	return NULL;
+}
+
+static GHashTable *
+_wifi_devices_new (void)
+{
+	GHashTable *wifi_devices;
+	GArray *links;
+	const NMPlatformLink *link;
+	guint i;
+
+	wifi_devices = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	links = nm_platform_link_get_all (NM_PLATFORM_GET);
+	for (i = 0; i < links->len; i++) {
+		link = &g_array_index (links, NMPlatformLink, i);
+		if (link->type == NM_LINK_TYPE_WIFI)
+			g_hash_table_add (wifi_devices, g_strdup (link->name));
+	}
+	g_array_unref (links);
+	return wifi_devices;
+}
+
+/**
+ * connections_from_files:
+ * @results: an array of @len elements with the filenames to read.
+ * @len: the number of elements in @results.
+ *
+ * Reads each file like connection_from_file() and sets either the
+ * connection or the error of each element. With many files, the files
+ * are parsed by a thread per CPU and the function returns when all
+ * files are read. The order of @results is not changed, so the caller
+ * can process the results on the main thread in a deterministic order.
+ */
+void
+connections_from_files (NMIfcfgReadResult *results, guint len)
+{
+	ReadFilesData data = {
+		.results = results,
+		.len = len,
+	};
+	GThread **threads;
+	long n_cpus;
+	guint n_threads;
+	guint i;
+
+	g_return_if_fail (results || !len);
+
+	n_cpus = sysconf (_SC_NPROCESSORS_ONLN);
+	n_threads = len / READ_FILES_PER_THREAD_MIN;
+	if (n_cpus > 0)
+		n_threads = MIN (n_threads, (guint) n_cpus);
+	else
+		n_threads = 0;
+
+	if (n_threads <= 1) {
+		_read_files_thread (&data);
+		return;
+	}
+
+	/* the setting types register themselves on first use. Do it
+	 * here, so that the threads don't race on the registry. */
+	_nm_setting_ensure_all_registered ();
+
+	/* files without TYPE are typed by the link DEVICE refers to. */
+	data.wifi_devices = _wifi_devices_new ();
+
+	/* the calling thread parses files too. */
+	threads = g_new (GThread *, n_threads - 1);
+	for (i = 0; i < n_threads - 1; i++)
+		threads[i] = g_thread_new ("ifcfg-read", _read_files_thread, &data);
+	_read_files_thread (&data);
+	for (i = 0; i < n_threads - 1; i++)
+		g_thread_join (threads[i]);
+	g_free (threads);
+
+	g_hash_table_unref (data.wifi_devices);
+}
+
+void
+read_result_clear (NMIfcfgReadResult *result)
+{
+	g_clear_object (&result->connection);
+	g_clear_error (&result->error);
+	g_clear_pointer (&result->unhandled_spec, g_free);
+	result->ignore_error = FALSE;
+}
+
 guint
 devtimeout_from_file (const char *filename)
 {
@@ -31,6 +31,22 @@ NMConnection *connection_from_file (const char *filename,
                                     GError **error,
                                     gboolean *out_ignore_error);
 
+typedef struct {
+	const char *filename;
+
+	/* either the read connection or the error. */
+	NMConnection *connection;
+	GError *error;
+
+	/* the out arguments of connection_from_file(). */
+	char *unhandled_spec;
+	gboolean ignore_error;
+} NMIfcfgReadResult;
+
+void connections_from_files (NMIfcfgReadResult *results, guint len);
+
+void read_result_clear (NMIfcfgReadResult *result);
+
 char *uuid_from_file (const char *filename);
 
 guint devtimeout_from_file (const char *filename);
@@ -119,7 +119,7 @@ svOpenFileInternal (const char *name, gboolean create, GError **error)
 
 	g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errsv),
 	             "Could not read file '%s': %s",
-	             name, errsv ? strerror (errsv) : "Unknown error");
+	             name, errsv ? g_strerror (errsv) : "Unknown error");
 	return NULL;
 }
 
@@ -474,7 +474,7 @@ svWriteFile (shvarFile *s, int mode, GError **error)
 
 			g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errsv),
 			             "Could not open file '%s' for writing: %s",
-			             s->fileName, strerror (errsv));
+			             s->fileName, g_strerror (errsv));
 			return FALSE;
 		}
 		if (ftruncate (s->fd, 0) < 0) {
@@ -482,7 +482,7 @@ svWriteFile (shvarFile *s, int mode, GError **error)
 
 			g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errsv),
 			             "Could not overwrite file '%s': %s",
-			             s->fileName, strerror (errsv));
+			             s->fileName, g_strerror (errsv));
 			return FALSE;
 		}
 
@@ -492,7 +492,7 @@ svWriteFile (shvarFile *s, int mode, GError **error)
 
 			g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errsv),
 			             "Internal error writing file '%s': %s",
-			             s->fileName, strerror (errsv));
+			             s->fileName, g_strerror (errsv));
 			return FALSE;
 		}
 		f = fdopen (tmpfd, "w");
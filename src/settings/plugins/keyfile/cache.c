@@ -0,0 +1,332 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager system settings service - keyfile plugin
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2016 Red Hat, Inc.
+ */
+
+#include "config.h"
+
+#include <string.h>
+#include <sys/stat.h>
+
+#include "nm-default.h"
+#include "cache.h"
+
+#include <nm-simple-connection.h>
+
+#include "nm-macros-internal.h"
+#include "NetworkManagerUtils.h"
+
+/* The normalization of connections may change between versions, so a
+ * cache written by a different version is never used. */
+#define CACHE_VERSION      "nm-keyfile-cache-1 " VERSION
+
+#define CACHE_ENTRY_TYPE   "(tttxxa{sa{sv}})"
+#define CACHE_ENTRY_FORMAT "(tttxx@a{sa{sv}})"
+#define CACHE_TYPE         "(sa{s" CACHE_ENTRY_TYPE "})"
+
+typedef struct {
+	guint64 dev;
+	guint64 ino;
+	guint64 size;
+	gint64 mtime_sec;
+	gint64 mtime_nsec;
+	GVariant *dict;
+
+	/* whether the entry was passed to nm_keyfile_plugin_cache_add()
+	 * and is saved by the next write. */
+	bool keep:1;
+} CacheEntry;
+
+struct _NMKeyfileCache {
+	char *filename;
+	GHashTable *entries;   /* path -> CacheEntry */
+
+	/* whether an entry was added or updated since loading. */
+	bool dirty:1;
+};
+
+/*****************************************************************************/
+
+static void
+_entry_free (CacheEntry *entry)
+{
+	g_variant_unref (entry->dict);
+	g_slice_free (CacheEntry, entry);
+}
+
+static void
+_entry_set_stat (CacheEntry *entry, const struct stat *st)
+{
+	entry->dev = st->st_dev;
+	entry->ino = st->st_ino;
+	entry->size = st->st_size;
+	entry->mtime_sec = st->st_mtim.tv_sec;
+	entry->mtime_nsec = st->st_mtim.tv_nsec;
+}
+
+static gboolean
+_entry_matches (const CacheEntry *entry, const struct stat *st)
+{
+	return    entry->dev == (guint64) st->st_dev
+	       && entry->ino == (guint64) st->st_ino
+	       && entry->size == (guint64) st->st_size
+	       && entry->mtime_sec == (gint64) st->st_mtim.tv_sec
+	       && entry->mtime_nsec == (gint64) st->st_mtim.tv_nsec;
+}
+
+static void
+_load (NMKeyfileCache *cache)
+{
+	struct stat st;
+	char *contents;
+	gsize len;
+	gs_unref_variant GVariant *variant = NULL;
+	gs_unref_variant GVariant *version = NULL;
+	gs_unref_variant GVariant *entries = NULL;
+	GVariantIter iter;
+	const char *path;
+	CacheEntry *entry;
+
+	if (stat (cache->filename, &st) != 0)
+		return;
+
+	/* the cache contains secrets, like the keyfiles themselves. */
+	if (   !S_ISREG (st.st_mode)
+	    || (st.st_mode & 0077)
+	    || (   st.st_uid != 0
+	        && !NM_FLAGS_HAS (nm_utils_get_testing (), NM_UTILS_TEST_NO_KEYFILE_OWNER_CHECK))) {
+		nm_log_warn (LOGD_SETTINGS, "keyfile: ignore cache \"%s\" with insecure owner or permissions",
+		             cache->filename);
+		return;
+	}
+
+	if (!g_file_get_contents (cache->filename, &contents, &len, NULL))
+		return;
+
+	variant = g_variant_ref_sink (g_variant_new_from_data (G_VARIANT_TYPE (CACHE_TYPE),
+	                                                       contents, len, FALSE,
+	                                                       g_free, contents));
+
+	version = g_variant_get_child_value (variant, 0);
+	if (strcmp (g_variant_get_string (version, NULL), CACHE_VERSION) != 0) {
+		nm_log_dbg (LOGD_SETTINGS, "keyfile: ignore cache \"%s\" of version \"%s\"",
+		            cache->filename, g_variant_get_string (version, NULL));
+		return;
+	}
+
+	entries = g_variant_get_child_value (variant, 1);
+	g_variant_iter_init (&iter, entries);
+	entry = g_slice_new0 (CacheEntry);
+	while (g_variant_iter_next (&iter, "{&s" CACHE_ENTRY_FORMAT "}",
+	                            &path,
+	                            &entry->dev,
+	                            &entry->ino,
+	                            &entry->size,
+	                            &entry->mtime_sec,
+	                            &entry->mtime_nsec,
+	                            &entry->dict)) {
+		g_hash_table_insert (cache->entries, g_strdup (path), entry);
+		entry = g_slice_new0 (CacheEntry);
+	}
+	g_slice_free (CacheEntry, entry);
+
+	nm_log_dbg (LOGD_SETTINGS, "keyfile: loaded %u entries from cache \"%s\"",
+	            g_hash_table_size (cache->entries), cache->filename);
+}
+
+/*****************************************************************************/
+
+/**
+ * nm_keyfile_plugin_cache_lookup:
+ * @cache: the #NMKeyfileCache
+ * @path: the path of the keyfile
+ * @st: the stat of @path, taken before reading it
+ *
+ * Returns: (transfer full): a new, normalized connection if @cache has an
+ *   entry for @path with the same file identity as @st, or %NULL.
+ */
+NMConnection *
+nm_keyfile_plugin_cache_lookup (const NMKeyfileCache *cache,
+                                const char *path,
+                                const struct stat *st)
+{
+	const CacheEntry *entry;
+	NMConnection *connection;
+	GError *error = NULL;
+
+	g_return_val_if_fail (cache, NULL);
+	g_return_val_if_fail (path, NULL);
+	g_return_val_if_fail (st, NULL);
+
+	entry = g_hash_table_lookup (cache->entries, path);
+	if (!entry || !_entry_matches (entry, st))
+		return NULL;
+
+	connection = nm_simple_connection_new_from_dbus (entry->dict, &error);
+	if (!connection) {
+		nm_log_dbg (LOGD_SETTINGS, "keyfile: invalid cache entry for \"%s\": %s",
+		            path, error->message);
+		g_clear_error (&error);
+	}
+	return connection;
+}
+
+/**
+ * nm_keyfile_plugin_cache_add:
+ * @cache: the #NMKeyfileCache
+ * @path: the path of the keyfile
+ * @st: the stat of @path, taken before reading it
+ * @connection: the connection read from @path
+ *
+ * Marks the entry for @path to be saved by the next write. If
+ * the entry is missing or outdated, it is replaced by @connection.
+ */
+void
+nm_keyfile_plugin_cache_add (NMKeyfileCache *cache,
+                             const char *path,
+                             const struct stat *st,
+                             NMConnection *connection)
+{
+	CacheEntry *entry;
+	GVariant *dict;
+
+	g_return_if_fail (cache);
+	g_return_if_fail (path);
+	g_return_if_fail (st);
+	g_return_if_fail (NM_IS_CONNECTION (connection));
+
+	entry = g_hash_table_lookup (cache->entries, path);
+	if (entry && _entry_matches (entry, st)) {
+		entry->keep = TRUE;
+		return;
+	}
+
+	dict = nm_connection_to_dbus (connection, NM_CONNECTION_SERIALIZE_ALL);
+	if (!dict)
+		return;
+
+	if (!entry) {
+		entry = g_slice_new0 (CacheEntry);
+		g_hash_table_insert (cache->entries, g_strdup (path), entry);
+	} else
+		g_variant_unref (entry->dict);
+
+	_entry_set_stat (entry, st);
+	entry->dict = g_variant_ref_sink (dict);
+	entry->keep = TRUE;
+	cache->dirty = TRUE;
+}
+
+/**
+ * nm_keyfile_plugin_cache_write:
+ * @cache: the #NMKeyfileCache
+ * @error: the error on failure
+ *
+ * Drops all entries that were not added since the last write and
+ * saves the cache, unless nothing changed.
+ *
+ * Returns: %FALSE if writing the cache failed.
+ */
+gboolean
+nm_keyfile_plugin_cache_write (NMKeyfileCache *cache, GError **error)
+{
+	GHashTableIter h_iter;
+	GVariantBuilder builder;
+	gs_unref_variant GVariant *variant = NULL;
+	const char *path;
+	CacheEntry *entry;
+	mode_t saved_umask;
+	gboolean success;
+
+	g_return_val_if_fail (cache, FALSE);
+
+	g_hash_table_iter_init (&h_iter, cache->entries);
+	while (g_hash_table_iter_next (&h_iter, NULL, (gpointer *) &entry)) {
+		if (!entry->keep) {
+			g_hash_table_iter_remove (&h_iter);
+			cache->dirty = TRUE;
+		} else
+			entry->keep = FALSE;
+	}
+
+	if (!cache->dirty)
+		return TRUE;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{s" CACHE_ENTRY_TYPE "}"));
+	g_hash_table_iter_init (&h_iter, cache->entries);
+	while (g_hash_table_iter_next (&h_iter, (gpointer *) &path, (gpointer *) &entry)) {
+		g_variant_builder_add (&builder, "{s" CACHE_ENTRY_FORMAT "}",
+		                       path,
+		                       entry->dev,
+		                       entry->ino,
+		                       entry->size,
+		                       entry->mtime_sec,
+		                       entry->mtime_nsec,
+		                       entry->dict);
+	}
+	variant = g_variant_ref_sink (g_variant_new ("(s@a{s" CACHE_ENTRY_TYPE "})",
+	                                             CACHE_VERSION,
+	                                             g_variant_builder_end (&builder)));
+
+	saved_umask = umask (S_IRWXG | S_IRWXO);
+	success = g_file_set_contents (cache->filename,
+	                               g_variant_get_data (variant),
+	                               g_variant_get_size (variant),
+	                               error);
+	umask (saved_umask);
+
+	if (success) {
+		cache->dirty = FALSE;
+		nm_log_dbg (LOGD_SETTINGS, "keyfile: wrote %u entries to cache \"%s\"",
+		            g_hash_table_size (cache->entries), cache->filename);
+	}
+	return success;
+}
+
+/*****************************************************************************/
+
+/**
+ * nm_keyfile_plugin_cache_new:
+ * @filename: the file of the cache
+ *
+ * Returns: the cache with the entries loaded from @filename. If the
+ *   file is missing, insecure or of another version, the cache is empty.
+ */
+NMKeyfileCache *
+nm_keyfile_plugin_cache_new (const char *filename)
+{
+	NMKeyfileCache *cache;
+
+	g_return_val_if_fail (filename, NULL);
+
+	cache = g_slice_new0 (NMKeyfileCache);
+	cache->filename = g_strdup (filename);
+	cache->entries = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) _entry_free);
+	_load (cache);
+	return cache;
+}
+
+void
+nm_keyfile_plugin_cache_free (NMKeyfileCache *cache)
+{
+	g_return_if_fail (cache);
+
+	g_hash_table_unref (cache->entries);
+	g_free (cache->filename);
+	g_slice_free (NMKeyfileCache, cache);
+}
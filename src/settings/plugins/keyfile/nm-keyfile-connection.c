@@ -37,9 +37,22 @@
 
 G_DEFINE_TYPE (NMKeyfileConnection, nm_keyfile_connection, NM_TYPE_SETTINGS_CONNECTION)
 
+/**
+ * nm_keyfile_connection_new:
+ * @source: (allow-none): a connection from memory. If given,
+ *   the connection is marked as unsaved.
+ * @full_path: (allow-none): the file of the connection.
+ * @read_connection: (allow-none): if @source is %NULL, the connection
+ *   that was already read from @full_path. Otherwise, @full_path
+ *   is read.
+ * @error: the error on failure.
+ *
+ * Returns: the new connection or %NULL on failure.
+ */
 NMKeyfileConnection *
 nm_keyfile_connection_new (NMConnection *source,
                            const char *full_path,
+                           NMConnection *read_connection,
                            GError **error)
 {
 	GObject *object;
@@ -48,14 +61,19 @@ nm_keyfile_connection_new (NMConnection *source,
 	gboolean update_unsaved = TRUE;
 
 	g_assert (source || full_path);
+	g_assert (!read_connection || full_path);
 
 	/* If we're given a connection already, prefer that instead of re-reading */
 	if (source)
 		tmp = g_object_ref (source);
 	else {
-		tmp = nm_keyfile_plugin_connection_from_file (full_path, error);
-		if (!tmp)
-			return NULL;
+		if (read_connection)
+			tmp = g_object_ref (read_connection);
+		else {
+			tmp = nm_keyfile_plugin_connection_from_file (full_path, error);
+			if (!tmp)
+				return NULL;
+		}
 
 		uuid = nm_connection_get_uuid (NM_CONNECTION (tmp));
 		if (!uuid) {
@@ -45,6 +45,7 @@ GType nm_keyfile_connection_get_type (void);
 
 NMKeyfileConnection *nm_keyfile_connection_new (NMConnection *source,
                                                 const char *filename,
+                                                NMConnection *read_connection,
                                                 GError **error);
 
 G_END_DECLS
@@ -40,11 +40,14 @@
 #include "plugin.h"
 #include "nm-settings-plugin.h"
 #include "nm-keyfile-connection.h"
+#include "reader.h"
 #include "writer.h"
 #include "utils.h"
 
 static void settings_plugin_interface_init (NMSettingsPluginInterface *plugin_iface);
 
+#define KEYFILE_CACHE_FILE NMSTATEDIR "/keyfile-cache"
+
 G_DEFINE_TYPE_EXTENDED (SettingsPluginKeyfile, settings_plugin_keyfile, G_TYPE_OBJECT, 0,
                         G_IMPLEMENT_INTERFACE (NM_TYPE_SETTINGS_PLUGIN,
                                                settings_plugin_interface_init))
@@ -113,6 +116,8 @@ find_by_path (SettingsPluginKeyfile *self, const char *path)
  *   and updates it. When passing @source, this adds a connection from
  *   memory.
  * @full_path: the filename of the keyfile to be loaded
+ * @read_result: (allow-none): if given, the result of reading
+ *   @full_path in advance. Otherwise, the file is read now.
  * @connection: an existing connection that might be updated.
  *   If given, @connection must be an existing connection that is currently
  *   owned by the plugin.
@@ -142,6 +147,7 @@ static NMKeyfileConnection *
 update_connection (SettingsPluginKeyfile *self,
                    NMConnection *source,
                    const char *full_path,
+                   const NMKeyfileReadResult *read_result,
                    NMKeyfileConnection *connection,
                    gboolean protect_existing_connection,
                    GHashTable *protected_connections,
@@ -155,11 +161,19 @@ update_connection (SettingsPluginKeyfile *self,
 
 	g_return_val_if_fail (!source || NM_IS_CONNECTION (source), NULL);
 	g_return_val_if_fail (full_path || source, NULL);
+	g_return_val_if_fail (!read_result || (!source && !g_strcmp0 (full_path, read_result->filename)), NULL);
 
 	if (full_path)
 		nm_log_dbg (LOGD_SETTINGS, "keyfile: loading from file \"%s\"...", full_path);
 
-	connection_new = nm_keyfile_connection_new (source, full_path, &local);
+	if (read_result && !read_result->connection) {
+		connection_new = NULL;
+		local = g_error_copy (read_result->error);
+	} else {
+		connection_new = nm_keyfile_connection_new (source, full_path,
+		                                            read_result ? read_result->connection : NULL,
+		                                            &local);
+	}
 	if (!connection_new) {
 		/* Error; remove the connection */
 		if (source)
@@ -301,7 +315,7 @@ dir_changed (GFileMonitor *monitor,
 	case G_FILE_MONITOR_EVENT_CREATED:
 	case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
 		if (exists)
-			update_connection (SETTINGS_PLUGIN_KEYFILE (config), NULL, full_path, connection, TRUE, NULL, NULL);
+			update_connection (SETTINGS_PLUGIN_KEYFILE (config), NULL, full_path, NULL, connection, TRUE, NULL, NULL);
 		break;
 	default:
 		break;
@@ -387,6 +401,17 @@ _sort_paths (const char **f1, const char **f2, GHashTable *paths)
 	return strcmp (*f1, *f2);
 }
 
+static NMKeyfileCache *
+_cache_new (void)
+{
+	if (!nm_config_data_get_value_boolean (NM_CONFIG_GET_DATA_ORIG,
+	                                       NM_CONFIG_KEYFILE_GROUP_KEYFILE,
+	                                       NM_CONFIG_KEYFILE_KEY_KEYFILE_CACHE,
+	                                       FALSE))
+		return NULL;
+	return nm_keyfile_plugin_cache_new (KEYFILE_CACHE_FILE);
+}
+
 static void
 read_connections (NMSettingsPlugin *config)
 {
@@ -402,6 +427,8 @@ read_connections (NMSettingsPlugin *config)
 	guint i;
 	GPtrArray *filenames;
 	GHashTable *paths;
+	NMKeyfileReadResult *read_results;
+	NMKeyfileCache *cache;
 
 	dir = g_dir_open (nm_keyfile_plugin_get_path (), 0, &error);
 	if (!dir) {
@@ -433,13 +460,38 @@ read_connections (NMSettingsPlugin *config)
 	g_ptr_array_sort_with_data (filenames, (GCompareDataFunc) _sort_paths, paths);
 	g_hash_table_destroy (paths);
 
+	/* Parsing and verifying the files is independent of our state, so
+	 * do it for all files first, possibly in parallel. Then merge the
+	 * results in the order of @filenames. */
+	read_results = g_new0 (NMKeyfileReadResult, filenames->len);
+	for (i = 0; i < filenames->len; i++)
+		read_results[i].filename = filenames->pdata[i];
+	cache = _cache_new ();
+	nm_keyfile_plugin_connections_from_files (read_results, filenames->len, cache);
+
 	for (i = 0; i < filenames->len; i++) {
-		connection = update_connection (self, NULL, filenames->pdata[i], NULL, FALSE, alive_connections, NULL);
+		connection = update_connection (self, NULL, filenames->pdata[i], &read_results[i], NULL, FALSE, alive_connections, NULL);
 		if (connection)
 			g_hash_table_add (alive_connections, connection);
+		if (cache && read_results[i].connection) {
+			nm_keyfile_plugin_cache_add (cache,
+			                             read_results[i].filename,
+			                             &read_results[i].statbuf,
+			                             read_results[i].connection);
+		}
+		nm_keyfile_plugin_read_result_clear (&read_results[i]);
 	}
+	g_free (read_results);
 	g_ptr_array_free (filenames, TRUE);
 
+	if (cache) {
+		if (!nm_keyfile_plugin_cache_write (cache, &error)) {
+			nm_log_warn (LOGD_SETTINGS, "keyfile: cannot write cache: %s", error->message);
+			g_clear_error (&error);
+		}
+		nm_keyfile_plugin_cache_free (cache);
+	}
+
 	g_hash_table_iter_init (&iter, priv->connections);
 	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &connection)) {
 		if (   !g_hash_table_contains (alive_connections, connection)
@@ -489,7 +541,7 @@ load_connection (NMSettingsPlugin *config,
 	if (nm_keyfile_plugin_utils_should_ignore_file (filename + dir_len + 1))
 		return FALSE;
 
-	connection = update_connection (self, NULL, filename, find_by_path (self, filename), TRUE, NULL, NULL);
+	connection = update_connection (self, NULL, filename, NULL, find_by_path (self, filename), TRUE, NULL, NULL);
 
 	return (connection != NULL);
 }
@@ -513,7 +565,7 @@ add_connection (NMSettingsPlugin *config,
 		if (!nm_keyfile_plugin_write_connection (connection, NULL, FALSE, &path, error))
 			return NULL;
 	}
-	return NM_SETTINGS_CONNECTION (update_connection (self, connection, path, NULL, FALSE, NULL, error));
+	return NM_SETTINGS_CONNECTION (update_connection (self, connection, path, NULL, NULL, FALSE, NULL, error));
 }
 
 static GSList *
@@ -22,11 +22,13 @@
 
 #include <sys/stat.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "reader.h"
 
 #include "nm-default.h"
 #include "nm-keyfile-internal.h"
+#include "nm-core-internal.h"
 #include "NetworkManagerUtils.h"
 
 static const char *
@@ -86,8 +88,12 @@ _handler_read (GKeyFile *keyfile,
 	return FALSE;
 }
 
-NMConnection *
-nm_keyfile_plugin_connection_from_file (const char *filename, GError **error)
+static NMConnection *
+_connection_from_file (const char *filename,
+                       const NMKeyfileCache *cache,
+                       struct stat *out_statbuf,
+                       gboolean *out_from_cache,
+                       GError **error)
 {
 	GKeyFile *key_file;
 	struct stat statbuf;
@@ -116,6 +122,17 @@ nm_keyfile_plugin_connection_from_file (const char *filename, GError **error)
 		}
 	}
 
+	NM_SET_OUT (out_statbuf, statbuf);
+
+	if (cache) {
+		connection = nm_keyfile_plugin_cache_lookup (cache, filename, &statbuf);
+		if (connection) {
+			NM_SET_OUT (out_from_cache, TRUE);
+			return connection;
+		}
+	}
+	NM_SET_OUT (out_from_cache, FALSE);
+
 	key_file = g_key_file_new ();
 	if (!g_key_file_load_from_file (key_file, filename, G_KEY_FILE_NONE, error))
 		goto out;
@@ -139,3 +156,99 @@ out:
 	return connection;
 }
 
+NMConnection *
+nm_keyfile_plugin_connection_from_file (const char *filename, GError **error)
+{
+	return _connection_from_file (filename, NULL, NULL, NULL, error);
+}
+
+
+/*****************************************************************************/
+
+/* below this number of files per thread, spawning threads is not worth it. */
+#define READ_FILES_PER_THREAD_MIN 32
+
+typedef struct {
+	NMKeyfileReadResult *results;
+	guint len;
+	const NMKeyfileCache *cache;
+	volatile gint next;
+} ReadFilesData;
+
+static gpointer
+_read_files_thread (gpointer user_data)
+{
+	ReadFilesData *data = user_data;
+	NMKeyfileReadResult *r;
+	guint i;
+
+	while ((i = (guint) g_atomic_int_add (&data->next, 1)) < data->len) {
+		r = &data->results[i];
+		r->connection = _connection_from_file (r->filename, data->cache, &r->statbuf, &r->from_cache, &r->error);
+	}
+	return NULL;
+}
+
+/**
+ * nm_keyfile_plugin_connections_from_files:
+ * @results: an array of @len elements with the filenames to read.
+ * @len: the number of elements in @results.
+ * @cache: (allow-none): if given, files that are unchanged since
+ *   they were added to @cache are not parsed again.
+ *
+ * Reads, normalizes and verifies each file like
+ * nm_keyfile_plugin_connection_from_file() and sets either the connection
+ * or the error of each element. With many files, the files are parsed by
+ * a thread per CPU and the function returns when all files are read.
+ * The order of @results is not changed, so the caller can process
+ * the results on the main thread in a deterministic order.
+ */
+void
+nm_keyfile_plugin_connections_from_files (NMKeyfileReadResult *results,
+                                          guint len,
+                                          const NMKeyfileCache *cache)
+{
+	ReadFilesData data = {
+		.results = results,
+		.len = len,
+		.cache = cache,
+	};
+	GThread **threads;
+	long n_cpus;
+	guint n_threads;
+	guint i;
+
+	g_return_if_fail (results || !len);
+
+	n_cpus = sysconf (_SC_NPROCESSORS_ONLN);
+	n_threads = len / READ_FILES_PER_THREAD_MIN;
+	if (n_cpus > 0)
+		n_threads = MIN (n_threads, (guint) n_cpus);
+	else
+		n_threads = 0;
+
+	if (n_threads <= 1) {
+		_read_files_thread (&data);
+		return;
+	}
+
+	/* the setting types register themselves on first use. Do it
+	 * here, so that the threads don't race on the registry. */
+	_nm_setting_ensure_all_registered ();
+
+	/* the calling thread parses files too. */
+	threads = g_new (GThread *, n_threads - 1);
+	for (i = 0; i < n_threads - 1; i++)
+		threads[i] = g_thread_new ("keyfile-read", _read_files_thread, &data);
+	_read_files_thread (&data);
+	for (i = 0; i < n_threads - 1; i++)
+		g_thread_join (threads[i]);
+	g_free (threads);
+}
+
+void
+nm_keyfile_plugin_read_result_clear (NMKeyfileReadResult *result)
+{
+	g_clear_object (&result->connection);
+	g_clear_error (&result->error);
+}
@@ -25,7 +25,27 @@
 #include <nm-connection.h>
 
 #include "nm-default.h"
+#include "cache.h"
 
 NMConnection *nm_keyfile_plugin_connection_from_file (const char *filename, GError **error);
 
+typedef struct {
+	const char *filename;
+
+	/* either the read connection or the error. */
+	NMConnection *connection;
+	GError *error;
+
+	/* if @connection is set, the stat of the file before reading it
+	 * and whether it was taken from the cache. */
+	struct stat statbuf;
+	gboolean from_cache;
+} NMKeyfileReadResult;
+
+void nm_keyfile_plugin_connections_from_files (NMKeyfileReadResult *results,
+                                               guint len,
+                                               const NMKeyfileCache *cache);
+
+void nm_keyfile_plugin_read_result_clear (NMKeyfileReadResult *result);
+
 #endif /* _KEYFILE_PLUGIN_READER_H */
@@ -3548,6 +3548,221 @@ test_nm_keyfile_plugin_utils_escape_filename (void)
 
 /*****************************************************************************/
 
+static void
+test_read_files_parallel (void)
+{
+	const char *files[] = {
+		TEST_WIRELESS_FILE,
+		TEST_WIRED_IP6_FILE,
+		TEST_GSM_FILE,
+		TEST_INFINIBAND_FILE,
+		TEST_KEYFILES_DIR"/Test_minimal_1",
+		TEST_KEYFILES_DIR"/does-not-exist",
+	};
+	const guint len = 300;
+	NMKeyfileReadResult *results;
+	guint i;
+
+	results = g_new0 (NMKeyfileReadResult, len);
+	for (i = 0; i < len; i++)
+		results[i].filename = files[i % G_N_ELEMENTS (files)];
+
+	nm_keyfile_plugin_connections_from_files (results, len, NULL);
+
+	for (i = 0; i < len; i++) {
+		gs_unref_object NMConnection *connection = NULL;
+		GError *error = NULL;
+
+		connection = nm_keyfile_plugin_connection_from_file (results[i].filename, &error);
+		if (!connection) {
+			g_assert (error);
+			g_assert (!results[i].connection);
+			g_assert_error (results[i].error, error->domain, error->code);
+			g_clear_error (&error);
+		} else {
+			g_assert_no_error (results[i].error);
+			g_assert (results[i].connection);
+			g_assert (nm_connection_compare (results[i].connection, connection, NM_SETTING_COMPARE_FLAG_EXACT));
+		}
+		nm_keyfile_plugin_read_result_clear (&results[i]);
+		g_assert (!results[i].connection);
+		g_assert (!results[i].error);
+	}
+	g_free (results);
+}
+
+static char **
+_write_test_connections (const char *dir, guint n)
+{
+	char **filenames = g_new0 (char *, n + 1);
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		gs_unref_object NMConnection *connection = NULL;
+		gs_free char *id = g_strdup_printf ("cache-test-%u", i);
+		GError *error = NULL;
+
+		connection = nmtst_create_minimal_connection (id, NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+		nm_keyfile_plugin_write_test_connection (connection, dir, geteuid (), getegid (), &filenames[i], &error);
+		g_assert_no_error (error);
+	}
+	return filenames;
+}
+
+static NMKeyfileReadResult *
+_read_with_cache (const char *cache_file, char **filenames, guint n, gboolean add_all)
+{
+	NMKeyfileReadResult *results = g_new0 (NMKeyfileReadResult, n);
+	NMKeyfileCache *cache;
+	GError *error = NULL;
+	guint i;
+
+	for (i = 0; i < n; i++)
+		results[i].filename = filenames[i];
+
+	cache = nm_keyfile_plugin_cache_new (cache_file);
+	nm_keyfile_plugin_connections_from_files (results, n, cache);
+	for (i = 0; i < n; i++) {
+		g_assert_no_error (results[i].error);
+		g_assert (results[i].connection);
+		if (add_all || i > 0)
+			nm_keyfile_plugin_cache_add (cache, filenames[i], &results[i].statbuf, results[i].connection);
+	}
+	nm_keyfile_plugin_cache_write (cache, &error);
+	g_assert_no_error (error);
+	nm_keyfile_plugin_cache_free (cache);
+	return results;
+}
+
+static void
+_read_results_free (NMKeyfileReadResult *results, guint n)
+{
+	guint i;
+
+	for (i = 0; i < n; i++)
+		nm_keyfile_plugin_read_result_clear (&results[i]);
+	g_free (results);
+}
+
+static void
+_remove_test_connections (const char *dir, char **filenames, const char *cache_file)
+{
+	guint i;
+
+	for (i = 0; filenames[i]; i++)
+		unlink (filenames[i]);
+	unlink (cache_file);
+	rmdir (dir);
+	g_strfreev (filenames);
+}
+
+static void
+test_read_files_cache (void)
+{
+	const guint n = 3;
+	gs_free char *dir = NULL;
+	gs_free char *cache_file = NULL;
+	char **filenames;
+	NMKeyfileReadResult *results;
+	struct stat st;
+	FILE *f;
+	guint i;
+
+	dir = g_dir_make_tmp ("nm-test-keyfile-cache-XXXXXX", NULL);
+	g_assert (dir);
+	cache_file = g_build_filename (dir, "keyfile-cache", NULL);
+	filenames = _write_test_connections (dir, n);
+
+	/* the first read parses all files and fills the cache. */
+	results = _read_with_cache (cache_file, filenames, n, TRUE);
+	for (i = 0; i < n; i++)
+		g_assert (!results[i].from_cache);
+	_read_results_free (results, n);
+
+	g_assert (stat (cache_file, &st) == 0);
+	g_assert_cmpint (st.st_mode & 0077, ==, 0);
+
+	/* unchanged files are taken from the cache. */
+	results = _read_with_cache (cache_file, filenames, n, TRUE);
+	for (i = 0; i < n; i++) {
+		gs_unref_object NMConnection *parsed = NULL;
+
+		g_assert (results[i].from_cache);
+		parsed = nm_keyfile_plugin_connection_from_file (filenames[i], NULL);
+		g_assert (parsed);
+		g_assert (nm_connection_compare (results[i].connection, parsed, NM_SETTING_COMPARE_FLAG_EXACT));
+	}
+	_read_results_free (results, n);
+
+	/* a modified file is parsed again. This time, it is not added. */
+	f = fopen (filenames[0], "a");
+	g_assert (f);
+	fprintf (f, "\n# modified\n");
+	fclose (f);
+	results = _read_with_cache (cache_file, filenames, n, FALSE);
+	g_assert (!results[0].from_cache);
+	g_assert (results[1].from_cache);
+	g_assert (results[2].from_cache);
+	_read_results_free (results, n);
+
+	/* entries that were not added are dropped from the cache. */
+	results = _read_with_cache (cache_file, filenames, n, TRUE);
+	g_assert (!results[0].from_cache);
+	g_assert (results[1].from_cache);
+	_read_results_free (results, n);
+
+	results = _read_with_cache (cache_file, filenames, n, TRUE);
+	for (i = 0; i < n; i++)
+		g_assert (results[i].from_cache);
+	_read_results_free (results, n);
+
+	_remove_test_connections (dir, filenames, cache_file);
+}
+
+static void
+test_read_files_cache_bench (void)
+{
+	const guint n = nmtst_test_quick () ? 1000 : 10000;
+	gs_free char *dir = NULL;
+	gs_free char *cache_file = NULL;
+	char **filenames;
+	NMKeyfileReadResult *results;
+	gdouble t_parse, t_cold, t_warm;
+	guint i;
+
+	dir = g_dir_make_tmp ("nm-test-keyfile-cache-XXXXXX", NULL);
+	g_assert (dir);
+	cache_file = g_build_filename (dir, "keyfile-cache", NULL);
+	filenames = _write_test_connections (dir, n);
+
+	results = g_new0 (NMKeyfileReadResult, n);
+	for (i = 0; i < n; i++)
+		results[i].filename = filenames[i];
+	g_test_timer_start ();
+	nm_keyfile_plugin_connections_from_files (results, n, NULL);
+	t_parse = g_test_timer_elapsed ();
+	_read_results_free (results, n);
+
+	g_test_timer_start ();
+	results = _read_with_cache (cache_file, filenames, n, TRUE);
+	t_cold = g_test_timer_elapsed ();
+	_read_results_free (results, n);
+
+	g_test_timer_start ();
+	results = _read_with_cache (cache_file, filenames, n, TRUE);
+	t_warm = g_test_timer_elapsed ();
+	for (i = 0; i < n; i++)
+		g_assert (results[i].from_cache);
+	_read_results_free (results, n);
+
+	g_test_message ("%u profiles: no cache %.3f msec, cold cache %.3f msec, warm cache %.3f msec",
+	                n, t_parse * 1000, t_cold * 1000, t_warm * 1000);
+
+	_remove_test_connections (dir, filenames, cache_file);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int main (int argc, char **argv)
@@ -3622,6 +3837,10 @@ int main (int argc, char **argv)
 
 	g_test_add_func ("/keyfile/test_nm_keyfile_plugin_utils_escape_filename ", test_nm_keyfile_plugin_utils_escape_filename);
 
+	g_test_add_func ("/keyfile/test_read_files_parallel", test_read_files_parallel);
+	g_test_add_func ("/keyfile/test_read_files_cache", test_read_files_cache);
+	g_test_add_func ("/keyfile/test_read_files_cache/bench", test_read_files_cache_bench);
+
 	return g_test_run ();
 }
 
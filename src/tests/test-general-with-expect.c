@@ -29,7 +29,11 @@
 
 #include "nm-default.h"
 #include "NetworkManagerUtils.h"
+#include "nm-core-internal.h"
+#include "nm-expiry-queue.h"
+#include "nm-group-index.h"
 #include "nm-multi-index.h"
+#include "settings/nm-settings-index.h"
 
 #include "nm-test-utils.h"
 
@@ -855,6 +859,526 @@ test_nm_multi_index (void)
 
 /*******************************************/
 
+typedef struct {
+	NMGroupIndexNode node;
+	int bucket;
+} NMGroupIndexTestValue;
+
+static guint
+_gi_idx_hash (gconstpointer id)
+{
+	return *((const guint *) id);
+}
+
+static gboolean
+_gi_idx_equal (gconstpointer a, gconstpointer b)
+{
+	return *((const guint *) a) == *((const guint *) b);
+}
+
+static void
+_gi_assert_index (const NMGroupIndex *index, const NMGroupIndexTestValue *array, guint num_values, guint num_buckets)
+{
+	guint bucket, i, j, len, n_groups = 0, n_values = 0;
+	void *const*values;
+
+	for (bucket = 0; bucket < num_buckets; bucket++) {
+		values = nm_group_index_lookup (index, &bucket, &len);
+		if (!values) {
+			g_assert_cmpint (len, ==, 0);
+			for (i = 0; i < num_values; i++)
+				g_assert_cmpint (array[i].bucket, !=, bucket);
+			continue;
+		}
+		n_groups++;
+		g_assert_cmpint (len, >, 0);
+		g_assert (!values[len]);
+		for (j = 0; j < len; j++) {
+			const NMGroupIndexTestValue *v = values[j];
+
+			g_assert (v >= array && v < &array[num_values]);
+			g_assert_cmpint (v->bucket, ==, bucket);
+			g_assert (nm_group_index_node_is_linked (&v->node));
+			g_assert_cmpint (*((const guint *) nm_group_index_node_get_id (&v->node)), ==, bucket);
+			n_values++;
+		}
+	}
+	for (i = 0; i < num_values; i++) {
+		if (array[i].bucket >= 0)
+			n_values--;
+	}
+	g_assert_cmpint (n_values, ==, 0);
+	g_assert_cmpint (n_groups, ==, nm_group_index_get_num_groups (index));
+}
+
+static void
+_gi_test_run (guint num_values, guint num_buckets)
+{
+	NMGroupIndex *index = nm_group_index_new (_gi_idx_hash, _gi_idx_equal, sizeof (guint));
+	gs_free NMGroupIndexTestValue *array = g_new0 (NMGroupIndexTestValue, num_values);
+	GRand *rand = nmtst_get_rand ();
+	guint i;
+
+	for (i = 0; i < num_values; i++)
+		array[i].bucket = -1;
+
+	for (i = 0; i < 5 * num_values; i++) {
+		NMGroupIndexTestValue *v = &array[g_rand_int_range (rand, 0, num_values)];
+		guint bucket = g_rand_int_range (rand, 0, num_buckets);
+
+		if (g_rand_boolean (rand)) {
+			if (nm_group_index_add (index, &bucket, v, &v->node)) {
+				g_assert_cmpint (v->bucket, ==, -1);
+				v->bucket = bucket;
+			} else
+				g_assert_cmpint (v->bucket, >=, 0);
+		} else {
+			if (nm_group_index_remove (index, v, &v->node)) {
+				g_assert_cmpint (v->bucket, >=, 0);
+				v->bucket = -1;
+			} else
+				g_assert_cmpint (v->bucket, ==, -1);
+		}
+		_gi_assert_index (index, array, num_values, num_buckets);
+	}
+
+	nm_group_index_free (index);
+
+	/* freeing the index unlinks all the nodes. */
+	for (i = 0; i < num_values; i++)
+		g_assert (!nm_group_index_node_is_linked (&array[i].node));
+}
+
+static void
+test_nm_group_index (void)
+{
+	guint i, j;
+
+	for (i = 1; i < 7; i++) {
+		for (j = 1; j < 6; j++)
+			_gi_test_run (i, j);
+	}
+	_gi_test_run (50, 3);
+	_gi_test_run (50, 18);
+}
+
+/* Compare NMGroupIndex with NMMultiIndex for the access pattern of the
+ * platform cache during a route flap: one large group (all the routes
+ * of an interface) where single values get removed and re-added, and
+ * the group is looked up after every change. */
+static void
+test_nm_group_index_bench (void)
+{
+	const guint num_values = nmtst_test_quick () ? 2000 : 20000;
+	const guint num_flaps = num_values;
+	gs_free NMGroupIndexTestValue *array = g_new0 (NMGroupIndexTestValue, num_values);
+	GRand *rand = nmtst_get_rand ();
+	NMMultiIndexIdTest mi_id = { .bucket = 1 };
+	guint gi_id = 1;
+	NMMultiIndex *mi;
+	NMGroupIndex *gi;
+	guint i, len;
+	gdouble t_mi, t_gi;
+
+	mi = nm_multi_index_new ((NMMultiIndexFuncHash) _mi_idx_hash,
+	                         (NMMultiIndexFuncEqual) _mi_idx_equal,
+	                         (NMMultiIndexFuncClone) _mi_idx_clone,
+	                         (NMMultiIndexFuncDestroy) _mi_idx_destroy);
+	g_test_timer_start ();
+	for (i = 0; i < num_values; i++)
+		nm_multi_index_add (mi, &mi_id.id_base, &array[i]);
+	for (i = 0; i < num_flaps; i++) {
+		NMGroupIndexTestValue *v = &array[g_rand_int_range (rand, 0, num_values)];
+
+		nm_multi_index_remove (mi, &mi_id.id_base, v);
+		nm_multi_index_lookup (mi, &mi_id.id_base, &len);
+		g_assert_cmpint (len, ==, num_values - 1);
+		nm_multi_index_add (mi, &mi_id.id_base, v);
+		nm_multi_index_lookup (mi, &mi_id.id_base, &len);
+		g_assert_cmpint (len, ==, num_values);
+	}
+	for (i = 0; i < num_values; i++)
+		nm_multi_index_remove (mi, &mi_id.id_base, &array[i]);
+	t_mi = g_test_timer_elapsed ();
+	g_assert_cmpint (nm_multi_index_get_num_groups (mi), ==, 0);
+	nm_multi_index_free (mi);
+
+	gi = nm_group_index_new (_gi_idx_hash, _gi_idx_equal, sizeof (guint));
+	g_test_timer_start ();
+	for (i = 0; i < num_values; i++)
+		nm_group_index_add (gi, &gi_id, &array[i], &array[i].node);
+	for (i = 0; i < num_flaps; i++) {
+		NMGroupIndexTestValue *v = &array[g_rand_int_range (rand, 0, num_values)];
+
+		nm_group_index_remove (gi, v, &v->node);
+		nm_group_index_lookup (gi, &gi_id, &len);
+		g_assert_cmpint (len, ==, num_values - 1);
+		nm_group_index_add (gi, &gi_id, v, &v->node);
+		nm_group_index_lookup (gi, &gi_id, &len);
+		g_assert_cmpint (len, ==, num_values);
+	}
+	for (i = 0; i < num_values; i++)
+		nm_group_index_remove (gi, &array[i], &array[i].node);
+	t_gi = g_test_timer_elapsed ();
+	g_assert_cmpint (nm_group_index_get_num_groups (gi), ==, 0);
+	nm_group_index_free (gi);
+
+	g_test_message ("%u values, %u flaps: NMMultiIndex %.3f msec, NMGroupIndex %.3f msec",
+	                num_values, num_flaps, t_mi * 1000, t_gi * 1000);
+}
+
+/*******************************************/
+
+typedef struct {
+	NMExpiryQueueNode node;
+	gint64 expiry;
+} NMExpiryQueueTestValue;
+
+typedef struct {
+	GMainLoop *loop;
+	NMExpiryQueue *queue;
+	gint64 last_expiry;
+	guint n_expired;
+} NMExpiryQueueTestData;
+
+static void
+_eq_expired_cb (NMExpiryQueueNode *node, gpointer user_data)
+{
+	NMExpiryQueueTestData *data = user_data;
+	NMExpiryQueueTestValue *v = (NMExpiryQueueTestValue *) node;
+
+	g_assert (!nm_expiry_queue_node_is_queued (node));
+	g_assert_cmpint (v->expiry, <=, nm_utils_get_monotonic_timestamp_ns ());
+	g_assert_cmpint (v->expiry, >=, data->last_expiry);
+	data->last_expiry = v->expiry;
+	v->expiry = -1;
+	data->n_expired++;
+
+	if (nm_expiry_queue_get_length (data->queue) == 0)
+		g_main_loop_quit (data->loop);
+}
+
+static void
+test_nm_expiry_queue (void)
+{
+	const guint num_values = 50;
+	gs_free NMExpiryQueueTestValue *array = g_new0 (NMExpiryQueueTestValue, num_values);
+	NMExpiryQueueTestData data = { 0 };
+	GRand *rand = nmtst_get_rand ();
+	gint64 now_ns, min;
+	guint i, j, n_queued = 0;
+
+	data.queue = nm_expiry_queue_new (_eq_expired_cb, &data);
+	now_ns = nm_utils_get_monotonic_timestamp_ns ();
+
+	for (i = 0; i < num_values; i++)
+		array[i].expiry = -1;
+
+	/* schedule, reschedule and remove values in random order. The
+	 * head of the queue must always be the earliest expiry. */
+	for (i = 0; i < 10 * num_values; i++) {
+		NMExpiryQueueTestValue *v = &array[g_rand_int_range (rand, 0, num_values)];
+
+		if (g_rand_int_range (rand, 0, 3) > 0) {
+			if (v->expiry < 0)
+				n_queued++;
+			v->expiry = now_ns + g_rand_int_range (rand, 1, 50) * (NM_UTILS_NS_PER_SECOND / 1000);
+			nm_expiry_queue_schedule (data.queue, &v->node, v->expiry);
+		} else {
+			g_assert (nm_expiry_queue_remove (data.queue, &v->node) == (v->expiry >= 0));
+			if (v->expiry >= 0)
+				n_queued--;
+			v->expiry = -1;
+		}
+
+		g_assert_cmpint (nm_expiry_queue_get_length (data.queue), ==, n_queued);
+		min = G_MAXINT64;
+		for (j = 0; j < num_values; j++) {
+			g_assert (nm_expiry_queue_node_is_queued (&array[j].node) == (array[j].expiry >= 0));
+			if (array[j].expiry >= 0)
+				min = MIN (min, array[j].expiry);
+		}
+		if (n_queued == 0)
+			g_assert (!nm_expiry_queue_peek (data.queue));
+		else
+			g_assert_cmpint (nm_expiry_queue_node_get_expiry (nm_expiry_queue_peek (data.queue)), ==, min);
+	}
+
+	/* all the remaining values expire from the main loop, in order. */
+	if (n_queued > 0) {
+		data.loop = g_main_loop_new (NULL, FALSE);
+		if (!nmtst_main_loop_run (data.loop, 2000))
+			g_assert_not_reached ();
+		g_main_loop_unref (data.loop);
+	}
+	g_assert_cmpint (data.n_expired, ==, n_queued);
+	for (i = 0; i < num_values; i++)
+		g_assert (!nm_expiry_queue_node_is_queued (&array[i].node));
+
+	nm_expiry_queue_free (data.queue);
+}
+
+/*******************************************/
+
+/* sort like NMSettings: autoconnect first, then by the most recent
+ * timestamp. As in NMSettingsConnection, the timestamp is not part
+ * of the settings. */
+static int
+_index_sort (gconstpointer pa, gconstpointer pb)
+{
+	NMConnection *a = (NMConnection *) pa;
+	NMConnection *b = (NMConnection *) pb;
+	gboolean can_ac_a, can_ac_b;
+	guint ts_a, ts_b;
+
+	can_ac_a = !!nm_setting_connection_get_autoconnect (nm_connection_get_setting_connection (a));
+	can_ac_b = !!nm_setting_connection_get_autoconnect (nm_connection_get_setting_connection (b));
+	if (can_ac_a != can_ac_b)
+		return can_ac_a ? -1 : 1;
+
+	ts_a = GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (a), "timestamp"));
+	ts_b = GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (b), "timestamp"));
+	if (ts_a > ts_b)
+		return -1;
+	else if (ts_a == ts_b)
+		return 0;
+	return 1;
+}
+
+static void
+test_nm_settings_index_uuid (void)
+{
+	NMSettingsIndex *index;
+	gs_unref_object NMConnection *a = NULL;
+	gs_unref_object NMConnection *b = NULL;
+	gs_unref_object NMConnection *dup = NULL;
+	gs_free char *uuid_a = NULL;
+	gs_free char *uuid_b = NULL;
+	gs_free char *uuid_new = nm_utils_uuid_generate ();
+
+	a = nmtst_create_minimal_connection ("a", NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+	b = nmtst_create_minimal_connection ("b", NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+	uuid_a = g_strdup (nm_connection_get_uuid (a));
+	uuid_b = g_strdup (nm_connection_get_uuid (b));
+
+	index = nm_settings_index_new (_index_sort);
+
+	/* claim */
+	nm_settings_index_add (index, a);
+	nm_settings_index_add (index, b);
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_a) == a);
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_b) == b);
+	g_assert (!nm_settings_index_lookup_uuid (index, uuid_new));
+
+	/* an update that keeps the UUID */
+	g_object_set (nm_connection_get_setting_connection (a),
+	              NM_SETTING_CONNECTION_ID, "a2",
+	              NULL);
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_a) == a);
+
+	/* the UUID changes. The index must follow right away, not only
+	 * after NMSettingsConnection emitted "updated" from an idle handler. */
+	g_object_set (nm_connection_get_setting_connection (a),
+	              NM_SETTING_CONNECTION_UUID, uuid_new,
+	              NULL);
+	g_assert (!nm_settings_index_lookup_uuid (index, uuid_a));
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_new) == a);
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_b) == b);
+
+	/* remove */
+	nm_settings_index_remove (index, a);
+	g_assert (!nm_settings_index_lookup_uuid (index, uuid_new));
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_b) == b);
+
+	/* a removed connection is no longer tracked */
+	g_object_set (nm_connection_get_setting_connection (a),
+	              NM_SETTING_CONNECTION_UUID, uuid_a,
+	              NULL);
+	g_assert (!nm_settings_index_lookup_uuid (index, uuid_a));
+
+	/* claim again after the UUID changed */
+	nm_settings_index_add (index, a);
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_a) == a);
+
+	/* another connection with the same UUID doesn't take over the entry,
+	 * but gets it once the first one is gone. */
+	dup = nmtst_create_minimal_connection ("dup", uuid_b, NM_SETTING_WIRED_SETTING_NAME, NULL);
+	nm_settings_index_add (index, dup);
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_b) == b);
+	nm_settings_index_remove (index, b);
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_b) == dup);
+	nm_settings_index_add (index, b);
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_b) == dup);
+
+	/* removing or changing the connection that doesn't own the entry
+	 * leaves it alone. */
+	nm_settings_index_remove (index, b);
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_b) == dup);
+	nm_settings_index_add (index, b);
+	g_object_set (nm_connection_get_setting_connection (b),
+	              NM_SETTING_CONNECTION_UUID, uuid_new,
+	              NULL);
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_b) == dup);
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_new) == b);
+
+	/* the owner changes its UUID, the other connection takes over. */
+	g_object_set (nm_connection_get_setting_connection (dup),
+	              NM_SETTING_CONNECTION_UUID, uuid_a,
+	              NULL);
+	g_assert (!nm_settings_index_lookup_uuid (index, uuid_b));
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_a) == a);
+	nm_settings_index_remove (index, a);
+	g_assert (nm_settings_index_lookup_uuid (index, uuid_a) == dup);
+
+	nm_settings_index_free (index);
+
+	/* the index disconnected from the connections it still had. */
+	g_object_set (nm_connection_get_setting_connection (b),
+	              NM_SETTING_CONNECTION_UUID, uuid_new,
+	              NULL);
+}
+
+/* Time UUID lookups in an index filled with @num_connections, like
+ * nm_settings_get_connection_by_uuid() does them. */
+static void
+_index_uuid_lookup_bench (guint num_connections)
+{
+	const guint num_lookups = 100000;
+	gs_free NMConnection **array = g_new (NMConnection *, num_connections);
+	GRand *rand = nmtst_get_rand ();
+	NMSettingsIndex *index;
+	guint i;
+	gdouble t_add, t_lookup;
+
+	for (i = 0; i < num_connections; i++)
+		array[i] = nmtst_create_minimal_connection ("bench", NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+
+	index = nm_settings_index_new (_index_sort);
+
+	g_test_timer_start ();
+	for (i = 0; i < num_connections; i++)
+		nm_settings_index_add (index, array[i]);
+	t_add = g_test_timer_elapsed ();
+
+	g_test_timer_start ();
+	for (i = 0; i < num_lookups; i++) {
+		NMConnection *connection = array[g_rand_int_range (rand, 0, num_connections)];
+
+		g_assert (nm_settings_index_lookup_uuid (index, nm_connection_get_uuid (connection)) == connection);
+	}
+	t_lookup = g_test_timer_elapsed ();
+
+	g_test_message ("%u connections: add %.3f msec, %u lookups %.3f msec",
+	                num_connections, t_add * 1000, num_lookups, t_lookup * 1000);
+
+	nm_settings_index_free (index);
+	for (i = 0; i < num_connections; i++)
+		g_object_unref (array[i]);
+}
+
+static void
+test_nm_settings_index_uuid_bench (void)
+{
+	_index_uuid_lookup_bench (1000);
+	_index_uuid_lookup_bench (10000);
+	if (!nmtst_test_quick ())
+		_index_uuid_lookup_bench (100000);
+}
+
+static NMConnection *
+_index_connection_new (const char *id, gboolean autoconnect, guint timestamp)
+{
+	NMConnection *connection;
+
+	connection = nmtst_create_minimal_connection (id, NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+	g_object_set (nm_connection_get_setting_connection (connection),
+	              NM_SETTING_CONNECTION_AUTOCONNECT, autoconnect,
+	              NULL);
+	g_object_set_data (G_OBJECT (connection), "timestamp", GUINT_TO_POINTER (timestamp));
+	return connection;
+}
+
+static void
+_index_assert_sorted (NMSettingsIndex *index, guint n, ...)
+{
+	NMConnection *const*sorted;
+	guint i, len;
+	va_list ap;
+
+	sorted = nm_settings_index_get_sorted (index, &len);
+	g_assert_cmpint (len, ==, n);
+
+	va_start (ap, n);
+	for (i = 0; i < n; i++)
+		g_assert (sorted[i] == va_arg (ap, NMConnection *));
+	va_end (ap);
+}
+
+static void
+test_nm_settings_index_sorted (void)
+{
+	NMSettingsIndex *index;
+	gs_unref_object NMConnection *a = _index_connection_new ("a", TRUE, 10);
+	gs_unref_object NMConnection *b = _index_connection_new ("b", TRUE, 20);
+	gs_unref_object NMConnection *c = _index_connection_new ("c", FALSE, 30);
+	gs_unref_object NMConnection *d = _index_connection_new ("d", TRUE, 10);
+
+	index = nm_settings_index_new (_index_sort);
+
+	/* insert */
+	nm_settings_index_add (index, a);
+	_index_assert_sorted (index, 1, a);
+	nm_settings_index_add (index, c);
+	_index_assert_sorted (index, 2, a, c);
+	nm_settings_index_add (index, b);
+	_index_assert_sorted (index, 3, b, a, c);
+
+	/* connections that compare equal are kept in the order they were added. */
+	nm_settings_index_add (index, d);
+	_index_assert_sorted (index, 4, b, a, d, c);
+
+	/* the autoconnect flag changes. The connection must move right away,
+	 * not only after NMSettingsConnection emitted "updated" from an idle
+	 * handler. */
+	g_object_set (nm_connection_get_setting_connection (c),
+	              NM_SETTING_CONNECTION_AUTOCONNECT, TRUE,
+	              NULL);
+	_index_assert_sorted (index, 4, c, b, a, d);
+	g_object_set (nm_connection_get_setting_connection (b),
+	              NM_SETTING_CONNECTION_AUTOCONNECT, FALSE,
+	              NULL);
+	_index_assert_sorted (index, 4, c, a, d, b);
+
+	/* a change that keeps the position */
+	g_object_set (nm_connection_get_setting_connection (a),
+	              NM_SETTING_CONNECTION_ID, "a2",
+	              NULL);
+	_index_assert_sorted (index, 4, c, a, d, b);
+
+	/* the timestamp changes */
+	g_object_set_data (G_OBJECT (d), "timestamp", GUINT_TO_POINTER (40));
+	nm_settings_index_reorder (index, d);
+	_index_assert_sorted (index, 4, d, c, a, b);
+	g_object_set_data (G_OBJECT (d), "timestamp", GUINT_TO_POINTER (5));
+	nm_settings_index_reorder (index, d);
+	_index_assert_sorted (index, 4, c, a, d, b);
+
+	/* remove */
+	nm_settings_index_remove (index, a);
+	_index_assert_sorted (index, 3, c, d, b);
+
+	/* a removed connection is no longer reordered */
+	g_object_set (nm_connection_get_setting_connection (a),
+	              NM_SETTING_CONNECTION_AUTOCONNECT, FALSE,
+	              NULL);
+	nm_settings_index_reorder (index, a);
+	_index_assert_sorted (index, 3, c, d, b);
+
+	nm_settings_index_free (index);
+}
+
+/*******************************************/
+
 static void
 test_nm_utils_new_vlan_name (void)
 {
@@ -910,6 +1434,12 @@ main (int argc, char **argv)
 	g_test_add_func ("/general/nm_utils_array_remove_at_indexes", test_nm_utils_array_remove_at_indexes);
 	g_test_add_func ("/general/nm_ethernet_address_is_valid", test_nm_ethernet_address_is_valid);
 	g_test_add_func ("/general/nm_multi_index", test_nm_multi_index);
+	g_test_add_func ("/general/nm_group_index", test_nm_group_index);
+	g_test_add_func ("/general/nm_group_index/bench", test_nm_group_index_bench);
+	g_test_add_func ("/general/nm_expiry_queue", test_nm_expiry_queue);
+	g_test_add_func ("/general/nm_settings_index/uuid", test_nm_settings_index_uuid);
+	g_test_add_func ("/general/nm_settings_index/uuid/bench", test_nm_settings_index_uuid_bench);
+	g_test_add_func ("/general/nm_settings_index/sorted", test_nm_settings_index_sorted);
 	g_test_add_func ("/general/nm_utils_new_vlan_name", test_nm_utils_new_vlan_name);
 
 	return g_test_run ();
@@ -22,10 +22,12 @@
 
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
 
 #include "nm-default.h"
 #include "NetworkManagerUtils.h"
 #include "nm-core-internal.h"
+#include "settings/nm-settings-state-db.h"
 
 #include "nm-test-utils.h"
 
@@ -1113,6 +1115,99 @@ test_nm_utils_strbuf_append (void)
 
 /*******************************************/
 
+static guint
+_state_db_count_lines (const char *filename)
+{
+	gs_free char *contents = NULL;
+	guint n = 0;
+	const char *p;
+
+	if (!g_file_get_contents (filename, &contents, NULL, NULL))
+		return 0;
+	for (p = contents; *p; p++) {
+		if (*p == '\n')
+			n++;
+	}
+	return n;
+}
+
+static void
+test_nm_settings_state_db (void)
+{
+	gs_free char *dir = NULL;
+	gs_free char *filename = NULL;
+	NMSettingsStateDB *db;
+	GKeyFile *keyfile;
+	gs_free char *value = NULL;
+	guint i;
+
+	dir = g_dir_make_tmp ("nm-test-state-db-XXXXXX", NULL);
+	g_assert (dir);
+	filename = g_build_filename (dir, "timestamps", NULL);
+
+	db = nm_settings_state_db_new (filename, "timestamps");
+	g_assert (!nm_settings_state_db_get (db, "a"));
+	nm_settings_state_db_set (db, "a", "1");
+	nm_settings_state_db_set (db, "b", "2");
+	nm_settings_state_db_set (db, "a", "3");
+	g_assert_cmpstr (nm_settings_state_db_get (db, "a"), ==, "3");
+	nm_settings_state_db_free (db);
+
+	/* the updates were appended and the last line wins, also for GKeyFile. */
+	g_assert_cmpint (_state_db_count_lines (filename), ==, 4);
+	keyfile = g_key_file_new ();
+	g_assert (g_key_file_load_from_file (keyfile, filename, G_KEY_FILE_NONE, NULL));
+	value = g_key_file_get_value (keyfile, "timestamps", "a", NULL);
+	g_assert_cmpstr (value, ==, "3");
+	g_key_file_free (keyfile);
+
+	db = nm_settings_state_db_new (filename, "timestamps");
+	g_assert_cmpstr (nm_settings_state_db_get (db, "a"), ==, "3");
+	g_assert_cmpstr (nm_settings_state_db_get (db, "b"), ==, "2");
+
+	/* removing a key rewrites the file. */
+	nm_settings_state_db_remove (db, "b");
+	g_assert (!nm_settings_state_db_get (db, "b"));
+	g_assert_cmpint (_state_db_count_lines (filename), ==, 2);
+
+	/* setting the same value does not touch the file. */
+	nm_settings_state_db_set (db, "a", "3");
+	g_assert_cmpint (_state_db_count_lines (filename), ==, 2);
+
+	/* superseded lines get compacted. */
+	for (i = 0; i < 1000; i++) {
+		char buf[20];
+
+		g_snprintf (buf, sizeof (buf), "%u", i);
+		nm_settings_state_db_set (db, "a", buf);
+	}
+	g_assert_cmpint (_state_db_count_lines (filename), <=, 2 + 64 + 1);
+	nm_settings_state_db_free (db);
+
+	db = nm_settings_state_db_new (filename, "timestamps");
+	g_assert_cmpstr (nm_settings_state_db_get (db, "a"), ==, "999");
+	g_assert (!nm_settings_state_db_get (db, "b"));
+	nm_settings_state_db_free (db);
+
+	/* a truncated last line is ignored. */
+	g_assert (g_file_set_contents (filename, "[timestamps]\na=1\nb=2", -1, NULL));
+	db = nm_settings_state_db_new (filename, "timestamps");
+	g_assert_cmpstr (nm_settings_state_db_get (db, "a"), ==, "1");
+	g_assert (!nm_settings_state_db_get (db, "b"));
+	nm_settings_state_db_set (db, "c", "3");
+	nm_settings_state_db_free (db);
+
+	db = nm_settings_state_db_new (filename, "timestamps");
+	g_assert_cmpstr (nm_settings_state_db_get (db, "a"), ==, "1");
+	g_assert_cmpstr (nm_settings_state_db_get (db, "c"), ==, "3");
+	nm_settings_state_db_free (db);
+
+	unlink (filename);
+	rmdir (dir);
+}
+
+/*******************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -1142,6 +1237,8 @@ main (int argc, char **argv)
 	g_test_add_func ("/general/nm_match_spec_interface_name", test_nm_match_spec_interface_name);
 	g_test_add_func ("/general/nm_match_spec_match_config", test_nm_match_spec_match_config);
 
+	g_test_add_func ("/general/nm_settings_state_db", test_nm_settings_state_db);
+
 	return g_test_run ();
 }
 
@@ -26,6 +26,7 @@
 #include "nm-default.h"
 #include "nm-ip4-config.h"
 #include "nm-platform.h"
+#include "NetworkManagerUtils.h"
 
 #include "nm-test-utils.h"
 
@@ -361,6 +362,453 @@ test_strip_search_trailing_dot (void)
 	g_object_unref (config);
 }
 
+static const NMPlatformIP4Route *
+_direct_route_for_host_linear (NMIP4Config *config, guint32 host)
+{
+	const NMPlatformIP4Route *best_route = NULL;
+	guint i;
+
+	for (i = 0; i < nm_ip4_config_get_num_routes (config); i++) {
+		const NMPlatformIP4Route *item = nm_ip4_config_get_route (config, i);
+
+		if (item->gateway != 0)
+			continue;
+		if (nm_utils_ip4_address_clear_host_address (host, item->plen) != nm_utils_ip4_address_clear_host_address (item->network, item->plen))
+			continue;
+		if (   best_route
+		    && (   best_route->plen > item->plen
+		        || (best_route->plen == item->plen && best_route->metric <= item->metric)))
+			continue;
+		best_route = item;
+	}
+	return best_route;
+}
+
+static void
+test_direct_route_for_host (void)
+{
+	NMIP4Config *config;
+	NMPlatformIP4Route route;
+	NMPlatformIP4Address addr;
+	const NMPlatformIP4Route *r;
+	GRand *rand = nmtst_get_rand ();
+	const guint num_routes = nmtst_test_quick () ? 3000 : 20000;
+	const guint num_lookups = 20000;
+	gs_free guint32 *hosts = NULL;
+	gdouble t_linear, t_trie;
+	guint i;
+
+	config = nm_ip4_config_new (1);
+
+	route_new (&route, "10.0.0.0", 8, NULL);
+	route.metric = 10;
+	nm_ip4_config_add_route (config, &route);
+	route_new (&route, "10.1.0.0", 16, NULL);
+	route.metric = 20;
+	nm_ip4_config_add_route (config, &route);
+	route_new (&route, "10.1.2.0", 24, "10.0.0.1");
+	nm_ip4_config_add_route (config, &route);
+
+	/* the longest prefix wins, regardless of the metric. Routes with
+	 * gateway are not direct. */
+	r = nm_ip4_config_get_direct_route_for_host (config, addr_to_num ("10.1.2.3"));
+	g_assert (r);
+	g_assert_cmpint (r->plen, ==, 16);
+	r = nm_ip4_config_get_direct_route_for_host (config, addr_to_num ("10.2.0.1"));
+	g_assert (r);
+	g_assert_cmpint (r->plen, ==, 8);
+	g_assert (!nm_ip4_config_get_direct_route_for_host (config, addr_to_num ("11.0.0.1")));
+
+	/* the index follows changes of the routes. */
+	nm_ip4_config_del_route (config, 1);
+	r = nm_ip4_config_get_direct_route_for_host (config, addr_to_num ("10.1.2.3"));
+	g_assert (r);
+	g_assert_cmpint (r->plen, ==, 8);
+
+	addr_init (&addr, "192.168.1.10", "192.168.1.10", 24);
+	nm_ip4_config_add_address (config, &addr);
+	g_assert (nm_ip4_config_destination_is_direct (config, addr_to_num ("192.168.1.1"), 32));
+	g_assert (nm_ip4_config_destination_is_direct (config, addr_to_num ("192.168.1.0"), 24));
+	g_assert (!nm_ip4_config_destination_is_direct (config, addr_to_num ("192.168.0.0"), 16));
+	g_assert (!nm_ip4_config_destination_is_direct (config, addr_to_num ("192.168.2.1"), 32));
+
+	/* compare against a linear scan with many routes. */
+	nm_ip4_config_reset_routes (config);
+	for (i = 0; i < num_routes; i++) {
+		memset (&route, 0, sizeof (route));
+		route.plen = g_rand_int_range (rand, 8, 33);
+		route.network = nm_utils_ip4_address_clear_host_address (htonl (0x0a000000 | (g_rand_int (rand) & 0x00FFFFFF)), route.plen);
+		route.metric = g_rand_int_range (rand, 0, 4);
+		if (g_rand_int_range (rand, 0, 10) == 0)
+			route.gateway = addr_to_num ("10.0.0.1");
+		nm_ip4_config_add_route (config, &route);
+	}
+
+	hosts = g_new (guint32, num_lookups);
+	for (i = 0; i < num_lookups; i++)
+		hosts[i] = htonl (0x0a000000 | (g_rand_int (rand) & 0x00FFFFFF));
+
+	g_test_timer_start ();
+	for (i = 0; i < num_lookups; i++)
+		_direct_route_for_host_linear (config, hosts[i]);
+	t_linear = g_test_timer_elapsed ();
+
+	g_test_timer_start ();
+	for (i = 0; i < num_lookups; i++)
+		nm_ip4_config_get_direct_route_for_host (config, hosts[i]);
+	t_trie = g_test_timer_elapsed ();
+
+	g_test_message ("%u lookups in %u routes: linear %.3f msec, trie %.3f msec",
+	                num_lookups, nm_ip4_config_get_num_routes (config), t_linear * 1000, t_trie * 1000);
+
+	for (i = 0; i < num_lookups; i++) {
+		const NMPlatformIP4Route *r1 = _direct_route_for_host_linear (config, hosts[i]);
+		const NMPlatformIP4Route *r2 = nm_ip4_config_get_direct_route_for_host (config, hosts[i]);
+
+		g_assert ((!r1) == (!r2));
+		if (r1) {
+			g_assert_cmpint (r1->plen, ==, r2->plen);
+			g_assert_cmpint (r1->metric, ==, r2->metric);
+		}
+	}
+
+	g_object_unref (config);
+}
+
+static void
+_fill_many (NMIP4Config *config, guint num, guint step, guint32 metric)
+{
+	NMPlatformIP4Address addr;
+	NMPlatformIP4Route route;
+	guint i;
+
+	for (i = 0; i < num; i += step) {
+		memset (&addr, 0, sizeof (addr));
+		addr.address = htonl (0x0b000000 + i);
+		addr.peer_address = addr.address;
+		addr.plen = 32;
+		nm_ip4_config_add_address (config, &addr);
+
+		memset (&route, 0, sizeof (route));
+		route.network = htonl (0x0a000000 + i);
+		route.plen = 32;
+		route.metric = metric;
+		nm_ip4_config_add_route (config, &route);
+	}
+}
+
+static void
+test_many_addresses_and_routes (void)
+{
+	NMIP4Config *config, *even, *copy;
+	const guint num = nmtst_test_quick () ? 3000 : 20000;
+	gdouble t;
+	guint i;
+
+	config = nm_ip4_config_new (1);
+
+	g_test_timer_start ();
+	_fill_many (config, num, 1, 10);
+	t = g_test_timer_elapsed ();
+	g_test_message ("adding %u addresses and routes took %.3f msec", num, t * 1000);
+
+	g_assert_cmpint (nm_ip4_config_get_num_addresses (config), ==, num);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (config), ==, num);
+
+	/* adding them again overwrites the existing entries. */
+	_fill_many (config, num, 1, 20);
+	g_assert_cmpint (nm_ip4_config_get_num_addresses (config), ==, num);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (config), ==, num);
+	for (i = 0; i < num; i++) {
+		g_assert_cmpint (nm_ip4_config_get_route (config, i)->network, ==, htonl (0x0a000000 + i));
+		g_assert_cmpint (nm_ip4_config_get_route (config, i)->metric, ==, 20);
+	}
+
+	/* the index follows deletions. */
+	nm_ip4_config_del_route (config, 0);
+	nm_ip4_config_del_address (config, 0);
+	_fill_many (config, 1, 1, 20);
+	g_assert_cmpint (nm_ip4_config_get_num_addresses (config), ==, num);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (config), ==, num);
+	g_assert_cmpint (nm_ip4_config_get_route (config, num - 1)->network, ==, htonl (0x0a000000));
+
+	even = nm_ip4_config_new (1);
+	_fill_many (even, num, 2, 20);
+
+	copy = nm_ip4_config_new (1);
+	nm_ip4_config_replace (copy, config, NULL);
+
+	g_test_timer_start ();
+	nm_ip4_config_subtract (config, even);
+	t = g_test_timer_elapsed ();
+	g_test_message ("subtracting %u addresses and routes took %.3f msec", num / 2, t * 1000);
+
+	g_assert_cmpint (nm_ip4_config_get_num_addresses (config), ==, num / 2);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (config), ==, num / 2);
+	for (i = 0; i < num / 2; i++) {
+		g_assert_cmpint (nm_ip4_config_get_route (config, i)->network, ==, htonl (0x0a000000 + 2 * i + 1));
+		g_assert_cmpint (nm_ip4_config_get_address (config, i)->address, ==, htonl (0x0b000000 + 2 * i + 1));
+	}
+
+	nm_ip4_config_intersect (copy, even);
+	g_assert_cmpint (nm_ip4_config_get_num_addresses (copy), ==, num / 2);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (copy), ==, num / 2);
+	for (i = 0; i < num / 2; i++) {
+		g_assert_cmpint (ntohl (nm_ip4_config_get_route (copy, i)->network) % 2, ==, 0);
+		g_assert_cmpint (ntohl (nm_ip4_config_get_address (copy, i)->address) % 2, ==, 0);
+	}
+
+	nm_ip4_config_intersect (config, even);
+	g_assert_cmpint (nm_ip4_config_get_num_addresses (config), ==, 0);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (config), ==, 0);
+
+	nm_ip4_config_subtract (even, even);
+	g_assert_cmpint (nm_ip4_config_get_num_addresses (even), ==, 0);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (even), ==, 0);
+
+	g_object_unref (config);
+	g_object_unref (even);
+	g_object_unref (copy);
+}
+
+static void
+test_shared_arrays (void)
+{
+	NMIP4Config *src, *dst, *copy;
+	NMPlatformIP4Address addr;
+	NMPlatformIP4Route route;
+
+	src = nm_ip4_config_new (1);
+	_fill_many (src, 100, 1, 10);
+
+	/* merging into an empty config shares the arrays... */
+	dst = nm_ip4_config_new (1);
+	nm_ip4_config_merge (dst, src, NM_IP_CONFIG_MERGE_DEFAULT);
+	g_assert (nm_ip4_config_equal (dst, src));
+	g_assert (nm_ip4_config_get_address (dst, 0) == nm_ip4_config_get_address (src, 0));
+	g_assert (nm_ip4_config_get_route (dst, 0) == nm_ip4_config_get_route (src, 0));
+
+	/* ... until one of them is modified. */
+	addr_init (&addr, "192.168.1.10", NULL, 24);
+	nm_ip4_config_add_address (dst, &addr);
+	g_assert (nm_ip4_config_get_address (dst, 0) != nm_ip4_config_get_address (src, 0));
+	g_assert_cmpint (nm_ip4_config_get_num_addresses (dst), ==, 101);
+	g_assert_cmpint (nm_ip4_config_get_num_addresses (src), ==, 100);
+
+	route_new (&route, "10.0.0.0", 32, NULL);
+	route.metric = 20;
+	nm_ip4_config_add_route (src, &route);
+	g_assert (nm_ip4_config_get_route (dst, 0) != nm_ip4_config_get_route (src, 0));
+	g_assert_cmpint (nm_ip4_config_get_route (src, 0)->metric, ==, 20);
+	g_assert_cmpint (nm_ip4_config_get_route (dst, 0)->metric, ==, 10);
+
+	/* replace shares the arrays too, also between more than two configs. */
+	copy = nm_ip4_config_new (1);
+	nm_ip4_config_replace (copy, src, NULL);
+	nm_ip4_config_replace (dst, src, NULL);
+	g_assert (nm_ip4_config_equal (dst, src));
+	g_assert (nm_ip4_config_equal (copy, src));
+	g_assert (nm_ip4_config_get_route (dst, 0) == nm_ip4_config_get_route (src, 0));
+	g_assert (nm_ip4_config_get_route (copy, 0) == nm_ip4_config_get_route (src, 0));
+
+	nm_ip4_config_del_route (copy, 0);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (copy), ==, 99);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (src), ==, 100);
+	g_assert (nm_ip4_config_get_route (dst, 0) == nm_ip4_config_get_route (src, 0));
+
+	g_object_unref (src);
+	nm_ip4_config_reset_routes (dst);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (dst), ==, 0);
+	g_assert_cmpint (nm_ip4_config_get_num_addresses (dst), ==, 100);
+
+	/* routes of another interface are copied. */
+	src = nm_ip4_config_new (2);
+	_fill_many (src, 10, 1, 10);
+	nm_ip4_config_merge (dst, src, NM_IP_CONFIG_MERGE_DEFAULT);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (dst), ==, 10);
+	g_assert (nm_ip4_config_get_route (dst, 0) != nm_ip4_config_get_route (src, 0));
+	g_assert_cmpint (nm_ip4_config_get_route (dst, 0)->ifindex, ==, 1);
+
+	g_object_unref (src);
+	g_object_unref (dst);
+	g_object_unref (copy);
+}
+
+static GVariant *
+_get_variant_property (NMIP4Config *config, const char *name)
+{
+	GVariant *v = NULL;
+
+	g_object_get (config, name, &v, NULL);
+	g_assert (v);
+	return v;
+}
+
+static void
+test_exported_variants (void)
+{
+	NMIP4Config *config;
+	NMPlatformIP4Address addr;
+	NMPlatformIP4Route route;
+	GVariant *v1, *v2, *entry, *entry2;
+	const char *str;
+	guint32 metric;
+
+	config = nm_ip4_config_new (1);
+	_fill_many (config, 50, 1, 10);
+
+	/* the values are cached until something changes. */
+	v1 = _get_variant_property (config, NM_IP4_CONFIG_ROUTE_DATA);
+	v2 = _get_variant_property (config, NM_IP4_CONFIG_ROUTE_DATA);
+	g_assert (v1 == v2);
+	g_assert_cmpint (g_variant_n_children (v1), ==, 50);
+	g_variant_unref (v2);
+
+	route_new (&route, "10.0.0.1", 32, NULL);
+	route.metric = 42;
+	nm_ip4_config_add_route (config, &route);
+	v2 = _get_variant_property (config, NM_IP4_CONFIG_ROUTE_DATA);
+	g_assert (v1 != v2);
+	g_assert_cmpint (g_variant_n_children (v2), ==, 50);
+
+	entry = g_variant_get_child_value (v2, 1);
+	g_assert (g_variant_lookup (entry, "dest", "&s", &str));
+	g_assert_cmpstr (str, ==, "10.0.0.1");
+	g_assert (g_variant_lookup (entry, "metric", "u", &metric));
+	g_assert_cmpint (metric, ==, 42);
+	g_variant_unref (entry);
+
+	/* unchanged routes keep their entries, changed ones get a new one. */
+	entry = g_variant_get_child_value (v1, 2);
+	entry2 = g_variant_get_child_value (v2, 2);
+	g_assert (entry == entry2);
+	g_variant_unref (entry);
+	g_variant_unref (entry2);
+	entry = g_variant_get_child_value (v1, 1);
+	entry2 = g_variant_get_child_value (v2, 1);
+	g_assert (entry != entry2);
+	g_variant_unref (entry);
+	g_variant_unref (entry2);
+	g_variant_unref (v1);
+	g_variant_unref (v2);
+
+	nm_ip4_config_del_route (config, 0);
+	v1 = _get_variant_property (config, NM_IP4_CONFIG_ROUTE_DATA);
+	g_assert_cmpint (g_variant_n_children (v1), ==, 49);
+	v2 = _get_variant_property (config, NM_IP4_CONFIG_ROUTES);
+	g_assert_cmpint (g_variant_n_children (v2), ==, 49);
+	g_variant_unref (v1);
+	g_variant_unref (v2);
+
+	/* "Addresses" includes the gateway. */
+	nm_ip4_config_reset_addresses (config);
+	addr_init (&addr, "192.168.1.10", NULL, 24);
+	nm_ip4_config_add_address (config, &addr);
+	v1 = _get_variant_property (config, NM_IP4_CONFIG_ADDRESSES);
+	nm_ip4_config_set_gateway (config, addr_to_num ("192.168.1.1"));
+	v2 = _get_variant_property (config, NM_IP4_CONFIG_ADDRESSES);
+	g_assert (!g_variant_equal (v1, v2));
+	g_variant_unref (v1);
+	g_variant_unref (v2);
+
+	g_object_unref (config);
+}
+
+static int
+_strcmp_p (gconstpointer a, gconstpointer b)
+{
+	return strcmp (*((const char **) a), *((const char **) b));
+}
+
+/* collects the routes of a RoutesAdded/RoutesRemoved signal as sorted,
+ * comma separated "dest/prefix metric" string. */
+static void
+_routes_delta_collect (NMIP4Config *config, GVariant *routes, GPtrArray *collected)
+{
+	GVariantIter iter;
+	GVariant *entry;
+	GPtrArray *strs;
+	const char *dest;
+	guint32 prefix, metric;
+
+	strs = g_ptr_array_new_with_free_func (g_free);
+	g_variant_iter_init (&iter, routes);
+	while ((entry = g_variant_iter_next_value (&iter))) {
+		g_assert (g_variant_lookup (entry, "dest", "&s", &dest));
+		g_assert (g_variant_lookup (entry, "prefix", "u", &prefix));
+		g_assert (g_variant_lookup (entry, "metric", "u", &metric));
+		g_ptr_array_add (strs, g_strdup_printf ("%s/%u %u", dest, prefix, metric));
+		g_variant_unref (entry);
+	}
+	g_ptr_array_sort (strs, _strcmp_p);
+	g_ptr_array_add (strs, NULL);
+	g_ptr_array_add (collected, g_strjoinv (",", (char **) strs->pdata));
+	g_ptr_array_unref (strs);
+}
+
+static void
+test_routes_delta (void)
+{
+	NMIP4Config *config;
+	NMPlatformIP4Route route;
+	GPtrArray *added, *removed;
+	GVariant *v;
+
+	added = g_ptr_array_new_with_free_func (g_free);
+	removed = g_ptr_array_new_with_free_func (g_free);
+
+	config = nm_ip4_config_new (1);
+	_fill_many (config, 5, 1, 10);
+	g_signal_connect (config, NM_IP4_CONFIG_ROUTES_ADDED, G_CALLBACK (_routes_delta_collect), added);
+	g_signal_connect (config, NM_IP4_CONFIG_ROUTES_REMOVED, G_CALLBACK (_routes_delta_collect), removed);
+
+	/* the initial RouteData is not announced as a delta. */
+	v = _get_variant_property (config, NM_IP4_CONFIG_ROUTE_DATA);
+	g_variant_unref (v);
+	while (g_main_context_iteration (NULL, FALSE)) {
+	}
+	g_assert_cmpint (added->len, ==, 0);
+	g_assert_cmpint (removed->len, ==, 0);
+
+	/* a changed metric is reported as removed and added again. */
+	route_new (&route, "10.0.0.1", 32, NULL);
+	route.metric = 42;
+	nm_ip4_config_add_route (config, &route);
+	nm_ip4_config_del_route (config, 0);
+
+	/* a route that is added and removed again between two signals
+	 * cancels out, even if RouteData was read in between. */
+	route_new (&route, "10.0.0.100", 32, NULL);
+	route.metric = 10;
+	nm_ip4_config_add_route (config, &route);
+	v = _get_variant_property (config, NM_IP4_CONFIG_ROUTE_DATA);
+	g_assert_cmpint (g_variant_n_children (v), ==, 5);
+	g_variant_unref (v);
+	nm_ip4_config_del_route (config, nm_ip4_config_get_num_routes (config) - 1);
+	v = _get_variant_property (config, NM_IP4_CONFIG_ROUTE_DATA);
+	g_assert_cmpint (g_variant_n_children (v), ==, 4);
+	g_variant_unref (v);
+
+	while (g_main_context_iteration (NULL, FALSE)) {
+	}
+	g_assert_cmpint (removed->len, ==, 1);
+	g_assert_cmpstr (removed->pdata[0], ==, "10.0.0.0/32 10,10.0.0.1/32 10");
+	g_assert_cmpint (added->len, ==, 1);
+	g_assert_cmpstr (added->pdata[0], ==, "10.0.0.1/32 42");
+
+	/* without a change, nothing is emitted. */
+	v = _get_variant_property (config, NM_IP4_CONFIG_ROUTE_DATA);
+	g_variant_unref (v);
+	while (g_main_context_iteration (NULL, FALSE)) {
+	}
+	g_assert_cmpint (removed->len, ==, 1);
+	g_assert_cmpint (added->len, ==, 1);
+
+	g_object_unref (config);
+	g_ptr_array_unref (added);
+	g_ptr_array_unref (removed);
+}
+
 /*******************************************/
 
 NMTST_DEFINE ();
@@ -376,6 +824,11 @@ main (int argc, char **argv)
 	g_test_add_func ("/ip4-config/add-route-with-source", test_add_route_with_source);
 	g_test_add_func ("/ip4-config/merge-subtract-mss-mtu", test_merge_subtract_mss_mtu);
 	g_test_add_func ("/ip4-config/strip-search-trailing-dot", test_strip_search_trailing_dot);
+	g_test_add_func ("/ip4-config/direct-route-for-host", test_direct_route_for_host);
+	g_test_add_func ("/ip4-config/many-addresses-and-routes", test_many_addresses_and_routes);
+	g_test_add_func ("/ip4-config/shared-arrays", test_shared_arrays);
+	g_test_add_func ("/ip4-config/exported-variants", test_exported_variants);
+	g_test_add_func ("/ip4-config/routes-delta", test_routes_delta);
 
 	return g_test_run ();
 }
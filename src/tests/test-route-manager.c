@@ -863,6 +863,229 @@ test_ip4_full_sync (test_fixture *fixture, gconstpointer user_data)
 	nm_log_dbg (LOGD_CORE, "TEST test_ip4_full_sync(): done");
 }
 
+typedef struct {
+	int ifindex;
+	in_addr_t network;
+	GArray *changes;
+} RouteReplaceData;
+
+static void
+_ip4_route_replace_cb (NMPlatform *platform,
+                       NMPObjectType obj_type,
+                       int ifindex,
+                       const NMPlatformIP4Route *route,
+                       NMPlatformSignalChangeType change_type,
+                       RouteReplaceData *data)
+{
+	if (   route->ifindex == data->ifindex
+	    && route->network == data->network)
+		g_array_append_val (data->changes, change_type);
+}
+
+static void
+_assert_route_changes (RouteReplaceData *data, guint n_changes, ...)
+{
+	va_list ap;
+	guint i;
+
+	g_assert_cmpint (data->changes->len, ==, n_changes);
+
+	va_start (ap, n_changes);
+	for (i = 0; i < n_changes; i++)
+		g_assert_cmpint (g_array_index (data->changes, NMPlatformSignalChangeType, i), ==, va_arg (ap, int));
+	va_end (ap);
+
+	g_array_set_size (data->changes, 0);
+}
+
+static void
+test_ip4_replace (test_fixture *fixture, gconstpointer user_data)
+{
+	const NMPlatformVTableRoute *vtable = &nm_platform_vtable_route_v4;
+	gs_unref_array GArray *routes = g_array_new (FALSE, FALSE, sizeof (NMPlatformIP4Route));
+	NMPlatformIP4Route r01, r02, r02_old;
+	RouteReplaceData data;
+	gulong handler_id;
+
+	r01 = *nmtst_platform_ip4_route_full ("12.3.4.0", 24, NULL,
+	                                      fixture->ifindex0, NM_IP_CONFIG_SOURCE_USER,
+	                                      100, 0, RT_SCOPE_LINK, NULL);
+	r02 = *nmtst_platform_ip4_route_full ("13.4.5.6", 32, "12.3.4.1",
+	                                      fixture->ifindex0, NM_IP_CONFIG_SOURCE_USER,
+	                                      100, 0, RT_SCOPE_UNIVERSE, NULL);
+	g_array_set_size (routes, 2);
+	g_array_index (routes, NMPlatformIP4Route, 0) = r01;
+	g_array_index (routes, NMPlatformIP4Route, 1) = r02;
+	nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes, TRUE, TRUE);
+
+	_assert_route_check (vtable, TRUE, (const NMPlatformIPXRoute *) &r01);
+	_assert_route_check (vtable, TRUE, (const NMPlatformIPXRoute *) &r02);
+
+	data.ifindex = fixture->ifindex0;
+	data.network = r02.network;
+	data.changes = g_array_new (FALSE, FALSE, sizeof (NMPlatformSignalChangeType));
+	handler_id = g_signal_connect (NM_PLATFORM_GET, NM_PLATFORM_SIGNAL_IP4_ROUTE_CHANGED, G_CALLBACK (_ip4_route_replace_cb), &data);
+
+	/* changing only the MSS updates the route in place. */
+	r02.mss = 1400;
+	g_array_index (routes, NMPlatformIP4Route, 1) = r02;
+	nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes, TRUE, TRUE);
+
+	_assert_route_check (vtable, TRUE, (const NMPlatformIPXRoute *) &r02);
+	_assert_route_changes (&data, 1, NM_PLATFORM_SIGNAL_CHANGED);
+
+	/* the same, with a non-full sync. */
+	r02.mss = 1300;
+	g_array_index (routes, NMPlatformIP4Route, 1) = r02;
+	nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes, TRUE, FALSE);
+
+	_assert_route_check (vtable, TRUE, (const NMPlatformIPXRoute *) &r02);
+	_assert_route_changes (&data, 1, NM_PLATFORM_SIGNAL_CHANGED);
+
+	/* the metric is part of the identity of the route. The new route
+	 * is added before the old one is removed. */
+	r02_old = r02;
+	r02.metric = 200;
+	g_array_index (routes, NMPlatformIP4Route, 1) = r02;
+	nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes, TRUE, FALSE);
+
+	_assert_route_check (vtable, TRUE,  (const NMPlatformIPXRoute *) &r02);
+	_assert_route_check (vtable, FALSE, (const NMPlatformIPXRoute *) &r02_old);
+	_assert_route_changes (&data, 2, NM_PLATFORM_SIGNAL_ADDED, NM_PLATFORM_SIGNAL_REMOVED);
+
+	/* the same, with a full sync. */
+	r02_old = r02;
+	r02.metric = 300;
+	g_array_index (routes, NMPlatformIP4Route, 1) = r02;
+	nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes, TRUE, TRUE);
+
+	_assert_route_check (vtable, TRUE,  (const NMPlatformIPXRoute *) &r01);
+	_assert_route_check (vtable, TRUE,  (const NMPlatformIPXRoute *) &r02);
+	_assert_route_check (vtable, FALSE, (const NMPlatformIPXRoute *) &r02_old);
+	_assert_route_changes (&data, 2, NM_PLATFORM_SIGNAL_ADDED, NM_PLATFORM_SIGNAL_REMOVED);
+
+	g_signal_handler_disconnect (NM_PLATFORM_GET, handler_id);
+	g_array_unref (data.changes);
+}
+
+static void
+_ip4_route_count_cb (NMPlatform *platform,
+                     NMPObjectType obj_type,
+                     int ifindex,
+                     const NMPlatformIP4Route *route,
+                     NMPlatformSignalChangeType change_type,
+                     guint *p_count)
+{
+	(*p_count)++;
+}
+
+static void
+test_ip4_sync_unchanged (test_fixture *fixture, gconstpointer user_data)
+{
+	const NMPlatformVTableRoute *vtable = &nm_platform_vtable_route_v4;
+	gs_unref_array GArray *routes = g_array_new (FALSE, FALSE, sizeof (NMPlatformIP4Route));
+	NMPlatformIP4Route r01, r02, r03;
+	guint n_changes = 0;
+	gulong handler_id;
+
+	r01 = *nmtst_platform_ip4_route_full ("12.3.4.0", 24, NULL,
+	                                      fixture->ifindex0, NM_IP_CONFIG_SOURCE_USER,
+	                                      100, 0, RT_SCOPE_LINK, NULL);
+	r02 = *nmtst_platform_ip4_route_full ("13.4.5.6", 32, "12.3.4.1",
+	                                      fixture->ifindex0, NM_IP_CONFIG_SOURCE_USER,
+	                                      100, 0, RT_SCOPE_UNIVERSE, NULL);
+	r03 = *nmtst_platform_ip4_route_full ("14.5.6.7", 32, "12.3.4.1",
+	                                      fixture->ifindex0, NM_IP_CONFIG_SOURCE_USER,
+	                                      110, 0, RT_SCOPE_UNIVERSE, NULL);
+	g_array_set_size (routes, 2);
+	g_array_index (routes, NMPlatformIP4Route, 0) = r01;
+	g_array_index (routes, NMPlatformIP4Route, 1) = r02;
+	g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes, TRUE, TRUE));
+
+	_assert_route_check (vtable, TRUE, (const NMPlatformIPXRoute *) &r01);
+	_assert_route_check (vtable, TRUE, (const NMPlatformIPXRoute *) &r02);
+
+	handler_id = g_signal_connect (NM_PLATFORM_GET, NM_PLATFORM_SIGNAL_IP4_ROUTE_CHANGED, G_CALLBACK (_ip4_route_count_cb), &n_changes);
+
+	/* syncing the same routes again does not touch platform. */
+	g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes, TRUE, TRUE));
+	g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes, TRUE, FALSE));
+	g_assert_cmpint (n_changes, ==, 0);
+
+	/* a route removed outside of route-manager is restored by the next
+	 * sync, although the routes did not change. */
+	g_assert (vtable->route_delete (NM_PLATFORM_GET, 0, (const NMPlatformIPXRoute *) &r02));
+	_assert_route_check (vtable, FALSE, (const NMPlatformIPXRoute *) &r02);
+
+	g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes, TRUE, FALSE));
+	_assert_route_check (vtable, TRUE, (const NMPlatformIPXRoute *) &r02);
+
+	/* a route added outside of route-manager is kept by a non-full sync
+	 * and removed by the next full sync. */
+	g_assert (vtable->route_add (NM_PLATFORM_GET, 0, (const NMPlatformIPXRoute *) &r03, -1));
+
+	g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes, TRUE, FALSE));
+	_assert_route_check (vtable, TRUE, (const NMPlatformIPXRoute *) &r03);
+
+	g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes, TRUE, TRUE));
+	_assert_route_check (vtable, TRUE,  (const NMPlatformIPXRoute *) &r01);
+	_assert_route_check (vtable, TRUE,  (const NMPlatformIPXRoute *) &r02);
+	_assert_route_check (vtable, FALSE, (const NMPlatformIPXRoute *) &r03);
+
+	/* changed routes are synced. */
+	g_array_set_size (routes, 1);
+	g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes, TRUE, TRUE));
+	_assert_route_check (vtable, TRUE,  (const NMPlatformIPXRoute *) &r01);
+	_assert_route_check (vtable, FALSE, (const NMPlatformIPXRoute *) &r02);
+
+	n_changes = 0;
+	g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes, TRUE, TRUE));
+	g_assert_cmpint (n_changes, ==, 0);
+
+	g_signal_handler_disconnect (NM_PLATFORM_GET, handler_id);
+}
+
+static void
+test_ip4_sync_shadowed (test_fixture *fixture, gconstpointer user_data)
+{
+	const NMPlatformVTableRoute *vtable = &nm_platform_vtable_route_v4;
+	gs_unref_array GArray *routes0 = g_array_new (FALSE, FALSE, sizeof (NMPlatformIP4Route));
+	gs_unref_array GArray *routes1 = g_array_new (FALSE, FALSE, sizeof (NMPlatformIP4Route));
+	NMPlatformIP4Route r00, r01, r10, r11;
+
+	r00 = *nmtst_platform_ip4_route_full ("12.3.5.0", 24, NULL,
+	                                      fixture->ifindex0, NM_IP_CONFIG_SOURCE_USER,
+	                                      100, 0, RT_SCOPE_LINK, NULL);
+	r01 = *nmtst_platform_ip4_route_full ("13.4.5.6", 32, "12.3.5.1",
+	                                      fixture->ifindex0, NM_IP_CONFIG_SOURCE_USER,
+	                                      10, 0, RT_SCOPE_UNIVERSE, NULL);
+	r10 = *nmtst_platform_ip4_route_full ("12.3.4.0", 24, NULL,
+	                                      fixture->ifindex1, NM_IP_CONFIG_SOURCE_USER,
+	                                      100, 0, RT_SCOPE_LINK, NULL);
+	r11 = *nmtst_platform_ip4_route_full ("13.4.5.6", 32, "12.3.4.1",
+	                                      fixture->ifindex1, NM_IP_CONFIG_SOURCE_USER,
+	                                      20, 0, RT_SCOPE_UNIVERSE, NULL);
+
+	g_array_append_val (routes1, r10);
+	g_array_append_val (routes1, r11);
+	g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex1, routes1, TRUE, TRUE));
+	_assert_route_check (vtable, TRUE, (const NMPlatformIPXRoute *) &r11);
+
+	/* sync again, so that only the changes below are pending for ifindex1. */
+	g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex1, routes1, TRUE, TRUE));
+
+	/* the gateway route on ifindex0 has a lower metric and shadows the one on ifindex1. */
+	g_array_append_val (routes0, r00);
+	g_array_append_val (routes0, r01);
+	g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex0, routes0, TRUE, TRUE));
+	_assert_route_check (vtable, TRUE, (const NMPlatformIPXRoute *) &r01);
+
+	/* the routes of ifindex1 did not change, but the shadowed route is removed. */
+	g_assert (nm_route_manager_ip4_route_sync (nm_route_manager_get (), fixture->ifindex1, routes1, TRUE, TRUE));
+	_assert_route_check (vtable, TRUE,  (const NMPlatformIPXRoute *) &r10);
+	_assert_route_check (vtable, FALSE, (const NMPlatformIPXRoute *) &r11);
+}
+
 /*****************************************************************************/
 
 static void
@@ -917,4 +1140,7 @@ setup_tests (void)
 	g_test_add ("/route-manager/ip6", test_fixture, NULL, fixture_setup, test_ip6, fixture_teardown);
 
 	g_test_add ("/route-manager/ip4-full-sync", test_fixture, NULL, fixture_setup, test_ip4_full_sync, fixture_teardown);
+	g_test_add ("/route-manager/ip4-replace", test_fixture, NULL, fixture_setup, test_ip4_replace, fixture_teardown);
+	g_test_add ("/route-manager/ip4-sync-unchanged", test_fixture, NULL, fixture_setup, test_ip4_sync_unchanged, fixture_teardown);
+	g_test_add ("/route-manager/ip4-sync-shadowed", test_fixture, NULL, fixture_setup, test_ip4_sync_shadowed, fixture_teardown);
 }